@@ -0,0 +1,40 @@
+# - Find Numpy
+# Find the NumPy C API headers of the Python interpreter PYTHON_EXECUTABLE
+#
+#   NUMPY_FOUND        - True if the NumPy headers are found.
+#   NUMPY_INCLUDE_DIRS - where to find numpy/arrayobject.h, etc.
+#
+
+if( NUMPY_INCLUDE_DIR )
+    # Already in cache, be silent
+    set( Numpy_FIND_QUIETLY TRUE )
+endif()
+
+# Ask the interpreter where its numpy package keeps the headers
+if( PYTHON_EXECUTABLE )
+  execute_process( COMMAND ${PYTHON_EXECUTABLE} -c
+                   "import sys, numpy; sys.stdout.write(numpy.get_include())"
+                   OUTPUT_VARIABLE NUMPY_INCLUDE_HINT
+                   RESULT_VARIABLE NUMPY_IMPORT_RESULT
+                   ERROR_QUIET
+                   OUTPUT_STRIP_TRAILING_WHITESPACE )
+  if( NOT NUMPY_IMPORT_RESULT EQUAL 0 )
+    set( NUMPY_INCLUDE_HINT )
+  endif()
+endif()
+
+find_path( NUMPY_INCLUDE_DIR numpy/arrayobject.h
+           HINTS ${NUMPY_INCLUDE_HINT} )
+
+# handle the QUIETLY and REQUIRED arguments and set NUMPY_FOUND to TRUE if
+# all listed variables are TRUE
+include( FindPackageHandleStandardArgs )
+FIND_PACKAGE_HANDLE_STANDARD_ARGS( Numpy DEFAULT_MSG NUMPY_INCLUDE_DIR )
+
+mark_as_advanced( NUMPY_INCLUDE_DIR )
+
+if(NUMPY_FOUND)
+  set(NUMPY_INCLUDE_DIRS ${NUMPY_INCLUDE_DIR})
+else()
+  set(NUMPY_INCLUDE_DIRS)
+endif()
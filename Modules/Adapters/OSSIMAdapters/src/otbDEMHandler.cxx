@@ -65,6 +65,17 @@ DEMHandler
   ossimFilename ossimDEMDir;
   ossimDEMDir = ossimFilename(DEMDirectory);
 
+  // Do not stack the same database twice, e.g. when a long-lived
+  // process (the application server) already opened the directory
+  for (unsigned int i = 0; i < m_ElevManager->getNumberOfElevationDatabases(); ++i)
+    {
+    if (m_ElevManager->getElevationDatabase(i)->getConnectionString() == ossimDEMDir)
+      {
+      otbMsgDevMacro(<< "DEM directory already opened: " << ossimDEMDir);
+      return;
+      }
+    }
+
   if (!m_ElevManager->loadElevationPath(ossimDEMDir))
     {
     // In ossim elevation database factory code, the
@@ -26,6 +26,7 @@
 #include "itkWeightedCentroidKdTreeGenerator.h"
 #include "itkKdTreeBasedKmeansEstimator.h"
 #include "otbStreamingShrinkImageFilter.h"
+#include "otbStreamingKMeansImageFilter.h"
 #include "otbChangeLabelImageFilter.h"
 #include "otbRAMDrivenStrippedStreamingManager.h"
 
@@ -42,66 +43,6 @@ namespace otb
 namespace Wrapper
 {
 
-namespace Functor
-{
-template <class TSample, class TLabel> class KMeansFunctor
-{
-public:
-  /** operator */
-  TLabel operator ()(const TSample& sample) const
-  {
-    typename CentroidMapType::const_iterator it = m_CentroidsMap.begin();
-
-    if (it == m_CentroidsMap.end())
-      {
-      return 0;
-      }
-
-    TLabel resp = it->first;
-    double minDist = m_Distance->Evaluate(sample, it->second);
-    ++it;
-
-    while (it != m_CentroidsMap.end())
-      {
-      double dist = m_Distance->Evaluate(sample, it->second);
-
-      if (dist < minDist)
-        {
-        resp = it->first;
-        minDist = dist;
-        }
-      ++it;
-      }
-    return resp;
-  }
-
-  /** Add a new centroid */
-  void AddCentroid(const TLabel& label, const TSample& centroid)
-  {
-    m_CentroidsMap[label] = centroid;
-  }
-
-  /** Constructor */
-  KMeansFunctor() : m_CentroidsMap(), m_Distance()
-  {
-    m_Distance = DistanceType::New();
-  }
-
-  bool operator !=(const KMeansFunctor& other) const
-  {
-    return m_CentroidsMap != other.m_CentroidsMap;
-  }
-
-private:
-  typedef std::map<TLabel, TSample>                   CentroidMapType;
-  typedef itk::Statistics::EuclideanDistanceMetric<TSample> DistanceType;
-
-  CentroidMapType m_CentroidsMap;
-  typename DistanceType::Pointer m_Distance;
-};
-}
-
-
 typedef FloatImageType::PixelType PixelType;
 typedef UInt8ImageType   LabeledImageType;
 
@@ -130,7 +71,8 @@ typedef otb::StreamingShrinkImageFilter<FloatVectorImageType,
 
 typedef otb::StreamingShrinkImageFilter<LabeledImageType,
     UInt8ImageType>              MaskSamplingFilterType;
-typedef Functor::KMeansFunctor<SampleType, LabelType> KMeansFunctorType;
+typedef otb::StreamingKMeansImageFilter<FloatVectorImageType, LabeledImageType> StreamingKMeansFilterType;
+typedef otb::Functor::KMeansNearestCentroidFunctor<SampleType, LabelType> KMeansFunctorType;
 typedef itk::UnaryFunctorImageFilter<FloatVectorImageType,
     LabeledImageType, KMeansFunctorType>     KMeansFilterType;
 
@@ -202,6 +144,17 @@ private:
     SetParameterDescription("ct", "Convergence threshold for class centroid  (L2 distance, by default 0.0001).");
     SetDefaultParameterFloat("ct", 0.0001);
     MandatoryOff("ct");
+
+    AddParameter(ParameterType_Choice, "alg", "Learning algorithm");
+    SetParameterDescription("alg", "Algorithm used to estimate the centroids. The initial centroids are always drawn from the training set.");
+    AddChoice("alg.sample", "KMeans on the training set");
+    SetParameterDescription("alg.sample", "KMeans estimation on the training set only, with a kd-tree. The training set is limited by the available RAM, and to 1000x1000 samples.");
+    AddChoice("alg.lloyd", "Lloyd iterations on the whole image");
+    SetParameterDescription("alg.lloyd", "Each iteration streams the whole image (or the pixels of the validity mask) and moves the centroids to the mean of their pixels.");
+    AddChoice("alg.minibatch", "Mini-batch KMeans on the whole image");
+    SetParameterDescription("alg.minibatch", "Each iteration streams the whole image (or the pixels of the validity mask), and the centroids are moved after each stream. It usually needs less iterations than the Lloyd algorithm.");
+    SetParameterString("alg", "sample");
+
     AddParameter(ParameterType_OutputFilename, "outmeans", "Centroid filename");
     SetParameterDescription("outmeans", "Output text file containing centroid positions");
     MandatoryOff("outmeans");
@@ -445,25 +398,53 @@ private:
     GetLogger()->Info(message.str());
     message.str("");
     otbAppLogINFO("Starting optimization." << std::endl);
-    EstimatorType::Pointer estimator = EstimatorType::New();
+    int maxIt = GetParameterInt("maxit");
+    int nbIterations = 0;
+    EstimatorType::ParametersType estimatedMeans;
+
+    if (GetParameterString("alg") == "sample")
+      {
+      EstimatorType::Pointer estimator = EstimatorType::New();
 
-    TreeGeneratorType::Pointer treeGenerator = TreeGeneratorType::New();
-    treeGenerator->SetSample(sampleList);
+      TreeGeneratorType::Pointer treeGenerator = TreeGeneratorType::New();
+      treeGenerator->SetSample(sampleList);
 
-    treeGenerator->SetBucketSize(10000);
-    treeGenerator->Update();
+      treeGenerator->SetBucketSize(10000);
+      treeGenerator->Update();
 
-    estimator->SetParameters(initialMeans);
-    estimator->SetKdTree(treeGenerator->GetOutput());
-    int maxIt = GetParameterInt("maxit");
-    estimator->SetMaximumIteration(maxIt);
-    estimator->SetCentroidPositionChangesThreshold(GetParameterFloat("ct"));
-    estimator->StartOptimization();
+      estimator->SetParameters(initialMeans);
+      estimator->SetKdTree(treeGenerator->GetOutput());
+      estimator->SetMaximumIteration(maxIt);
+      estimator->SetCentroidPositionChangesThreshold(GetParameterFloat("ct"));
+      estimator->StartOptimization();
 
-    EstimatorType::ParametersType estimatedMeans = estimator->GetParameters();
+      estimatedMeans = estimator->GetParameters();
+      nbIterations = estimator->GetCurrentIteration();
+      }
+    else
+      {
+      // Iterations over the whole image, stream by stream
+      StreamingKMeansFilterType::Pointer kmeans = StreamingKMeansFilterType::New();
+      kmeans->SetInput(m_InImage);
+      if (maskFlag)
+        {
+        kmeans->SetInputMask(maskImage);
+        }
+      kmeans->SetCentroids(initialMeans);
+      kmeans->SetUseMiniBatch(GetParameterString("alg") == "minibatch");
+      kmeans->SetMaximumNumberOfIterations(maxIt);
+      kmeans->SetConvergenceThreshold(GetParameterFloat("ct"));
+      kmeans->GetStreamer()->SetAutomaticStrippedStreaming(GetParameterInt("ram"));
+      AddProcess(kmeans->GetStreamer(), "KMeans iterations on the whole image");
+      kmeans->Update();
+
+      estimatedMeans = kmeans->GetCentroids();
+      nbIterations = kmeans->GetNumberOfIterations();
+      otbAppLogINFO("Inertia after " << nbIterations << " iterations: " << kmeans->GetInertia() << std::endl);
+      }
 
     otbAppLogINFO("Optimization completed." );
-    if (estimator->GetCurrentIteration() == maxIt)
+    if (nbIterations == maxIt)
       {
       otbAppLogWARNING("The estimator reached the maximum iteration number." << std::endl);
       }
@@ -492,17 +473,7 @@ private:
 
     // Finally, update the KMeans filter
     KMeansFunctorType functor;
-
-    for (unsigned int classIndex = 0; classIndex < nbClasses; ++classIndex)
-      {
-      SampleType centroid(sampleSize);
-
-      for (unsigned int compIndex = 0; compIndex < sampleSize; ++compIndex)
-        {
-        centroid[compIndex] = estimatedMeans[compIndex + classIndex * sampleSize];
-        }
-      functor.AddCentroid(classIndex, centroid);
-      }
+    functor.SetCentroids(estimatedMeans, sampleSize);
 
     m_KMeansFilter = KMeansFilterType::New();
     m_KMeansFilter->SetFunctor(functor);
@@ -136,6 +136,10 @@ private:
     SetParameterDescription("iv", "Maximum initial neuron weight");
     MandatoryOff("iv");
 
+    AddParameter(ParameterType_Int,  "bs",   "BatchSize");
+    SetParameterDescription("bs", "Number of samples of the mini-batches: the samples of a batch are learnt together, by several threads. 0 means that the samples are learnt one by one, on a single thread.");
+    MandatoryOff("bs");
+
     AddRAMParameter();
     // TODO : replace StreamingLines by RAM param ?
 
@@ -150,6 +154,7 @@ private:
     SetDefaultParameterFloat("bi", 1.0);
     SetDefaultParameterFloat("bf", 0.1);
     SetDefaultParameterFloat("iv", 0.0);
+    SetDefaultParameterInt("bs", 0);
 
     // Doc example parameter settings
     SetDocExampleParameterValue("in", "QB_1_ortho.tif");
@@ -350,6 +355,7 @@ private:
       estimator->SetBetaInit(GetParameterFloat("bi"));
       estimator->SetBetaEnd(GetParameterFloat("bf"));
       estimator->SetMaxWeight(GetParameterFloat("iv"));
+      estimator->SetBatchSize(GetParameterInt("bs"));
 
     AddProcess(estimator,"Learning");
     estimator->Update();
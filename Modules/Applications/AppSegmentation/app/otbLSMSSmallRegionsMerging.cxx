@@ -16,18 +16,10 @@
 
  =========================================================================*/
 
-#include "otbMultiChannelExtractROI.h"
-#include "otbExtractROI.h"
-
-#include "otbStreamingStatisticsImageFilter.h"
-#include "otbSystem.h"
+#include "otbLabelImageSmallRegionMergingFilter.h"
 #include "itkChangeLabelImageFilter.h"
 
-#include "otbTileImageFilter.h"
-
 #include <time.h>
-#include <vcl_algorithm.h>
-#include <climits>
 
 #include "otbWrapperApplication.h"
 #include "otbWrapperApplicationFactory.h"
@@ -52,21 +44,15 @@ public:
   typedef UInt32ImageType                   LabelImageType;
   typedef LabelImageType::InternalPixelType LabelImagePixelType;
 
-  typedef otb::MultiChannelExtractROI <ImagePixelType,ImagePixelType > MultiChannelExtractROIFilterType;
-  typedef otb::ExtractROI<LabelImagePixelType,LabelImagePixelType> ExtractROIFilterType;
-
-  typedef otb::StreamingStatisticsImageFilter<LabelImageType> StatisticsImageFilterType;
-
-  typedef itk::ImageRegionConstIterator<LabelImageType> LabelImageIterator;
-  typedef itk::ImageRegionConstIterator<ImageType> ImageIterator;
+  typedef otb::LabelImageSmallRegionMergingFilter<LabelImageType,ImageType> SmallRegionMergingFilterType;
 
   typedef itk::ChangeLabelImageFilter<LabelImageType,LabelImageType> ChangeLabelImageFilterType;
-  typedef otb::TileImageFilter<LabelImageType> TileImageFilterType;
 
   itkNewMacro(Self);
   itkTypeMacro(Merging, otb::Application);
 
 private:
+  SmallRegionMergingFilterType::Pointer m_SmallRegionMergingFilter;
   ChangeLabelImageFilterType::Pointer m_ChangeLabelFilter;
 
   void DoInit()
@@ -75,7 +61,7 @@ private:
     SetDescription("Third (optional) step of the exact Large-Scale Mean-Shift segmentation workflow.");
 
     SetDocName("Exact Large-Scale Mean-Shift segmentation, step 3 (optional)");
-    SetDocLongDescription("This application performs the third step of the exact Large-Scale Mean-Shift segmentation workflow (LSMS). Given a segmentation result (label image) and the original image, it will merge regions whose size in pixels is lower than minsize parameter with the adjacent regions with the adjacent region with closest radiometry and acceptable size. Small regions will be processed by size: first all regions of area, which is equal to 1 pixel will be merged with adjacent region, then all regions of area equal to 2 pixels, until regions of area minsize. For large images one can use the nbtilesx and nbtilesy parameters for tile-wise processing, with the guarantees of identical results.");
+    SetDocLongDescription("This application performs the third step of the exact Large-Scale Mean-Shift segmentation workflow (LSMS). Given a segmentation result (label image) and the original image, it will merge regions whose size in pixels is lower than minsize parameter with the adjacent regions with the adjacent region with closest radiometry and acceptable size. Small regions will be processed by size: first all regions of area, which is equal to 1 pixel will be merged with adjacent region, then all regions of area equal to 2 pixels, until regions of area minsize. The region adjacency graph and the region means are computed in a single pass over the images, then all the merging is done in memory. For large images one can use the tilesizex and tilesizey parameters for tile-wise reading of the images, with the guarantees of identical results.");
     SetDocLimitations("This application is part of the Large-Scale Mean-Shift segmentation workflow (LSMS) and may not be suited for any other purpose.");
     SetDocAuthors("David Youssefi");
     SetDocSeeAlso("LSMSSegmentation, LSMSVectorization, MeanShiftSmoothing");
@@ -134,277 +120,33 @@ private:
     imageIn->UpdateOutputInformation();
     unsigned long sizeImageX = imageIn->GetLargestPossibleRegion().GetSize()[0],
       sizeImageY = imageIn->GetLargestPossibleRegion().GetSize()[1];
-    unsigned int numberOfComponentsPerPixel = imageIn->GetNumberOfComponentsPerPixel();
 
     LabelImageType::Pointer labelIn = GetParameterUInt32Image("inseg");
 
-    StatisticsImageFilterType::Pointer stats = StatisticsImageFilterType::New();
-    stats->SetInput(labelIn);
-    stats->Update();
-    unsigned int regionCount=stats->GetMaximum();
-
-    std::vector<unsigned int>nbPixels;
-    nbPixels.clear();
-    nbPixels.resize(regionCount+1);
-    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      nbPixels[curLabel] = 0;
-
-    ImageType::PixelType defaultValue(numberOfComponentsPerPixel);
-    defaultValue.Fill(0);
-
-    std::vector<ImageType::PixelType>sum(regionCount+1,defaultValue);
-
     unsigned int nbTilesX = sizeImageX/sizeTilesX + (sizeImageX%sizeTilesX > 0 ? 1 : 0);
     unsigned int nbTilesY = sizeImageY/sizeTilesY + (sizeImageY%sizeTilesY > 0 ? 1 : 0);
 
     otbAppLogINFO(<<"Number of tiles: "<<nbTilesX<<" x "<<nbTilesY);
 
-    //Sums calculation per label
-    otbAppLogINFO(<<"Sums calculation ...");
-
-    for(unsigned int row = 0; row < nbTilesY; row++)
-      for(unsigned int column = 0; column < nbTilesX; column++)
-       {
-        unsigned long startX = column*sizeTilesX;
-        unsigned long startY = row*sizeTilesY;
-        unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
-        unsigned long sizeY = vcl_min(sizeTilesY,sizeImageY-startY);
-
-        //Tiles extraction of the input image
-        MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
-        imageROI->SetInput(imageIn);
-        imageROI->SetStartX(startX);
-        imageROI->SetStartY(startY);
-        imageROI->SetSizeX(sizeX);
-        imageROI->SetSizeY(sizeY);
-        imageROI->Update();
-
-        //Tiles extraction of the segmented image
-        ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX);
-        labelImageROI->SetSizeY(sizeY);
-        labelImageROI->Update();
-
-        //Sums calculation for the mean calculation per label
-        LabelImageIterator itLabel( labelImageROI->GetOutput(), labelImageROI->GetOutput()->GetLargestPossibleRegion());
-        ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
-
-        for (itLabel.GoToBegin(), itImage.GoToBegin(); !itLabel.IsAtEnd(); ++itLabel, ++itImage)
-          {
-          nbPixels[itLabel.Value()]++;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-            {
-            sum[itLabel.Value()][comp]+=itImage.Get()[comp];
-            }
-          }
-        }
-
-    //LUT creation for the final relabelling
-    std::vector<LabelImagePixelType> LUT;
-    LUT.clear();
-    LUT.resize(regionCount+1);
-    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      {
-      LUT[curLabel] = curLabel;
-      }
-
-    //Minimal size region suppression
+    //Region adjacency graph and sums calculation, then merging of the small regions
     otbAppLogINFO(<<"Building LUT for small regions merging ...");
 
-    for (unsigned int size=1; size<minSize; size++)
-      {
-      // LUTtmp creation in order to modify the LUT only at the end of the pass
-      std::vector<LabelImagePixelType> LUTtmp;
-      LUTtmp.clear();
-      LUTtmp.resize(regionCount+1);
-      for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-        {
-        LUTtmp[curLabel] = LUT[curLabel];
-        }
-
-      for(unsigned int row = 0; row < nbTilesY; row++)
-        {
-        for(unsigned int column = 0; column < nbTilesX; column++)
-          {
-          std::set<int> minLabel, edgeLabel, labelMerged;
-          std::map<int,std::set<int> > adjMap;
-
-          unsigned long startX = column*sizeTilesX, startY = row*sizeTilesY;
-          unsigned long sizeX = vcl_min(sizeTilesX+size+1,sizeImageX-startX),
-            sizeY = vcl_min(sizeTilesY+size+1,sizeImageY-startY);
-
-          ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
-          labelImageROI->SetInput(labelIn);
-          labelImageROI->SetStartX(startX);
-          labelImageROI->SetStartY(startY);
-          labelImageROI->SetSizeX(sizeX);
-          labelImageROI->SetSizeY(sizeY);
-          labelImageROI->Update();
-
-          LabelImageType::IndexType pixelIndex;
-
-          //"Adjacency map" creation for the region with nbPixels=="size"
-          for(pixelIndex[0]=0; pixelIndex[0]<static_cast<long>(sizeX); ++pixelIndex[0])
-            for(pixelIndex[1]=0; pixelIndex[1]<static_cast<long>(sizeY); ++pixelIndex[1])
-              {
-              LabelImagePixelType curLabel = labelImageROI->GetOutput()->GetPixel(pixelIndex);
-
-              if(labelMerged.count(LUT[curLabel]))
-                {
-                edgeLabel.insert(LUT[curLabel]);
-                }
-              if((pixelIndex[0]==0)&&(startX!=0))
-                {
-                edgeLabel.insert(LUT[curLabel]);
-                }
-              if((pixelIndex[1]==0)&&(startY!=0))
-                {
-                edgeLabel.insert(LUT[curLabel]);
-                }
-
-              if(pixelIndex[0]==static_cast<long>(sizeX)-1)
-                {
-                if(startX!=(nbTilesX-1)*sizeTilesX) edgeLabel.insert(LUT[curLabel]);
-                }
-              else
-                {
-                ++pixelIndex[0];
-                LabelImagePixelType adjLabelX = labelImageROI->GetOutput()->GetPixel(pixelIndex);
-                --pixelIndex[0];
-
-                if(LUT[adjLabelX]!=LUT[curLabel])
-                  {
-                  if((nbPixels[LUT[curLabel]]>0)&&(nbPixels[LUT[curLabel]]==size))
-                    {
-                    adjMap[LUT[curLabel]].insert(LUT[adjLabelX]);
-                    minLabel.insert(LUT[curLabel]);
-                    }
-                  if((nbPixels[LUT[adjLabelX]]>0)&&(nbPixels[LUT[adjLabelX]]==size))
-                    {
-                    adjMap[LUT[adjLabelX]].insert(LUT[curLabel]);
-                    minLabel.insert(LUT[adjLabelX]);
-                    }
-                  }
-                }
-              if(pixelIndex[1]==static_cast<long>(sizeY)-1)
-                {
-                if(startY!=(nbTilesY-1)*sizeTilesY) edgeLabel.insert(LUT[curLabel]);
-                }
-              else
-                {
-                ++pixelIndex[1];
-                LabelImagePixelType adjLabelY = labelImageROI->GetOutput()->GetPixel(pixelIndex);
-                --pixelIndex[1];
-                if(LUT[adjLabelY]!=LUT[curLabel])
-                  {
-                  if((nbPixels[LUT[curLabel]]>0)&&(nbPixels[LUT[curLabel]]==size))
-                    {
-                    adjMap[LUT[curLabel]].insert(LUT[adjLabelY]);
-                    minLabel.insert(LUT[curLabel]);
-                    }
-                  if((nbPixels[LUT[adjLabelY]]>0)&&(nbPixels[LUT[adjLabelY]]==size))
-                    {
-                    adjMap[LUT[adjLabelY]].insert(LUT[curLabel]);
-                    minLabel.insert(LUT[adjLabelY]); }
-                  }
-                }
-              }
-
-          //Searching the "nearest" region
-          for(std::set<int>::iterator itMinLabel=minLabel.begin(); itMinLabel!=minLabel.end(); ++itMinLabel)
-            {
-            LabelImagePixelType curLabel = *itMinLabel, adjLabel(0);
-            double err = itk::NumericTraits<double>::max();
-            if(edgeLabel.count(curLabel)==0)
-              {
-              if(nbPixels[curLabel]==size)
-                {
-                edgeLabel.insert(curLabel);
-                for(std::set<int>::iterator itAdjLabel=adjMap[curLabel].begin();
-                    itAdjLabel!=adjMap[curLabel].end(); ++itAdjLabel)
-                  {
-                  double tmpError = 0;
-                  LabelImagePixelType tmpLabel = *itAdjLabel;
-                  if(tmpLabel!=curLabel)
-                    {
-                    for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-                      {
-                      double curComp = static_cast<double>(sum[curLabel][comp])/nbPixels[curLabel];
-                      int tmpComp = static_cast<double>(sum[tmpLabel][comp])/nbPixels[tmpLabel];
-                      tmpError += (curComp-tmpComp)*(curComp-tmpComp);
-                      }
-                    if(tmpError<err)
-                      {
-                      err = tmpError;
-                      adjLabel = tmpLabel;
-                      }
-                    }
-                  }
-
-                //Fusion of the two regions
-                if(adjLabel!=curLabel)
-                  {
-                  unsigned int curLabelLUT = curLabel, adjLabelLUT = adjLabel;
-                  while(LUTtmp[curLabelLUT] != curLabelLUT)
-                    {
-                    curLabelLUT = LUTtmp[curLabelLUT];
-                    }
-                  while(LUTtmp[adjLabelLUT] != adjLabelLUT)
-                    {
-                    adjLabelLUT = LUTtmp[adjLabelLUT];
-                    }
-                  if(curLabelLUT < adjLabelLUT)
-                    {
-                    LUTtmp[adjLabelLUT] = curLabelLUT;
-                    }
-                  else
-                    {
-                    LUTtmp[LUTtmp[curLabelLUT]] = adjLabelLUT; LUTtmp[curLabelLUT] = adjLabelLUT;
-                    }
-                  }
-                }
-              }
-            }
-
-          for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
-            {
-            LabelImagePixelType can = label;
-            while(LUTtmp[can] != can)
-              {
-              can = LUTtmp[can];
-              }
-            LUTtmp[label] = can;
-            }
-          }
-        }
-
-      for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
-        {
-        LUT[label]=LUTtmp[label];
-        if((nbPixels[label]!=0)&&(LUT[label]!=label))
-          {
-          nbPixels[LUT[label]]+=nbPixels[label];
-          nbPixels[label]=0;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-            {
-            sum[LUT[label]][comp]+=sum[label][comp];
-            }
-          }
-        }
-      }
+    m_SmallRegionMergingFilter = SmallRegionMergingFilterType::New();
+    m_SmallRegionMergingFilter->SetInputLabelImage(labelIn);
+    m_SmallRegionMergingFilter->SetInputSpectralImage(imageIn);
+    m_SmallRegionMergingFilter->SetMinSize(minSize);
+    m_SmallRegionMergingFilter->GetStreamer()->SetNumberOfDivisionsTiledStreaming(nbTilesX*nbTilesY);
+
+    AddProcess(m_SmallRegionMergingFilter->GetStreamer(), "Computing region adjacency graph...");
+    m_SmallRegionMergingFilter->Update();
+
+    otbAppLogINFO(<<"Number of regions: "<<m_SmallRegionMergingFilter->GetFilter()->GetNumberOfRegions()
+                  <<", after merging: "<<m_SmallRegionMergingFilter->GetFilter()->GetNumberOfMergedRegions());
+
     //Relabelling
     m_ChangeLabelFilter = ChangeLabelImageFilterType::New();
     m_ChangeLabelFilter->SetInput(labelIn);
-    for(LabelImagePixelType label = 1; label<regionCount+1; ++label)
-      {
-      if(label!=LUT[label])
-        {
-        m_ChangeLabelFilter->SetChange(label,LUT[label]);
-        }
-      }
+    m_ChangeLabelFilter->SetChangeMap(m_SmallRegionMergingFilter->GetLUT());
 
     SetParameterOutputImage("out", m_ChangeLabelFilter->GetOutput());
 
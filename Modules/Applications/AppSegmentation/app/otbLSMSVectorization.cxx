@@ -21,12 +21,17 @@
 #include "otbMultiChannelExtractROI.h"
 #include "otbExtractROI.h"
 
-#include "otbStreamingStatisticsImageFilter.h"
 #include "otbLabelImageToOGRDataSourceFilter.h"
 #include "otbOGRFeatureWrapper.h"
 
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkConditionVariable.h"
+
 #include <time.h>
 #include <vcl_algorithm.h>
+#include <deque>
+#include <map>
 
 namespace otb
 {
@@ -50,8 +55,6 @@ public:
   typedef otb::MultiChannelExtractROI <ImagePixelType,ImagePixelType > MultiChannelExtractROIFilterType;
   typedef otb::ExtractROI<LabelImagePixelType,LabelImagePixelType> ExtractROIFilterType;
 
-  typedef otb::StreamingStatisticsImageFilter<LabelImageType> StatisticsImageFilterType;
-
   typedef itk::ImageRegionConstIterator<LabelImageType> LabelImageIterator;
   typedef itk::ImageRegionConstIterator<ImageType> ImageIterator;
 
@@ -63,6 +66,251 @@ public:
   itkTypeMacro(Vectorization, otb::Application);
 
 private:
+  /** Label tile to polygonize */
+  struct TileJob
+  {
+    unsigned int            m_TileIndex;
+    LabelImageType::Pointer m_Label;
+  };
+
+  /** Polygons of a tile, owned by the batch until written */
+  struct PolygonBatch
+  {
+    unsigned int                     m_TileIndex;
+    std::vector<LabelImagePixelType> m_Labels;
+    std::vector<OGRGeometry *>       m_Geometries;
+  };
+
+  /** First-in first-out queue of bounded size, shared between threads.
+   *  Push() blocks while the queue is full, and Pop() blocks while it
+   *  is empty and not closed. */
+  template <class T>
+  class BoundedQueue
+  {
+  public:
+    BoundedQueue(unsigned int capacity)
+      : m_Capacity(capacity), m_Closed(false)
+    {
+      m_NotEmpty = itk::ConditionVariable::New();
+      m_NotFull = itk::ConditionVariable::New();
+    }
+
+    void Push(const T& item)
+    {
+      m_Mutex.Lock();
+      while (m_Items.size() >= m_Capacity && !m_Closed)
+        {
+        m_NotFull->Wait(&m_Mutex);
+        }
+      m_Items.push_back(item);
+      m_Mutex.Unlock();
+      m_NotEmpty->Signal();
+    }
+
+    /** Returns false once the queue is closed and empty */
+    bool Pop(T& item)
+    {
+      m_Mutex.Lock();
+      while (m_Items.empty() && !m_Closed)
+        {
+        m_NotEmpty->Wait(&m_Mutex);
+        }
+      bool ok = !m_Items.empty();
+      if (ok)
+        {
+        item = m_Items.front();
+        m_Items.pop_front();
+        }
+      m_Mutex.Unlock();
+      m_NotFull->Signal();
+      return ok;
+    }
+
+    /** No more items will be pushed */
+    void Close()
+    {
+      m_Mutex.Lock();
+      m_Closed = true;
+      m_Mutex.Unlock();
+      m_NotEmpty->Broadcast();
+      m_NotFull->Broadcast();
+    }
+
+  private:
+    unsigned int                    m_Capacity;
+    bool                            m_Closed;
+    std::deque<T>                   m_Items;
+    itk::SimpleMutexLock            m_Mutex;
+    itk::ConditionVariable::Pointer m_NotEmpty;
+    itk::ConditionVariable::Pointer m_NotFull;
+  };
+
+  /** Data shared by the reading, polygonization and writing threads */
+  struct VectorizationStruct
+  {
+    VectorizationStruct(unsigned int tileCapacity, unsigned int batchCapacity)
+      : m_Tiles(tileCapacity), m_Batches(batchCapacity), m_Layer(NULL, false), m_Failed(false) {}
+
+    BoundedQueue<TileJob>      m_Tiles;
+    BoundedQueue<PolygonBatch> m_Batches;
+    otb::ogr::Layer            m_Layer;
+    unsigned int               m_TransactionSize;
+    itk::SimpleFastMutexLock   m_ErrorMutex;
+    bool                       m_Failed;
+    std::string                m_Error;
+
+    void SetError(const std::string& error)
+    {
+      m_ErrorMutex.Lock();
+      if (!m_Failed)
+        {
+        m_Failed = true;
+        m_Error = error;
+        }
+      m_ErrorMutex.Unlock();
+    }
+
+    /** m_Failed is written by any thread, it is read under the lock too */
+    bool HasFailed()
+    {
+      m_ErrorMutex.Lock();
+      bool failed = m_Failed;
+      m_ErrorMutex.Unlock();
+      return failed;
+    }
+  };
+
+  /** Polygonize the label tiles, until the tile queue is closed */
+  static ITK_THREAD_RETURN_TYPE PolygonizationThreaderCallback(void * arg)
+  {
+    struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+    VectorizationStruct * str = (VectorizationStruct *) (pInfo->UserData);
+
+    TileJob tile;
+    while (str->m_Tiles.Pop(tile))
+      {
+      PolygonBatch batch;
+      batch.m_TileIndex = tile.m_TileIndex;
+
+      try
+        {
+        //Raster->Vecteur conversion
+        LabelImageToOGRDataSourceFilterType::Pointer labelToOGR = LabelImageToOGRDataSourceFilterType::New();
+        labelToOGR->SetInput(tile.m_Label);
+        labelToOGR->SetInputMask(tile.m_Label);
+        labelToOGR->SetFieldName("label");
+        labelToOGR->Update();
+
+        otb::ogr::DataSource::ConstPointer ogrDSTmp = labelToOGR->GetOutput();
+        otb::ogr::Layer layerTmp = ogrDSTmp->GetLayerChecked(0);
+
+        otb::ogr::Layer::const_iterator featIt = layerTmp.begin();
+        for(; featIt!=layerTmp.end(); ++featIt)
+          {
+          batch.m_Labels.push_back(featIt->ogr().GetFieldAsInteger("label"));
+          batch.m_Geometries.push_back(featIt->GetGeometry()->clone());
+          }
+        }
+      catch (std::exception& e)
+        {
+        str->SetError(e.what());
+        }
+
+      // An empty batch is still sent, so that the writer does not wait
+      // for this tile
+      str->m_Batches.Push(batch);
+      }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  /** Write the polygons in tile order, in large transactions, until
+   *  the batch queue is closed */
+  static ITK_THREAD_RETURN_TYPE WritingThreaderCallback(void * arg)
+  {
+    struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+    VectorizationStruct * str = (VectorizationStruct *) (pInfo->UserData);
+
+    // Batches come in any order from the polygonization threads, and
+    // are written in tile order so that the output does not depend on
+    // the scheduling
+    std::map<unsigned int, PolygonBatch> pending;
+    unsigned int nextTile = 0;
+    unsigned int nbFeaturesInTransaction = 0;
+
+    OGRLayer & ogrLayer = str->m_Layer.ogr();
+    ogrLayer.StartTransaction();
+
+    PolygonBatch batch;
+    while (str->m_Batches.Pop(batch))
+      {
+      pending[batch.m_TileIndex] = batch;
+
+      std::map<unsigned int, PolygonBatch>::iterator it = pending.find(nextTile);
+      for (; it != pending.end(); it = pending.find(nextTile))
+        {
+        for (unsigned int i = 0; i < it->second.m_Geometries.size(); ++i)
+          {
+          OGRGeometry * geometry = it->second.m_Geometries[i];
+          it->second.m_Geometries[i] = NULL;
+
+          if (str->HasFailed())
+            {
+            OGRGeometryFactory::destroyGeometry(geometry);
+            continue;
+            }
+
+          try
+            {
+            otb::ogr::Feature dstFeature(str->m_Layer.GetLayerDefn());
+            dstFeature.ogr().SetField("label", static_cast<int>(it->second.m_Labels[i]));
+            dstFeature.SetGeometryDirectly(otb::ogr::UniqueGeometryPtr(geometry));
+            str->m_Layer.CreateFeature(dstFeature);
+            }
+          catch (std::exception& e)
+            {
+            str->SetError(e.what());
+            }
+
+          if (++nbFeaturesInTransaction == str->m_TransactionSize)
+            {
+            ogrLayer.CommitTransaction();
+            ogrLayer.StartTransaction();
+            nbFeaturesInTransaction = 0;
+            }
+          }
+        pending.erase(it);
+        ++nextTile;
+        }
+      }
+
+    ogrLayer.CommitTransaction();
+
+    // Polygons of the tiles following a failure
+    for (std::map<unsigned int, PolygonBatch>::iterator it = pending.begin(); it != pending.end(); ++it)
+      {
+      for (unsigned int i = 0; i < it->second.m_Geometries.size(); ++i)
+        {
+        OGRGeometryFactory::destroyGeometry(it->second.m_Geometries[i]);
+        }
+      }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  /** Let the threads finish the queued work and wait for them */
+  static void JoinThreads(itk::MultiThreader * threader, VectorizationStruct& str,
+                          const std::vector<int>& workerIds, int writerId)
+  {
+    str.m_Tiles.Close();
+    for(unsigned int worker = 0; worker < workerIds.size(); ++worker)
+      {
+      threader->TerminateThread(workerIds[worker]);
+      }
+    str.m_Batches.Close();
+    threader->TerminateThread(writerId);
+  }
+
   void DoInit()
   {
     SetName("LSMSVectorization");
@@ -127,31 +375,20 @@ private:
 
     otbAppLogINFO(<<"Number of tiles: "<<nbTilesX<<" x "<<nbTilesY);
 
-    StatisticsImageFilterType::Pointer stats = StatisticsImageFilterType::New();
-    stats->SetInput(labelIn);
-    stats->Update();
-    unsigned int regionCount=stats->GetMaximum();
-
     ImageType::Pointer imageIn = GetParameterImage("in");
     imageIn->UpdateOutputInformation();
 
     unsigned long numberOfComponentsPerPixel = imageIn->GetNumberOfComponentsPerPixel();
     std::string projRef = imageIn->GetProjectionRef();
 
+    //Statistics per label, grown with the labels met in the tiles
     std::vector<int>nbPixels;
-    nbPixels.clear();
-    nbPixels.resize(regionCount+1);
-
-    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      {
-      nbPixels[curLabel] = 0;
-      }
 
     ImageType::PixelType defaultValue(numberOfComponentsPerPixel);
     defaultValue.Fill(0);
 
-    std::vector<ImageType::PixelType>sum(regionCount+1,defaultValue);
-    std::vector<ImageType::PixelType>sum2(regionCount+1,defaultValue);
+    std::vector<ImageType::PixelType>sum;
+    std::vector<ImageType::PixelType>sum2;
 
     otb::ogr::DataSource::Pointer ogrDS;
     otb::ogr::Layer layer(NULL, false);
@@ -184,74 +421,103 @@ private:
     layer.CreateField(field, true);
     }
 
-    //Vectorization per tile
+    //Vectorization per tile: the tiles are read once in this thread,
+    //for the statistics, and polygonized by the worker threads, while a
+    //single thread writes the polygons to the output layer
     otbAppLogINFO(<<"Vectorization ...");
-    for(unsigned int row = 0; row < nbTilesY; row++)
+
+    unsigned int nbTiles = nbTilesX*nbTilesY;
+    unsigned int nbWorkers = vcl_min(static_cast<unsigned int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()), nbTiles);
+    // One more thread is spawned for the writing
+    nbWorkers = vcl_min(nbWorkers, static_cast<unsigned int>(ITK_MAX_THREADS - 1));
+    nbWorkers = vcl_max(nbWorkers, 1U);
+
+    VectorizationStruct str(2*nbWorkers, 4*nbWorkers);
+    str.m_Layer = layer;
+    str.m_TransactionSize = 50000;
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    std::vector<int> workerIds;
+    for(unsigned int worker = 0; worker < nbWorkers; ++worker)
       {
-      for(unsigned int column = 0; column < nbTilesX; column++)
-       {
-        unsigned long startX = column*sizeTilesX;
-        unsigned long startY = row*sizeTilesY;
-        unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
+      workerIds.push_back(threader->SpawnThread(PolygonizationThreaderCallback, &str));
+      }
+    int writerId = threader->SpawnThread(WritingThreaderCallback, &str);
+
+    // The threads use str, which lives on this stack: they must be
+    // stopped before leaving, even on error
+    try
+      {
+      for(unsigned int row = 0; row < nbTilesY && !str.HasFailed(); row++)
+        {
+        for(unsigned int column = 0; column < nbTilesX && !str.HasFailed(); column++)
+         {
+          unsigned long startX = column*sizeTilesX;
+          unsigned long startY = row*sizeTilesY;
+          unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
           unsigned long sizeY = vcl_min(sizeTilesY,sizeImageY-startY);
 
-        //Tiles extraction of the input image
-        MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
-        imageROI->SetInput(imageIn);
-        imageROI->SetStartX(startX);
-        imageROI->SetStartY(startY);
-        imageROI->SetSizeX(sizeX);
-        imageROI->SetSizeY(sizeY);
-        imageROI->Update();
-
-        //Tiles extraction of the segmented image
-        ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX);
-        labelImageROI->SetSizeY(sizeY);
-        labelImageROI->Update();
-
-        //Sums calculation for the mean and the variance calculation per label
-        LabelImageIterator itLabel( labelImageROI->GetOutput(), labelImageROI->GetOutput()->GetLargestPossibleRegion());
-        ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
-        for (itLabel.GoToBegin(), itImage.GoToBegin(); !itImage.IsAtEnd(); ++itLabel, ++itImage)
-          {
-          nbPixels[itLabel.Value()]++;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
+          //Tiles extraction of the input image
+          MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
+          imageROI->SetInput(imageIn);
+          imageROI->SetStartX(startX);
+          imageROI->SetStartY(startY);
+          imageROI->SetSizeX(sizeX);
+          imageROI->SetSizeY(sizeY);
+          imageROI->Update();
+
+          //Tiles extraction of the segmented image, with one more line and
+          //column for the polygonization
+          ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
+          labelImageROI->SetInput(labelIn);
+          labelImageROI->SetStartX(startX);
+          labelImageROI->SetStartY(startY);
+          labelImageROI->SetSizeX(sizeX+1);
+          labelImageROI->SetSizeY(sizeY+1);
+          labelImageROI->Update();
+
+          LabelImageType::Pointer labelTile = labelImageROI->GetOutput();
+
+          //Sums calculation for the mean and the variance calculation per label
+          LabelImageIterator itLabel( labelTile, imageROI->GetOutput()->GetLargestPossibleRegion());
+          ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
+          for (itLabel.GoToBegin(), itImage.GoToBegin(); !itImage.IsAtEnd(); ++itLabel, ++itImage)
             {
-            sum[itLabel.Value()][comp]+=itImage.Get()[comp];
-            sum2[itLabel.Value()][comp]+=itImage.Get()[comp]*itImage.Get()[comp];
+            LabelImagePixelType curLabel = itLabel.Value();
+            if(curLabel >= nbPixels.size())
+              {
+              nbPixels.resize(curLabel+1, 0);
+              sum.resize(curLabel+1, defaultValue);
+              sum2.resize(curLabel+1, defaultValue);
+              }
+            nbPixels[curLabel]++;
+            for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
+              {
+              sum[curLabel][comp]+=itImage.Get()[comp];
+              sum2[curLabel][comp]+=itImage.Get()[comp]*itImage.Get()[comp];
+              }
             }
-          }
-
-        labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX+1);
-        labelImageROI->SetSizeY(sizeY+1);
-        labelImageROI->Update();
 
-        //Raster->Vecteur conversion
-        LabelImageToOGRDataSourceFilterType::Pointer labelToOGR = LabelImageToOGRDataSourceFilterType::New();
-        labelToOGR->SetInput(labelImageROI->GetOutput());
-        labelToOGR->SetInputMask(labelImageROI->GetOutput());
-        labelToOGR->SetFieldName("label");
-        labelToOGR->Update();
+          TileJob tile;
+          tile.m_TileIndex = row*nbTilesX+column;
+          tile.m_Label = labelTile;
+          labelTile->DisconnectPipeline();
+          str.m_Tiles.Push(tile);
+         }
+        }
+      }
+    catch(...)
+      {
+      str.SetError("Tile extraction failed");
+      JoinThreads(threader, str, workerIds, writerId);
+      throw;
+      }
 
-        otb::ogr::DataSource::ConstPointer ogrDSTmp = labelToOGR->GetOutput();
-        otb::ogr::Layer layerTmp = ogrDSTmp->GetLayerChecked(0);
+    JoinThreads(threader, str, workerIds, writerId);
 
-        otb::ogr::Layer::const_iterator featIt = layerTmp.begin();
-        for(; featIt!=layerTmp.end(); ++featIt)
-          {
-          otb::ogr::Feature dstFeature(layer.GetLayerDefn());
-          dstFeature.SetFrom( *featIt, TRUE );
-          layer.CreateFeature( dstFeature );
-          }
-       }
+    if(str.HasFailed())
+      {
+      itkExceptionMacro(<<"Vectorization failed: "<<str.m_Error);
       }
 
     //Sorting by increasing label of the features
@@ -69,6 +69,27 @@ public:
    */
   static RAMValueType GetMaxRAMHint();
 
+  /**
+   * ProfileFile is the path of the pipeline profiling report (see
+   * PipelineProfiler).
+   *
+   * If environment variable OTB_PROFILE_FILE is defined,
+   * returns it contents as a string
+   * Else, returns an empty string (no profiling)
+   */
+  static std::string GetProfileFile();
+
+  /**
+   * GDALReadThreads is the number of threads (and of dataset handles)
+   * used by GDALImageIO to decode the blocks of a compressed file
+   * concurrently.
+   *
+   * If environment variable OTB_GDAL_READ_THREADS is defined,
+   * returns its value (1 disables the concurrent reads)
+   * Else, returns 0 (use a default number of threads)
+   */
+  static unsigned int GetGDALReadThreads();
+
 private:
   ConfigurationManager(); //purposely not implemented
   ~ConfigurationManager(); //purposely not implemented
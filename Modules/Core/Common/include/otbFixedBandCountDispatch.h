@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbFixedBandCountDispatch_h
+#define __otbFixedBandCountDispatch_h
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+/** \class FixedBandCount
+ *  \brief Band count known at compile time.
+ *
+ * FixedBandCount<N>::Get() returns N, so that loops over the bands of a
+ * pixel have a constant trip count and can be unrolled and vectorized by
+ * the compiler. FixedBandCount<0> is the generic case, where the band
+ * count is only known at runtime.
+ *
+ * \sa ProcessBandInterleavedRegion
+ *
+ * \ingroup OTBCommon
+ */
+template <unsigned int VBands>
+struct FixedBandCount
+{
+  static inline unsigned int Get(unsigned int itkNotUsed(nbBands))
+  {
+    return VBands;
+  }
+};
+
+template <>
+struct FixedBandCount<0>
+{
+  static inline unsigned int Get(unsigned int nbBands)
+  {
+    return nbBands;
+  }
+};
+
+/** Apply a per-band kernel to a band-interleaved scanline of nbPixels
+ *  pixels, with a compile-time band count VBands (0 means runtime).
+ *
+ *  The kernel is called as kernel(value, band) and returns the output
+ *  value of the given band. */
+template <unsigned int VBands, class TKernel, class TInputValue, class TOutputValue>
+inline void ProcessBandInterleavedScanline(const TKernel& kernel,
+                                           const TInputValue * in,
+                                           TOutputValue * out,
+                                           unsigned long nbPixels,
+                                           unsigned int nbBands)
+{
+  const unsigned int nb = FixedBandCount<VBands>::Get(nbBands);
+
+  for (unsigned long p = 0; p < nbPixels; ++p, in += nb, out += nb)
+    {
+    for (unsigned int b = 0; b < nb; ++b)
+      {
+      out[b] = kernel(in[b], b);
+      }
+    }
+}
+
+/** Dispatch a scanline to the instantiation matching its band count.
+ *  Common band counts (1 to 4 for panchromatic, RGB(N) and XS
+ *  images, 8 for WorldView-2 like sensors and 13 for Sentinel-2 like
+ *  sensors) have a dedicated inner loop, other band counts use the
+ *  generic runtime loop. */
+template <class TKernel, class TInputValue, class TOutputValue>
+inline void DispatchBandInterleavedScanline(const TKernel& kernel,
+                                            const TInputValue * in,
+                                            TOutputValue * out,
+                                            unsigned long nbPixels,
+                                            unsigned int nbBands)
+{
+  switch (nbBands)
+    {
+    case 1:
+      ProcessBandInterleavedScanline<1>(kernel, in, out, nbPixels, nbBands);
+      break;
+    case 2:
+      ProcessBandInterleavedScanline<2>(kernel, in, out, nbPixels, nbBands);
+      break;
+    case 3:
+      ProcessBandInterleavedScanline<3>(kernel, in, out, nbPixels, nbBands);
+      break;
+    case 4:
+      ProcessBandInterleavedScanline<4>(kernel, in, out, nbPixels, nbBands);
+      break;
+    case 8:
+      ProcessBandInterleavedScanline<8>(kernel, in, out, nbPixels, nbBands);
+      break;
+    case 13:
+      ProcessBandInterleavedScanline<13>(kernel, in, out, nbPixels, nbBands);
+      break;
+    default:
+      ProcessBandInterleavedScanline<0>(kernel, in, out, nbPixels, nbBands);
+      break;
+    }
+}
+
+/** Apply a per-band kernel over a region of band-interleaved images
+ *  (otb::VectorImage or otb::Image with scalar pixels), working
+ *  directly on the pixel buffers scanline by scanline instead of
+ *  building an itk::VariableLengthVector per pixel.
+ *
+ *  Input and output must have the same number of components per pixel,
+ *  and the region must be inside the buffered region of both images. */
+template <class TInputImage, class TOutputImage, class TKernel>
+void ProcessBandInterleavedRegion(const TInputImage * input,
+                                  TOutputImage * output,
+                                  const typename TOutputImage::RegionType& region,
+                                  const TKernel& kernel,
+                                  itk::ProgressReporter& progress)
+{
+  typedef itk::ImageLinearConstIteratorWithIndex<TOutputImage> LineIteratorType;
+
+  const unsigned int  nbBands = output->GetNumberOfComponentsPerPixel();
+  const unsigned long lineLength = region.GetSize()[0];
+
+  const typename TInputImage::InternalPixelType * inBuffer = input->GetBufferPointer();
+  typename TOutputImage::InternalPixelType *      outBuffer = output->GetBufferPointer();
+
+  LineIteratorType it(output, region);
+  it.SetDirection(0);
+
+  for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
+    {
+    const typename TOutputImage::IndexType& lineStart = it.GetIndex();
+
+    DispatchBandInterleavedScanline(kernel,
+                                    inBuffer + input->ComputeOffset(lineStart) * nbBands,
+                                    outBuffer + output->ComputeOffset(lineStart) * nbBands,
+                                    lineLength,
+                                    nbBands);
+
+    for (unsigned long p = 0; p < lineLength; ++p)
+      {
+      progress.CompletedPixel();
+      }
+    }
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,275 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbPipelineProfiler_h
+#define __otbPipelineProfiler_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkProcessObject.h"
+#include "itkCommand.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkRealTimeClock.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PipelineProfiler
+ *  \brief Records the time spent by each filter of the streamed pipelines.
+ *
+ * The profiler is a singleton, disabled by default. It is enabled when
+ * a report file name is set, either through the OTB_PROFILE_FILE
+ * environment variable (see ConfigurationManager) or with SetFileName().
+ *
+ * The streaming writers (ImageFileWriter, StreamingImageVirtualWriter)
+ * call BeginStreaming() once the streaming manager has split the
+ * region: the profiler then observes the StartEvent and EndEvent of
+ * every ProcessObject upstream of the writer, and records for each
+ * filter and each stream division the wall time, the CPU time (user and
+ * system time of the whole process, so that it includes the filter
+ * threads) and the size of the output image buffers, of dimension 1 to 4,
+ * the filter has allocated. The readers and the
+ * writers report the number of bytes they read and write.
+ *
+ * WriteReport() writes the records in the Chrome trace event format
+ * (chrome://tracing, Perfetto), with a summary per filter and the
+ * decisions of the streaming managers.
+ *
+ * The records are protected by a mutex, so that writers may stream from
+ * several threads. Each filter gets a unique number when it is first met,
+ * and is forgotten when it is deleted: a new filter allocated at the same
+ * address is recorded separately. The file name must be set before the
+ * pipelines run.
+ *
+ * \ingroup OTBCommon
+ */
+class ITK_EXPORT PipelineProfiler : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef PipelineProfiler              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineProfiler, itk::Object);
+
+  /** The profiler instance */
+  static Pointer GetInstance();
+
+  /** Set/Get the report file name. The profiler records only if it is
+   * not empty. */
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+
+  /** Is the profiler recording ? */
+  bool IsEnabled() const
+  {
+    return !m_FileName.empty();
+  }
+
+  /** Start observing the pipeline upstream of the data object streamed
+   * by the writer, and record the streaming manager decision */
+  void BeginStreaming(itk::ProcessObject * writer, itk::DataObject * streamedData,
+                      const std::string& streamingManager, unsigned int numberOfDivisions,
+                      const std::string& region);
+
+  /** Stop observing the pipeline of the writer. Streamings may be
+   * nested (a filter may stream a mini-pipeline while it is updated). */
+  void EndStreaming(itk::ProcessObject * writer);
+
+  /** A stream division of the writer starts */
+  void BeginDivision(itk::ProcessObject * writer, unsigned int division, const std::string& region);
+
+  /** The pipeline has produced the division, the writer writes it */
+  void BeginDivisionWrite(itk::ProcessObject * writer);
+
+  /** The division is written */
+  void EndDivision(itk::ProcessObject * writer, unsigned long bytesWritten);
+
+  /** A reader has read bytes from its file */
+  void AddBytesRead(itk::ProcessObject * reader, unsigned long bytesRead);
+
+  /** Write the report, and clear the records */
+  void WriteReport();
+
+  /** Clear the records */
+  void Reset();
+
+  /** \class StreamingGuard
+   * Ends the streaming begun by a writer when it goes out of scope, so
+   * that the filters are no longer observed if the pipeline throws. */
+  class StreamingGuard
+  {
+  public:
+    /** The guard does nothing if the writer is NULL */
+    explicit StreamingGuard(itk::ProcessObject * writer) : m_Writer(writer) {}
+
+    ~StreamingGuard()
+    {
+      this->End();
+    }
+
+    /** End the streaming now */
+    void End()
+    {
+      if (m_Writer != NULL)
+        {
+        PipelineProfiler::GetInstance()->EndStreaming(m_Writer);
+        m_Writer = NULL;
+        }
+    }
+
+  private:
+    StreamingGuard(const StreamingGuard &); //purposely not implemented
+    void operator =(const StreamingGuard&); //purposely not implemented
+
+    itk::ProcessObject * m_Writer;
+  };
+
+protected:
+  PipelineProfiler();
+  virtual ~PipelineProfiler();
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+private:
+  PipelineProfiler(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** Record of a time interval */
+  struct Event
+  {
+    std::string   name;
+    std::string   category;
+    double        start;    // seconds since the creation of the profiler
+    double        duration; // seconds
+    double        cpu;      // seconds
+    long          division; // -1 outside of the stream divisions
+    unsigned long bytes;
+    unsigned long bufferedPixels;
+    unsigned long bufferedComponents;
+    std::string   details;
+  };
+
+  /** Totals of a filter */
+  struct FilterStatistics
+  {
+    std::string   name;
+    unsigned long calls;
+    double        wallTime;
+    double        cpuTime;
+    unsigned long bytesRead;
+    unsigned long allocatedComponents;
+  };
+
+  /** Observer of the Start and End events of a filter */
+  struct Observer
+  {
+    itk::ProcessObject::Pointer filter;
+    unsigned long               startTag;
+    unsigned long               endTag;
+  };
+
+  /** State of a streaming */
+  struct Streaming
+  {
+    itk::ProcessObject *  writer;
+    std::string           name;
+    std::vector<Observer> observers; // filters observed by this streaming
+    long                  division;  // -1 between the divisions
+    std::string           region;
+    double                start;
+    double                cpuStart;
+    double                writeStart;
+  };
+
+  /** Number of a filter, and tag of its DeleteEvent observer */
+  struct FilterId
+  {
+    unsigned long id;
+    unsigned long deleteTag;
+  };
+
+  /** Recursively observe the filters upstream of data */
+  void Observe(itk::DataObject * data, std::set<itk::ProcessObject *>& visited,
+               std::vector<Observer>& observers);
+
+  /** Innermost streaming of the writer, NULL if none */
+  Streaming * WriterStreaming(itk::ProcessObject * writer);
+
+  /** Streaming observing the filter, NULL if none */
+  Streaming * ObservingStreaming(itk::ProcessObject * filter);
+
+  /** Stop observing the filters of the i-th streaming and remove it.
+   * The observers are moved to released, so that the filters they hold
+   * are deleted once the mutex is unlocked. */
+  void RemoveStreaming(unsigned int i, std::vector<Observer>& released);
+
+  /** Remove the streamings and clear the records */
+  void ClearRecords(std::vector<Observer>& released);
+
+  /** Start/End events callback */
+  void FilterEventCallback(itk::Object * caller, const itk::EventObject& event);
+
+  /** DeleteEvent callback: forget the filter */
+  void FilterDeleteCallback(itk::Object * caller, const itk::EventObject& event);
+
+  /** Wall time in seconds, since the creation of the profiler */
+  double WallTime() const;
+
+  /** User and system CPU time of the process in seconds */
+  static double CPUTime();
+
+  /** Statistics of a filter, created with its name (class name and a
+   *  number, in the order the filters are met) on first use */
+  FilterStatistics& Statistics(itk::ProcessObject * filter);
+
+  std::string                 m_FileName;
+  itk::RealTimeClock::Pointer m_Clock;
+  double                      m_Origin;
+
+  /** Filters being executed, with their start wall and CPU times */
+  std::map<itk::ProcessObject *, Event> m_Running;
+
+  /** Filters alive, with their unique number */
+  std::map<itk::Object *, FilterId> m_FilterIds;
+  unsigned long                     m_NextFilterId;
+
+  std::map<unsigned long, FilterStatistics> m_Filters;
+  std::map<std::string, unsigned int>       m_ClassCount;
+  std::vector<Event>                        m_Events;
+
+  typedef itk::MemberCommand<Self> CommandType;
+  CommandType::Pointer m_Command;
+  CommandType::Pointer m_DeleteCommand;
+
+  /** Current streamings, the innermost last */
+  std::vector<Streaming> m_Streamings;
+
+  mutable itk::SimpleFastMutexLock m_Mutex;
+};
+
+} // end namespace otb
+
+#endif
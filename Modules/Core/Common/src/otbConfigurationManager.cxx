@@ -38,6 +38,24 @@ std::string ConfigurationManager::GetGeoidFile()
   return svalue;
 }
 
+std::string ConfigurationManager::GetProfileFile()
+{
+  std::string svalue;
+  itksys::SystemTools::GetEnv("OTB_PROFILE_FILE",svalue);
+  return svalue;
+}
+
+unsigned int ConfigurationManager::GetGDALReadThreads()
+{
+  std::string svalue;
+  unsigned int value = 0;
+  if(itksys::SystemTools::GetEnv("OTB_GDAL_READ_THREADS",svalue))
+    {
+    value = static_cast<unsigned int>(strtoul(svalue.c_str(),NULL,10));
+    }
+  return value;
+}
+
 ConfigurationManager::RAMValueType ConfigurationManager::GetMaxRAMHint()
 {
   std::string svalue;
@@ -0,0 +1,585 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbPipelineProfiler.h"
+#include "otbConfigurationManager.h"
+#include "otbMacro.h"
+
+#include "itkImageBase.h"
+#include "itkMutexLockHolder.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <sstream>
+#include <typeinfo>
+#include <fstream>
+#include <iomanip>
+
+namespace otb
+{
+
+namespace
+{
+/** Escape a string for a JSON document */
+std::string JSONString(const std::string& str)
+{
+  std::ostringstream oss;
+  oss << '"';
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+    {
+    switch (*it)
+      {
+      case '"':
+        oss << "\\\"";
+        break;
+      case '\\':
+        oss << "\\\\";
+        break;
+      case '\n':
+        oss << "\\n";
+        break;
+      case '\t':
+        oss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*it) < 0x20)
+          {
+          oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+              << static_cast<int>(*it) << std::dec << std::setfill(' ');
+          }
+        else
+          {
+          oss << *it;
+          }
+      }
+    }
+  oss << '"';
+  return oss.str();
+}
+
+/** Add the buffer size of data to pixels and components, if it is an
+ *  image of dimension VDimension */
+template <unsigned int VDimension>
+bool AddBufferSize(itk::DataObject * data, unsigned long& pixels, unsigned long& components)
+{
+  itk::ImageBase<VDimension> * image = dynamic_cast<itk::ImageBase<VDimension> *>(data);
+  if (image == NULL)
+    {
+    return false;
+    }
+  const unsigned long imagePixels = image->GetBufferedRegion().GetNumberOfPixels();
+  pixels += imagePixels;
+  components += imagePixels * image->GetNumberOfComponentsPerPixel();
+  return true;
+}
+}
+
+PipelineProfiler::Pointer PipelineProfiler::GetInstance()
+{
+  static itk::SimpleFastMutexLock mutex;
+  static Pointer                  instance;
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(mutex);
+  if (instance.IsNull())
+    {
+    instance = new PipelineProfiler;
+    instance->UnRegister();
+    }
+  return instance;
+}
+
+PipelineProfiler::PipelineProfiler()
+  : m_FileName(ConfigurationManager::GetProfileFile()),
+    m_Clock(itk::RealTimeClock::New()),
+    m_NextFilterId(0)
+{
+  m_Origin = m_Clock->GetTimeInSeconds();
+  m_Command = CommandType::New();
+  m_Command->SetCallbackFunction(this, &Self::FilterEventCallback);
+  m_DeleteCommand = CommandType::New();
+  m_DeleteCommand->SetCallbackFunction(this, &Self::FilterDeleteCallback);
+}
+
+PipelineProfiler::~PipelineProfiler()
+{
+  // The filters still alive must not call back a deleted profiler
+  for (std::map<itk::Object *, FilterId>::iterator it = m_FilterIds.begin(); it != m_FilterIds.end(); ++it)
+    {
+    it->first->RemoveObserver(it->second.deleteTag);
+    }
+}
+
+double PipelineProfiler::WallTime() const
+{
+  return m_Clock->GetTimeInSeconds() - m_Origin;
+}
+
+double PipelineProfiler::CPUTime()
+{
+  // User and system time of all the threads of the process
+#if defined(_WIN32)
+  FILETIME creationTime, exitTime, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernel, &user))
+    {
+    return 0.;
+    }
+  ULARGE_INTEGER kernelTime, userTime;
+  kernelTime.LowPart = kernel.dwLowDateTime;
+  kernelTime.HighPart = kernel.dwHighDateTime;
+  userTime.LowPart = user.dwLowDateTime;
+  userTime.HighPart = user.dwHighDateTime;
+  // 100 ns units
+  return static_cast<double>(kernelTime.QuadPart + userTime.QuadPart) * 1e-7;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+    return 0.;
+    }
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+    + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+PipelineProfiler::FilterStatistics& PipelineProfiler::Statistics(itk::ProcessObject * filter)
+{
+  std::map<itk::Object *, FilterId>::iterator id = m_FilterIds.find(filter);
+  if (id == m_FilterIds.end())
+    {
+    FilterId filterId;
+    filterId.id = m_NextFilterId++;
+    filterId.deleteTag = filter->AddObserver(itk::DeleteEvent(), m_DeleteCommand);
+    id = m_FilterIds.insert(std::make_pair(static_cast<itk::Object *>(filter), filterId)).first;
+    }
+
+  std::map<unsigned long, FilterStatistics>::iterator it = m_Filters.find(id->second.id);
+  if (it == m_Filters.end())
+    {
+    FilterStatistics stats;
+    std::ostringstream oss;
+    oss << filter->GetNameOfClass() << " #" << ++m_ClassCount[filter->GetNameOfClass()];
+    stats.name = oss.str();
+    stats.calls = 0;
+    stats.wallTime = 0.;
+    stats.cpuTime = 0.;
+    stats.bytesRead = 0;
+    stats.allocatedComponents = 0;
+    it = m_Filters.insert(std::make_pair(id->second.id, stats)).first;
+    }
+  return it->second;
+}
+
+PipelineProfiler::Streaming * PipelineProfiler::WriterStreaming(itk::ProcessObject * writer)
+{
+  for (std::vector<Streaming>::reverse_iterator streaming = m_Streamings.rbegin();
+       streaming != m_Streamings.rend(); ++streaming)
+    {
+    if (streaming->writer == writer)
+      {
+      return &*streaming;
+      }
+    }
+  return NULL;
+}
+
+PipelineProfiler::Streaming * PipelineProfiler::ObservingStreaming(itk::ProcessObject * filter)
+{
+  for (std::vector<Streaming>::iterator streaming = m_Streamings.begin();
+       streaming != m_Streamings.end(); ++streaming)
+    {
+    for (std::vector<Observer>::const_iterator it = streaming->observers.begin();
+         it != streaming->observers.end(); ++it)
+      {
+      if (it->filter.GetPointer() == filter)
+        {
+        return &*streaming;
+        }
+      }
+    }
+  return NULL;
+}
+
+void PipelineProfiler::BeginStreaming(itk::ProcessObject * writer, itk::DataObject * streamedData,
+                                      const std::string& streamingManager, unsigned int numberOfDivisions,
+                                      const std::string& region)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+
+  Streaming streaming;
+  streaming.writer = writer;
+  streaming.name = this->Statistics(writer).name;
+  streaming.division = -1;
+  streaming.start = 0.;
+  streaming.cpuStart = 0.;
+  streaming.writeStart = -1.;
+
+  std::set<itk::ProcessObject *> visited;
+  this->Observe(streamedData, visited, streaming.observers);
+  m_Streamings.push_back(streaming);
+
+  Event decision;
+  decision.name = streaming.name + " streaming";
+  decision.category = "streaming";
+  decision.start = this->WallTime();
+  decision.duration = 0.;
+  decision.cpu = 0.;
+  decision.division = -1;
+  decision.bytes = 0;
+  decision.bufferedPixels = 0;
+  decision.bufferedComponents = 0;
+  std::ostringstream details;
+  details << streamingManager << ", " << numberOfDivisions << " divisions of " << region
+          << ", " << visited.size() << " filters";
+  decision.details = details.str();
+  m_Events.push_back(decision);
+
+  otbMsgDevMacro(<< "Profiling " << decision.name << ": " << decision.details);
+}
+
+void PipelineProfiler::Observe(itk::DataObject * data, std::set<itk::ProcessObject *>& visited,
+                               std::vector<Observer>& observers)
+{
+  if (data == NULL)
+    {
+    return;
+    }
+  itk::ProcessObject * source = data->GetSource();
+  if (source == NULL || !visited.insert(source).second)
+    {
+    return;
+    }
+
+  if (this->ObservingStreaming(source) == NULL)
+    {
+    this->Statistics(source);
+    Observer observer;
+    observer.filter = source;
+    observer.startTag = source->AddObserver(itk::StartEvent(), m_Command);
+    observer.endTag = source->AddObserver(itk::EndEvent(), m_Command);
+    observers.push_back(observer);
+    }
+
+  itk::ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+  for (unsigned int i = 0; i < inputs.size(); ++i)
+    {
+    this->Observe(inputs[i].GetPointer(), visited, observers);
+    }
+}
+
+void PipelineProfiler::RemoveStreaming(unsigned int i, std::vector<Observer>& released)
+{
+  std::vector<Observer>& observers = m_Streamings[i].observers;
+  for (std::vector<Observer>::iterator it = observers.begin(); it != observers.end(); ++it)
+    {
+    it->filter->RemoveObserver(it->startTag);
+    it->filter->RemoveObserver(it->endTag);
+    m_Running.erase(it->filter.GetPointer());
+    }
+  released.insert(released.end(), observers.begin(), observers.end());
+  m_Streamings.erase(m_Streamings.begin() + i);
+}
+
+void PipelineProfiler::EndStreaming(itk::ProcessObject * writer)
+{
+  // Declared before the lock, so that the filters are released after
+  // the mutex is unlocked: their DeleteEvent callback locks it
+  std::vector<Observer> released;
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  for (unsigned int i = m_Streamings.size(); i > 0; --i)
+    {
+    if (m_Streamings[i - 1].writer == writer)
+      {
+      this->RemoveStreaming(i - 1, released);
+      return;
+      }
+    }
+}
+
+void PipelineProfiler::BeginDivision(itk::ProcessObject * writer, unsigned int division, const std::string& region)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  Streaming * streaming = this->WriterStreaming(writer);
+  if (streaming == NULL)
+    {
+    return;
+    }
+  streaming->division = division;
+  streaming->region = region;
+  streaming->start = this->WallTime();
+  streaming->cpuStart = CPUTime();
+  streaming->writeStart = -1.;
+}
+
+void PipelineProfiler::BeginDivisionWrite(itk::ProcessObject * writer)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  Streaming * streaming = this->WriterStreaming(writer);
+  if (streaming != NULL)
+    {
+    streaming->writeStart = this->WallTime();
+    }
+}
+
+void PipelineProfiler::EndDivision(itk::ProcessObject * writer, unsigned long bytesWritten)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  Streaming * streaming = this->WriterStreaming(writer);
+  if (streaming == NULL || streaming->division < 0)
+    {
+    return;
+    }
+
+  Event event;
+  std::ostringstream name;
+  name << streaming->name << " division " << streaming->division;
+  event.name = name.str();
+  event.category = "division";
+  event.start = streaming->start;
+  event.duration = this->WallTime() - streaming->start;
+  event.cpu = CPUTime() - streaming->cpuStart;
+  event.division = streaming->division;
+  event.bytes = bytesWritten;
+  event.bufferedPixels = 0;
+  event.bufferedComponents = 0;
+  std::ostringstream details;
+  details << streaming->region;
+  if (streaming->writeStart >= 0.)
+    {
+    details << ", write time " << this->WallTime() - streaming->writeStart << " s";
+    }
+  event.details = details.str();
+  m_Events.push_back(event);
+
+  streaming->division = -1;
+}
+
+void PipelineProfiler::AddBytesRead(itk::ProcessObject * reader, unsigned long bytesRead)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  std::map<itk::ProcessObject *, Event>::iterator it = m_Running.find(reader);
+  if (it != m_Running.end())
+    {
+    it->second.bytes += bytesRead;
+    }
+  std::map<itk::Object *, FilterId>::const_iterator id = m_FilterIds.find(reader);
+  if (id != m_FilterIds.end())
+    {
+    std::map<unsigned long, FilterStatistics>::iterator stats = m_Filters.find(id->second.id);
+    if (stats != m_Filters.end())
+      {
+      stats->second.bytesRead += bytesRead;
+      }
+    }
+}
+
+void PipelineProfiler::FilterEventCallback(itk::Object * caller, const itk::EventObject& event)
+{
+  itk::ProcessObject * filter = dynamic_cast<itk::ProcessObject *>(caller);
+  if (filter == NULL)
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+
+  if (typeid(event) == typeid(itk::StartEvent))
+    {
+    Streaming * streaming = this->ObservingStreaming(filter);
+    Event record;
+    record.name = this->Statistics(filter).name;
+    record.category = "filter";
+    record.start = this->WallTime();
+    record.duration = 0.;
+    record.cpu = CPUTime();
+    record.division = streaming == NULL ? -1 : streaming->division;
+    record.bytes = 0;
+    record.bufferedPixels = 0;
+    record.bufferedComponents = 0;
+    m_Running[filter] = record;
+    }
+  else if (typeid(event) == typeid(itk::EndEvent))
+    {
+    std::map<itk::ProcessObject *, Event>::iterator it = m_Running.find(filter);
+    if (it == m_Running.end())
+      {
+      return;
+      }
+    Event record = it->second;
+    m_Running.erase(it);
+
+    record.duration = this->WallTime() - record.start;
+    record.cpu = CPUTime() - record.cpu;
+
+    // Size of the buffers of the image outputs, of dimension 1 to 4
+    itk::ProcessObject::DataObjectPointerArray outputs = filter->GetOutputs();
+    for (unsigned int i = 0; i < outputs.size(); ++i)
+      {
+      itk::DataObject * output = outputs[i].GetPointer();
+      AddBufferSize<2>(output, record.bufferedPixels, record.bufferedComponents)
+        || AddBufferSize<3>(output, record.bufferedPixels, record.bufferedComponents)
+        || AddBufferSize<1>(output, record.bufferedPixels, record.bufferedComponents)
+        || AddBufferSize<4>(output, record.bufferedPixels, record.bufferedComponents);
+      }
+    m_Events.push_back(record);
+
+    FilterStatistics& stats = this->Statistics(filter);
+    ++stats.calls;
+    stats.wallTime += record.duration;
+    stats.cpuTime += record.cpu;
+    stats.allocatedComponents += record.bufferedComponents;
+    }
+}
+
+void PipelineProfiler::FilterDeleteCallback(itk::Object * caller, const itk::EventObject& itkNotUsed(event))
+{
+  // The statistics are kept for the report, under the number of the filter
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  m_FilterIds.erase(caller);
+}
+
+void PipelineProfiler::WriteReport()
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+
+  std::vector<Observer> released;
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+
+  std::ofstream file(m_FileName.c_str());
+  if (!file)
+    {
+    itkExceptionMacro(<< "Can not write the profiling report " << m_FileName);
+    }
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [";
+  for (unsigned int i = 0; i < m_Events.size(); ++i)
+    {
+    const Event& event = m_Events[i];
+    file << (i == 0 ? "\n" : ",\n")
+         << "{\"name\": " << JSONString(event.name)
+         << ", \"cat\": " << JSONString(event.category)
+         << ", \"ph\": " << (event.category == "streaming" ? "\"i\", \"s\": \"g\"" : "\"X\"")
+         << ", \"pid\": 1, \"tid\": 1"
+         << ", \"ts\": " << event.start * 1e6;
+    if (event.category != "streaming")
+      {
+      file << ", \"dur\": " << event.duration * 1e6;
+      }
+    file << ", \"args\": {\"division\": " << event.division;
+    if (event.category != "streaming")
+      {
+      file << ", \"cpuTime\": " << event.cpu;
+      }
+    if (event.category == "filter")
+      {
+      file << ", \"bytesRead\": " << event.bytes
+           << ", \"bufferedPixels\": " << event.bufferedPixels
+           << ", \"bufferedComponents\": " << event.bufferedComponents;
+      }
+    else if (event.category == "division")
+      {
+      file << ", \"bytesWritten\": " << event.bytes;
+      }
+    if (!event.details.empty())
+      {
+      file << ", \"details\": " << JSONString(event.details);
+      }
+    file << "}}";
+    }
+  file << "\n],\n\"otbFilters\": [";
+
+  bool first = true;
+  for (std::map<unsigned long, FilterStatistics>::const_iterator it = m_Filters.begin();
+       it != m_Filters.end(); ++it)
+    {
+    const FilterStatistics& stats = it->second;
+    if (stats.calls == 0)
+      {
+      continue;
+      }
+    file << (first ? "\n" : ",\n")
+         << "{\"name\": " << JSONString(stats.name)
+         << ", \"calls\": " << stats.calls
+         << ", \"wallTime\": " << stats.wallTime
+         << ", \"cpuTime\": " << stats.cpuTime
+         << ", \"bytesRead\": " << stats.bytesRead
+         << ", \"allocatedComponents\": " << stats.allocatedComponents << "}";
+    first = false;
+    }
+  file << "\n]\n}\n";
+
+  otbMsgDevMacro(<< "Profiling report written in " << m_FileName);
+
+  this->ClearRecords(released);
+}
+
+void PipelineProfiler::Reset()
+{
+  std::vector<Observer> released;
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  this->ClearRecords(released);
+}
+
+void PipelineProfiler::ClearRecords(std::vector<Observer>& released)
+{
+  while (!m_Streamings.empty())
+    {
+    this->RemoveStreaming(m_Streamings.size() - 1, released);
+    }
+  m_Running.clear();
+  m_Events.clear();
+  m_Filters.clear();
+  m_ClassCount.clear();
+}
+
+void PipelineProfiler::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Number of events: " << m_Events.size() << std::endl;
+  os << indent << "Number of filters: " << m_Filters.size() << std::endl;
+}
+
+} // end namespace otb
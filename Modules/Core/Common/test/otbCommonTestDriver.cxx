@@ -21,4 +21,5 @@ void RegisterTests()
   REGISTER_TEST(otbStandardFilterWatcherNew);
   REGISTER_TEST(otbStandardOneLineFilterWatcherTest);
   REGISTER_TEST(otbStandardWriterWatcher);
+  REGISTER_TEST(otbPipelineProfiler);
 }
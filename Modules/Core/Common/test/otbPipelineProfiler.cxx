@@ -0,0 +1,84 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "itkMacro.h"
+
+#include "otbImageFileReader.h"
+#include "otbImage.h"
+#include "itkGradientMagnitudeImageFilter.h"
+#include "otbImageFileWriter.h"
+#include "otbPipelineProfiler.h"
+
+#include <fstream>
+
+int otbPipelineProfiler(int itkNotUsed(argc), char * argv[])
+{
+  const char *       infname = argv[1];
+  const char *       outfname = argv[2];
+  const char *       reportfname = argv[3];
+  const unsigned int nbsd = atoi(argv[4]);
+
+  typedef otb::Image<unsigned char, 2>                            ImageType;
+  typedef otb::ImageFileReader<ImageType>                         ReaderType;
+  typedef itk::GradientMagnitudeImageFilter<ImageType, ImageType> FilterType;
+  typedef otb::ImageFileWriter<ImageType>                         WriterType;
+
+  otb::PipelineProfiler::Pointer profiler = otb::PipelineProfiler::GetInstance();
+  profiler->SetFileName(reportfname);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+
+  FilterType::Pointer gradient = FilterType::New();
+  gradient->SetInput(reader->GetOutput());
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetNumberOfDivisionsStrippedStreaming(nbsd);
+  writer->SetInput(gradient->GetOutput());
+  writer->SetFileName(outfname);
+  writer->Update();
+
+  profiler->WriteReport();
+  profiler->SetFileName("");
+
+  // The report has one event per division and per filter and division
+  std::ifstream report(reportfname);
+  std::string line;
+  unsigned int nbDivisions = 0;
+  unsigned int nbReaderEvents = 0;
+  unsigned int nbGradientEvents = 0;
+  while (std::getline(report, line))
+    {
+    if (line.find("\"cat\": \"division\"") != std::string::npos)
+      ++nbDivisions;
+    else if (line.find("\"ImageFileReader #1\", \"cat\": \"filter\"") != std::string::npos)
+      ++nbReaderEvents;
+    else if (line.find("\"GradientMagnitudeImageFilter #1\", \"cat\": \"filter\"") != std::string::npos)
+      ++nbGradientEvents;
+    }
+
+  std::cout << nbDivisions << " divisions, " << nbReaderEvents << " reader and "
+            << nbGradientEvents << " gradient events" << std::endl;
+
+  if (nbDivisions != nbsd || nbReaderEvents != nbsd || nbGradientEvents != nbsd)
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
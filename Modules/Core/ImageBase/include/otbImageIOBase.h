@@ -170,6 +170,15 @@ public:
   itkGetEnumMacro(ComponentType,IOComponentType);
   virtual const std::type_info& GetComponentTypeInfo() const;
 
+  /** Component type corresponding to a type_info (UNKNOWNCOMPONENTTYPE
+   * if the type is not a supported component type). */
+  static IOComponentType GetComponentTypeFromTypeInfo(const std::type_info& ctype);
+
+  /** Is the conversion of a component from one type to another exact,
+   * that is, is every value of the first type represented by the same
+   * value in the second one ? (unsigned char to float, short to int...) */
+  static bool IsLosslessComponentConversion(IOComponentType from, IOComponentType to);
+
   /** Set/Get the number of components per pixel in the image. This may
    * be set by the reading process. For SCALAR pixel types,
    * NumberOfComponents will be 1.  For other pixel types,
@@ -317,6 +326,52 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void* buffer) = 0;
 
+  /** Can the ImageIO read the data directly as components of another
+   * type than the one of the file ? Only exact conversions (see
+   * IsLosslessComponentConversion()) are expected to be supported.
+   * Default is false. */
+  virtual bool CanReadAs(IOComponentType itkNotUsed(componentType)) const
+    {
+    return false;
+    }
+
+  /** Reads the data from disk into the memory buffer provided, as
+   * components of the given type. The number of components per pixel
+   * and the layout of the buffer are the ones of Read(). Only valid if
+   * CanReadAs(componentType) returns true. */
+  virtual void ReadAs(void* buffer, IOComponentType componentType);
+
+  /** Set/Get the list of the bands to read (0 based, in the order of the
+   * output components). An empty list means every band. It has to be set
+   * before ReadImageInformation(). */
+  void SetBandList(const std::vector<unsigned int>& bandList)
+    {
+    m_BandList = bandList;
+    }
+  const std::vector<unsigned int>& GetBandList() const
+    {
+    return m_BandList;
+    }
+
+  /** Does the ImageIO read the bands of the band list only ? In that case
+   * NumberOfComponents is the number of selected bands times
+   * GetNumberOfComponentsPerBand(). Otherwise, every
+   * band is read and the selection is left to the caller. Valid after
+   * ReadImageInformation(). Default is false. */
+  virtual bool CanReadBandSubset() const
+    {
+    return false;
+    }
+
+  /** Number of consecutive components read from each band of the file,
+   * for instance the real and imaginary parts of a complex band read as
+   * scalars. A band of the band list selects all of them. Valid after
+   * ReadImageInformation(). Default is 1. */
+  virtual unsigned int GetNumberOfComponentsPerBand() const
+    {
+    return 1;
+    }
+
 
   /*-------- This part of the interfaces deals with writing data ----- */
 
@@ -453,6 +508,9 @@ protected:
   /** Should we use streaming for writing */
   bool m_UseStreamedWriting;
 
+  /** The bands to read (every band if empty) */
+  std::vector<unsigned int> m_BandList;
+
   /** The region to read or write. The region contains information about the
    * data within the region to read or write. */
   itk::ImageIORegion m_IORegion;
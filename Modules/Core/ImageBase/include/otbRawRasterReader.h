@@ -0,0 +1,154 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbRawRasterReader_h
+#define __otbRawRasterReader_h
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class RawRasterReader
+ * \brief Read regions of a raw raster file, through a memory mapping.
+ *
+ * This class is the common reading back-end of the ImageIOs of the raw
+ * formats, where each line of the file is a contiguous array of pixels
+ * (BSQ, LUM, RAD, MW, ONERA...). The file is mapped in memory when it
+ * is opened, and ReadRegion() copies the requested pixels directly from
+ * the mapping into the caller buffer, with a stride in the buffer (to
+ * interleave the bands of a band-sequential format) and an optional
+ * byte swapping, in a single pass. There is no intermediate line
+ * buffer.
+ *
+ * ReadRegion() does not modify the reader, so that several threads may
+ * read regions of the same file concurrently. If the file can not be
+ * mapped (for instance, a very large file on a 32 bits system), the
+ * reader falls back on a std::ifstream, whose accesses are serialized.
+ *
+ * \ingroup OTBImageBase
+ */
+class ITK_EXPORT RawRasterReader : public itk::LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef RawRasterReader               Self;
+  typedef itk::LightObject              Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RawRasterReader, itk::LightObject);
+
+  /** Open the file for reading. Nothing is done if the file is
+   *  already opened. Throws an exception if the file can not be opened. */
+  void Open(const std::string& filename);
+
+  /** Release the mapping (or the stream) */
+  void Close();
+
+  /** Is a file opened ? */
+  bool IsOpen() const;
+
+  /** Is the opened file mapped in memory ? */
+  bool IsMapped() const
+  {
+    return m_Data != NULL;
+  }
+
+  /** Name of the opened file */
+  const std::string& GetFileName() const
+  {
+    return m_FileName;
+  }
+
+  /** Size of the opened file, in bytes */
+  std::streamoff GetFileSize() const
+  {
+    return m_FileSize;
+  }
+
+  /** Copy a region of the file into a buffer.
+   *
+   * The line l of the file starts at headerLength + l * bytesPerLine,
+   * and is made of pixels of pixelSize bytes. The nbColumns pixels from
+   * firstColumn of the nbLines lines from firstLine are copied in the
+   * buffer, line after line, the start of two consecutive pixels being
+   * separated by bufferPixelStride bytes in the buffer (pixelSize for a
+   * contiguous copy).
+   *
+   * If swapWordSize is not 0, the bytes of each word of swapWordSize
+   * bytes of the pixels are reversed during the copy. pixelSize must
+   * then be a multiple of swapWordSize.
+   *
+   * Throws an exception if the region is not inside the file. */
+  void ReadRegion(char * buffer,
+                  std::streamoff headerLength,
+                  std::streamoff bytesPerLine,
+                  unsigned int pixelSize,
+                  long firstColumn, long firstLine,
+                  unsigned long nbColumns, unsigned long nbLines,
+                  unsigned long bufferPixelStride,
+                  unsigned int swapWordSize) const;
+
+  /** Copy nbPixels pixels of pixelSize bytes from src (contiguous) to
+   *  dst (one pixel every dstPixelStride bytes), reversing the bytes of
+   *  each word of swapWordSize bytes if swapWordSize is not 0. */
+  static void CopyPixels(char * dst, const char * src,
+                         unsigned long nbPixels, unsigned int pixelSize,
+                         unsigned long dstPixelStride, unsigned int swapWordSize);
+
+protected:
+  RawRasterReader();
+  virtual ~RawRasterReader();
+
+  virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+private:
+  RawRasterReader(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  std::string    m_FileName;
+  std::streamoff m_FileSize;
+
+  /** Memory mapping */
+  const char * m_Data;
+#if defined(_WIN32)
+  void * m_FileHandle;
+  void * m_MappingHandle;
+#else
+  int    m_FileDescriptor;
+#endif
+
+  /** Fallback when the file can not be mapped */
+  mutable std::ifstream              m_Stream;
+  mutable std::vector<char>          m_LineBuffer;
+  mutable itk::SimpleFastMutexLock   m_StreamMutex;
+};
+
+} // end namespace otb
+
+#endif
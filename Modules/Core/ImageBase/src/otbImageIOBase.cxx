@@ -215,6 +215,74 @@ const std::type_info& ImageIOBase::GetComponentTypeInfo() const
     }
 }
 
+ImageIOBase::IOComponentType
+ImageIOBase::GetComponentTypeFromTypeInfo(const std::type_info& ctype)
+{
+  if (ctype == typeid(unsigned char)) return UCHAR;
+  else if (ctype == typeid(char)) return CHAR;
+  else if (ctype == typeid(unsigned short)) return USHORT;
+  else if (ctype == typeid(short)) return SHORT;
+  else if (ctype == typeid(unsigned int)) return UINT;
+  else if (ctype == typeid(int)) return INT;
+  else if (ctype == typeid(unsigned long)) return ULONG;
+  else if (ctype == typeid(long)) return LONG;
+  else if (ctype == typeid(float)) return FLOAT;
+  else if (ctype == typeid(double)) return DOUBLE;
+  else if (ctype == typeid(std::complex<short>)) return CSHORT;
+  else if (ctype == typeid(std::complex<int>)) return CINT;
+  else if (ctype == typeid(std::complex<float>)) return CFLOAT;
+  else if (ctype == typeid(std::complex<double>)) return CDOUBLE;
+  return UNKNOWNCOMPONENTTYPE;
+}
+
+bool
+ImageIOBase::IsLosslessComponentConversion(IOComponentType from, IOComponentType to)
+{
+  if (from == to)
+    {
+    return from != UNKNOWNCOMPONENTTYPE;
+    }
+
+  // Widening conversions only: the destination type must hold every
+  // value of the source type (float holds 24 bits integers, double 53
+  // bits ones).
+  const bool longIs64Bits = (sizeof(long) > 4);
+  switch (from)
+    {
+    case UCHAR:
+      return to == USHORT || to == SHORT || to == UINT || to == INT
+             || to == ULONG || to == LONG || to == FLOAT || to == DOUBLE;
+    case CHAR:
+      return to == SHORT || to == INT || to == LONG || to == FLOAT || to == DOUBLE;
+    case USHORT:
+      return to == UINT || to == INT || to == ULONG || to == LONG
+             || to == FLOAT || to == DOUBLE;
+    case SHORT:
+      return to == INT || to == LONG || to == FLOAT || to == DOUBLE;
+    case UINT:
+      return to == ULONG || to == DOUBLE || (to == LONG && longIs64Bits);
+    case INT:
+      return to == LONG || to == DOUBLE;
+    case FLOAT:
+      return to == DOUBLE;
+    case CSHORT:
+      return to == CINT || to == CFLOAT || to == CDOUBLE;
+    case CINT:
+      return to == CDOUBLE;
+    case CFLOAT:
+      return to == CDOUBLE;
+    default:
+      return false;
+    }
+}
+
+void ImageIOBase::ReadAs(void* itkNotUsed(buffer), IOComponentType componentType)
+{
+  itkExceptionMacro(<< "Reading " << this->GetComponentTypeAsString(m_ComponentType)
+                    << " components as " << this->GetComponentTypeAsString(componentType)
+                    << " is not supported by " << this->GetNameOfClass());
+}
+
 //
 // This macro enforces pixel type information to be available for all different
 // pixel types.
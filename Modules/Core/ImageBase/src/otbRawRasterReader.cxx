@@ -0,0 +1,397 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbRawRasterReader.h"
+#include "otbMacro.h"
+
+#include "itkIntTypes.h"
+#include "itkMutexLockHolder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace otb
+{
+
+namespace
+{
+
+/** Byte swapping of a word. These kernels only use shifts and masks,
+ *  so that the copy loops below can be vectorized by the compiler. */
+template <class TWord>
+inline TWord SwapWord(TWord word);
+
+template <>
+inline itk::uint8_t SwapWord(itk::uint8_t word)
+{
+  return word;
+}
+
+template <>
+inline itk::uint16_t SwapWord(itk::uint16_t word)
+{
+  return static_cast<itk::uint16_t>((word >> 8) | (word << 8));
+}
+
+template <>
+inline itk::uint32_t SwapWord(itk::uint32_t word)
+{
+  return ((word >> 24) & 0x000000ffU) | ((word >> 8) & 0x0000ff00U)
+         | ((word << 8) & 0x00ff0000U) | ((word << 24) & 0xff000000U);
+}
+
+template <>
+inline itk::uint64_t SwapWord(itk::uint64_t word)
+{
+  return (static_cast<itk::uint64_t>(SwapWord(static_cast<itk::uint32_t>(word))) << 32)
+         | static_cast<itk::uint64_t>(SwapWord(static_cast<itk::uint32_t>(word >> 32)));
+}
+
+/** Copy (and swap) pixels made of VWordsPerPixel words. memcpy with a
+ *  constant size is used to load and store the words, since the file
+ *  offsets are not aligned in general. */
+template <class TWord, unsigned int VWordsPerPixel, bool VSwap>
+void CopyWords(char * dst, const char * src, unsigned long nbPixels, unsigned long dstPixelStride)
+{
+  const unsigned long pixelSize = sizeof(TWord) * VWordsPerPixel;
+  for (unsigned long i = 0; i < nbPixels; ++i)
+    {
+    const char * s = src + i * pixelSize;
+    char *       d = dst + i * dstPixelStride;
+    for (unsigned int w = 0; w < VWordsPerPixel; ++w)
+      {
+      TWord word;
+      memcpy(&word, s + w * sizeof(TWord), sizeof(TWord));
+      if (VSwap)
+        {
+        word = SwapWord(word);
+        }
+      memcpy(d + w * sizeof(TWord), &word, sizeof(TWord));
+      }
+    }
+}
+
+/** Dispatch on the number of words per pixel (1 for scalar pixels, 2
+ *  for complex pixels). Returns false if there is no dedicated kernel. */
+template <class TWord, bool VSwap>
+bool CopyWordsDispatch(char * dst, const char * src, unsigned long nbPixels,
+                       unsigned int wordsPerPixel, unsigned long dstPixelStride)
+{
+  switch (wordsPerPixel)
+    {
+    case 1:
+      CopyWords<TWord, 1, VSwap>(dst, src, nbPixels, dstPixelStride);
+      return true;
+    case 2:
+      CopyWords<TWord, 2, VSwap>(dst, src, nbPixels, dstPixelStride);
+      return true;
+    case 4:
+      CopyWords<TWord, 4, VSwap>(dst, src, nbPixels, dstPixelStride);
+      return true;
+    default:
+      return false;
+    }
+}
+
+} // end anonymous namespace
+
+
+RawRasterReader::RawRasterReader()
+  : m_FileSize(0),
+    m_Data(NULL)
+#if defined(_WIN32)
+  , m_FileHandle(NULL),
+    m_MappingHandle(NULL)
+#else
+  , m_FileDescriptor(-1)
+#endif
+{
+}
+
+RawRasterReader::~RawRasterReader()
+{
+  this->Close();
+}
+
+bool RawRasterReader::IsOpen() const
+{
+  return (m_Data != NULL) || m_Stream.is_open();
+}
+
+void RawRasterReader::Open(const std::string& filename)
+{
+  if (this->IsOpen() && (filename == m_FileName))
+    {
+    return;
+    }
+  this->Close();
+
+  m_FileName = filename;
+
+#if defined(_WIN32)
+  m_FileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_FileHandle == INVALID_HANDLE_VALUE)
+    {
+    m_FileHandle = NULL;
+    itkExceptionMacro(<< "RawRasterReader: unable to open the file " << filename);
+    }
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(m_FileHandle, &fileSize))
+    {
+    m_FileSize = static_cast<std::streamoff>(fileSize.QuadPart);
+    }
+  if (m_FileSize > 0)
+    {
+    m_MappingHandle = CreateFileMappingA(m_FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_MappingHandle != NULL)
+      {
+      m_Data = static_cast<const char *>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+      }
+    }
+#else
+  m_FileDescriptor = open(filename.c_str(), O_RDONLY);
+  if (m_FileDescriptor < 0)
+    {
+    itkExceptionMacro(<< "RawRasterReader: unable to open the file " << filename);
+    }
+  struct stat fileStat;
+  if (fstat(m_FileDescriptor, &fileStat) == 0)
+    {
+    m_FileSize = static_cast<std::streamoff>(fileStat.st_size);
+    }
+  if (m_FileSize > 0)
+    {
+    void * data = mmap(NULL, static_cast<size_t>(m_FileSize), PROT_READ, MAP_SHARED, m_FileDescriptor, 0);
+    if (data != MAP_FAILED)
+      {
+      m_Data = static_cast<const char *>(data);
+      }
+    }
+#endif
+
+  if (m_Data == NULL)
+    {
+    // Fallback on a stream, with serialized accesses
+    otbMsgDevMacro(<< "RawRasterReader: " << filename << " can not be mapped in memory, reading through a stream.");
+    this->Close();
+    m_FileName = filename;
+    m_Stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (m_Stream.fail())
+      {
+      itkExceptionMacro(<< "RawRasterReader: unable to open the file " << filename);
+      }
+    m_Stream.seekg(0, std::ios::end);
+    m_FileSize = static_cast<std::streamoff>(m_Stream.tellg());
+    }
+}
+
+void RawRasterReader::Close()
+{
+#if defined(_WIN32)
+  if (m_Data != NULL)
+    {
+    UnmapViewOfFile(m_Data);
+    }
+  if (m_MappingHandle != NULL)
+    {
+    CloseHandle(m_MappingHandle);
+    m_MappingHandle = NULL;
+    }
+  if (m_FileHandle != NULL)
+    {
+    CloseHandle(m_FileHandle);
+    m_FileHandle = NULL;
+    }
+#else
+  if (m_Data != NULL)
+    {
+    munmap(const_cast<char *>(m_Data), static_cast<size_t>(m_FileSize));
+    }
+  if (m_FileDescriptor >= 0)
+    {
+    close(m_FileDescriptor);
+    m_FileDescriptor = -1;
+    }
+#endif
+  m_Data = NULL;
+
+  if (m_Stream.is_open())
+    {
+    m_Stream.close();
+    }
+  m_Stream.clear();
+
+  m_FileName.clear();
+  m_FileSize = 0;
+}
+
+void RawRasterReader::CopyPixels(char * dst, const char * src,
+                                 unsigned long nbPixels, unsigned int pixelSize,
+                                 unsigned long dstPixelStride, unsigned int swapWordSize)
+{
+  bool done = false;
+
+  if (swapWordSize <= 1)
+    {
+    if (dstPixelStride == pixelSize)
+      {
+      memcpy(dst, src, nbPixels * pixelSize);
+      return;
+      }
+    switch (pixelSize)
+      {
+      case 1:
+        CopyWords<itk::uint8_t, 1, false>(dst, src, nbPixels, dstPixelStride);
+        done = true;
+        break;
+      case 2:
+        done = CopyWordsDispatch<itk::uint16_t, false>(dst, src, nbPixels, 1, dstPixelStride);
+        break;
+      case 4:
+        done = CopyWordsDispatch<itk::uint32_t, false>(dst, src, nbPixels, 1, dstPixelStride);
+        break;
+      case 8:
+        done = CopyWordsDispatch<itk::uint64_t, false>(dst, src, nbPixels, 1, dstPixelStride);
+        break;
+      case 16:
+        done = CopyWordsDispatch<itk::uint64_t, false>(dst, src, nbPixels, 2, dstPixelStride);
+        break;
+      }
+    if (!done)
+      {
+      for (unsigned long i = 0; i < nbPixels; ++i)
+        {
+        memcpy(dst + i * dstPixelStride, src + i * pixelSize, pixelSize);
+        }
+      }
+    return;
+    }
+
+  const unsigned int wordsPerPixel = pixelSize / swapWordSize;
+  switch (swapWordSize)
+    {
+    case 2:
+      done = CopyWordsDispatch<itk::uint16_t, true>(dst, src, nbPixels, wordsPerPixel, dstPixelStride);
+      break;
+    case 4:
+      done = CopyWordsDispatch<itk::uint32_t, true>(dst, src, nbPixels, wordsPerPixel, dstPixelStride);
+      break;
+    case 8:
+      done = CopyWordsDispatch<itk::uint64_t, true>(dst, src, nbPixels, wordsPerPixel, dstPixelStride);
+      break;
+    }
+  if (!done)
+    {
+    for (unsigned long i = 0; i < nbPixels; ++i)
+      {
+      for (unsigned int w = 0; w < wordsPerPixel; ++w)
+        {
+        const char * s = src + i * pixelSize + w * swapWordSize;
+        std::reverse_copy(s, s + swapWordSize, dst + i * dstPixelStride + w * swapWordSize);
+        }
+      }
+    }
+}
+
+void RawRasterReader::ReadRegion(char * buffer,
+                                 std::streamoff headerLength,
+                                 std::streamoff bytesPerLine,
+                                 unsigned int pixelSize,
+                                 long firstColumn, long firstLine,
+                                 unsigned long nbColumns, unsigned long nbLines,
+                                 unsigned long bufferPixelStride,
+                                 unsigned int swapWordSize) const
+{
+  if (!this->IsOpen())
+    {
+    itkExceptionMacro(<< "RawRasterReader: no file opened.");
+    }
+  if ((nbColumns == 0) || (nbLines == 0))
+    {
+    return;
+    }
+  if ((swapWordSize > 1) && (pixelSize % swapWordSize != 0))
+    {
+    itkExceptionMacro(<< "RawRasterReader: the pixel size (" << pixelSize
+                      << ") is not a multiple of the word size (" << swapWordSize << ").");
+    }
+
+  const std::streamoff numberOfBytesToBeRead = static_cast<std::streamoff>(pixelSize) * nbColumns;
+  const std::streamoff columnOffset = static_cast<std::streamoff>(pixelSize) * firstColumn;
+  const std::streamoff endOfRegion = headerLength
+                                     + bytesPerLine * static_cast<std::streamoff>(firstLine + nbLines - 1)
+                                     + columnOffset + numberOfBytesToBeRead;
+  if ((firstColumn < 0) || (firstLine < 0) || (endOfRegion > m_FileSize))
+    {
+    itkExceptionMacro(<< "RawRasterReader: can not read the specified region of " << m_FileName
+                      << " (" << endOfRegion << " bytes needed, " << m_FileSize << " available).");
+    }
+
+  const unsigned long bufferLineStride = bufferPixelStride * nbColumns;
+
+  if (this->IsMapped())
+    {
+    for (unsigned long line = 0; line < nbLines; ++line)
+      {
+      const std::streamoff offset = headerLength
+                                    + bytesPerLine * static_cast<std::streamoff>(firstLine + line)
+                                    + columnOffset;
+      CopyPixels(buffer + line * bufferLineStride, m_Data + offset,
+                 nbColumns, pixelSize, bufferPixelStride, swapWordSize);
+      }
+    return;
+    }
+
+  // Stream fallback
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_StreamMutex);
+  m_LineBuffer.resize(static_cast<size_t>(numberOfBytesToBeRead));
+  for (unsigned long line = 0; line < nbLines; ++line)
+    {
+    const std::streamoff offset = headerLength
+                                  + bytesPerLine * static_cast<std::streamoff>(firstLine + line)
+                                  + columnOffset;
+    m_Stream.seekg(offset, std::ios::beg);
+    m_Stream.read(&(m_LineBuffer[0]), numberOfBytesToBeRead);
+    if (m_Stream.gcount() != numberOfBytesToBeRead)
+      {
+      m_Stream.clear();
+      itkExceptionMacro(<< "RawRasterReader: can not read the specified region of " << m_FileName);
+      }
+    CopyPixels(buffer + line * bufferLineStride, &(m_LineBuffer[0]),
+               nbColumns, pixelSize, bufferPixelStride, swapWordSize);
+    }
+}
+
+void RawRasterReader::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "FileSize: " << m_FileSize << std::endl;
+  os << indent << "Mapped: " << (this->IsMapped() ? "yes" : "no") << std::endl;
+}
+
+} // end namespace otb
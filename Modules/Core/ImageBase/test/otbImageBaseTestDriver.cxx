@@ -31,4 +31,5 @@ void RegisterTests()
   REGISTER_TEST(otbMultiChannelExtractROINew);
   REGISTER_TEST(otbMetaImageFunction);
   REGISTER_TEST(otbMetaImageFunctionNew);
+  REGISTER_TEST(otbRawRasterReader);
 }
@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "itkMacro.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include "itkByteSwapper.h"
+#include "otbRawRasterReader.h"
+
+int otbRawRasterReader(int itkNotUsed(argc), char* argv[])
+{
+  const char * filename = argv[1];
+
+  // A big endian 16 bits raster of 20 x 10 pixels, with a 7 bytes header
+  const unsigned int  width = 20, height = 10, headerLength = 7;
+  std::ofstream file(filename, std::ios::out | std::ios::binary);
+  file.write("RAWTEST", headerLength);
+  for (unsigned int y = 0; y < height; ++y)
+    {
+    for (unsigned int x = 0; x < width; ++x)
+      {
+      unsigned short value = static_cast<unsigned short>(1000 * y + x);
+      char bytes[2];
+      bytes[0] = static_cast<char>(value >> 8);
+      bytes[1] = static_cast<char>(value & 0xff);
+      file.write(bytes, 2);
+      }
+    }
+  file.close();
+
+  otb::RawRasterReader::Pointer reader = otb::RawRasterReader::New();
+  reader->Open(filename);
+  std::cout << "Mapped in memory: " << reader->IsMapped() << std::endl;
+
+  // Read a region as the second band of a 3 bands interleaved buffer,
+  // swapping to the host byte order
+  const long firstColumn = 3, firstLine = 4;
+  const unsigned long nbColumns = 5, nbLines = 4;
+  std::vector<unsigned short> buffer(3 * nbColumns * nbLines, 0);
+  unsigned int swapWordSize = itk::ByteSwapper<unsigned short>::SystemIsBigEndian() ? 0 : 2;
+
+  reader->ReadRegion(reinterpret_cast<char *>(&(buffer[1])), headerLength, 2 * width, 2,
+                     firstColumn, firstLine, nbColumns, nbLines,
+                     3 * sizeof(unsigned short), swapWordSize);
+
+  for (unsigned long y = 0; y < nbLines; ++y)
+    {
+    for (unsigned long x = 0; x < nbColumns; ++x)
+      {
+      unsigned long  idx = 3 * (y * nbColumns + x);
+      unsigned short expected = static_cast<unsigned short>(1000 * (firstLine + y) + firstColumn + x);
+      if ((buffer[idx + 1] != expected) || (buffer[idx] != 0) || (buffer[idx + 2] != 0))
+        {
+        std::cerr << "Bad value at (" << x << "," << y << "): " << buffer[idx + 1]
+                  << " instead of " << expected << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // A region outside the file must be rejected
+  try
+    {
+    reader->ReadRegion(reinterpret_cast<char *>(&(buffer[0])), headerLength, 2 * width, 2,
+                       0, height - 1, width, 2, 2, 0);
+    std::cerr << "A region outside the file has been read." << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
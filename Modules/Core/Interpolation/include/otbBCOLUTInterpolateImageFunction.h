@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbBCOLUTInterpolateImageFunction_h
+#define __otbBCOLUTInterpolateImageFunction_h
+
+#include "otbSeparableLUTInterpolateImageFunction.h"
+
+namespace otb
+{
+
+namespace Function
+{
+/**
+ * \class BCOKernelFunction
+ * \brief Bicubic kernel, stretched over the window radius.
+ *
+ * This is the kernel used by BCOInterpolateImageFunction: the cubic
+ * convolution kernel of parameter alpha, defined on [-2, 2], is stretched
+ * so that its support matches [-radius, radius].
+ *
+ * \sa BCOLUTInterpolateImageFunction
+ *
+ * \ingroup OTBInterpolation
+ */
+template<class TInput = double, class TOutput = double>
+class BCOKernelFunction
+{
+public:
+  BCOKernelFunction() : m_Radius(2), m_Step(1.), m_Alpha(-0.5) {}
+
+  void SetRadius(unsigned int radius)
+  {
+    m_Radius = radius;
+    m_Step = 2. / static_cast<double>(radius);
+  }
+  unsigned int GetRadius() const
+  {
+    return m_Radius;
+  }
+  void SetAlpha(double alpha)
+  {
+    m_Alpha = alpha;
+  }
+  double GetAlpha() const
+  {
+    return m_Alpha;
+  }
+
+  inline TOutput operator ()(const TInput& A) const
+  {
+    const double dist = vcl_abs(static_cast<double>(A)) * m_Step;
+    double res = 0.;
+    if (dist <= 1.)
+      {
+      res = (m_Alpha + 2.) * dist * dist * dist - (m_Alpha + 3.) * dist * dist + 1.;
+      }
+    else if (dist <= 2.)
+      {
+      res = m_Alpha * dist * dist * dist - 5. * m_Alpha * dist * dist + 8. * m_Alpha * dist - 4. * m_Alpha;
+      }
+    return static_cast<TOutput>(res);
+  }
+private:
+  unsigned int m_Radius;
+  // Equal to \f$ \frac{2}{radius} \f$
+  double       m_Step;
+  double       m_Alpha;
+};
+} //namespace Function
+
+/** \class BCOLUTInterpolateImageFunction
+ *  \brief Bicubic interpolation using a precomputed look-up table.
+ *
+ * This interpolator gives the same results as BCOInterpolateImageFunction
+ * up to the quantization of the sub-pixel phase (see
+ * SeparableLUTInterpolateImageFunctionBase), but does not evaluate the
+ * coefficients nor allocate temporary buffers at each call. It is
+ * therefore much faster when resampling large images, for instance
+ * in StreamingResampleImageFilter or GenericRSResampleImageFilter.
+ *
+ * Parameters are the same as BCOInterpolateImageFunction: the window
+ * radius (2 by default) and the bicubic optimisation coefficient alpha
+ * (-0.5 by default).
+ *
+ * \sa BCOInterpolateImageFunction
+ * \ingroup ImageFunctions ImageInterpolators
+ *
+ * \ingroup OTBInterpolation
+ */
+template< class TInputImage, class TCoordRep = double >
+class ITK_EXPORT BCOLUTInterpolateImageFunction :
+  public SeparableLUTInterpolateImageFunction<TInputImage, Function::BCOKernelFunction<>, TCoordRep>
+{
+public:
+  /** Standard class typedefs. */
+  typedef BCOLUTInterpolateImageFunction Self;
+  typedef SeparableLUTInterpolateImageFunction
+    <TInputImage, Function::BCOKernelFunction<>, TCoordRep>      Superclass;
+  typedef itk::SmartPointer<Self>                               Pointer;
+  typedef itk::SmartPointer<const Self>                         ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BCOLUTInterpolateImageFunction, SeparableLUTInterpolateImageFunction);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Set/Get the optimisation coefficient (Common values are -0.5, -0.75 or -1.0) */
+  void SetAlpha(double alpha)
+  {
+    if (alpha != this->GetKernel().GetAlpha())
+      {
+      this->GetKernel().SetAlpha(alpha);
+      this->Modified();
+      if (this->GetInputImage() != NULL)
+        {
+        this->UpdateLookUpTable();
+        }
+      }
+  }
+  double GetAlpha() const
+  {
+    return this->GetKernel().GetAlpha();
+  }
+
+protected:
+  BCOLUTInterpolateImageFunction() {}
+  virtual ~BCOLUTInterpolateImageFunction() {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Alpha: " << this->GetAlpha() << std::endl;
+  }
+
+private:
+  BCOLUTInterpolateImageFunction( const Self& ); //purposely not implemented
+  void operator=( const Self& ); //purposely not implemented
+};
+
+} // end namespace otb
+
+#endif
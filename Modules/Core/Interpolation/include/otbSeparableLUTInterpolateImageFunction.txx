@@ -0,0 +1,248 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbSeparableLUTInterpolateImageFunction_txx
+#define __otbSeparableLUTInterpolateImageFunction_txx
+
+#include "otbSeparableLUTInterpolateImageFunction.h"
+
+#include "itkNumericTraits.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TCoordRep>
+SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::SeparableLUTInterpolateImageFunctionBase()
+  : m_Radius(2), m_WinSize(5), m_NumberOfPhases(1024), m_NormalizeWeights(true)
+{
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "NumberOfPhases: " << m_NumberOfPhases << std::endl;
+  os << indent << "NormalizeWeights: " << m_NormalizeWeights << std::endl;
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::SetInputImage(const InputImageType * image)
+{
+  Superclass::SetInputImage(image);
+
+  if (image != NULL)
+    {
+    this->UpdateLookUpTable();
+    }
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::SetRadius(unsigned int radius)
+{
+  if (radius < 1)
+    {
+    itkExceptionMacro(<< "Radius must be strictly greater than 0");
+    }
+  if (radius != m_Radius)
+    {
+    m_Radius = radius;
+    m_WinSize = 2*m_Radius+1;
+    this->RadiusChanged();
+    this->Modified();
+    }
+  if (this->GetInputImage() != NULL)
+    {
+    this->UpdateLookUpTable();
+    }
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::SetNumberOfPhases(unsigned int nbPhases)
+{
+  if (nbPhases < 1)
+    {
+    itkExceptionMacro(<< "Number of phases must be strictly greater than 0");
+    }
+  if (nbPhases != m_NumberOfPhases)
+    {
+    m_NumberOfPhases = nbPhases;
+    this->Modified();
+    }
+  if (this->GetInputImage() != NULL)
+    {
+    this->UpdateLookUpTable();
+    }
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::SetNormalizeWeights(bool flag)
+{
+  if (flag != m_NormalizeWeights)
+    {
+    m_NormalizeWeights = flag;
+    this->Modified();
+    }
+  if (this->GetInputImage() != NULL)
+    {
+    this->UpdateLookUpTable();
+    }
+}
+
+template <class TInputImage, class TCoordRep>
+void SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::UpdateLookUpTable()
+{
+  m_LUT.assign((m_NumberOfPhases + 1) * m_WinSize, 0.);
+
+  const double radius = static_cast<double>(m_Radius);
+
+  // Row p holds the weights for a sub-pixel phase of p/N - 0.5
+  for (unsigned int p = 0; p <= m_NumberOfPhases; ++p)
+    {
+    const double offset = static_cast<double>(p) / static_cast<double>(m_NumberOfPhases) - 0.5;
+    double * weights = &m_LUT[p * m_WinSize];
+
+    double sum = 0.;
+    for (unsigned int i = 0; i < m_WinSize; ++i)
+      {
+      const double x = static_cast<double>(i) - radius - offset;
+
+      // Taps outside the kernel support are discarded
+      if (vcl_abs(x) <= radius)
+        {
+        weights[i] = this->EvaluateKernel(x);
+        }
+      sum += weights[i];
+      }
+
+    if (m_NormalizeWeights && sum != 0.)
+      {
+      for (unsigned int i = 0; i < m_WinSize; ++i)
+        {
+        weights[i] /= sum;
+        }
+      }
+    }
+}
+
+template <class TInputImage, class TCoordRep>
+typename SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::OutputType
+SeparableLUTInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+{
+  if (m_LUT.empty())
+    {
+    itkExceptionMacro(<< "The look-up table is not initialized, an input image has to be set");
+    }
+
+  const InputImageType * image = this->GetInputImage();
+  const unsigned int nbComp = image->GetNumberOfComponentsPerPixel();
+
+  // Closest index and quantized sub-pixel phase for each axis
+  IndexType baseIndex;
+  const double * weights[2];
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    baseIndex[dim] = itk::Math::Floor<IndexValueType>(index[dim] + 0.5);
+    const double offset = static_cast<double>(index[dim] - baseIndex[dim]);
+    int phase = itk::Math::Floor<int>((offset + 0.5) * m_NumberOfPhases + 0.5);
+    if (phase < 0)
+      {
+      phase = 0;
+      }
+    if (phase > static_cast<int>(m_NumberOfPhases))
+      {
+      phase = m_NumberOfPhases;
+      }
+    weights[dim] = &m_LUT[phase * m_WinSize];
+    }
+
+  OutputType output;
+  itk::NumericTraits<OutputType>::SetLength(output, nbComp);
+  ScalarRealType * value = GetOutputDataPointer(output);
+  for (unsigned int k = 0; k < nbComp; ++k)
+    {
+    value[k] = itk::NumericTraits<ScalarRealType>::Zero;
+    }
+
+  // Direct access to the buffer: pixels are stored line by line, with
+  // their components contiguous
+  const InternalPixelType * buffer = image->GetBufferPointer();
+  const IndexType bufferStart = image->GetBufferedRegion().GetIndex();
+  const IndexValueType lineStride = static_cast<IndexValueType>(image->GetBufferedRegion().GetSize()[0]);
+
+  const IndexValueType radius = static_cast<IndexValueType>(m_Radius);
+
+  for (unsigned int j = 0; j < m_WinSize; ++j)
+    {
+    const double wy = weights[1][j];
+    if (wy == 0.)
+      {
+      continue;
+      }
+
+    IndexValueType y = baseIndex[1] + static_cast<IndexValueType>(j) - radius;
+    if (y > this->m_EndIndex[1])
+      {
+      y = this->m_EndIndex[1];
+      }
+    if (y < this->m_StartIndex[1])
+      {
+      y = this->m_StartIndex[1];
+      }
+    const InternalPixelType * line = buffer + (y - bufferStart[1]) * lineStride * nbComp;
+
+    for (unsigned int i = 0; i < m_WinSize; ++i)
+      {
+      const double w = weights[0][i] * wy;
+      if (w == 0.)
+        {
+        continue;
+        }
+
+      IndexValueType x = baseIndex[0] + static_cast<IndexValueType>(i) - radius;
+      if (x > this->m_EndIndex[0])
+        {
+        x = this->m_EndIndex[0];
+        }
+      if (x < this->m_StartIndex[0])
+        {
+        x = this->m_StartIndex[0];
+        }
+      const InternalPixelType * pixel = line + (x - bufferStart[0]) * nbComp;
+
+      for (unsigned int k = 0; k < nbComp; ++k)
+        {
+        value[k] += w * static_cast<ScalarRealType>(pixel[k]);
+        }
+      }
+    }
+
+  return output;
+}
+
+} //namespace otb
+
+#endif
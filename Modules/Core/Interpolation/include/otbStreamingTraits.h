@@ -30,6 +30,7 @@
 #include "otbWindowedSincInterpolateImageLanczosFunction.h"
 #include "otbWindowedSincInterpolateImageBlackmanFunction.h"
 #include "otbBCOInterpolateImageFunction.h"
+#include "otbSeparableLUTInterpolateImageFunction.h"
 
 #include "otbProlateInterpolateImageFunction.h"
 
@@ -75,6 +76,7 @@ public:
   typedef WindowedSincInterpolateImageBlackmanFunction<ImageType>         BlackmanInterpolationType;
   typedef ProlateInterpolateImageFunction<ImageType>                      ProlateInterpolationType;
   typedef BCOInterpolateImageFunction<ImageType>                          BCOInterpolationType;
+  typedef SeparableLUTInterpolateImageFunctionBase<ImageType>             SeparableLUTInterpolationType;
 
   static unsigned int CalculateNeededRadiusForInterpolator(const InterpolationType* interpolator);
 };
@@ -111,6 +113,7 @@ public:
   // OTB Interpolators (supported for otb::VectorImage)
   typedef WindowedSincInterpolateImageGaussianFunction<ImageType>         GaussianInterpolationType;
   typedef BCOInterpolateImageFunction<ImageType>                          BCOInterpolationType;
+  typedef SeparableLUTInterpolateImageFunctionBase<ImageType>             SeparableLUTInterpolationType;
 
   static unsigned int CalculateNeededRadiusForInterpolator(const InterpolationType* interpolator);
 };
@@ -86,6 +86,11 @@ unsigned int StreamingTraits<TImage>
     otbMsgDevMacro(<< "BCO Interpolator");
     neededRadius = dynamic_cast<const BCOInterpolationType *>(interpolator)->GetRadius();
     }
+  else if (dynamic_cast<const SeparableLUTInterpolationType *>(interpolator) != NULL)
+    {
+    otbMsgDevMacro(<< "Separable LUT Interpolator");
+    neededRadius = dynamic_cast<const SeparableLUTInterpolationType *>(interpolator)->GetRadius();
+    }
   return neededRadius;
 }
 
@@ -123,6 +128,11 @@ unsigned int StreamingTraits< otb::VectorImage<TPixel, VImageDimension> >
     otbMsgDevMacro(<< "BCO Interpolator");
     neededRadius = dynamic_cast<const BCOInterpolationType *>(interpolator)->GetRadius();
     }
+  else if (dynamic_cast<const SeparableLUTInterpolationType *>(interpolator) != NULL)
+    {
+    otbMsgDevMacro(<< "Separable LUT Interpolator");
+    neededRadius = dynamic_cast<const SeparableLUTInterpolationType *>(interpolator)->GetRadius();
+    }
 
   return neededRadius;
 }
@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "itkMacro.h"
+
+#include "otbBCOLUTInterpolateImageFunction.h"
+#include "otbBCOInterpolateImageFunction.h"
+#include "otbWindowedSincInterpolateImageLanczosFunction.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbStreamingResampleImageFilter.h"
+
+
+int otbBCOLUTInterpolateImageFunctionNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::Image<double, 2>                                   ImageType;
+  typedef otb::VectorImage<double, 2>                             VectorImageType;
+  typedef otb::BCOLUTInterpolateImageFunction<ImageType, double>  InterpolatorType;
+  typedef otb::BCOLUTInterpolateImageFunction<VectorImageType>    VectorInterpolatorType;
+
+  // Instantiating objects
+  InterpolatorType::Pointer interp = InterpolatorType::New();
+  VectorInterpolatorType::Pointer vinterp = VectorInterpolatorType::New();
+
+  std::cout << interp << std::endl;
+  std::cout << vinterp << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+/** Compare the look-up table implementation with the direct BCO and
+ *  Lanczos interpolators on a regular grid of sub-pixel positions */
+int otbBCOLUTInterpolateImageFunctionCompare(int itkNotUsed(argc), char * argv[])
+{
+  const char * infname      = argv[1];
+  const unsigned int radius = atoi(argv[2]);
+  const double alpha        = atof(argv[3]);
+  const double tolerance    = atof(argv[4]);
+
+  typedef otb::VectorImage<double, 2>                                      ImageType;
+  typedef otb::ImageFileReader<ImageType>                                  ReaderType;
+  typedef otb::BCOInterpolateImageFunction<ImageType, double>              BCOInterpolatorType;
+  typedef otb::BCOLUTInterpolateImageFunction<ImageType, double>           BCOLUTInterpolatorType;
+  typedef otb::SeparableLUTInterpolateImageFunction
+    <ImageType, otb::Function::LanczosWindowFunction<>, double>            LanczosLUTInterpolatorType;
+  typedef otb::WindowedSincInterpolateImageLanczosFunction<ImageType>      LanczosInterpolatorType;
+  typedef BCOInterpolatorType::ContinuousIndexType                         ContinuousIndexType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+  reader->Update();
+
+  BCOInterpolatorType::Pointer bco = BCOInterpolatorType::New();
+  bco->SetRadius(radius);
+  bco->SetAlpha(alpha);
+  bco->SetInputImage(reader->GetOutput());
+
+  BCOLUTInterpolatorType::Pointer bcoLUT = BCOLUTInterpolatorType::New();
+  bcoLUT->SetRadius(radius);
+  bcoLUT->SetAlpha(alpha);
+  bcoLUT->SetInputImage(reader->GetOutput());
+
+  LanczosInterpolatorType::Pointer lanczos = LanczosInterpolatorType::New();
+  lanczos->SetInputImage(reader->GetOutput());
+  lanczos->SetRadius(radius);
+  lanczos->Initialize();
+
+  LanczosLUTInterpolatorType::Pointer lanczosLUT = LanczosLUTInterpolatorType::New();
+  lanczosLUT->SetRadius(radius);
+  lanczosLUT->NormalizeWeightsOff();
+  lanczosLUT->SetInputImage(reader->GetOutput());
+
+  const ImageType::SizeType size = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
+  const unsigned int nbComp = reader->GetOutput()->GetNumberOfComponentsPerPixel();
+
+  // Positions far enough from the borders so that boundary conditions
+  // do not interfere
+  double maxBCOError = 0.;
+  double maxLanczosError = 0.;
+  for (double y = radius + 1; y < size[1] - radius - 1; y += 3.37)
+    {
+    for (double x = radius + 1; x < size[0] - radius - 1; x += 2.91)
+      {
+      ContinuousIndexType idx;
+      idx[0] = x;
+      idx[1] = y;
+
+      BCOInterpolatorType::OutputType ref = bco->EvaluateAtContinuousIndex(idx);
+      BCOInterpolatorType::OutputType res = bcoLUT->EvaluateAtContinuousIndex(idx);
+      LanczosInterpolatorType::OutputType lref = lanczos->EvaluateAtContinuousIndex(idx);
+      LanczosInterpolatorType::OutputType lres = lanczosLUT->EvaluateAtContinuousIndex(idx);
+
+      for (unsigned int k = 0; k < nbComp; ++k)
+        {
+        maxBCOError = std::max(maxBCOError, vcl_abs(ref[k] - res[k]));
+        maxLanczosError = std::max(maxLanczosError, vcl_abs(lref[k] - lres[k]));
+        }
+      }
+    }
+
+  std::cout << "Max BCO error: " << maxBCOError << std::endl;
+  std::cout << "Max Lanczos error: " << maxLanczosError << std::endl;
+
+  if (maxBCOError > tolerance || maxLanczosError > tolerance)
+    {
+    std::cerr << "Look-up table interpolation differs from direct evaluation (tolerance " << tolerance << ")"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbBCOLUTInterpolateImageFunctionVectorImageTest(int itkNotUsed(argc), char * argv[])
+{
+  const char * infname      = argv[1];
+  const char * outfname     = argv[2];
+  const unsigned int radius = atoi(argv[3]);
+  const double alpha        = atof(argv[4]);
+
+  typedef otb::VectorImage<double, 2>                                      ImageType;
+  typedef otb::ImageFileReader<ImageType>                                  ReaderType;
+  typedef otb::StreamingResampleImageFilter<ImageType, ImageType, double>  StreamingResampleImageFilterType;
+  typedef otb::BCOLUTInterpolateImageFunction<ImageType, double>           InterpolatorType;
+  typedef otb::ImageFileWriter<ImageType>                                  WriterType;
+
+  // Instantiating objects
+  ReaderType::Pointer                         reader = ReaderType::New();
+  WriterType::Pointer                         writer = WriterType::New();
+  StreamingResampleImageFilterType::Pointer   resampler = StreamingResampleImageFilterType::New();
+  InterpolatorType::Pointer                   interpolator = InterpolatorType::New();
+
+  reader->SetFileName(infname);
+
+  interpolator->SetRadius(radius);
+  interpolator->SetAlpha(alpha);
+
+  resampler->SetInput(reader->GetOutput());
+  resampler->SetInterpolator(interpolator);
+  StreamingResampleImageFilterType::SizeType size;
+  size[0] = 256;
+  size[1] = 256;
+  resampler->SetOutputSize(size);
+  resampler->SetOutputSpacing(2);
+
+  writer->SetInput(resampler->GetOutput());
+  writer->SetFileName(outfname);
+  writer->SetNumberOfDivisionsStrippedStreaming(4);
+  writer->Update();
+
+  return EXIT_SUCCESS;
+}
@@ -29,6 +29,9 @@ void RegisterTests()
   REGISTER_TEST(otbBCOInterpolateImageFunctionOverVectorImage);
   REGISTER_TEST(otbBCOInterpolateImageFunctionTest);
   REGISTER_TEST(otbBCOInterpolateImageFunctionVectorImageTest);
+  REGISTER_TEST(otbBCOLUTInterpolateImageFunctionNew);
+  REGISTER_TEST(otbBCOLUTInterpolateImageFunctionCompare);
+  REGISTER_TEST(otbBCOLUTInterpolateImageFunctionVectorImageTest);
   REGISTER_TEST(otbProlateInterpolateImageFunction);
   REGISTER_TEST(otbProlateValidationTest);
 }
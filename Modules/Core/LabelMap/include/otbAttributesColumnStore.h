@@ -0,0 +1,296 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbAttributesColumnStore_h
+#define __otbAttributesColumnStore_h
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMutexLockHolder.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class AttributesColumnStore
+ *  \brief Columnar storage of the attributes of a set of label objects
+ *
+ *  The attributes names are interned: each name gets an integer id
+ *  (GetAttributeId()), and the values of an attribute are stored in one
+ *  contiguous array, indexed by the row of the label object. Values which
+ *  have never been set are flagged as undefined.
+ *
+ *  Threading contract:
+ *  - AddRows(), Consolidate() and the destruction of the store must be
+ *    called from non-threaded code;
+ *  - GetAttributeId(), FindAttributeId(), SetValue() and GetValue() can
+ *    be called concurrently, as long as two threads do not write the same
+ *    row. Names interned since the last Consolidate() are looked up under
+ *    a lock, the others without any synchronisation.
+ *
+ * \sa AttributesColumnsLabelObject
+ *
+ * \ingroup OTBLabelMap
+ */
+template <class TValue>
+class ITK_EXPORT AttributesColumnStore : public itk::LightObject
+{
+public:
+  /** Standard class typedefs */
+  typedef AttributesColumnStore         Self;
+  typedef itk::LightObject              Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(AttributesColumnStore, LightObject);
+
+  typedef TValue        ValueType;
+  typedef unsigned int  AttributeIdType;
+  typedef unsigned long RowIdType;
+
+  /** Maximum number of distinct attributes in a store */
+  itkStaticConstMacro(MaximumNumberOfAttributes, unsigned int, 4096);
+
+  /** Id of the attribute name, which is interned if it is new */
+  AttributeIdType GetAttributeId(const std::string& name)
+  {
+    AttributeIdType id;
+    if (this->FindConsolidatedId(name, id))
+      {
+      return id;
+      }
+
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+    typename NameMapType::const_iterator it = m_PendingIds.find(name);
+    if (it != m_PendingIds.end())
+      {
+      return it->second;
+      }
+
+    id = static_cast<AttributeIdType>(m_Names.size());
+    if (id >= MaximumNumberOfAttributes)
+      {
+      itkExceptionMacro(<< "Can not store more than " << MaximumNumberOfAttributes
+                        << " attributes (adding " << name << ")");
+      }
+    unsigned int segment, offset;
+    Self::LocateColumn(id, segment, offset);
+    if (offset == 0)
+      {
+      m_Segments[segment] = new Column *[1u << segment];
+      }
+    Column * column = new Column;
+    column->Values.resize(m_NumberOfRows);
+    column->Defined.resize(m_NumberOfRows, 0);
+    m_Segments[segment][offset] = column;
+    m_Names.push_back(name);
+    m_PendingIds[name] = id;
+    return id;
+  }
+
+  /** Look for the id of an attribute. Returns false if the name has
+   *  never been interned. */
+  bool FindAttributeId(const std::string& name, AttributeIdType& id) const
+  {
+    if (this->FindConsolidatedId(name, id))
+      {
+      return true;
+      }
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+    typename NameMapType::const_iterator it = m_PendingIds.find(name);
+    if (it == m_PendingIds.end())
+      {
+      return false;
+      }
+    id = it->second;
+    return true;
+  }
+
+  /** Name of an attribute */
+  std::string GetAttributeName(AttributeIdType id) const
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+    if (id >= m_Names.size())
+      {
+      itkExceptionMacro(<< "Invalid attribute id " << id);
+      }
+    return m_Names[id];
+  }
+
+  /** Number of interned attributes */
+  unsigned int GetNumberOfAttributes() const
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+    return m_Names.size();
+  }
+
+  /** Add rows to all the columns, with undefined values. Returns the
+   *  index of the first new row. Not thread safe. */
+  RowIdType AddRows(RowIdType nbRows)
+  {
+    const RowIdType first = m_NumberOfRows;
+    m_NumberOfRows += nbRows;
+    for (unsigned int id = 0; id < m_Names.size(); ++id)
+      {
+      Column * column = this->GetColumnPointer(id);
+      column->Values.resize(m_NumberOfRows);
+      column->Defined.resize(m_NumberOfRows, 0);
+      }
+    return first;
+  }
+
+  /** Number of rows of the columns */
+  RowIdType GetNumberOfRows() const
+  {
+    return m_NumberOfRows;
+  }
+
+  /** Set a value */
+  void SetValue(AttributeIdType id, RowIdType row, ValueType value)
+  {
+    Column * column = this->GetColumnPointer(id);
+    column->Values[row] = value;
+    column->Defined[row] = 1;
+  }
+
+  /** Get a value (undefined values are default constructed) */
+  ValueType GetValue(AttributeIdType id, RowIdType row) const
+  {
+    return this->GetColumnPointer(id)->Values[row];
+  }
+
+  /** Has the value been set ? */
+  bool IsDefined(AttributeIdType id, RowIdType row) const
+  {
+    return this->GetColumnPointer(id)->Defined[row] != 0;
+  }
+
+  /** The contiguous array of the values of an attribute, with
+   *  GetNumberOfRows() elements */
+  const ValueType * GetColumn(AttributeIdType id) const
+  {
+    const Column * column = this->GetColumnPointer(id);
+    return column->Values.empty() ? NULL : &column->Values[0];
+  }
+
+  /** Make the names interned since the last call visible to the lock-free
+   *  lookups. Not thread safe. */
+  void Consolidate()
+  {
+    m_ConsolidatedIds.insert(m_PendingIds.begin(), m_PendingIds.end());
+    m_PendingIds.clear();
+  }
+
+protected:
+  AttributesColumnStore() : m_NumberOfRows(0)
+  {
+    std::fill(m_Segments, m_Segments + NumberOfSegments, static_cast<Column **>(NULL));
+  }
+
+  virtual ~AttributesColumnStore()
+  {
+    for (unsigned int id = 0; id < m_Names.size(); ++id)
+      {
+      delete this->GetColumnPointer(id);
+      }
+    for (unsigned int segment = 0; segment < NumberOfSegments; ++segment)
+      {
+      delete[] m_Segments[segment];
+      }
+  }
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "NumberOfRows: " << m_NumberOfRows << std::endl;
+    os << indent << "NumberOfAttributes: " << this->GetNumberOfAttributes() << std::endl;
+  }
+
+private:
+  AttributesColumnStore(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  typedef std::map<std::string, AttributeIdType> NameMapType;
+
+  struct Column
+  {
+    std::vector<ValueType> Values;
+    // char rather than bool, so that threads can write neighbour rows
+    std::vector<char>      Defined;
+  };
+
+  /** The columns are stored in segments of 1, 2, 4, ... pointers: the
+   *  column of id lies in the segment floor(log2(id + 1)) */
+  itkStaticConstMacro(NumberOfSegments, unsigned int, 13);
+
+  static void LocateColumn(AttributeIdType id, unsigned int& segment, unsigned int& offset)
+  {
+    const unsigned int position = id + 1;
+    segment = 0;
+    while (position >> (segment + 1))
+      {
+      ++segment;
+      }
+    offset = position - (1u << segment);
+  }
+
+  Column * GetColumnPointer(AttributeIdType id) const
+  {
+    unsigned int segment, offset;
+    Self::LocateColumn(id, segment, offset);
+    return m_Segments[segment][offset];
+  }
+
+  bool FindConsolidatedId(const std::string& name, AttributeIdType& id) const
+  {
+    typename NameMapType::const_iterator it = m_ConsolidatedIds.find(name);
+    if (it == m_ConsolidatedIds.end())
+      {
+      return false;
+      }
+    id = it->second;
+    return true;
+  }
+
+  RowIdType m_NumberOfRows;
+
+  /** Ids of the names, only modified by Consolidate() */
+  NameMapType m_ConsolidatedIds;
+
+  /** Ids of the names interned since the last Consolidate(), protected
+   *  by m_Mutex as well as m_Names */
+  NameMapType                      m_PendingIds;
+  std::vector<std::string>         m_Names;
+  mutable itk::SimpleFastMutexLock m_Mutex;
+
+  /** Columns, indexed by attribute id. The segments are allocated as the
+   *  attributes are interned, and never reallocated, so that the columns
+   *  can be read while a new one is added. */
+  Column ** m_Segments[NumberOfSegments];
+};
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,516 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbAttributesColumnsLabelObject_h
+#define __otbAttributesColumnsLabelObject_h
+
+#include "itkLabelObject.h"
+#include "itkLabelMap.h"
+#include "otbPolygon.h"
+#include "otbAttributesColumnStore.h"
+#include <algorithm>
+
+namespace otb
+{
+
+/** \class AttributesColumnsLabelObject
+ *  \brief A LabelObject storing its attributes in a shared column store
+ *
+ *  This class offers the same interface as AttributesMapLabelObject, but
+ *  its attributes are stored in the row GetRow() of an
+ *  AttributesColumnStore, usually shared by all the objects of a label
+ *  map: the attributes names are interned once for all the objects, and
+ *  the values of an attribute are contiguous in memory.
+ *
+ *  The attributes filters deriving from LabelMapFeaturesFunctorImageFilter
+ *  attach all the objects of their output to one store (see
+ *  AttributesColumnsTraits). An object which is not attached to a store
+ *  creates a private one the first time an attribute is set.
+ *
+ *  SetAttribute() and GetAttribute() also accept the id of an attribute in
+ *  the store (see AttributesColumnStore::GetAttributeId()), which avoids
+ *  the name lookup.
+ *
+ * \sa AttributesMapLabelObject, AttributesColumnStore
+ *
+ * \ingroup DataRepresentation
+ *
+ * \ingroup OTBLabelMap
+ */
+template <class TLabel, unsigned int VImageDimension, class TAttributesValue>
+class ITK_EXPORT AttributesColumnsLabelObject
+  : public itk::LabelObject<TLabel, VImageDimension>
+{
+public:
+  /** Standard class typedefs */
+  typedef AttributesColumnsLabelObject              Self;
+  typedef itk::LabelObject<TLabel, VImageDimension> Superclass;
+  typedef typename Superclass::LabelObjectType      LabelObjectType;
+  typedef itk::SmartPointer<Self>                   Pointer;
+  typedef itk::SmartPointer<const Self>             ConstPointer;
+  typedef itk::WeakPointer <const Self>             ConstWeakPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(AttributesColumnsLabelObject, LabelObject);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, VImageDimension);
+
+  /// Type of a label map using an AttributesColumnsLabelObject
+  typedef itk::LabelMap<Self> LabelMapType;
+
+  /// Template parameters typedef
+  typedef TLabel           LabelType;
+  typedef TAttributesValue AttributesValueType;
+
+  // Convenient inherited typedefs
+  typedef typename Superclass::IndexType         IndexType;
+  typedef typename Superclass::LineType          LineType;
+  typedef typename Superclass::LengthType        LengthType;
+
+  /// Column store typedefs
+  typedef AttributesColumnStore<AttributesValueType> AttributesStoreType;
+  typedef typename AttributesStoreType::Pointer      AttributesStorePointerType;
+  typedef typename AttributesStoreType::AttributeIdType AttributeIdType;
+  typedef typename AttributesStoreType::RowIdType    RowIdType;
+
+  // The polygon corresponding to the label object
+  typedef Polygon<double>               PolygonType;
+  typedef typename PolygonType::Pointer PolygonPointerType;
+
+  /**
+   * Set an attribute value.
+   * If the key name already exists, the value is overwritten.
+   */
+  void SetAttribute(const char * name, AttributesValueType value)
+  {
+    this->SetAttribute(std::string(name), value);
+  }
+
+  /**
+   * Set an attribute value.
+   * If the key name already exists, the value is overwritten.
+   */
+  void SetAttribute(const std::string& name, AttributesValueType value)
+  {
+    if (m_Store.IsNull())
+      {
+      this->SetAttributesStore(AttributesStoreType::New(), 0);
+      }
+    m_Store->SetValue(m_Store->GetAttributeId(name), m_Row, value);
+  }
+
+  /**
+   * Set an attribute value from its id in the store
+   */
+  void SetAttribute(AttributeIdType id, AttributesValueType value)
+  {
+    m_Store->SetValue(id, m_Row, value);
+  }
+
+  /**
+   * Returns the attribute corresponding to name
+   */
+  AttributesValueType GetAttribute(const char * name) const
+  {
+    AttributeIdType id;
+    if (m_Store.IsNull() || !m_Store->FindAttributeId(name, id) || !m_Store->IsDefined(id, m_Row))
+      {
+      itkExceptionMacro(<< "Could not find attribute named " << name);
+      }
+    return m_Store->GetValue(id, m_Row);
+  }
+
+  /**
+   * Returns the attribute corresponding to id in the store
+   */
+  AttributesValueType GetAttribute(AttributeIdType id) const
+  {
+    return m_Store->GetValue(id, m_Row);
+  }
+
+  /**
+   * Has the attribute been set ?
+   */
+  bool HasAttribute(const char * name) const
+  {
+    AttributeIdType id;
+    return m_Store.IsNotNull() && m_Store->FindAttributeId(name, id) && m_Store->IsDefined(id, m_Row);
+  }
+
+  /**
+   * Returns the total number of attributes
+   */
+  unsigned int GetNumberOfAttributes() const
+  {
+    return this->GetAvailableAttributes().size();
+  }
+
+  /**
+   * Returns the list of available attributes, in alphabetical order
+   */
+  std::vector<std::string> GetAvailableAttributes() const
+  {
+    std::vector<std::string> attributesNames;
+    if (m_Store.IsNull())
+      {
+      return attributesNames;
+      }
+    const unsigned int nbAttributes = m_Store->GetNumberOfAttributes();
+    for (AttributeIdType id = 0; id < nbAttributes; ++id)
+      {
+      if (m_Store->IsDefined(id, m_Row))
+        {
+        attributesNames.push_back(m_Store->GetAttributeName(id));
+        }
+      }
+    std::sort(attributesNames.begin(), attributesNames.end());
+    return attributesNames;
+  }
+
+  /** The store holding the attributes (NULL if none has been set) */
+  AttributesStoreType * GetAttributesStore() const
+  {
+    return m_Store;
+  }
+
+  /** The row of the object in its store */
+  RowIdType GetRow() const
+  {
+    return m_Row;
+  }
+
+  /**
+   * Move the object to the row of a store. The attributes already set are
+   * copied to the new store. Not thread safe.
+   */
+  void SetAttributesStore(AttributesStoreType * store, RowIdType row)
+  {
+    if (store == m_Store.GetPointer() && row == m_Row)
+      {
+      return;
+      }
+    if (row >= store->GetNumberOfRows())
+      {
+      store->AddRows(row + 1 - store->GetNumberOfRows());
+      }
+    if (m_Store.IsNotNull())
+      {
+      const unsigned int nbAttributes = m_Store->GetNumberOfAttributes();
+      for (AttributeIdType id = 0; id < nbAttributes; ++id)
+        {
+        if (m_Store->IsDefined(id, m_Row))
+          {
+          store->SetValue(store->GetAttributeId(m_Store->GetAttributeName(id)), row, m_Store->GetValue(id, m_Row));
+          }
+        }
+      }
+    m_Store = store;
+    m_Row = row;
+  }
+
+  /**
+  * This method is overloaded to add the copy of the attributes.
+  */
+  virtual void CopyAttributesFrom(const LabelObjectType * lo)
+  {
+    Superclass::CopyAttributesFrom(lo);
+
+    // copy the data of the current type if possible
+    const Self * src = dynamic_cast<const Self *>(lo);
+    if (src == NULL || src->m_Store.IsNull())
+      {
+      return;
+      }
+    if (m_Store.IsNull())
+      {
+      this->SetAttributesStore(AttributesStoreType::New(), 0);
+      }
+    const unsigned int nbAttributes = src->m_Store->GetNumberOfAttributes();
+    for (AttributeIdType id = 0; id < nbAttributes; ++id)
+      {
+      if (src->m_Store->IsDefined(id, src->m_Row))
+        {
+        m_Store->SetValue(m_Store->GetAttributeId(src->m_Store->GetAttributeName(id)), m_Row,
+                          src->m_Store->GetValue(id, src->m_Row));
+        }
+      }
+  }
+
+  /** Return the polygon (const version) */
+  const PolygonType * GetPolygon() const
+  {
+    return m_Polygon;
+  }
+
+  /** Return the polygon (non const version) */
+  PolygonType * GetPolygon()
+  {
+    return m_Polygon;
+  }
+
+  /** Set the polygon */
+  void SetPolygon(PolygonType* p)
+  {
+    m_Polygon = p;
+  }
+
+protected:
+  /** Constructor */
+  AttributesColumnsLabelObject() : m_Store(), m_Row(0), m_Polygon(PolygonType::New()) {}
+  /** Destructor */
+  virtual ~AttributesColumnsLabelObject() {}
+
+  /** The printself method */
+  void PrintSelf(std::ostream& os, itk::Indent indent) const
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Row: " << m_Row << std::endl;
+    os << indent << "Attributes: " << std::endl;
+    std::vector<std::string> attributes = this->GetAvailableAttributes();
+    for (std::vector<std::string>::const_iterator it = attributes.begin();
+         it != attributes.end(); ++it)
+      {
+      os << indent << indent << *it << " = " << this->GetAttribute(it->c_str()) << std::endl;
+      }
+  }
+private:
+  AttributesColumnsLabelObject(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** The store of the attributes, and the row of the object */
+  AttributesStorePointerType m_Store;
+  RowIdType                  m_Row;
+
+  /** The polygon corresponding to the label object. Caution, this
+   *  will be empty by default */
+  PolygonPointerType m_Polygon;
+};
+
+namespace Functor
+{
+
+/** \class AttributesColumnsMeasurementFunctor
+*   \brief Builds a measurement vector from an AttributesColumnsLabelObject
+*
+*   This is the counterpart of AttributesMapMeasurementFunctor: the
+*   attributes names are resolved once per store, then the measurement
+*   vector is gathered from the columns by id.
+ *
+ * \ingroup OTBLabelMap
+*/
+template<class TLabelObject, class TMeasurementVector>
+class AttributesColumnsMeasurementFunctor
+{
+public:
+  typedef std::vector<std::string>                        AttributesListType;
+  typedef typename TLabelObject::AttributesStoreType      AttributesStoreType;
+  typedef typename AttributesStoreType::AttributeIdType   AttributeIdType;
+
+  AttributesColumnsMeasurementFunctor() : m_Store() {}
+
+  inline TMeasurementVector operator()(const TLabelObject * object) const
+  {
+    const AttributesStoreType * store = object->GetAttributesStore();
+    if (store == NULL)
+      {
+      itkGenericExceptionMacro(<< "Label object " << object->GetLabel() << " has no attribute");
+      }
+    if (store != m_Store.GetPointer())
+      {
+      this->ResolveIds(store);
+      }
+
+    TMeasurementVector newSample(m_Attributes.size());
+    const typename TLabelObject::RowIdType row = object->GetRow();
+    for (unsigned int attrIndex = 0; attrIndex < m_Ids.size(); ++attrIndex)
+      {
+      if (!store->IsDefined(m_Ids[attrIndex], row))
+        {
+        itkGenericExceptionMacro(<< "Could not find attribute named " << m_Attributes[attrIndex]);
+        }
+      newSample[attrIndex] = store->GetValue(m_Ids[attrIndex], row);
+      }
+    return newSample;
+  }
+
+  /** Add an attribute to the exported attributes list */
+  void AddAttribute(const char * attr)
+  {
+    m_Attributes.push_back(attr);
+    m_Store = NULL;
+  }
+
+  /** Remove an attribute from the exported attributes list */
+  void RemoveAttribute(const char * attr)
+  {
+    AttributesListType::iterator elt = std::find(m_Attributes.begin(), m_Attributes.end(), attr);
+    if(elt!=m_Attributes.end())
+      {
+      m_Attributes.erase(elt);
+      m_Store = NULL;
+      }
+  }
+
+  /** Remove all attributes from the exported attributes list */
+  void ClearAttributes()
+  {
+    m_Attributes.clear();
+    m_Store = NULL;
+  }
+
+  /** Get The number of exported attributes */
+  unsigned int GetNumberOfAttributes()
+  {
+    return m_Attributes.size();
+  }
+
+private:
+  void ResolveIds(const AttributesStoreType * store) const
+  {
+    m_Ids.resize(m_Attributes.size());
+    for (unsigned int attrIndex = 0; attrIndex < m_Attributes.size(); ++attrIndex)
+      {
+      if (!store->FindAttributeId(m_Attributes[attrIndex], m_Ids[attrIndex]))
+        {
+        itkGenericExceptionMacro(<< "Could not find attribute named " << m_Attributes[attrIndex]);
+        }
+      }
+    m_Store = store;
+  }
+
+  AttributesListType m_Attributes;
+
+  /** Ids of the attributes in the last store met (held, so that its
+   *  address can not be reused by another store) */
+  mutable typename AttributesStoreType::ConstPointer m_Store;
+  mutable std::vector<AttributeIdType>               m_Ids;
+};
+
+} // end namespace Functor
+
+/** \class AttributesColumnsTraits
+ *  \brief Attaches the objects of a label map to a shared column store
+ *
+ *  LabelMapFeaturesFunctorImageFilter uses these traits before processing
+ *  the objects in parallel. Label objects other than
+ *  AttributesColumnsLabelObject store their attributes by themselves, and
+ *  nothing is done.
+ *
+ * \ingroup OTBLabelMap
+ */
+template <class TLabelObject>
+struct AttributesColumnsTraits
+{
+  /** Attach the objects to one store. Returns false if the objects do not
+   *  use a column store. */
+  template <class TLabelMap>
+  static bool AttachLabelObjects(TLabelMap *)
+  {
+    return false;
+  }
+
+  /** Intern the attributes of probe in the store of the objects */
+  template <class TLabelMap>
+  static void InternAttributes(TLabelMap *, const TLabelObject *)
+  {
+  }
+
+  /** Consolidate the store of the objects */
+  template <class TLabelMap>
+  static void Consolidate(TLabelMap *)
+  {
+  }
+};
+
+template <class TLabel, unsigned int VImageDimension, class TAttributesValue>
+struct AttributesColumnsTraits<AttributesColumnsLabelObject<TLabel, VImageDimension, TAttributesValue> >
+{
+  typedef AttributesColumnsLabelObject<TLabel, VImageDimension, TAttributesValue> LabelObjectType;
+  typedef typename LabelObjectType::AttributesStoreType                           AttributesStoreType;
+
+  template <class TLabelMap>
+  static bool AttachLabelObjects(TLabelMap * labelMap)
+  {
+    const unsigned long nbObjects = labelMap->GetNumberOfLabelObjects();
+    if (nbObjects == 0)
+      {
+      return true;
+      }
+
+    // Keep the store if the objects already share one
+    AttributesStoreType * store = labelMap->GetNthLabelObject(0)->GetAttributesStore();
+    std::vector<char>     rowUsed(store != NULL ? store->GetNumberOfRows() : 0, 0);
+    bool                  shared = (store != NULL);
+    for (typename TLabelMap::Iterator it(labelMap); shared && !it.IsAtEnd(); ++it)
+      {
+      LabelObjectType * lo = it.GetLabelObject();
+      shared = (lo->GetAttributesStore() == store && !rowUsed[lo->GetRow()]);
+      if (shared)
+        {
+        rowUsed[lo->GetRow()] = 1;
+        }
+      }
+    if (shared)
+      {
+      return true;
+      }
+
+    typename AttributesStoreType::Pointer newStore = AttributesStoreType::New();
+    newStore->AddRows(nbObjects);
+    typename LabelObjectType::RowIdType row = 0;
+    for (typename TLabelMap::Iterator it(labelMap); !it.IsAtEnd(); ++it, ++row)
+      {
+      it.GetLabelObject()->SetAttributesStore(newStore, row);
+      }
+    newStore->Consolidate();
+    return true;
+  }
+
+  template <class TLabelMap>
+  static void InternAttributes(TLabelMap * labelMap, const LabelObjectType * probe)
+  {
+    if (labelMap->GetNumberOfLabelObjects() > 0)
+      {
+      AttributesStoreType *    store = labelMap->GetNthLabelObject(0)->GetAttributesStore();
+      std::vector<std::string> names = probe->GetAvailableAttributes();
+      for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        {
+        store->GetAttributeId(*it);
+        }
+      store->Consolidate();
+      }
+  }
+
+  template <class TLabelMap>
+  static void Consolidate(TLabelMap * labelMap)
+  {
+    if (labelMap->GetNumberOfLabelObjects() > 0)
+      {
+      AttributesStoreType * store = labelMap->GetNthLabelObject(0)->GetAttributesStore();
+      if (store != NULL)
+        {
+        store->Consolidate();
+        }
+      }
+  }
+};
+
+} // end namespace otb
+#endif
@@ -270,9 +270,6 @@ void
 BandsStatisticsAttributesLabelMapFilter<TImage, TFeatureImage>
 ::BeforeThreadedGenerateData()
 {
-  // First call superclass implementation
-  Superclass::BeforeThreadedGenerateData();
-
   unsigned long nbComponents = this->GetFeatureImage()->GetNumberOfComponentsPerPixel();
 
   // Clear any previous feature
@@ -295,6 +292,10 @@ BandsStatisticsAttributesLabelMapFilter<TImage, TFeatureImage>
     this->GetFunctor().AddFeature(oss.str(), band->GetOutput());
 
     }
+
+  // Superclass implementation may apply the functor, which is now
+  // configured
+  Superclass::BeforeThreadedGenerateData();
 }
 
 template <class TImage, class TFeatureImage>
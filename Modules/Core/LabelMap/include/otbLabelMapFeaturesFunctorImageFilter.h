@@ -22,6 +22,7 @@
 #define __otbLabelMapFeaturesFunctorImageFilter_h
 
 #include "itkInPlaceLabelMapFilter.h"
+#include "otbAttributesColumnsLabelObject.h"
 
 namespace otb {
 
@@ -31,7 +32,13 @@ namespace otb {
  *  The functor is applied on each LabelObject, enriching the
  *  available features.
  *
- *  The LabelObject type must be an AttributeMapLabelObject.
+ *  The LabelObject type must be an AttributeMapLabelObject or an
+ *  AttributesColumnsLabelObject. In the latter case, all the objects of
+ *  the output are attached to one column store before the threaded
+ *  processing, and the functor is applied once on a copy of the first
+ *  object to intern the attributes names: the objects are then processed
+ *  in parallel without any lock. Subclasses must therefore configure the
+ *  functor before calling Superclass::BeforeThreadedGenerateData().
  *
  *  This filter can not be instanciated on its own, since its purpose
  *  is to provide a base class for all LabelMap attributes enriching filters
@@ -98,6 +105,32 @@ protected:
   /** Destructor */
   ~LabelMapFeaturesFunctorImageFilter() {}
 
+  /** Attach the objects to a column store if needed */
+  virtual void BeforeThreadedGenerateData()
+  {
+    Superclass::BeforeThreadedGenerateData();
+
+    ImageType * output = this->GetOutput();
+    if (AttributesColumnsTraits<LabelObjectType>::AttachLabelObjects(output)
+        && output->GetNumberOfLabelObjects() > 0)
+      {
+      // Apply the functor on a copy of the first object, so that the
+      // threads find the attributes names already interned in the store
+      typename LabelObjectType::Pointer probe = LabelObjectType::New();
+      probe->CopyAllFrom(output->GetNthLabelObject(0));
+      this->ThreadedProcessLabelObject(probe);
+      AttributesColumnsTraits<LabelObjectType>::InternAttributes(output, probe.GetPointer());
+      }
+  }
+
+  /** Make the attributes names interned by the threads visible to the
+   * lock-free lookups */
+  virtual void AfterThreadedGenerateData()
+  {
+    Superclass::AfterThreadedGenerateData();
+    AttributesColumnsTraits<LabelObjectType>::Consolidate(this->GetOutput());
+  }
+
   /** Threaded generate data */
   virtual void ThreadedProcessLabelObject(LabelObjectType * labelObject)
   {
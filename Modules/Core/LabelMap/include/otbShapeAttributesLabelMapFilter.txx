@@ -1214,7 +1214,6 @@ void
 ShapeAttributesLabelMapFilter<TImage, TLabelImage>
 ::BeforeThreadedGenerateData()
 {
-  Superclass::BeforeThreadedGenerateData();
   if (!this->GetFunctor().GetLabelImage())
     {
     // generate an image of the labelized image
@@ -1236,6 +1235,9 @@ ShapeAttributesLabelMapFilter<TImage, TLabelImage>
 /*     this->GetFunctor().SetPerimeterCalculator(pc); */
 /*     } */
 
+  // Call superclass implementation once the functor is configured, since
+  // it may apply it to intern the attributes names
+  Superclass::BeforeThreadedGenerateData();
 }
 
 template<class TImage, class TLabelImage>
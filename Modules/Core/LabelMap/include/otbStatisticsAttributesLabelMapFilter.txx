@@ -478,11 +478,11 @@ void
 StatisticsAttributesLabelMapFilter<TImage, TFeatureImage>
 ::BeforeThreadedGenerateData()
 {
-  // First call superclass implementation
-  Superclass::BeforeThreadedGenerateData();
-
   // Set the feature image to the functor
   this->GetFunctor().SetFeatureImage(this->GetFeatureImage());
+
+  // Superclass implementation comes last, it may already use the functor
+  Superclass::BeforeThreadedGenerateData();
 }
 
 template <class TImage, class TFeatureImage>
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "otbAttributesMapLabelObject.h"
+#include "otbAttributesColumnsLabelObject.h"
+#include "itkBinaryImageToLabelMapFilter.h"
+#include "otbShapeAttributesLabelMapFilter.h"
+#include "otbLabelMapToSampleListFilter.h"
+#include "itkVariableLengthVector.h"
+#include "itkListSample.h"
+
+const unsigned int Dimension = 2;
+typedef unsigned short LabelType;
+
+typedef otb::Image<LabelType, Dimension>       LabeledImageType;
+typedef otb::ImageFileReader<LabeledImageType> LabeledReaderType;
+
+typedef otb::AttributesMapLabelObject<LabelType, Dimension, double>     MapLabelObjectType;
+typedef itk::LabelMap<MapLabelObjectType>                               MapLabelMapType;
+typedef otb::AttributesColumnsLabelObject<LabelType, Dimension, double> ColumnsLabelObjectType;
+typedef itk::LabelMap<ColumnsLabelObjectType>                           ColumnsLabelMapType;
+
+typedef itk::VariableLengthVector<double>       VectorType;
+typedef itk::Statistics::ListSample<VectorType> ListSampleType;
+
+template <class TLabelMap>
+typename TLabelMap::Pointer ComputeShapeAttributes(LabeledImageType * image)
+{
+  typedef itk::BinaryImageToLabelMapFilter<LabeledImageType, TLabelMap> LabelMapFilterType;
+  typedef otb::ShapeAttributesLabelMapFilter<TLabelMap>                ShapeLabelMapFilterType;
+
+  typename LabelMapFilterType::Pointer labelMapFilter = LabelMapFilterType::New();
+  labelMapFilter->SetInput(image);
+  labelMapFilter->SetInputForegroundValue(255);
+
+  typename ShapeLabelMapFilterType::Pointer shapeLabelMapFilter = ShapeLabelMapFilterType::New();
+  shapeLabelMapFilter->SetInput(labelMapFilter->GetOutput());
+  shapeLabelMapFilter->SetReducedAttributeSet(false);
+  shapeLabelMapFilter->SetComputePerimeter(true);
+  shapeLabelMapFilter->SetComputeFeretDiameter(true);
+  shapeLabelMapFilter->Update();
+
+  return shapeLabelMapFilter->GetOutput();
+}
+
+int otbAttributesColumnsLabelObjectNew(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  ColumnsLabelObjectType::Pointer object = ColumnsLabelObjectType::New();
+
+  object->SetAttribute("test", 1.);
+  if (object->GetNumberOfAttributes() != 1 || object->GetAttribute("test") != 1.)
+    {
+    std::cerr << "Attribute not stored" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbAttributesColumnsLabelObject(int argc, char * argv[])
+{
+  const char * infname = argv[1];
+
+  LabeledReaderType::Pointer reader = LabeledReaderType::New();
+  reader->SetFileName(infname);
+  reader->Update();
+
+  MapLabelMapType::Pointer     mapLabelMap     = ComputeShapeAttributes<MapLabelMapType>(reader->GetOutput());
+  ColumnsLabelMapType::Pointer columnsLabelMap = ComputeShapeAttributes<ColumnsLabelMapType>(reader->GetOutput());
+
+  if (mapLabelMap->GetNumberOfLabelObjects() != columnsLabelMap->GetNumberOfLabelObjects())
+    {
+    std::cerr << "Different number of objects" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The objects of the columns label map share one store
+  const ColumnsLabelObjectType::AttributesStoreType * store =
+    columnsLabelMap->GetNthLabelObject(0)->GetAttributesStore();
+
+  // Compare all the attributes of the two label maps
+  MapLabelMapType::ConstIterator mapIt(mapLabelMap);
+  ColumnsLabelMapType::ConstIterator columnsIt(columnsLabelMap);
+  for (; !mapIt.IsAtEnd(); ++mapIt, ++columnsIt)
+    {
+    const MapLabelObjectType *     mapObject = mapIt.GetLabelObject();
+    const ColumnsLabelObjectType * columnsObject = columnsIt.GetLabelObject();
+
+    if (columnsObject->GetAttributesStore() != store)
+      {
+      std::cerr << "Object " << columnsObject->GetLabel() << " is not in the shared store" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    std::vector<std::string> attributes = mapObject->GetAvailableAttributes();
+    if (attributes != columnsObject->GetAvailableAttributes())
+      {
+      std::cerr << "Different attributes for object " << mapObject->GetLabel() << std::endl;
+      return EXIT_FAILURE;
+      }
+    for (std::vector<std::string>::const_iterator attrIt = attributes.begin(); attrIt != attributes.end(); ++attrIt)
+      {
+      const double mapValue = mapObject->GetAttribute(attrIt->c_str());
+      const double columnsValue = columnsObject->GetAttribute(attrIt->c_str());
+      if (mapValue != columnsValue && !(mapValue != mapValue && columnsValue != columnsValue))
+        {
+        std::cerr << "Object " << mapObject->GetLabel() << ", " << *attrIt << ": "
+                  << mapValue << " != " << columnsValue << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Compare the sample lists
+  typedef otb::LabelMapToSampleListFilter<MapLabelMapType, ListSampleType> MapSampleListFilterType;
+  typedef otb::LabelMapToSampleListFilter<ColumnsLabelMapType, ListSampleType,
+    otb::Functor::AttributesColumnsMeasurementFunctor<ColumnsLabelObjectType, VectorType> >
+    ColumnsSampleListFilterType;
+
+  MapSampleListFilterType::Pointer     mapSampleList = MapSampleListFilterType::New();
+  ColumnsSampleListFilterType::Pointer columnsSampleList = ColumnsSampleListFilterType::New();
+  mapSampleList->SetInputLabelMap(mapLabelMap);
+  columnsSampleList->SetInputLabelMap(columnsLabelMap);
+  for (int i = 2; i < argc; ++i)
+    {
+    mapSampleList->GetMeasurementFunctor().AddAttribute(argv[i]);
+    columnsSampleList->GetMeasurementFunctor().AddAttribute(argv[i]);
+    }
+  mapSampleList->Update();
+  columnsSampleList->Update();
+
+  const ListSampleType * mapSamples = mapSampleList->GetOutputSampleList();
+  const ListSampleType * columnsSamples = columnsSampleList->GetOutputSampleList();
+  if (mapSamples->Size() != columnsSamples->Size())
+    {
+    std::cerr << "Different number of samples" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (unsigned int i = 0; i < mapSamples->Size(); ++i)
+    {
+    if (mapSamples->GetMeasurementVector(i) != columnsSamples->GetMeasurementVector(i))
+      {
+      std::cerr << "Sample " << i << ": " << mapSamples->GetMeasurementVector(i)
+                << " != " << columnsSamples->GetMeasurementVector(i) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -26,4 +26,6 @@ void RegisterTests()
   REGISTER_TEST(otbShapeAttributesLabelMapFilterNew);
   REGISTER_TEST(otbBandsStatisticsAttributesLabelMapFilter);
   REGISTER_TEST(otbBandsStatisticsAttributesLabelMapFilterNew);
+  REGISTER_TEST(otbAttributesColumnsLabelObjectNew);
+  REGISTER_TEST(otbAttributesColumnsLabelObject);
 }
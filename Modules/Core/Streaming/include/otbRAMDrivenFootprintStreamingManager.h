@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbRAMDrivenFootprintStreamingManager_h
+#define __otbRAMDrivenFootprintStreamingManager_h
+
+#include "otbStreamingManager.h"
+#include "itkImageBase.h"
+#include <vector>
+#include <set>
+
+namespace otb
+{
+
+/** \class RAMDrivenFootprintStreamingManager
+ *  \brief This class computes the divisions needed to stream an image
+ *  in square tiles, ordered and sized according to their footprint in
+ *  the input files.
+ *
+ * This streaming manager is meant for resampling pipelines
+ * (orthorectification, superimposition...), where an output strip maps
+ * to a skewed region of the input image, so that the same input tiles
+ * are decoded again and again for successive output strips.
+ *
+ * The output region is first split in square tiles according to the
+ * available RAM, as RAMDrivenTiledStreamingManager does. Each tile is
+ * then back-projected by propagating it as a requested region through
+ * the pipeline, and the requested regions of the source images (images
+ * produced by a reader, i.e. a process object without inputs) give its
+ * input footprint. The footprint is aligned on the input tiling scheme
+ * (TileHintX/TileHintY from the MetaDataDictionary) to estimate the size
+ * of the input tiles working set.
+ *
+ * If the largest working set does not fit in the input cache size
+ * (SetInputCacheSizeInMB), the number of divisions is increased. Splits
+ * are finally ordered along a Hilbert curve over the input tiles of the
+ * first source image, so that successive splits reuse the same input
+ * tiles.
+ *
+ * If the footprints can not be computed (no reader in the pipeline, or
+ * a filter rejecting the requested region), this manager behaves like
+ * RAMDrivenTiledStreamingManager.
+ *
+ * \sa RAMDrivenTiledStreamingManager
+ * \sa ImageFileWriter
+ * \sa StreamingImageVirtualFileWriter
+ *
+ * \ingroup OTBStreaming
+ */
+template<class TImage>
+class ITK_EXPORT RAMDrivenFootprintStreamingManager : public StreamingManager<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef RAMDrivenFootprintStreamingManager Self;
+  typedef StreamingManager<TImage>           Superclass;
+  typedef itk::SmartPointer<Self>            Pointer;
+  typedef itk::SmartPointer<const Self>      ConstPointer;
+
+  typedef TImage                               ImageType;
+  typedef typename Superclass::RegionType      RegionType;
+  typedef typename Superclass::IndexType       IndexType;
+  typedef typename Superclass::SizeType        SizeType;
+  typedef typename Superclass::MemoryPrintType MemoryPrintType;
+
+  /** Creation through object factory macro */
+  itkNewMacro(Self);
+
+  /** Type macro */
+  itkTypeMacro(RAMDrivenFootprintStreamingManager, itk::LightObject);
+
+  /** Dimension of input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  typedef itk::ImageBase<itkGetStaticConstMacro(ImageDimension)> SourceImageType;
+  typedef std::vector<SourceImageType *>                         SourceImageListType;
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkSetMacro(AvailableRAMInMB, unsigned int);
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkGetConstMacro(AvailableRAMInMB, unsigned int);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkSetMacro(Bias, double);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkGetConstMacro(Bias, double);
+
+  /** The size of the cache holding decoded input tiles, in Megabytes
+    (if 0, the configuration option is used) */
+  itkSetMacro(InputCacheSizeInMB, unsigned int);
+
+  /** The size of the cache holding decoded input tiles, in Megabytes
+    (if 0, the configuration option is used) */
+  itkGetConstMacro(InputCacheSizeInMB, unsigned int);
+
+  /** Maximum number of times the number of divisions is doubled to fit
+    the input cache size */
+  itkSetMacro(MaximumNumberOfRefinements, unsigned int);
+  itkGetConstMacro(MaximumNumberOfRefinements, unsigned int);
+
+  /** Actually computes the stream divisions, according to the specified streaming mode,
+   * eventually using the input parameter to estimate memory consumption */
+  virtual void PrepareStreaming(itk::DataObject * input, const RegionType &region);
+
+  /** Get the ith split, in footprint order */
+  virtual RegionType GetSplit(unsigned int i);
+
+  /** Get the largest input tiles working set of a split, in bytes.
+   * PrepareStreaming() must have been called before. */
+  itkGetConstMacro(MaximumWorkingSet, MemoryPrintType);
+
+protected:
+  RAMDrivenFootprintStreamingManager();
+  virtual ~RAMDrivenFootprintStreamingManager();
+
+  /** Collect the source images (outputs of process objects without
+   *  inputs) upstream of a data object */
+  void CollectSourceImages(itk::DataObject * data,
+                           SourceImageListType& sources,
+                           std::set<itk::ProcessObject *>& visited) const;
+
+  /** Get the input tile size of a source image, from its tile hint */
+  SizeType GetSourceTileSize(SourceImageType * source) const;
+
+  /** Distance along a Hilbert curve of order 2^order */
+  static unsigned long HilbertDistance(unsigned long order, unsigned long x, unsigned long y);
+
+  /** The number of MegaBytes of RAM available */
+  unsigned int m_AvailableRAMInMB;
+
+  /** The multiplier to apply to the memory print estimation */
+  double m_Bias;
+
+  /** The number of MegaBytes of input tile cache */
+  unsigned int m_InputCacheSizeInMB;
+
+  /** Maximum number of refinements of the number of divisions */
+  unsigned int m_MaximumNumberOfRefinements;
+
+  /** Largest working set of the computed splits */
+  MemoryPrintType m_MaximumWorkingSet;
+
+  /** The ordered splits */
+  std::vector<RegionType> m_Splits;
+
+private:
+  RAMDrivenFootprintStreamingManager(const RAMDrivenFootprintStreamingManager &);
+  void operator =(const RAMDrivenFootprintStreamingManager&);
+};
+
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbRAMDrivenFootprintStreamingManager.txx"
+#endif
+
+#endif
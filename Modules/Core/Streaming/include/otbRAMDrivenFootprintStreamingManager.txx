@@ -0,0 +1,313 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbRAMDrivenFootprintStreamingManager_txx
+#define __otbRAMDrivenFootprintStreamingManager_txx
+
+#include "otbRAMDrivenFootprintStreamingManager.h"
+#include "otbMacro.h"
+#include "otbConfigurationManager.h"
+#include "otbImageRegionSquareTileSplitter.h"
+#include "otbMetaDataKey.h"
+#include "itkMetaDataObject.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template <class TImage>
+RAMDrivenFootprintStreamingManager<TImage>::RAMDrivenFootprintStreamingManager()
+  : m_AvailableRAMInMB(0),
+    m_Bias(1.0),
+    m_InputCacheSizeInMB(0),
+    m_MaximumNumberOfRefinements(6),
+    m_MaximumWorkingSet(0)
+{
+}
+
+template <class TImage>
+RAMDrivenFootprintStreamingManager<TImage>::~RAMDrivenFootprintStreamingManager()
+{
+}
+
+template <class TImage>
+void
+RAMDrivenFootprintStreamingManager<TImage>
+::CollectSourceImages(itk::DataObject * data,
+                      SourceImageListType& sources,
+                      std::set<itk::ProcessObject *>& visited) const
+{
+  itk::ProcessObject * process = data->GetSource();
+
+  // In-memory data are not decoded from a file
+  if (process == NULL || visited.count(process))
+    {
+    return;
+    }
+  visited.insert(process);
+
+  if (process->GetNumberOfInputs() == 0)
+    {
+    SourceImageType * image = dynamic_cast<SourceImageType *>(data);
+    if (image != NULL)
+      {
+      sources.push_back(image);
+      }
+    return;
+    }
+
+  itk::ProcessObject::DataObjectPointerArray inputs = process->GetInputs();
+  for (unsigned int i = 0; i < inputs.size(); ++i)
+    {
+    if (inputs[i])
+      {
+      this->CollectSourceImages(inputs[i], sources, visited);
+      }
+    }
+}
+
+template <class TImage>
+typename RAMDrivenFootprintStreamingManager<TImage>::SizeType
+RAMDrivenFootprintStreamingManager<TImage>
+::GetSourceTileSize(SourceImageType * source) const
+{
+  unsigned int tileHintX(0), tileHintY(0);
+
+  itk::ExposeMetaData<unsigned int>(source->GetMetaDataDictionary(),
+                                    MetaDataKey::TileHintX,
+                                    tileHintX);
+
+  itk::ExposeMetaData<unsigned int>(source->GetMetaDataDictionary(),
+                                    MetaDataKey::TileHintY,
+                                    tileHintY);
+
+  // Without tile hint, the file is assumed to be read line by line
+  SizeType tileSize;
+  tileSize.Fill(1);
+  tileSize[0] = tileHintX > 0 ? tileHintX : source->GetLargestPossibleRegion().GetSize()[0];
+  tileSize[1] = tileHintY > 0 ? tileHintY : 1;
+
+  return tileSize;
+}
+
+template <class TImage>
+unsigned long
+RAMDrivenFootprintStreamingManager<TImage>
+::HilbertDistance(unsigned long order, unsigned long x, unsigned long y)
+{
+  const unsigned long n = 1UL << order;
+  unsigned long d = 0;
+
+  for (unsigned long s = n / 2; s > 0; s /= 2)
+    {
+    const unsigned long rx = (x & s) > 0 ? 1 : 0;
+    const unsigned long ry = (y & s) > 0 ? 1 : 0;
+    d += s * s * ((3 * rx) ^ ry);
+
+    // Rotate the quadrant
+    if (ry == 0)
+      {
+      if (rx == 1)
+        {
+        x = n - 1 - x;
+        y = n - 1 - y;
+        }
+      std::swap(x, y);
+      }
+    }
+  return d;
+}
+
+template <class TImage>
+void
+RAMDrivenFootprintStreamingManager<TImage>::PrepareStreaming( itk::DataObject * input, const RegionType &region )
+{
+  unsigned long nbDivisions =
+      this->EstimateOptimalNumberOfDivisions(input, region, m_AvailableRAMInMB, m_Bias);
+
+  typedef otb::ImageRegionSquareTileSplitter<itkGetStaticConstMacro(ImageDimension)> SplitterType;
+  typename SplitterType::Pointer splitter = SplitterType::New();
+  this->m_Splitter = splitter;
+  this->m_Region = region;
+  m_Splits.clear();
+  m_MaximumWorkingSet = 0;
+
+  MemoryPrintType cacheSizeInBytes = m_InputCacheSizeInMB;
+  if (cacheSizeInBytes == 0)
+    {
+    cacheSizeInBytes = ConfigurationManager::GetMaxRAMHint();
+    }
+  cacheSizeInBytes *= 1024 * 1024;
+
+  ImageType * image = dynamic_cast<ImageType *>(input);
+  SourceImageListType sources;
+  if (image != NULL)
+    {
+    std::set<itk::ProcessObject *> visited;
+    this->CollectSourceImages(image, sources, visited);
+    }
+
+  std::vector<unsigned long> keys;
+  bool footprintsAvailable = !sources.empty();
+  unsigned int refinement = 0;
+
+  do
+    {
+    this->m_ComputedNumberOfSplits = splitter->GetNumberOfSplits(region, nbDivisions);
+
+    m_Splits.clear();
+    keys.clear();
+    m_MaximumWorkingSet = 0;
+
+    for (unsigned int i = 0; i < this->m_ComputedNumberOfSplits; ++i)
+      {
+      RegionType split(region);
+      splitter->GetSplit(i, this->m_ComputedNumberOfSplits, split);
+      m_Splits.push_back(split);
+      }
+
+    if (!footprintsAvailable)
+      {
+      break;
+      }
+
+    // Back-project each split through the pipeline
+    PipelineMemoryPrintCalculator::Pointer memoryPrintCalculator = PipelineMemoryPrintCalculator::New();
+    try
+      {
+      for (unsigned int i = 0; i < m_Splits.size(); ++i)
+        {
+        image->SetRequestedRegion(m_Splits[i]);
+        image->PropagateRequestedRegion();
+
+        MemoryPrintType workingSet = 0;
+        for (unsigned int s = 0; s < sources.size(); ++s)
+          {
+          const RegionType footprint = sources[s]->GetRequestedRegion();
+          const SizeType   tileSize = this->GetSourceTileSize(sources[s]);
+
+          if (footprint.GetNumberOfPixels() == 0)
+            {
+            continue;
+            }
+
+          // Number of pixels of the tiles covering the footprint
+          unsigned long tiledPixels = 1;
+          IndexType firstTile, lastTile;
+          for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+            {
+            firstTile[dim] = footprint.GetIndex()[dim] / static_cast<long>(tileSize[dim]);
+            lastTile[dim] = (footprint.GetIndex()[dim] + footprint.GetSize()[dim] - 1)
+              / static_cast<long>(tileSize[dim]);
+            tiledPixels *= (lastTile[dim] - firstTile[dim] + 1) * tileSize[dim];
+            }
+
+          const double bytesPerPixel =
+              static_cast<double>(memoryPrintCalculator->EvaluateDataObjectPrint(sources[s]))
+              / static_cast<double>(footprint.GetNumberOfPixels());
+          workingSet += static_cast<MemoryPrintType>(tiledPixels * bytesPerPixel);
+
+          // Splits are ordered along the tiles of the first source
+          if (s == 0)
+            {
+            const SizeType largestSize = sources[s]->GetLargestPossibleRegion().GetSize();
+            unsigned long nbTiles = std::max((largestSize[0] + tileSize[0] - 1) / tileSize[0],
+                                             (largestSize[1] + tileSize[1] - 1) / tileSize[1]);
+            unsigned long order = 0;
+            while ((1UL << order) < nbTiles)
+              {
+              ++order;
+              }
+            const long maxTile = static_cast<long>((1UL << order) - 1);
+            long center[2];
+            for (unsigned int dim = 0; dim < 2; ++dim)
+              {
+              const long largestIndex = sources[s]->GetLargestPossibleRegion().GetIndex()[dim];
+              center[dim] = (firstTile[dim] + lastTile[dim]) / 2 - largestIndex / static_cast<long>(tileSize[dim]);
+              center[dim] = std::min(std::max(center[dim], 0L), maxTile);
+              }
+            keys.push_back(HilbertDistance(order, center[0], center[1]));
+            }
+          }
+
+        if (keys.size() < i + 1)
+          {
+          keys.push_back(0);
+          }
+        m_MaximumWorkingSet = std::max(m_MaximumWorkingSet, workingSet);
+        }
+      }
+    catch (itk::ExceptionObject & err)
+      {
+      otbMsgDevMacro(<< "Unable to compute the input footprints, splits will not be reordered: " << err)
+      footprintsAvailable = false;
+      keys.clear();
+      break;
+      }
+
+    otbMsgDevMacro(<< "Largest input working set with " << this->m_ComputedNumberOfSplits
+                   << " splits: " << m_MaximumWorkingSet / 1024 / 1024 << " MB")
+
+    // Refine the splits if the input tiles do not fit in the cache
+    if (m_MaximumWorkingSet <= cacheSizeInBytes
+        || this->m_ComputedNumberOfSplits >= region.GetNumberOfPixels()
+        || refinement >= m_MaximumNumberOfRefinements)
+      {
+      break;
+      }
+    nbDivisions = 2 * this->m_ComputedNumberOfSplits;
+    ++refinement;
+    }
+  while (true);
+
+  if (footprintsAvailable && keys.size() == m_Splits.size())
+    {
+    // Order splits along the Hilbert curve (stable, so that splits
+    // sharing the same input tiles keep the splitter order)
+    std::vector<std::pair<unsigned long, unsigned int> > order;
+    for (unsigned int i = 0; i < keys.size(); ++i)
+      {
+      order.push_back(std::make_pair(keys[i], i));
+      }
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<RegionType> orderedSplits;
+    for (unsigned int i = 0; i < order.size(); ++i)
+      {
+      orderedSplits.push_back(m_Splits[order[i].second]);
+      }
+    m_Splits.swap(orderedSplits);
+    }
+
+  otbMsgDevMacro(<< "Number of split : " << this->m_ComputedNumberOfSplits)
+}
+
+template <class TImage>
+typename RAMDrivenFootprintStreamingManager<TImage>::RegionType
+RAMDrivenFootprintStreamingManager<TImage>::GetSplit(unsigned int i)
+{
+  if (i >= m_Splits.size())
+    {
+    itkExceptionMacro(<< "Split " << i << " requested, but only " << m_Splits.size() << " splits are available");
+    }
+  return m_Splits[i];
+}
+
+} // End namespace otb
+
+#endif
@@ -0,0 +1,270 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbStreamingCompositeImageFilter_h
+#define __otbStreamingCompositeImageFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentCompositeImageFilter
+ * \brief Run several persistent filters on the same streamed input.
+ *
+ * Each persistent filter added with AddFilter() is run on every piece
+ * of the input image streamed through this filter, so that the input
+ * is read (or computed) only once for all of them. Each filter keeps its
+ * own per-thread temporary data, and Reset() and Synthetize() are
+ * forwarded to all of them.
+ *
+ * The persistent filters must take the input image type as their only
+ * input, and must not request a larger input region than the one they
+ * process (which is the case of statistics filters such as
+ * PersistentMinMaxVectorImageFilter, PersistentStatisticsVectorImageFilter
+ * or PersistentHistogramVectorImageFilter). The results are read from
+ * each persistent filter, as usual.
+ *
+ * \sa StreamingCompositeImageFilter
+ * \sa PersistentImageFilter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBStreaming
+ */
+template<class TInputImage>
+class ITK_EXPORT PersistentCompositeImageFilter :
+  public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentCompositeImageFilter                  Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentCompositeImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                   ImageType;
+  typedef typename TInputImage::Pointer InputImagePointer;
+  typedef typename TInputImage::RegionType RegionType;
+
+  /** Add a persistent filter to run on the streamed input */
+  template <class TFilter>
+  void AddFilter(TFilter * filter)
+  {
+    if (filter == NULL)
+      {
+      itkExceptionMacro(<< "Can not add a null filter");
+      }
+    m_Filters.push_back(new FilterWrapper<TFilter>(filter));
+    this->Modified();
+  }
+
+  /** Remove all the persistent filters */
+  void ClearFilters();
+
+  /** Get the number of persistent filters */
+  unsigned int GetNumberOfFilters() const
+  {
+    return m_Filters.size();
+  }
+
+  /** Get the ith persistent filter */
+  itk::ProcessObject * GetNthFilter(unsigned int i);
+
+  virtual void AllocateOutputs();
+  virtual void GenerateOutputInformation();
+  virtual void Synthetize(void);
+  virtual void Reset(void);
+
+protected:
+  PersistentCompositeImageFilter();
+  virtual ~PersistentCompositeImageFilter();
+  virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Run each persistent filter on the requested region */
+  virtual void GenerateData();
+
+private:
+  PersistentCompositeImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** Type erasure of the persistent filters, which have different
+   *  output types */
+  class FilterWrapperBase
+  {
+  public:
+    virtual ~FilterWrapperBase() {}
+    virtual itk::ProcessObject * GetProcessObject() = 0;
+    virtual void SetInput(ImageType * input) = 0;
+    virtual void Reset() = 0;
+    virtual void Process(const RegionType& region) = 0;
+    virtual void Synthetize() = 0;
+  };
+
+  template <class TFilter>
+  class FilterWrapper : public FilterWrapperBase
+  {
+  public:
+    FilterWrapper(TFilter * filter) : m_Filter(filter) {}
+
+    virtual itk::ProcessObject * GetProcessObject()
+    {
+      return m_Filter;
+    }
+    virtual void SetInput(ImageType * input)
+    {
+      m_Filter->SetInput(input);
+    }
+    virtual void Reset()
+    {
+      m_Filter->Reset();
+    }
+    virtual void Process(const RegionType& region)
+    {
+      // Persistent filters do not allocate their image output, so
+      // that they are executed again for each streamed piece
+      m_Filter->GetOutput()->SetRequestedRegion(region);
+      m_Filter->Modified();
+      m_Filter->GetOutput()->Update();
+    }
+    virtual void Synthetize()
+    {
+      m_Filter->Synthetize();
+    }
+
+  private:
+    typename TFilter::Pointer m_Filter;
+  };
+
+  typedef std::vector<FilterWrapperBase *> FilterWrapperListType;
+
+  /** The persistent filters */
+  FilterWrapperListType m_Filters;
+
+  /** Input of the persistent filters: the streamed input, grafted
+   *  without its source so that it is never updated again */
+  InputImagePointer m_InputView;
+};
+
+/**===========================================================================*/
+
+/** \class StreamingCompositeImageFilter
+ * \brief This class streams the whole input image through several
+ * persistent filters at once.
+ *
+ * The input is read only once to compute, for instance, the min/max,
+ * the mean and covariance, and the histograms of an image:
+ *
+ * \code
+ * typedef otb::StreamingCompositeImageFilter<ImageType>         CompositeType;
+ * typedef otb::StreamingStatisticsVectorImageFilter<ImageType>  StatisticsType;
+ * typedef otb::StreamingHistogramVectorImageFilter<ImageType>   HistogramType;
+ *
+ * CompositeType::Pointer composite = CompositeType::New();
+ * composite->SetInput(reader->GetOutput());
+ * composite->AddFilter(statistics->GetFilter());
+ * composite->AddFilter(histogram->GetFilter());
+ * composite->Update();
+ *
+ * statistics->GetCovariance();
+ * histogram->GetHistogramList();
+ * \endcode
+ *
+ * The results are read from the streaming filters (or directly from
+ * the persistent filters) added to the composite. Only the streamer of
+ * the composite is used.
+ *
+ * \sa PersistentCompositeImageFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \sa StreamingImageVirtualWriter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBStreaming
+ */
+template<class TInputImage>
+class ITK_EXPORT StreamingCompositeImageFilter :
+  public PersistentFilterStreamingDecorator<PersistentCompositeImageFilter<TInputImage> >
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingCompositeImageFilter Self;
+  typedef PersistentFilterStreamingDecorator
+  <PersistentCompositeImageFilter<TInputImage> > Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingCompositeImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage InputImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType * input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType * GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  /** Add a persistent filter to run on the streamed input */
+  template <class TFilter>
+  void AddFilter(TFilter * filter)
+  {
+    this->GetFilter()->AddFilter(filter);
+    this->Modified();
+  }
+
+  /** Remove all the persistent filters */
+  void ClearFilters()
+  {
+    this->GetFilter()->ClearFilters();
+    this->Modified();
+  }
+
+protected:
+  /** Constructor */
+  StreamingCompositeImageFilter() {}
+  /** Destructor */
+  virtual ~StreamingCompositeImageFilter() {}
+
+private:
+  StreamingCompositeImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingCompositeImageFilter.txx"
+#endif
+
+#endif
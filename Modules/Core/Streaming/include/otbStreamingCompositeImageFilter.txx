@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbStreamingCompositeImageFilter_txx
+#define __otbStreamingCompositeImageFilter_txx
+#include "otbStreamingCompositeImageFilter.h"
+
+#include "itkProgressAccumulator.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template<class TInputImage>
+PersistentCompositeImageFilter<TInputImage>
+::PersistentCompositeImageFilter()
+{
+  m_InputView = TInputImage::New();
+}
+
+template<class TInputImage>
+PersistentCompositeImageFilter<TInputImage>
+::~PersistentCompositeImageFilter()
+{
+  this->ClearFilters();
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::ClearFilters()
+{
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    delete m_Filters[i];
+    }
+  m_Filters.clear();
+  this->Modified();
+}
+
+template<class TInputImage>
+itk::ProcessObject *
+PersistentCompositeImageFilter<TInputImage>
+::GetNthFilter(unsigned int i)
+{
+  if (i >= m_Filters.size())
+    {
+    itkExceptionMacro(<< "Filter " << i << " requested, but only " << m_Filters.size() << " filters are available");
+    }
+  return m_Filters[i]->GetProcessObject();
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+    {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+      {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+      }
+    }
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used, and
+  // the persistent filters do not allocate theirs.
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::Reset()
+{
+  TInputImage * inputPtr = const_cast<TInputImage *>(this->GetInput());
+  inputPtr->UpdateOutputInformation();
+
+  // The persistent filters only see the information of the input
+  // until the first piece is streamed
+  m_InputView->Initialize();
+  m_InputView->CopyInformation(inputPtr);
+  m_InputView->SetNumberOfComponentsPerPixel(inputPtr->GetNumberOfComponentsPerPixel());
+  m_InputView->SetMetaDataDictionary(inputPtr->GetMetaDataDictionary());
+
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    m_Filters[i]->SetInput(m_InputView);
+    m_Filters[i]->Reset();
+    }
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::GenerateData()
+{
+  TInputImage * inputPtr = const_cast<TInputImage *>(this->GetInput());
+  const RegionType region = this->GetOutput()->GetRequestedRegion();
+
+  // Share the streamed piece with all the persistent filters
+  m_InputView->Graft(inputPtr);
+  m_InputView->SetMetaDataDictionary(inputPtr->GetMetaDataDictionary());
+
+  itk::ProgressAccumulator::Pointer progress = itk::ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    progress->RegisterInternalFilter(m_Filters[i]->GetProcessObject(), 1.f / m_Filters.size());
+    }
+
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    m_Filters[i]->Process(region);
+    }
+
+  otbMsgDevMacro(<< "Processed region " << region.GetIndex() << " " << region.GetSize()
+                 << " with " << m_Filters.size() << " persistent filters")
+}
+
+template<class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::Synthetize()
+{
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    m_Filters[i]->Synthetize();
+    }
+}
+
+template <class TInputImage>
+void
+PersistentCompositeImageFilter<TInputImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of persistent filters: " << m_Filters.size() << std::endl;
+  for (unsigned int i = 0; i < m_Filters.size(); ++i)
+    {
+    os << indent << "Filter " << i << ": " << m_Filters[i]->GetProcessObject()->GetNameOfClass() << std::endl;
+    }
+}
+
+} // end namespace otb
+#endif
@@ -21,6 +21,7 @@
 
 #include "otbMacro.h"
 #include "itkCommand.h"
+#include "otbPipelineProfiler.h"
 
 #include "otbNumberOfDivisionsStrippedStreamingManager.h"
 #include "otbNumberOfDivisionsTiledStreamingManager.h"
@@ -29,6 +30,7 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbRAMDrivenFootprintStreamingManager.h"
 
 namespace otb
 {
@@ -145,6 +147,19 @@ StreamingImageVirtualWriter<TInputImage>
   m_StreamingManager = streamingManager;
 }
 
+template <class TInputImage>
+void
+StreamingImageVirtualWriter<TInputImage>
+::SetAutomaticFootprintStreaming(unsigned int availableRAM, double bias, unsigned int inputCacheSize)
+{
+  typedef RAMDrivenFootprintStreamingManager<TInputImage> RAMDrivenFootprintStreamingManagerType;
+  typename RAMDrivenFootprintStreamingManagerType::Pointer streamingManager = RAMDrivenFootprintStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  streamingManager->SetInputCacheSizeInMB(inputCacheSize);
+  m_StreamingManager = streamingManager;
+}
+
 template <class TInputImage>
 void
 StreamingImageVirtualWriter<TInputImage>
@@ -234,20 +249,47 @@ StreamingImageVirtualWriter<TInputImage>
    * piece, and copy the results into the output image.
    */
   InputImageRegionType streamRegion;
+
+  // Record the streaming in the pipeline profiling report, if enabled
+  PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+  const bool profiling = profiler->IsEnabled();
+  if (profiling)
+    {
+    std::ostringstream region;
+    region << outputRegion.GetIndex() << " " << outputRegion.GetSize();
+    profiler->BeginStreaming(this, inputPtr, m_StreamingManager->GetNameOfClass(), m_NumberOfDivisions, region.str());
+    }
+  PipelineProfiler::StreamingGuard profilingGuard(profiling ? this : NULL);
+
   for (m_CurrentDivision = 0;
        m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
        m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
     {
     streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
     otbMsgDevMacro(<< "Processing region : " << streamRegion )
+
+    if (profiling)
+      {
+      std::ostringstream region;
+      region << streamRegion.GetIndex() << " " << streamRegion.GetSize();
+      profiler->BeginDivision(this, m_CurrentDivision, region.str());
+      }
+
     //inputPtr->ReleaseData();
     //inputPtr->SetRequestedRegion(streamRegion);
     //inputPtr->Update();
     inputPtr->SetRequestedRegion(streamRegion);
     inputPtr->PropagateRequestedRegion();
     inputPtr->UpdateOutputData();
+
+    if (profiling)
+      {
+      profiler->EndDivision(this, 0);
+      }
     }
 
+  profilingGuard.End();
+
   /**
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
@@ -0,0 +1,93 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "itkMacro.h"
+
+#include "otbStreamingCompositeImageFilter.h"
+#include "otbStreamingStatisticsVectorImageFilter.h"
+#include "otbStreamingMinMaxVectorImageFilter.h"
+#include "otbImageFileReader.h"
+#include "otbVectorImage.h"
+#include <fstream>
+
+int otbStreamingCompositeImageFilterNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::VectorImage<double, 2>                    ImageType;
+  typedef otb::StreamingCompositeImageFilter<ImageType>  CompositeFilterType;
+
+  // Instantiating object
+  CompositeFilterType::Pointer filter = CompositeFilterType::New();
+
+  std::cout << filter << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+int otbStreamingCompositeImageFilter(int itkNotUsed(argc), char * argv[])
+{
+  const char * infname = argv[1];
+  const char * outfname = argv[2];
+
+  const unsigned int Dimension = 2;
+  typedef double PixelType;
+
+  typedef otb::VectorImage<PixelType, Dimension>               ImageType;
+  typedef otb::ImageFileReader<ImageType>                      ReaderType;
+  typedef otb::StreamingCompositeImageFilter<ImageType>        CompositeFilterType;
+  typedef otb::StreamingStatisticsVectorImageFilter<ImageType> StatisticsFilterType;
+  typedef otb::StreamingMinMaxVectorImageFilter<ImageType>     MinMaxFilterType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+
+  StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+  MinMaxFilterType::Pointer minMax = MinMaxFilterType::New();
+
+  // Both statistics are computed with a single read of the input
+  CompositeFilterType::Pointer composite = CompositeFilterType::New();
+  composite->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  composite->SetInput(reader->GetOutput());
+  composite->AddFilter(statistics->GetFilter());
+  composite->AddFilter(minMax->GetFilter());
+  composite->Update();
+
+  if (statistics->GetMinimum() != minMax->GetMinimum()
+      || statistics->GetMaximum() != minMax->GetMaximum())
+    {
+    std::cerr << "Min/max differ between the statistics (" << statistics->GetMinimum() << " / "
+              << statistics->GetMaximum() << ") and the min/max filter (" << minMax->GetMinimum()
+              << " / " << minMax->GetMaximum() << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::ofstream file;
+  file.open(outfname);
+  file << "Minimum: " << statistics->GetMinimum() << std::endl;
+  file << "Maximum: " << statistics->GetMaximum() << std::endl;
+  file << std::fixed;
+  file.precision(5);
+  file << "Sum: " << statistics->GetSum() << std::endl;
+  file << "Mean: " << statistics->GetMean() << std::endl;
+  file << "Correlation: " << statistics->GetCorrelation() << std::endl;
+  file << "Covariance: " << statistics->GetCovariance() << std::endl;
+  file << "Component Mean: " << statistics->GetComponentMean() << std::endl;
+  file << "Component Correlation: " << statistics->GetComponentCorrelation() << std::endl;
+  file << "Component Covariance: " << statistics->GetComponentCovariance() << std::endl;
+  file.close();
+
+  return EXIT_SUCCESS;
+}
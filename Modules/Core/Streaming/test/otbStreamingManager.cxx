@@ -22,6 +22,9 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbRAMDrivenFootprintStreamingManager.h"
+#include "otbImageFileReader.h"
+#include "itkFlipImageFilter.h"
 
 #include <fstream>
 
@@ -32,6 +35,7 @@ typedef otb::RAMDrivenStrippedStreamingManager<ImageType>     RAMDrivenStrippedS
 typedef otb::TileDimensionTiledStreamingManager<ImageType>    TileDimensionTiledStreamingManagerType;
 typedef otb::RAMDrivenTiledStreamingManager<ImageType>        RAMDrivenTiledStreamingManagerType;
 typedef otb::RAMDrivenAdaptativeStreamingManager<ImageType>        RAMDrivenAdaptativeStreamingManagerType;
+typedef otb::RAMDrivenFootprintStreamingManager<ImageType>    RAMDrivenFootprintStreamingManagerType;
 
 
 ImageType::Pointer makeImage(ImageType::RegionType region)
@@ -66,6 +70,9 @@ int otbStreamingManagerNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
   RAMDrivenAdaptativeStreamingManagerType::Pointer streamingManager5 = RAMDrivenAdaptativeStreamingManagerType::New();
   std::cout<<streamingManager5<<std::endl;
 
+  RAMDrivenFootprintStreamingManagerType::Pointer streamingManager6 = RAMDrivenFootprintStreamingManagerType::New();
+  std::cout<<streamingManager6<<std::endl;
+
   return EXIT_SUCCESS;
 }
 
@@ -227,3 +234,68 @@ int otbRAMDrivenAdaptativeStreamingManager(int itkNotUsed(argc), char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbRAMDrivenFootprintStreamingManager(int itkNotUsed(argc), char * argv[])
+{
+  typedef otb::ImageFileReader<ImageType>              ReaderType;
+  typedef itk::FlipImageFilter<ImageType>              FlipFilterType;
+
+  std::ofstream outfile(argv[2]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+
+  // The flip maps each output tile to a mirrored input footprint
+  FlipFilterType::Pointer flip = FlipFilterType::New();
+  FlipFilterType::FlipAxesArrayType axes;
+  axes[0] = true;
+  axes[1] = false;
+  flip->SetFlipAxes(axes);
+  flip->SetInput(reader->GetOutput());
+  flip->UpdateOutputInformation();
+
+  RAMDrivenFootprintStreamingManagerType::Pointer streamingManager = RAMDrivenFootprintStreamingManagerType::New();
+
+  ImageType::RegionType region = flip->GetOutput()->GetLargestPossibleRegion();
+
+  streamingManager->SetAvailableRAMInMB(1);
+  streamingManager->SetInputCacheSizeInMB(1);
+  streamingManager->PrepareStreaming( flip->GetOutput(), region );
+
+  unsigned int nbSplits = streamingManager->GetNumberOfSplits();
+
+  // Splits must be a partition of the region, whatever their order
+  unsigned long nbPixels = 0;
+  for (unsigned int i = 0; i < nbSplits; ++i)
+    {
+    ImageType::RegionType split = streamingManager->GetSplit(i);
+    if (!region.IsInside(split))
+      {
+      std::cerr << "Split " << i << " is outside the region: " << split << std::endl;
+      return EXIT_FAILURE;
+      }
+    for (unsigned int j = 0; j < i; ++j)
+      {
+      ImageType::RegionType other = streamingManager->GetSplit(j);
+      if (other.Crop(split))
+        {
+        std::cerr << "Splits " << j << " and " << i << " overlap" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    nbPixels += split.GetNumberOfPixels();
+    }
+
+  if (nbPixels != region.GetNumberOfPixels())
+    {
+    std::cerr << "Splits cover " << nbPixels << " pixels instead of " << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  outfile << nbSplits << std::endl;
+  outfile << streamingManager->GetSplit(0) << std::endl;
+  outfile << streamingManager->GetSplit(1) << std::endl;
+  outfile << streamingManager->GetSplit(nbSplits - 1) << std::endl;
+
+  return EXIT_SUCCESS;
+}
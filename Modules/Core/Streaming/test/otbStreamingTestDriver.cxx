@@ -7,6 +7,9 @@ void RegisterTests()
   REGISTER_TEST(otbTileDimensionTiledStreamingManager);
   REGISTER_TEST(otbRAMDrivenTiledStreamingManager);
   REGISTER_TEST(otbRAMDrivenAdaptativeStreamingManager);
+  REGISTER_TEST(otbRAMDrivenFootprintStreamingManager);
   REGISTER_TEST(otbPipelineMemoryPrintCalculatorTest);
   REGISTER_TEST(otbPipelineMemoryPrintCalculatorNew);
+  REGISTER_TEST(otbStreamingCompositeImageFilterNew);
+  REGISTER_TEST(otbStreamingCompositeImageFilter);
 }
@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbPackedRTree_h
+#define __otbPackedRTree_h
+
+#include "itkMacro.h"
+#include <vector>
+
+namespace otb
+{
+/** \class PackedRTree
+ * \brief Static R-tree over 2D bounding boxes, bulk-loaded and packed in arrays.
+ *
+ * The tree is built once from the complete list of boxes with the
+ * Sort-Tile-Recursive algorithm: the boxes are sorted by the x of their
+ * center, cut into vertical slices, each slice is sorted by y and cut into
+ * nodes of NodeCapacity entries. The upper levels are packed the same way.
+ * Nodes are stored level after level in a single array, the children of
+ * a node being contiguous, so that a query only walks indices.
+ *
+ * Boxes are identified by their position in the list given to Build().
+ * Empty boxes are kept in the numbering but never returned by a query.
+ *
+ * \sa VectorDataSpatialIndex
+ *
+ * \ingroup OTBVectorDataBase
+ */
+class ITK_ABI_EXPORT PackedRTree
+{
+public:
+  /** Axis-aligned box, bounds included */
+  class BoxType
+  {
+  public:
+    /** Build an empty box */
+    BoxType();
+    BoxType(double minX, double minY, double maxX, double maxY);
+
+    bool IsEmpty() const
+    {
+      return Min[0] > Max[0] || Min[1] > Max[1];
+    }
+
+    void Expand(double x, double y);
+    void Expand(const BoxType& box);
+
+    bool Intersects(const BoxType& box) const
+    {
+      return !(box.Min[0] > Max[0] || box.Max[0] < Min[0] || box.Min[1] > Max[1] || box.Max[1] < Min[1]);
+    }
+
+    double Min[2];
+    double Max[2];
+  };
+
+  typedef std::vector<BoxType>       BoxListType;
+  typedef std::vector<unsigned long> IndexListType;
+
+  PackedRTree();
+
+  /** Build the tree from the boxes. The previous content is discarded. */
+  void Build(const BoxListType& boxes, unsigned int nodeCapacity = 16);
+
+  /** Remove all the boxes */
+  void Clear();
+
+  /** Append to result the indices of the boxes intersecting box, in
+   * increasing order */
+  void Search(const BoxType& box, IndexListType& result) const;
+
+  unsigned long GetNumberOfBoxes() const
+  {
+    return m_Boxes.size();
+  }
+
+  const BoxType& GetBox(unsigned long i) const
+  {
+    return m_Boxes[i];
+  }
+
+  /** Box containing all the non-empty boxes */
+  BoxType GetBoundingBox() const;
+
+  unsigned long GetNumberOfNodes() const
+  {
+    return m_Nodes.size();
+  }
+
+private:
+  struct NodeType
+  {
+    BoxType       Box;
+    unsigned long First;
+    unsigned long Count;
+    bool          Leaf;
+  };
+
+  typedef std::vector<NodeType> NodeListType;
+
+  BoxListType   m_Boxes;
+  IndexListType m_Entries;
+  NodeListType  m_Nodes;
+  unsigned int  m_NodeCapacity;
+};
+
+} // end namespace otb
+
+#endif
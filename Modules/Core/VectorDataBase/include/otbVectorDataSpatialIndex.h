@@ -0,0 +1,232 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbVectorDataSpatialIndex_h
+#define __otbVectorDataSpatialIndex_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "otbPackedRTree.h"
+
+namespace otb
+{
+/** \class VectorDataSpatialIndex
+ * \brief Packed copy of the geometries of a VectorData with an R-tree on them.
+ *
+ * Build() walks the data tree once and stores:
+ * - the vertices of all the features in one contiguous array of (x, y)
+ * pairs, addressed through per-part and per-feature offsets (a point has
+ * one part, a line one, a polygon its exterior ring then its interior
+ * rings);
+ * - the bounding box of each feature, loaded in a PackedRTree;
+ * - the structure of the tree: every node which is not a point, line or
+ * polygon is a container, and each node knows its parent container and
+ * its rank in the pre-order traversal of the tree.
+ *
+ * Search() then returns the features whose bounding box intersects a
+ * region without walking the tree, so that filters can restrict their
+ * exact tests to these candidates.
+ *
+ * The index does not follow the vector data: IsUpToDate() compares the
+ * modification times of the vector data and of its data tree with the
+ * ones they had at build time. These times do not change for every
+ * edit, in particular not when a DataNode is edited in place, so Build()
+ * must be called again after any change of the tree: adding, removing
+ * or editing a node. The index holds references to the tree nodes, so
+ * that a stale index never points to freed nodes.
+ *
+ * \sa PackedRTree
+ * \sa VectorDataExtractROI
+ *
+ * \ingroup OTBVectorDataBase
+ */
+template <class TVectorData>
+class ITK_EXPORT VectorDataSpatialIndex : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef VectorDataSpatialIndex        Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(VectorDataSpatialIndex, itk::Object);
+
+  typedef TVectorData                                 VectorDataType;
+  typedef typename VectorDataType::ConstPointer       VectorDataConstPointerType;
+  typedef typename VectorDataType::DataNodeType       DataNodeType;
+  typedef typename DataNodeType::Pointer              DataNodePointerType;
+  typedef typename VectorDataType::DataTreeType       DataTreeType;
+  typedef typename DataTreeType::TreeNodeType         TreeNodeType;
+  typedef typename TreeNodeType::Pointer              TreeNodePointerType;
+  typedef typename TreeNodeType::ChildrenListType     ChildrenListType;
+  typedef typename DataNodeType::PolygonType          PolygonType;
+  typedef typename DataNodeType::LineType             LineType;
+  typedef typename PolygonType::VertexListType        VertexListType;
+
+  typedef PackedRTree::BoxType       BoxType;
+  typedef PackedRTree::IndexListType IndexListType;
+
+  /** Index the given vector data, the previous content is discarded */
+  void Build(const VectorDataType * vectorData, unsigned int nodeCapacity = 16);
+
+  /** Release the packed data */
+  void Clear();
+
+  /** True if the index has been built from this vector data and neither
+   * the vector data nor its data tree have been modified since. See the
+   * class documentation for the edits which are not detected. */
+  bool IsUpToDate(const VectorDataType * vectorData) const;
+
+  /** Append to result the features whose bounding box intersects box,
+   * in pre-order */
+  void Search(const BoxType& box, IndexListType& result) const
+  {
+    m_RTree.Search(box, result);
+  }
+
+  /** Features access */
+  unsigned long GetNumberOfFeatures() const
+  {
+    return m_FeatureNodes.size();
+  }
+
+  TreeNodeType * GetFeatureTreeNode(unsigned long feature) const
+  {
+    return m_FeatureNodes[feature].GetPointer();
+  }
+
+  DataNodePointerType GetFeature(unsigned long feature) const
+  {
+    return m_FeatureNodes[feature]->Get();
+  }
+
+  const BoxType& GetFeatureBoundingBox(unsigned long feature) const
+  {
+    return m_RTree.GetBox(feature);
+  }
+
+  /** Container of the feature, -1 for the root of the tree */
+  long GetFeatureParent(unsigned long feature) const
+  {
+    return m_FeatureParents[feature];
+  }
+
+  /** Rank of the feature in the pre-order traversal of the tree */
+  unsigned long GetFeatureOrder(unsigned long feature) const
+  {
+    return m_FeatureOrders[feature];
+  }
+
+  /** Containers access, in pre-order. The root of the tree is not a
+   * container. */
+  unsigned long GetNumberOfContainers() const
+  {
+    return m_ContainerNodes.size();
+  }
+
+  TreeNodeType * GetContainerTreeNode(unsigned long container) const
+  {
+    return m_ContainerNodes[container].GetPointer();
+  }
+
+  long GetContainerParent(unsigned long container) const
+  {
+    return m_ContainerParents[container];
+  }
+
+  unsigned long GetContainerOrder(unsigned long container) const
+  {
+    return m_ContainerOrders[container];
+  }
+
+  /** Packed geometries access. The parts of a feature are numbered from
+   * GetFirstPart(feature) to GetFirstPart(feature + 1) excluded. */
+  unsigned long GetFirstPart(unsigned long feature) const
+  {
+    return m_FeatureOffsets[feature];
+  }
+
+  unsigned long GetNumberOfParts(unsigned long feature) const
+  {
+    return m_FeatureOffsets[feature + 1] - m_FeatureOffsets[feature];
+  }
+
+  unsigned long GetNumberOfVertices(unsigned long part) const
+  {
+    return m_PartOffsets[part + 1] - m_PartOffsets[part];
+  }
+
+  /** Interleaved (x, y) coordinates of the vertices of the part */
+  const double * GetVertices(unsigned long part) const
+  {
+    return m_Coordinates.empty() ? NULL : &m_Coordinates[2 * m_PartOffsets[part]];
+  }
+
+  /** Bounding box of all the features */
+  BoxType GetBoundingBox() const
+  {
+    return m_RTree.GetBoundingBox();
+  }
+
+protected:
+  VectorDataSpatialIndex();
+  virtual ~VectorDataSpatialIndex() {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Pack the children of node, parent being the container of node */
+  void ProcessNode(TreeNodeType * node, long parent, PackedRTree::BoxListType& boxes);
+
+  /** Append a part to the current feature */
+  void AddPart(const VertexListType * vertices, BoxType& box);
+
+private:
+  VectorDataSpatialIndex(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  VectorDataConstPointerType       m_VectorData;
+  unsigned long                    m_VectorDataMTime;
+  unsigned long                    m_DataTreeMTime;
+
+  unsigned long                    m_Order;
+
+  std::vector<TreeNodePointerType> m_ContainerNodes;
+  std::vector<long>                m_ContainerParents;
+  IndexListType                    m_ContainerOrders;
+
+  std::vector<TreeNodePointerType> m_FeatureNodes;
+  std::vector<long>                m_FeatureParents;
+  IndexListType                    m_FeatureOrders;
+
+  std::vector<double>              m_Coordinates;
+  IndexListType                    m_PartOffsets;
+  IndexListType                    m_FeatureOffsets;
+
+  PackedRTree                      m_RTree;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbVectorDataSpatialIndex.txx"
+#endif
+
+#endif
@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbVectorDataSpatialIndex_txx
+#define __otbVectorDataSpatialIndex_txx
+
+#include "otbVectorDataSpatialIndex.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template <class TVectorData>
+VectorDataSpatialIndex<TVectorData>
+::VectorDataSpatialIndex() :
+  m_VectorDataMTime(0),
+  m_DataTreeMTime(0),
+  m_Order(0)
+{
+}
+
+template <class TVectorData>
+void
+VectorDataSpatialIndex<TVectorData>
+::Clear()
+{
+  m_VectorData = NULL;
+  m_VectorDataMTime = 0;
+  m_DataTreeMTime = 0;
+  m_Order = 0;
+  m_ContainerNodes.clear();
+  m_ContainerParents.clear();
+  m_ContainerOrders.clear();
+  m_FeatureNodes.clear();
+  m_FeatureParents.clear();
+  m_FeatureOrders.clear();
+  m_Coordinates.clear();
+  m_PartOffsets.clear();
+  m_FeatureOffsets.clear();
+  m_RTree.Clear();
+  this->Modified();
+}
+
+template <class TVectorData>
+void
+VectorDataSpatialIndex<TVectorData>
+::Build(const VectorDataType * vectorData, unsigned int nodeCapacity)
+{
+  this->Clear();
+  if (vectorData == NULL)
+    {
+    itkExceptionMacro(<< "No vector data to index");
+    }
+
+  m_VectorData = vectorData;
+  m_VectorDataMTime = vectorData->GetMTime();
+  m_DataTreeMTime = vectorData->GetDataTree()->GetMTime();
+
+  m_PartOffsets.push_back(0);
+  m_FeatureOffsets.push_back(0);
+
+  PackedRTree::BoxListType boxes;
+  TreeNodeType * root = const_cast<TreeNodeType *>(vectorData->GetDataTree()->GetRoot());
+  if (root != NULL)
+    {
+    // The root itself is numbered 0
+    m_Order = 1;
+    this->ProcessNode(root, -1, boxes);
+    }
+
+  m_RTree.Build(boxes, nodeCapacity);
+
+  otbMsgDevMacro(<< "VectorDataSpatialIndex: " << m_FeatureNodes.size() << " features, "
+                 << m_PartOffsets.size() - 1 << " parts, " << m_Coordinates.size() / 2 << " vertices, "
+                 << m_RTree.GetNumberOfNodes() << " R-tree nodes");
+}
+
+template <class TVectorData>
+void
+VectorDataSpatialIndex<TVectorData>
+::ProcessNode(TreeNodeType * node, long parent, PackedRTree::BoxListType& boxes)
+{
+  ChildrenListType children = node->GetChildrenList();
+  for (typename ChildrenListType::iterator it = children.begin(); it != children.end(); ++it)
+    {
+    DataNodePointerType dataNode = (*it)->Get();
+
+    if (dataNode->IsPointFeature() || dataNode->IsLineFeature() || dataNode->IsPolygonFeature())
+      {
+      BoxType box;
+      if (dataNode->IsPointFeature())
+        {
+        const typename DataNodeType::PointType point = dataNode->GetPoint();
+        m_Coordinates.push_back(point[0]);
+        m_Coordinates.push_back(point[1]);
+        m_PartOffsets.push_back(m_Coordinates.size() / 2);
+        box.Expand(point[0], point[1]);
+        }
+      else if (dataNode->IsLineFeature())
+        {
+        typename LineType::Pointer line = dataNode->GetLine();
+        this->AddPart(line.IsNotNull() ? line->GetVertexList() : NULL, box);
+        }
+      else
+        {
+        typename PolygonType::Pointer exterior = dataNode->GetPolygonExteriorRing();
+        this->AddPart(exterior.IsNotNull() ? exterior->GetVertexList() : NULL, box);
+
+        typename DataNodeType::PolygonListPointerType interiors = dataNode->GetPolygonInteriorRings();
+        if (interiors.IsNotNull())
+          {
+          for (unsigned int i = 0; i < interiors->Size(); ++i)
+            {
+            this->AddPart(interiors->GetNthElement(i)->GetVertexList(), box);
+            }
+          }
+        }
+
+      m_FeatureNodes.push_back(*it);
+      m_FeatureParents.push_back(parent);
+      m_FeatureOrders.push_back(m_Order++);
+      m_FeatureOffsets.push_back(m_PartOffsets.size() - 1);
+      boxes.push_back(box);
+      }
+    else
+      {
+      const long container = m_ContainerNodes.size();
+      m_ContainerNodes.push_back(*it);
+      m_ContainerParents.push_back(parent);
+      m_ContainerOrders.push_back(m_Order++);
+      this->ProcessNode(*it, container, boxes);
+      }
+    }
+}
+
+template <class TVectorData>
+void
+VectorDataSpatialIndex<TVectorData>
+::AddPart(const VertexListType * vertices, BoxType& box)
+{
+  if (vertices != NULL)
+    {
+    for (typename VertexListType::ConstIterator it = vertices->Begin(); it != vertices->End(); ++it)
+      {
+      m_Coordinates.push_back(it.Value()[0]);
+      m_Coordinates.push_back(it.Value()[1]);
+      box.Expand(it.Value()[0], it.Value()[1]);
+      }
+    }
+  m_PartOffsets.push_back(m_Coordinates.size() / 2);
+}
+
+template <class TVectorData>
+bool
+VectorDataSpatialIndex<TVectorData>
+::IsUpToDate(const VectorDataType * vectorData) const
+{
+  return vectorData != NULL && m_VectorData.GetPointer() == vectorData
+         && vectorData->GetMTime() == m_VectorDataMTime
+         && vectorData->GetDataTree()->GetMTime() == m_DataTreeMTime;
+}
+
+template <class TVectorData>
+void
+VectorDataSpatialIndex<TVectorData>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Number of containers: " << m_ContainerNodes.size() << std::endl;
+  os << indent << "Number of features: " << m_FeatureNodes.size() << std::endl;
+  os << indent << "Number of vertices: " << m_Coordinates.size() / 2 << std::endl;
+  os << indent << "Number of R-tree nodes: " << m_RTree.GetNumberOfNodes() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
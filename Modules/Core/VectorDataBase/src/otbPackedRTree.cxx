@@ -0,0 +1,221 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbPackedRTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace otb
+{
+
+namespace
+{
+/** An entry to pack: its box and what it refers to (a box index for the
+ * leaves, a node of the level below otherwise) */
+typedef std::pair<PackedRTree::BoxType, unsigned long> PackedEntryType;
+
+struct CenterXLess
+{
+  bool operator()(const PackedEntryType& a, const PackedEntryType& b) const
+  {
+    return a.first.Min[0] + a.first.Max[0] < b.first.Min[0] + b.first.Max[0];
+  }
+};
+
+struct CenterYLess
+{
+  bool operator()(const PackedEntryType& a, const PackedEntryType& b) const
+  {
+    return a.first.Min[1] + a.first.Max[1] < b.first.Min[1] + b.first.Max[1];
+  }
+};
+
+/** Sort-Tile-Recursive ordering: after the call, each run of capacity
+ * consecutive entries forms a node */
+void SortTileRecursive(std::vector<PackedEntryType>& entries, unsigned int capacity)
+{
+  const unsigned long nbNodes = (entries.size() + capacity - 1) / capacity;
+  const unsigned long nbSlices = static_cast<unsigned long>(std::ceil(std::sqrt(static_cast<double>(nbNodes))));
+  const unsigned long sliceSize = nbSlices * capacity;
+
+  std::sort(entries.begin(), entries.end(), CenterXLess());
+  for (unsigned long start = 0; start < entries.size(); start += sliceSize)
+    {
+    const unsigned long end = std::min<unsigned long>(start + sliceSize, entries.size());
+    std::sort(entries.begin() + start, entries.begin() + end, CenterYLess());
+    }
+}
+}
+
+PackedRTree::BoxType::BoxType()
+{
+  Min[0] = Min[1] = std::numeric_limits<double>::max();
+  Max[0] = Max[1] = -std::numeric_limits<double>::max();
+}
+
+PackedRTree::BoxType::BoxType(double minX, double minY, double maxX, double maxY)
+{
+  Min[0] = std::min(minX, maxX);
+  Min[1] = std::min(minY, maxY);
+  Max[0] = std::max(minX, maxX);
+  Max[1] = std::max(minY, maxY);
+}
+
+void PackedRTree::BoxType::Expand(double x, double y)
+{
+  Min[0] = std::min(Min[0], x);
+  Min[1] = std::min(Min[1], y);
+  Max[0] = std::max(Max[0], x);
+  Max[1] = std::max(Max[1], y);
+}
+
+void PackedRTree::BoxType::Expand(const BoxType& box)
+{
+  if (!box.IsEmpty())
+    {
+    this->Expand(box.Min[0], box.Min[1]);
+    this->Expand(box.Max[0], box.Max[1]);
+    }
+}
+
+PackedRTree::PackedRTree() :
+  m_NodeCapacity(16)
+{
+}
+
+void PackedRTree::Clear()
+{
+  m_Boxes.clear();
+  m_Entries.clear();
+  m_Nodes.clear();
+}
+
+void PackedRTree::Build(const BoxListType& boxes, unsigned int nodeCapacity)
+{
+  this->Clear();
+  m_Boxes = boxes;
+  m_NodeCapacity = std::max(2u, nodeCapacity);
+
+  std::vector<PackedEntryType> entries;
+  entries.reserve(m_Boxes.size());
+  for (unsigned long i = 0; i < m_Boxes.size(); ++i)
+    {
+    if (!m_Boxes[i].IsEmpty())
+      {
+      entries.push_back(PackedEntryType(m_Boxes[i], i));
+      }
+    }
+  if (entries.empty())
+    {
+    return;
+    }
+
+  // Leaves
+  SortTileRecursive(entries, m_NodeCapacity);
+  m_Entries.reserve(entries.size());
+  NodeListType level;
+  for (unsigned long start = 0; start < entries.size(); start += m_NodeCapacity)
+    {
+    NodeType node;
+    node.First = m_Entries.size();
+    node.Count = std::min<unsigned long>(m_NodeCapacity, entries.size() - start);
+    node.Leaf = true;
+    for (unsigned long i = start; i < start + node.Count; ++i)
+      {
+      node.Box.Expand(entries[i].first);
+      m_Entries.push_back(entries[i].second);
+      }
+    level.push_back(node);
+    }
+
+  // Upper levels: the nodes of a level are stored in m_Nodes in their
+  // packing order, so that the children of a parent are contiguous
+  while (level.size() > 1)
+    {
+    entries.clear();
+    for (unsigned long i = 0; i < level.size(); ++i)
+      {
+      entries.push_back(PackedEntryType(level[i].Box, i));
+      }
+    SortTileRecursive(entries, m_NodeCapacity);
+
+    const unsigned long base = m_Nodes.size();
+    NodeListType        parents;
+    for (unsigned long start = 0; start < entries.size(); start += m_NodeCapacity)
+      {
+      NodeType node;
+      node.First = base + start;
+      node.Count = std::min<unsigned long>(m_NodeCapacity, entries.size() - start);
+      node.Leaf = false;
+      for (unsigned long i = start; i < start + node.Count; ++i)
+        {
+        node.Box.Expand(entries[i].first);
+        m_Nodes.push_back(level[entries[i].second]);
+        }
+      parents.push_back(node);
+      }
+    level.swap(parents);
+    }
+
+  // The root comes last
+  m_Nodes.push_back(level.front());
+}
+
+void PackedRTree::Search(const BoxType& box, IndexListType& result) const
+{
+  if (m_Nodes.empty() || box.IsEmpty() || !m_Nodes.back().Box.Intersects(box))
+    {
+    return;
+    }
+
+  const unsigned long        firstResult = result.size();
+  std::vector<unsigned long> stack(1, m_Nodes.size() - 1);
+  while (!stack.empty())
+    {
+    const NodeType& node = m_Nodes[stack.back()];
+    stack.pop_back();
+
+    for (unsigned long i = node.First; i < node.First + node.Count; ++i)
+      {
+      if (node.Leaf)
+        {
+        if (m_Boxes[m_Entries[i]].Intersects(box))
+          {
+          result.push_back(m_Entries[i]);
+          }
+        }
+      else if (m_Nodes[i].Box.Intersects(box))
+        {
+        stack.push_back(i);
+        }
+      }
+    }
+  std::sort(result.begin() + firstResult, result.end());
+}
+
+PackedRTree::BoxType PackedRTree::GetBoundingBox() const
+{
+  if (m_Nodes.empty())
+    {
+    return BoxType();
+    }
+  return m_Nodes.back().Box;
+}
+
+} // end namespace otb
@@ -12,4 +12,6 @@ void RegisterTests()
   REGISTER_TEST(otbPolyLineParametricPathWithValueNew);
   REGISTER_TEST(otbRemoteSensingRegionNew);
   REGISTER_TEST(otbVectorDataNew);
+  REGISTER_TEST(otbVectorDataSpatialIndexNew);
+  REGISTER_TEST(otbVectorDataSpatialIndex);
 }
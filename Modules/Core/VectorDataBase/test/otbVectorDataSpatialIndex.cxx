@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbMacro.h"
+#include <cstdlib>
+#include <iostream>
+
+#include "otbVectorData.h"
+#include "otbVectorDataSpatialIndex.h"
+
+int otbVectorDataSpatialIndexNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::VectorData<double, 2>                     VectorDataType;
+  typedef otb::VectorDataSpatialIndex<VectorDataType>    SpatialIndexType;
+
+  SpatialIndexType::Pointer index = SpatialIndexType::New();
+
+  std::cout << index << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+int otbVectorDataSpatialIndex(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::VectorData<double, 2>                  VectorDataType;
+  typedef VectorDataType::DataNodeType                DataNodeType;
+  typedef DataNodeType::PointType                     PointType;
+  typedef DataNodeType::LineType                      LineType;
+  typedef DataNodeType::PolygonType                   PolygonType;
+  typedef PolygonType::VertexType                     VertexType;
+  typedef otb::VectorDataSpatialIndex<VectorDataType> SpatialIndexType;
+  typedef SpatialIndexType::BoxType                   BoxType;
+  typedef SpatialIndexType::IndexListType             IndexListType;
+
+  // A document with one folder per row of a 20x20 grid of features
+  // cycling over points, lines and polygons with a hole
+  VectorDataType::Pointer data = VectorDataType::New();
+  DataNodeType::Pointer   root = data->GetDataTree()->GetRoot()->Get();
+  DataNodeType::Pointer   document = DataNodeType::New();
+  document->SetNodeType(otb::DOCUMENT);
+  data->GetDataTree()->Add(document, root);
+
+  std::vector<BoxType>       expectedBoxes;
+  std::vector<unsigned long> expectedVertices;
+  for (unsigned int row = 0; row < 20; ++row)
+    {
+    DataNodeType::Pointer folder = DataNodeType::New();
+    folder->SetNodeType(otb::FOLDER);
+    data->GetDataTree()->Add(folder, document);
+
+    for (unsigned int col = 0; col < 20; ++col)
+      {
+      const double          x = 10. * col;
+      const double          y = 10. * row;
+      DataNodeType::Pointer feature = DataNodeType::New();
+      VertexType            v;
+      switch ((row * 20 + col) % 3)
+        {
+        case 0:
+          {
+          PointType p;
+          p[0] = x;
+          p[1] = y;
+          feature->SetNodeType(otb::FEATURE_POINT);
+          feature->SetPoint(p);
+          expectedBoxes.push_back(BoxType(x, y, x, y));
+          expectedVertices.push_back(1);
+          break;
+          }
+        case 1:
+          {
+          LineType::Pointer l = LineType::New();
+          v[0] = x;
+          v[1] = y;
+          l->AddVertex(v);
+          v[0] = x + 3.;
+          v[1] = y + 7.;
+          l->AddVertex(v);
+          feature->SetNodeType(otb::FEATURE_LINE);
+          feature->SetLine(l);
+          expectedBoxes.push_back(BoxType(x, y, x + 3., y + 7.));
+          expectedVertices.push_back(2);
+          break;
+          }
+        default:
+          {
+          PolygonType::Pointer exterior = PolygonType::New();
+          v[0] = x;
+          v[1] = y;
+          exterior->AddVertex(v);
+          v[0] = x + 8.;
+          exterior->AddVertex(v);
+          v[1] = y + 8.;
+          exterior->AddVertex(v);
+          v[0] = x;
+          exterior->AddVertex(v);
+          PolygonType::Pointer interior = PolygonType::New();
+          v[0] = x + 2.;
+          v[1] = y + 2.;
+          interior->AddVertex(v);
+          v[0] = x + 4.;
+          interior->AddVertex(v);
+          v[1] = y + 4.;
+          interior->AddVertex(v);
+          DataNodeType::PolygonListPointerType interiors = DataNodeType::PolygonListType::New();
+          interiors->PushBack(interior);
+          feature->SetNodeType(otb::FEATURE_POLYGON);
+          feature->SetPolygonExteriorRing(exterior);
+          feature->SetPolygonInteriorRings(interiors);
+          expectedBoxes.push_back(BoxType(x, y, x + 8., y + 8.));
+          expectedVertices.push_back(4);
+          expectedVertices.push_back(3);
+          break;
+          }
+        }
+      data->GetDataTree()->Add(feature, folder);
+      }
+    }
+
+  SpatialIndexType::Pointer index = SpatialIndexType::New();
+  index->Build(data, 4);
+
+  if (index->GetNumberOfFeatures() != expectedBoxes.size() || index->GetNumberOfContainers() != 21)
+    {
+    std::cerr << "Wrong number of features (" << index->GetNumberOfFeatures() << ") or containers ("
+              << index->GetNumberOfContainers() << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Packed storage
+  unsigned long part = 0;
+  for (unsigned long f = 0; f < index->GetNumberOfFeatures(); ++f)
+    {
+    const BoxType& box = index->GetFeatureBoundingBox(f);
+    if (box.Min[0] != expectedBoxes[f].Min[0] || box.Min[1] != expectedBoxes[f].Min[1]
+        || box.Max[0] != expectedBoxes[f].Max[0] || box.Max[1] != expectedBoxes[f].Max[1])
+      {
+      std::cerr << "Wrong bounding box for feature " << f << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (index->GetFirstPart(f) != part || index->GetFeatureParent(f) != static_cast<long>(1 + f / 20))
+      {
+      std::cerr << "Wrong parts or parent for feature " << f << std::endl;
+      return EXIT_FAILURE;
+      }
+    for (unsigned long p = 0; p < index->GetNumberOfParts(f); ++p, ++part)
+      {
+      if (index->GetNumberOfVertices(part) != expectedVertices[part])
+        {
+        std::cerr << "Wrong number of vertices for part " << part << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if (index->GetVertices(index->GetFirstPart(f))[0] != box.Min[0]
+        || index->GetVertices(index->GetFirstPart(f))[1] != box.Min[1])
+      {
+      std::cerr << "Wrong first vertex for feature " << f << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Queries against a brute force scan
+  for (unsigned int q = 0; q < 50; ++q)
+    {
+    const double x = (q * 37) % 200 - 5.;
+    const double y = (q * 53) % 200 - 5.;
+    BoxType      query(x, y, x + (q % 7) * 9., y + (q % 5) * 11.);
+
+    IndexListType result;
+    index->Search(query, result);
+
+    IndexListType expected;
+    for (unsigned long f = 0; f < expectedBoxes.size(); ++f)
+      {
+      if (expectedBoxes[f].Intersects(query))
+        {
+        expected.push_back(f);
+        }
+      }
+
+    if (result != expected)
+      {
+      std::cerr << "Query " << q << ": " << result.size() << " features found, " << expected.size()
+                << " expected" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  if (!index->IsUpToDate(data))
+    {
+    std::cerr << "The index should be up to date" << std::endl;
+    return EXIT_FAILURE;
+    }
+  data->Modified();
+  if (index->IsUpToDate(data))
+    {
+    std::cerr << "The index should be out of date" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
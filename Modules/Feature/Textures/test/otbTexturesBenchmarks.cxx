@@ -0,0 +1,55 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbScalarImageToTexturesFilter.h"
+
+int otbScalarImageToTexturesFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " radius nbBins" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<double, 2>                                       ImageType;
+  typedef otb::ScalarImageToTexturesFilter<ImageType, ImageType>      FilterType;
+
+  FilterType::SizeType radius;
+  radius.Fill(atoi(argv[1]));
+
+  FilterType::OffsetType offset;
+  offset.Fill(1);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(helper->GenerateImage<ImageType>(0., 255.));
+  filter->SetRadius(radius);
+  filter->SetOffset(offset);
+  filter->SetNumberOfBinsPerAxis(atoi(argv[2]));
+  filter->SetInputImageMinimum(0);
+  filter->SetInputImageMaximum(255);
+
+  while (helper->KeepRunning())
+    {
+    filter->Modified();
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbSlidingJoinHistogramMIImageFilter_h
+#define __otbSlidingJoinHistogramMIImageFilter_h
+
+#include "otbJoinHistogramMIImageFilter.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class SlidingJoinHistogramMIImageFilter
+ * \brief JoinHistogramMIImageFilter with running sums over the
+ * neighborhoods.
+ *
+ * The output is the one of JoinHistogramMIImageFilter: for each pixel,
+ * log(N) - sum(f.log(f)) / N, where N is the total frequency of the
+ * joint histogram of the two images, and the sum is over the pixel
+ * pairs of the neighborhood, f being the frequency of the bin of the
+ * pair. The term f.log(f) of each pixel pair is computed once per
+ * thread region, instead of once for each neighborhood containing the
+ * pair. The neighborhood sums are then updated incrementally: a column
+ * sum is updated with the row entering and the row leaving the window,
+ * and the window sum slides along the rows by adding the column
+ * entering and removing the column leaving the window. The cost per
+ * pixel does not depend on the radius anymore.
+ *
+ * The buffers of the threads are reused from one stream to the other.
+ * This filter only processes 2D images.
+ *
+ * \sa JoinHistogramMIImageFilter
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ *
+ * \ingroup OTBChangeDetection
+ */
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+class ITK_EXPORT SlidingJoinHistogramMIImageFilter :
+  public JoinHistogramMIImageFilter<TInputImage1, TInputImage2, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingJoinHistogramMIImageFilter                                    Self;
+  typedef JoinHistogramMIImageFilter<TInputImage1, TInputImage2, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>                                              Pointer;
+  typedef itk::SmartPointer<const Self>                                        ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Macro defining the type*/
+  itkTypeMacro(SlidingJoinHistogramMIImageFilter, JoinHistogramMIImageFilter);
+
+  typedef typename Superclass::Input1ImageType       Input1ImageType;
+  typedef typename Superclass::Input2ImageType       Input2ImageType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImagePixelType  OutputImagePixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::HistogramType         HistogramType;
+
+protected:
+  SlidingJoinHistogramMIImageFilter() {}
+  virtual ~SlidingJoinHistogramMIImageFilter() {}
+
+  /** Compute the joint histogram and allocate the buffers of the threads */
+  virtual void BeforeThreadedGenerateData();
+
+  /** Slide the window along the rows of the region */
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                    itk::ThreadIdType threadId);
+
+private:
+  SlidingJoinHistogramMIImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** f.log(f) of the pixel pairs of the padded region of each thread */
+  std::vector<std::vector<double> > m_ThreadTerms;
+
+  /** Sums of the terms over the window rows, for each column */
+  std::vector<std::vector<double> > m_ThreadColumnSums;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbSlidingJoinHistogramMIImageFilter.txx"
+#endif
+
+#endif
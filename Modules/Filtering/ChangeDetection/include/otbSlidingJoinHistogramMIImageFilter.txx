@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbSlidingJoinHistogramMIImageFilter_txx
+#define __otbSlidingJoinHistogramMIImageFilter_txx
+
+#include "otbSlidingJoinHistogramMIImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void
+SlidingJoinHistogramMIImageFilter<TInputImage1, TInputImage2, TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  if (Input1ImageType::ImageDimension != 2)
+    {
+    itkExceptionMacro(<< "SlidingJoinHistogramMIImageFilter only processes 2D images");
+    }
+
+  Superclass::BeforeThreadedGenerateData();
+
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+  m_ThreadTerms.resize(numberOfThreads);
+  m_ThreadColumnSums.resize(numberOfThreads);
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void
+SlidingJoinHistogramMIImageFilter<TInputImage1, TInputImage2, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  const Input1ImageType * inputPtr1 = dynamic_cast<const Input1ImageType *>(this->itk::ProcessObject::GetInput(0));
+  const Input2ImageType * inputPtr2 = dynamic_cast<const Input2ImageType *>(this->itk::ProcessObject::GetInput(1));
+  OutputImageType *       outputPtr = this->GetOutput();
+  const HistogramType *   histogram = this->m_Histogram;
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const long radius = this->m_Radius;
+  const long width = outputRegionForThread.GetSize(0);
+  const long height = outputRegionForThread.GetSize(1);
+  const long paddedWidth = width + 2 * radius;
+  const long paddedHeight = height + 2 * radius;
+  const long firstX = outputRegionForThread.GetIndex(0) - radius;
+  const long firstY = outputRegionForThread.GetIndex(1) - radius;
+
+  // f.log(f) for each pixel pair of the region padded by the radius.
+  // The neighborhoods are clamped to the buffered regions, as with the
+  // zero flux Neumann boundary condition of JoinHistogramMIImageFilter
+  const typename Input1ImageType::RegionType& buffered1 = inputPtr1->GetBufferedRegion();
+  const typename Input2ImageType::RegionType& buffered2 = inputPtr2->GetBufferedRegion();
+
+  std::vector<double>& terms = m_ThreadTerms[threadId];
+  terms.resize(paddedWidth * paddedHeight);
+
+  typename HistogramType::MeasurementVectorType sample(2);
+  typename HistogramType::IndexType             index;
+  typename Input1ImageType::IndexType           index1;
+  typename Input2ImageType::IndexType           index2;
+
+  for (long y = 0; y < paddedHeight; ++y)
+    {
+    index1[1] = std::min(std::max(firstY + y, static_cast<long>(buffered1.GetIndex(1))),
+                         static_cast<long>(buffered1.GetIndex(1) + buffered1.GetSize(1)) - 1);
+    index2[1] = std::min(std::max(firstY + y, static_cast<long>(buffered2.GetIndex(1))),
+                         static_cast<long>(buffered2.GetIndex(1) + buffered2.GetSize(1)) - 1);
+    for (long x = 0; x < paddedWidth; ++x)
+      {
+      index1[0] = std::min(std::max(firstX + x, static_cast<long>(buffered1.GetIndex(0))),
+                           static_cast<long>(buffered1.GetIndex(0) + buffered1.GetSize(0)) - 1);
+      index2[0] = std::min(std::max(firstX + x, static_cast<long>(buffered2.GetIndex(0))),
+                           static_cast<long>(buffered2.GetIndex(0) + buffered2.GetSize(0)) - 1);
+
+      sample[0] = static_cast<double>(inputPtr1->GetPixel(index1));
+      sample[1] = static_cast<double>(inputPtr2->GetPixel(index2));
+      histogram->GetIndex(sample, index);
+      const double freq = histogram->GetFrequency(index);
+      terms[y * paddedWidth + x] = (freq > 0) ? freq * vcl_log(freq) : 0.;
+      }
+    }
+
+  const double totalFreq = histogram->GetTotalFrequency();
+  const double logTotal = vcl_log(totalFreq);
+
+  // Column sums over the window rows of the first output row
+  std::vector<double>& columnSums = m_ThreadColumnSums[threadId];
+  columnSums.assign(paddedWidth, 0.);
+  for (long y = 0; y <= 2 * radius; ++y)
+    {
+    for (long x = 0; x < paddedWidth; ++x)
+      {
+      columnSums[x] += terms[y * paddedWidth + x];
+      }
+    }
+
+  itk::ImageRegionIterator<OutputImageType> outputIt(outputPtr, outputRegionForThread);
+  outputIt.GoToBegin();
+
+  for (long y = 0; y < height; ++y)
+    {
+    if (y > 0)
+      {
+      // Slide the column sums down: the row y + 2 * radius enters the
+      // window, the row y - 1 leaves it
+      const double * entering = &terms[(y + 2 * radius) * paddedWidth];
+      const double * leaving = &terms[(y - 1) * paddedWidth];
+      for (long x = 0; x < paddedWidth; ++x)
+        {
+        columnSums[x] += entering[x] - leaving[x];
+        }
+      }
+
+    double sum = 0.;
+    for (long x = 0; x <= 2 * radius; ++x)
+      {
+      sum += columnSums[x];
+      }
+
+    for (long x = 0; x < width; ++x)
+      {
+      if (x > 0)
+        {
+        sum += columnSums[x + 2 * radius] - columnSums[x - 1];
+        }
+      outputIt.Set(static_cast<OutputImagePixelType>(-sum / totalFreq + logTotal));
+      ++outputIt;
+      progress.CompletedPixel();
+      }
+    }
+}
+
+} // end namespace otb
+
+#endif
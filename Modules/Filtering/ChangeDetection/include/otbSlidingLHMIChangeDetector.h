@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbSlidingLHMIChangeDetector_h
+#define __otbSlidingLHMIChangeDetector_h
+
+#include "otbLHMIChangeDetector.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class SlidingLHMIChangeDetector
+ * \brief LHMIChangeDetector with a joint histogram updated incrementally
+ * along the rows.
+ *
+ * The output is the one of LHMIChangeDetector: the ratio of the joint
+ * entropy of the two neighborhoods to the sum of their marginal
+ * entropies, with the same 256x256 bins (the pixel values, truncated,
+ * are the bin indexes). But instead of building a new histogram for
+ * each pixel, the window slides along the rows: moving to the next
+ * pixel removes the leftmost column of the neighborhood from the
+ * histogram and inserts the new rightmost one, and the sums of
+ * n.log(n) over the bins, from which the entropies are computed, are
+ * updated with the counts that change. The cost per pixel is
+ * proportional to the radius instead of the size of the neighborhood.
+ *
+ * Each thread reuses its histogram buffers from one stream to the
+ * other. Windows where both neighborhoods are uniform, for which
+ * LHMIChangeDetector divides zero by zero, give 0.
+ *
+ * This filter only processes 2D images.
+ *
+ * \sa LHMIChangeDetector
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ *
+ * \ingroup OTBChangeDetection
+ */
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+class ITK_EXPORT SlidingLHMIChangeDetector :
+  public LHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingLHMIChangeDetector                                    Self;
+  typedef LHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>                                      Pointer;
+  typedef itk::SmartPointer<const Self>                                ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Macro defining the type*/
+  itkTypeMacro(SlidingLHMIChangeDetector, LHMIChangeDetector);
+
+  typedef typename Superclass::Input1ImageType       Input1ImageType;
+  typedef typename Superclass::Input1ImagePixelType  Input1ImagePixelType;
+  typedef typename Superclass::Input2ImageType       Input2ImageType;
+  typedef typename Superclass::Input2ImagePixelType  Input2ImagePixelType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImagePixelType  OutputImagePixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Number of bins of each dimension of the histograms, as in Functor::LHMI */
+  itkStaticConstMacro(NumberOfBins, long, 256);
+
+protected:
+  SlidingLHMIChangeDetector() {}
+  virtual ~SlidingLHMIChangeDetector() {}
+
+  /** Allocate the histograms of the threads */
+  virtual void BeforeThreadedGenerateData();
+
+  /** Slide the window along the rows of the region */
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                    itk::ThreadIdType threadId);
+
+private:
+  SlidingLHMIChangeDetector(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** Joint and marginal histograms of a window, with their sums of
+   * n.log(n) over the bins and their numbers of non-empty bins */
+  class WindowHistogram
+  {
+  public:
+    std::vector<unsigned int> m_Joint;
+    std::vector<unsigned int> m_First;
+    std::vector<unsigned int> m_Second;
+    double                    m_JointSum;
+    double                    m_FirstSum;
+    double                    m_SecondSum;
+    unsigned long             m_JointBins;
+    unsigned long             m_FirstBins;
+    unsigned long             m_SecondBins;
+    unsigned long             m_TotalFrequency;
+
+    void Clear();
+    inline void Add(long a, long b, const std::vector<double>& nlogn);
+    inline void Remove(long a, long b, const std::vector<double>& nlogn);
+    inline double Evaluate() const;
+  };
+
+  std::vector<WindowHistogram> m_ThreadHistograms;
+
+  /** n.log(n) for the possible counts of a bin */
+  std::vector<double> m_NLogN;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbSlidingLHMIChangeDetector.txx"
+#endif
+
+#endif
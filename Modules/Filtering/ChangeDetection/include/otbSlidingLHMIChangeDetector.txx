@@ -0,0 +1,276 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbSlidingLHMIChangeDetector_txx
+#define __otbSlidingLHMIChangeDetector_txx
+
+#include "otbSlidingLHMIChangeDetector.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::WindowHistogram
+::Clear()
+{
+  m_Joint.assign(NumberOfBins * NumberOfBins, 0);
+  m_First.assign(NumberOfBins, 0);
+  m_Second.assign(NumberOfBins, 0);
+  m_JointSum = 0.;
+  m_FirstSum = 0.;
+  m_SecondSum = 0.;
+  m_JointBins = 0;
+  m_FirstBins = 0;
+  m_SecondBins = 0;
+  m_TotalFrequency = 0;
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+inline void
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::WindowHistogram
+::Add(long a, long b, const std::vector<double>& nlogn)
+{
+  // Same bin as itk::Statistics::Histogram::IncreaseFrequencyOfIndex():
+  // the samples out of the histogram are ignored
+  const long id = a + NumberOfBins * b;
+  if (id < 0 || id >= NumberOfBins * NumberOfBins)
+    {
+    return;
+    }
+
+  unsigned int& joint = m_Joint[id];
+  m_JointSum += nlogn[joint + 1] - nlogn[joint];
+  m_JointBins += (joint == 0);
+  ++joint;
+
+  unsigned int& first = m_First[id % NumberOfBins];
+  m_FirstSum += nlogn[first + 1] - nlogn[first];
+  m_FirstBins += (first == 0);
+  ++first;
+
+  unsigned int& second = m_Second[id / NumberOfBins];
+  m_SecondSum += nlogn[second + 1] - nlogn[second];
+  m_SecondBins += (second == 0);
+  ++second;
+
+  ++m_TotalFrequency;
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+inline void
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::WindowHistogram
+::Remove(long a, long b, const std::vector<double>& nlogn)
+{
+  const long id = a + NumberOfBins * b;
+  if (id < 0 || id >= NumberOfBins * NumberOfBins)
+    {
+    return;
+    }
+
+  unsigned int& joint = m_Joint[id];
+  --joint;
+  m_JointSum += nlogn[joint] - nlogn[joint + 1];
+  m_JointBins -= (joint == 0);
+
+  unsigned int& first = m_First[id % NumberOfBins];
+  --first;
+  m_FirstSum += nlogn[first] - nlogn[first + 1];
+  m_FirstBins -= (first == 0);
+
+  unsigned int& second = m_Second[id / NumberOfBins];
+  --second;
+  m_SecondSum += nlogn[second] - nlogn[second + 1];
+  m_SecondBins -= (second == 0);
+
+  --m_TotalFrequency;
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+inline double
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::WindowHistogram
+::Evaluate() const
+{
+  if (m_TotalFrequency == 0)
+    {
+    return 0.;
+    }
+
+  // H = log(N) - sum(n.log(n)) / N, exactly 0 if there is a single bin
+  const double totalFreq = static_cast<double>(m_TotalFrequency);
+  const double logTotal = vcl_log(totalFreq);
+  const double entropyX = (m_FirstBins > 1) ? logTotal - m_FirstSum / totalFreq : 0.;
+  const double entropyY = (m_SecondBins > 1) ? logTotal - m_SecondSum / totalFreq : 0.;
+  const double jointEntropy = (m_JointBins > 1) ? logTotal - m_JointSum / totalFreq : 0.;
+
+  if (entropyX + entropyY <= 0.)
+    {
+    return 0.;
+    }
+  return jointEntropy / (entropyX + entropyY);
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  if (Input1ImageType::ImageDimension != 2)
+    {
+    itkExceptionMacro(<< "SlidingLHMIChangeDetector only processes 2D images");
+    }
+
+  const unsigned long windowSize = (2 * this->m_Radius[0] + 1) * (2 * this->m_Radius[1] + 1);
+  if (m_NLogN.size() != windowSize + 1)
+    {
+    m_NLogN.resize(windowSize + 1);
+    m_NLogN[0] = 0.;
+    for (unsigned long n = 1; n <= windowSize; ++n)
+      {
+      m_NLogN[n] = n * vcl_log(static_cast<double>(n));
+      }
+    }
+
+  // The histograms are empty at the end of each row: they are only
+  // allocated once
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+  if (m_ThreadHistograms.size() != numberOfThreads)
+    {
+    m_ThreadHistograms.resize(numberOfThreads);
+    for (unsigned int i = 0; i < numberOfThreads; ++i)
+      {
+      m_ThreadHistograms[i].Clear();
+      }
+    }
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void
+SlidingLHMIChangeDetector<TInputImage1, TInputImage2, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  const Input1ImageType * inputPtr1 = dynamic_cast<const Input1ImageType *>(this->itk::ProcessObject::GetInput(0));
+  const Input2ImageType * inputPtr2 = dynamic_cast<const Input2ImageType *>(this->itk::ProcessObject::GetInput(1));
+  OutputImageType *       outputPtr = this->GetOutput();
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const long radiusX = this->m_Radius[0];
+  const long radiusY = this->m_Radius[1];
+
+  // The neighborhoods are clamped to the buffered regions, as with the
+  // zero flux Neumann boundary condition of LHMIChangeDetector
+  const typename Input1ImageType::RegionType& buffered1 = inputPtr1->GetBufferedRegion();
+  const typename Input2ImageType::RegionType& buffered2 = inputPtr2->GetBufferedRegion();
+  const long startX1 = buffered1.GetIndex(0);
+  const long endX1 = startX1 + static_cast<long>(buffered1.GetSize(0)) - 1;
+  const long startY1 = buffered1.GetIndex(1);
+  const long endY1 = startY1 + static_cast<long>(buffered1.GetSize(1)) - 1;
+  const long startX2 = buffered2.GetIndex(0);
+  const long endX2 = startX2 + static_cast<long>(buffered2.GetSize(0)) - 1;
+  const long startY2 = buffered2.GetIndex(1);
+  const long endY2 = startY2 + static_cast<long>(buffered2.GetSize(1)) - 1;
+
+  const long firstX = outputRegionForThread.GetIndex(0);
+  const long lastX = firstX + static_cast<long>(outputRegionForThread.GetSize(0)) - 1;
+  const long firstY = outputRegionForThread.GetIndex(1);
+  const long lastY = firstY + static_cast<long>(outputRegionForThread.GetSize(1)) - 1;
+
+  const Input1ImagePixelType * buffer1 = inputPtr1->GetBufferPointer();
+  const Input2ImagePixelType * buffer2 = inputPtr2->GetBufferPointer();
+
+  std::vector<const Input1ImagePixelType *> rows1(2 * radiusY + 1);
+  std::vector<const Input2ImagePixelType *> rows2(2 * radiusY + 1);
+
+  WindowHistogram&           histogram = m_ThreadHistograms[threadId];
+  const std::vector<double>& nlogn = m_NLogN;
+
+  itk::ImageRegionIterator<OutputImageType> outputIt(outputPtr, outputRegionForThread);
+  outputIt.GoToBegin();
+
+  for (long y = firstY; y <= lastY; ++y)
+    {
+    for (long dy = -radiusY; dy <= radiusY; ++dy)
+      {
+      const long y1 = std::min(std::max(y + dy, startY1), endY1);
+      const long y2 = std::min(std::max(y + dy, startY2), endY2);
+      rows1[dy + radiusY] = buffer1 + (y1 - startY1) * buffered1.GetSize(0);
+      rows2[dy + radiusY] = buffer2 + (y2 - startY2) * buffered2.GetSize(0);
+      }
+
+    // Window of the first pixel of the row
+    for (long x = firstX - radiusX; x <= firstX + radiusX; ++x)
+      {
+      const long x1 = std::min(std::max(x, startX1), endX1) - startX1;
+      const long x2 = std::min(std::max(x, startX2), endX2) - startX2;
+      for (unsigned int k = 0; k < rows1.size(); ++k)
+        {
+        histogram.Add(static_cast<long>(rows1[k][x1]), static_cast<long>(rows2[k][x2]), nlogn);
+        }
+      }
+
+    for (long x = firstX; x <= lastX; ++x)
+      {
+      outputIt.Set(static_cast<OutputImagePixelType>(histogram.Evaluate()));
+      ++outputIt;
+      progress.CompletedPixel();
+
+      // Slide the window: remove the leftmost column, insert the next one
+      if (x < lastX)
+        {
+        const long outX1 = std::min(std::max(x - radiusX, startX1), endX1) - startX1;
+        const long outX2 = std::min(std::max(x - radiusX, startX2), endX2) - startX2;
+        const long inX1 = std::min(std::max(x + radiusX + 1, startX1), endX1) - startX1;
+        const long inX2 = std::min(std::max(x + radiusX + 1, startX2), endX2) - startX2;
+        for (unsigned int k = 0; k < rows1.size(); ++k)
+          {
+          histogram.Remove(static_cast<long>(rows1[k][outX1]), static_cast<long>(rows2[k][outX2]), nlogn);
+          histogram.Add(static_cast<long>(rows1[k][inX1]), static_cast<long>(rows2[k][inX2]), nlogn);
+          }
+        }
+      }
+
+    // Empty the histogram for the next row
+    for (long x = lastX - radiusX; x <= lastX + radiusX; ++x)
+      {
+      const long x1 = std::min(std::max(x, startX1), endX1) - startX1;
+      const long x2 = std::min(std::max(x, startX2), endX2) - startX2;
+      for (unsigned int k = 0; k < rows1.size(); ++k)
+        {
+        histogram.Remove(static_cast<long>(rows1[k][x1]), static_cast<long>(rows2[k][x2]), nlogn);
+        }
+      }
+    // Reset the sums, to avoid the accumulation of rounding errors
+    histogram.m_JointSum = 0.;
+    histogram.m_FirstSum = 0.;
+    histogram.m_SecondSum = 0.;
+    }
+}
+
+} // end namespace otb
+
+#endif
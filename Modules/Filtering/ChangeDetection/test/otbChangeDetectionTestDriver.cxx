@@ -15,4 +15,6 @@ void RegisterTests()
   REGISTER_TEST(otbMeanRatioChangeDetectionTest);
   REGISTER_TEST(otbKullbackLeiblerDistanceImageFilterNew);
   REGISTER_TEST(otbLHMIChangeDetectionTest);
+  REGISTER_TEST(otbSlidingLHMIChangeDetectionTest);
+  REGISTER_TEST(otbSlidingJHMIChangeDetectionTest);
 }
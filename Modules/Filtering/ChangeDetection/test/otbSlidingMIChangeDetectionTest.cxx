@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbImage.h"
+#include "otbLHMIChangeDetector.h"
+#include "otbSlidingLHMIChangeDetector.h"
+#include "otbJoinHistogramMIImageFilter.h"
+#include "otbSlidingJoinHistogramMIImageFilter.h"
+
+typedef otb::Image<double, 2>                     SlidingMIImageType;
+typedef otb::ImageFileReader<SlidingMIImageType>  SlidingMIReaderType;
+typedef otb::ImageFileWriter<SlidingMIImageType>  SlidingMIWriterType;
+
+template <class TReferenceFilter, class TSlidingFilter>
+int SlidingMIChangeDetectionTest(char* argv[])
+{
+  const char *       inputFilename1  = argv[1];
+  const char *       inputFilename2  = argv[2];
+  const unsigned int radius = atoi(argv[3]);
+  const char *       referenceFilename = argv[4];
+  const char *       slidingFilename = argv[5];
+
+  SlidingMIReaderType::Pointer reader1 = SlidingMIReaderType::New();
+  SlidingMIReaderType::Pointer reader2 = SlidingMIReaderType::New();
+  reader1->SetFileName(inputFilename1);
+  reader2->SetFileName(inputFilename2);
+
+  // Both outputs are written in several streams: the joint histogram of
+  // JoinHistogramMIImageFilter is computed on the requested region, and
+  // the sliding filters have to reuse their buffers from one stream to
+  // the other
+
+  // Original filter, which goes through the whole neighborhood of each
+  // pixel
+  typename TReferenceFilter::Pointer reference = TReferenceFilter::New();
+  reference->SetInput1(reader1->GetOutput());
+  reference->SetInput2(reader2->GetOutput());
+  reference->SetRadius(radius);
+
+  SlidingMIWriterType::Pointer writer = SlidingMIWriterType::New();
+  writer->SetFileName(referenceFilename);
+  writer->SetInput(reference->GetOutput());
+  writer->SetNumberOfDivisionsStrippedStreaming(5);
+  writer->Update();
+
+  // Sliding version
+  typename TSlidingFilter::Pointer sliding = TSlidingFilter::New();
+  sliding->SetInput1(reader1->GetOutput());
+  sliding->SetInput2(reader2->GetOutput());
+  sliding->SetRadius(radius);
+
+  writer = SlidingMIWriterType::New();
+  writer->SetFileName(slidingFilename);
+  writer->SetInput(sliding->GetOutput());
+  writer->SetNumberOfDivisionsStrippedStreaming(5);
+  writer->Update();
+
+  return EXIT_SUCCESS;
+}
+
+int otbSlidingLHMIChangeDetectionTest(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::LHMIChangeDetector<SlidingMIImageType, SlidingMIImageType, SlidingMIImageType>        ReferenceFilterType;
+  typedef otb::SlidingLHMIChangeDetector<SlidingMIImageType, SlidingMIImageType, SlidingMIImageType> SlidingFilterType;
+
+  return SlidingMIChangeDetectionTest<ReferenceFilterType, SlidingFilterType>(argv);
+}
+
+int otbSlidingJHMIChangeDetectionTest(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::JoinHistogramMIImageFilter<SlidingMIImageType, SlidingMIImageType, SlidingMIImageType>        ReferenceFilterType;
+  typedef otb::SlidingJoinHistogramMIImageFilter<SlidingMIImageType, SlidingMIImageType, SlidingMIImageType> SlidingFilterType;
+
+  return SlidingMIChangeDetectionTest<ReferenceFilterType, SlidingFilterType>(argv);
+}
@@ -129,6 +129,41 @@ private:
   ClampVectorImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  /** Per band clamping, applied on the raw band-interleaved buffers
+   *  (see ProcessBandInterleavedRegion) */
+  class ClampKernel
+  {
+  public:
+    ClampKernel(double dlower, double dupper,
+                OutputImageInternalPixelType lower, OutputImageInternalPixelType upper)
+      : m_DLower(dlower), m_DUpper(dupper), m_Lower(lower), m_Upper(upper) {}
+
+    inline OutputImageInternalPixelType operator()(const InputImageInternalPixelType& in,
+                                                   unsigned int itkNotUsed(band)) const
+    {
+      // Cast the value of the pixel to double in order to compare
+      // with the double version of the upper and the lower bounds of
+      // output image
+      const double value = static_cast<double>(in);
+
+      if (value < m_DLower)
+        {
+        return m_Lower;
+        }
+      if (value > m_DUpper)
+        {
+        return m_Upper;
+        }
+      return static_cast<OutputImageInternalPixelType>(value);
+    }
+
+  private:
+    double                       m_DLower;
+    double                       m_DUpper;
+    OutputImageInternalPixelType m_Lower;
+    OutputImageInternalPixelType m_Upper;
+  };
+
   double m_DLower;
   double m_DUpper;
 
@@ -19,7 +19,7 @@
 #define __otbClampVectorImageFilter_txx
 
 #include "otbClampVectorImageFilter.h"
-#include "itkImageRegionIterator.h"
+#include "otbFixedBandCountDispatch.h"
 #include "itkNumericTraits.h"
 #include "itkObjectFactory.h"
 #include "itkProgressReporter.h"
@@ -136,53 +136,13 @@ ClampVectorImageFilter<TInputImage, TOutputImage>
   InputImagePointer  inputPtr  = this->GetInput();
   OutputImagePointer outputPtr = this->GetOutput(0);
 
-  // Define/declare an iterator that will walk the output region for this
-  // thread.
-  typedef itk::ImageRegionConstIterator<TInputImage> InputIterator;
-  typedef itk::ImageRegionIterator<TOutputImage>      OutputIterator;
-
-  InputIterator  inIt(inputPtr, outputRegionForThread);
-  OutputIterator outIt(outputPtr, outputRegionForThread);
-
   // support progress methods/callbacks
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
-  // walk the regions, threshold each pixel
-  while( !outIt.IsAtEnd() && !inIt.IsAtEnd()  )
-    {
-    const InputImagePixelType inPix = inIt.Get();
-    unsigned int l_size = inPix.Size();
-    OutputImagePixelType outPix;
-    outPix.SetSize(l_size);
-    for(unsigned int i=0; i<l_size; i++)
-      {
-      // Cast the value of the pixel to double in order to compare
-      // with the double version of the upper and the lower bounds of
-      // output image
-      const double value = static_cast<double>(inPix[i]);
-
-      if ( m_DLower <= value && value <= m_DUpper )
-        {
-        // pixel passes to output unchanged and is replaced by m_OutsideValue in
-        // the inverse output image
-        outPix[i] = static_cast<OutputImageInternalPixelType>(value);
-        }
-      else if ( value < m_DLower )
-        {
-        outPix[i] = m_Lower;
-        }
-      else if ( value > m_DUpper )
-        {
-        outPix[i] = m_Upper;
-        }
-
-      }
-    outIt.Set( outPix );
-
-    ++inIt;
-    ++outIt;
-    progress.CompletedPixel();
-    }
+  // walk the regions scanline by scanline, threshold each band
+  ClampKernel kernel(m_DLower, m_DUpper, m_Lower, m_Upper);
+  ProcessBandInterleavedRegion(inputPtr.GetPointer(), outputPtr.GetPointer(),
+                               outputRegionForThread, kernel, progress);
 }
 
 } // end namespace itk
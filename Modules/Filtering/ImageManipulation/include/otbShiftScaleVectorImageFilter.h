@@ -20,6 +20,7 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "itkVariableLengthVector.h"
+#include <vector>
 
 namespace otb
 {
@@ -170,6 +171,7 @@ public:
   typedef typename OutputPixelType::ValueType                                OutputValueType;
   typedef typename itk::NumericTraits<InputValueType>::RealType              InputRealType;
   typedef typename itk::NumericTraits<OutputValueType>::RealType             OutputRealType;
+  typedef typename Superclass::OutputImageRegionType                         OutputImageRegionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -197,10 +199,35 @@ protected:
   /** Generate input requested region */
   void GenerateInputRequestedRegion(void);
 
+  /** Apply the shift and scale directly on the band-interleaved
+   *  buffers, with a band loop instantiated for the common band
+   *  counts (see ProcessBandInterleavedRegion). The results are the
+   *  same as the ones of Functor::VectorShiftScale. */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            itk::ThreadIdType threadId);
+
 private:
   ShiftScaleVectorImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  /** Per band shift and scale, with precomputed inverted scales */
+  class ShiftScaleKernel
+  {
+  public:
+    ShiftScaleKernel(const std::vector<InputValueType>& shift,
+                     const std::vector<InputRealType>& invertedScale)
+      : m_Shift(&shift[0]), m_InvertedScale(&invertedScale[0]) {}
+
+    inline OutputValueType operator()(const InputValueType& in, unsigned int band) const
+    {
+      return static_cast<OutputValueType>(m_InvertedScale[band] * (in - m_Shift[band]));
+    }
+
+  private:
+    const InputValueType * m_Shift;
+    const InputRealType * m_InvertedScale;
+  };
+
   InputPixelType  m_Scale;
   InputPixelType  m_Shift;
 
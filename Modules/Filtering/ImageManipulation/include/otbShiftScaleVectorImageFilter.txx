@@ -22,6 +22,8 @@
 #define __otbShiftScaleVectorImageFilter_txx
 
 #include "otbShiftScaleVectorImageFilter.h"
+#include "otbFixedBandCountDispatch.h"
+#include "itkProgressReporter.h"
 
 namespace otb
 {
@@ -67,5 +69,45 @@ ShiftScaleVectorImageFilter<TInputImage, TOutputImage>
   this->GetFunctor().SetShiftValues(m_Shift);
 }
 
+
+/**
+ * ThreadedGenerateData performs the pixel-wise transform on the raw buffers.
+ */
+template <class TInputImage, class TOutputImage>
+void
+ShiftScaleVectorImageFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  const TInputImage * inputPtr  = this->GetInput();
+  TOutputImage *      outputPtr = this->GetOutput();
+
+  const unsigned int nbBands = inputPtr->GetNumberOfComponentsPerPixel();
+
+  // consistency checking
+  if (nbBands != m_Scale.GetSize() || nbBands != m_Shift.GetSize())
+    {
+    itkExceptionMacro(<< "Pixel size different from scale or shift size !");
+    }
+
+  // Same computation as Functor::VectorShiftScale, which stores the
+  // scales in the output pixel type and inverts them in that type (an
+  // integer division for integer outputs): a null scale only applies
+  // the shift
+  std::vector<InputValueType> shift(nbBands);
+  std::vector<InputRealType> invertedScale(nbBands);
+  for (unsigned int i = 0; i < nbBands; ++i)
+    {
+    shift[i] = m_Shift[i];
+    const OutputValueType scale = static_cast<OutputValueType>(m_Scale[i]);
+    invertedScale[i] = scale > 1e-10 ? static_cast<InputRealType>(1 / scale) : 1;
+    }
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  ShiftScaleKernel kernel(shift, invertedScale);
+  ProcessBandInterleavedRegion(inputPtr, outputPtr, outputRegionForThread, kernel, progress);
+}
+
 } // end namespace otb
 #endif
@@ -0,0 +1,62 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbStreamingResampleImageFilter.h"
+#include "itkScaleTransform.h"
+
+int otbStreamingResampleImageFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " scaleFactor" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<float, 2>                                       ImageType;
+  typedef itk::ScaleTransform<double, 2>                             TransformType;
+  typedef otb::StreamingResampleImageFilter<ImageType, ImageType, double> FilterType;
+
+  const double scale = atof(argv[1]);
+
+  ImageType::Pointer image = helper->GenerateImage<ImageType>(0., 255.);
+
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::ScaleType scales;
+  scales.Fill(1. / scale);
+  transform->SetScale(scales);
+
+  FilterType::SizeType size;
+  size[0] = static_cast<unsigned long>(helper->GetSizeX() * scale);
+  size[1] = static_cast<unsigned long>(helper->GetSizeY() * scale);
+  helper->SetPixelsPerRepetition(size[0] * size[1]);
+
+  while (helper->KeepRunning())
+    {
+    // The filter runs a mini-pipeline, which is not updated again if only
+    // the filter is modified: use a new filter at each iteration
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetTransform(transform);
+    filter->SetOutputSize(size);
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
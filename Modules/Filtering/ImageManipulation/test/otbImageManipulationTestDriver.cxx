@@ -42,6 +42,7 @@ void RegisterTests()
   REGISTER_TEST(otbChangeLabelImageFilter);
   REGISTER_TEST(otbClampVectorImageFilterNew);
   REGISTER_TEST(otbClampVectorImageFilterTest);
+  REGISTER_TEST(otbVectorImageBandDispatchBenchmark);
   REGISTER_TEST(otbPrintableImageFilterNew);
   REGISTER_TEST(otbShiftScaleImageAdaptorNew);
   REGISTER_TEST(otbStreamingInnerProductVectorImageFilterNew);
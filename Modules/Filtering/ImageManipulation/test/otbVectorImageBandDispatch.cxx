@@ -0,0 +1,245 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbClampVectorImageFilter.h"
+#include "otbShiftScaleVectorImageFilter.h"
+#include "otbVectorImage.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTimeProbe.h"
+
+namespace
+{
+typedef float                                 InputPixelType;
+typedef unsigned short                        OutputPixelType;
+typedef otb::VectorImage<InputPixelType, 2>   InputImageType;
+typedef otb::VectorImage<OutputPixelType, 2>  OutputImageType;
+typedef otb::VectorImage<float, 2>            RealImageType;
+
+/** Per pixel clamping, as done by ClampVectorImageFilter before the
+ *  band-interleaved fast path */
+class VectorClampFunctor
+{
+public:
+  VectorClampFunctor() : m_Lower(0.), m_Upper(0.) {}
+
+  void SetBounds(double lower, double upper)
+  {
+    m_Lower = lower;
+    m_Upper = upper;
+  }
+
+  bool operator !=(const VectorClampFunctor& other) const
+  {
+    return m_Lower != other.m_Lower || m_Upper != other.m_Upper;
+  }
+
+  bool operator ==(const VectorClampFunctor& other) const
+  {
+    return !(*this != other);
+  }
+
+  inline OutputImageType::PixelType operator ()(const InputImageType::PixelType& in) const
+  {
+    OutputImageType::PixelType out;
+    out.SetSize(in.Size());
+    for (unsigned int i = 0; i < in.Size(); ++i)
+      {
+      const double value = static_cast<double>(in[i]);
+      if (value < m_Lower)
+        {
+        out[i] = static_cast<OutputPixelType>(m_Lower);
+        }
+      else if (value > m_Upper)
+        {
+        out[i] = static_cast<OutputPixelType>(m_Upper);
+        }
+      else
+        {
+        out[i] = static_cast<OutputPixelType>(value);
+        }
+      }
+    return out;
+  }
+
+private:
+  double m_Lower;
+  double m_Upper;
+};
+
+InputImageType::Pointer GenerateImage(unsigned int size, unsigned int nbBands)
+{
+  InputImageType::RegionType region;
+  region.SetSize(0, size);
+  region.SetSize(1, size);
+
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  InputImageType::PixelType pixel;
+  pixel.SetSize(nbBands);
+
+  itk::ImageRegionIterator<InputImageType> it(image, region);
+  unsigned long n = 0;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, ++n)
+    {
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      pixel[b] = static_cast<InputPixelType>((n * 37 + b * 101) % 1200) - 100.25f;
+      }
+    it.Set(pixel);
+    }
+  return image;
+}
+
+template <class TImage>
+bool CompareImages(const TImage * ref, const TImage * res)
+{
+  itk::ImageRegionConstIterator<TImage> refIt(ref, ref->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> resIt(res, res->GetLargestPossibleRegion());
+
+  for (refIt.GoToBegin(), resIt.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++resIt)
+    {
+    if (refIt.Get() != resIt.Get())
+      {
+      std::cerr << "Pixel " << refIt.GetIndex() << " differs: " << refIt.Get() << " (generic path) / "
+                << resIt.Get() << " (band-interleaved path)" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+/** Run a filter and return the throughput in Mpixels/s */
+double Run(itk::ProcessObject * filter, unsigned long nbPixels)
+{
+  itk::TimeProbe chrono;
+  chrono.Start();
+  filter->Update();
+  chrono.Stop();
+
+  return chrono.GetTotal() > 0 ? nbPixels / chrono.GetTotal() / 1e6 : 0.;
+}
+}
+
+/** Benchmark ClampVectorImageFilter and ShiftScaleVectorImageFilter
+ *  against the generic per pixel itk::VariableLengthVector functor, and
+ *  check that both paths give the same results */
+int otbVectorImageBandDispatchBenchmark(int itkNotUsed(argc), char * argv[])
+{
+  const unsigned int size = atoi(argv[1]);
+  const unsigned long nbPixels = static_cast<unsigned long>(size) * size;
+
+  typedef otb::ClampVectorImageFilter<InputImageType, OutputImageType>       ClampFilterType;
+  typedef itk::UnaryFunctorImageFilter<InputImageType, OutputImageType,
+                                       VectorClampFunctor>                    GenericClampFilterType;
+  typedef otb::ShiftScaleVectorImageFilter<InputImageType, RealImageType>    ShiftScaleFilterType;
+  typedef itk::UnaryFunctorImageFilter<InputImageType, RealImageType,
+                                       ShiftScaleFilterType::FunctorType>     GenericShiftScaleFilterType;
+  typedef otb::ShiftScaleVectorImageFilter<InputImageType, OutputImageType>  IntegerShiftScaleFilterType;
+  typedef itk::UnaryFunctorImageFilter<InputImageType, OutputImageType,
+                                       IntegerShiftScaleFilterType::FunctorType>
+                                                                              GenericIntegerShiftScaleFilterType;
+
+  // Band counts with a dedicated loop, and a few using the generic one
+  const unsigned int bandCounts[] = {1, 2, 3, 4, 5, 8, 13, 16};
+  const unsigned int nbCases = sizeof(bandCounts) / sizeof(bandCounts[0]);
+
+  bool success = true;
+
+  std::cout << "Bands\tFilter\tGeneric (Mpix/s)\tBand-interleaved (Mpix/s)" << std::endl;
+
+  for (unsigned int c = 0; c < nbCases; ++c)
+    {
+    const unsigned int nbBands = bandCounts[c];
+    InputImageType::Pointer image = GenerateImage(size, nbBands);
+
+    // Clamping
+    ClampFilterType::Pointer clamp = ClampFilterType::New();
+    clamp->SetInput(image);
+    clamp->ClampOutside(0, 1000);
+
+    GenericClampFilterType::Pointer genericClamp = GenericClampFilterType::New();
+    genericClamp->SetInput(image);
+    genericClamp->GetFunctor().SetBounds(0, 1000);
+    genericClamp->GetOutput()->SetNumberOfComponentsPerPixel(nbBands);
+
+    const double genericClampRate = Run(genericClamp, nbPixels);
+    const double clampRate = Run(clamp, nbPixels);
+
+    std::cout << nbBands << "\tClamp\t" << genericClampRate << "\t" << clampRate << std::endl;
+    success = CompareImages(genericClamp->GetOutput(), clamp->GetOutput()) && success;
+
+    // Shift and scale
+    InputImageType::PixelType shift, scale;
+    shift.SetSize(nbBands);
+    scale.SetSize(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      shift[b] = -150.f + 10.f * b;
+      // Powers of two have an exact inverse in single and double
+      // precision, and null scales only apply the shift
+      scale[b] = b % 4 == 3 ? 0.f : static_cast<float>(1 << (b % 4)) / 2.f;
+      }
+
+    ShiftScaleFilterType::Pointer shiftScale = ShiftScaleFilterType::New();
+    shiftScale->SetInput(image);
+    shiftScale->SetShift(shift);
+    shiftScale->SetScale(scale);
+
+    GenericShiftScaleFilterType::Pointer genericShiftScale = GenericShiftScaleFilterType::New();
+    genericShiftScale->SetInput(image);
+    genericShiftScale->GetFunctor().SetShiftValues(shift);
+    genericShiftScale->GetFunctor().SetScaleValues(scale);
+    genericShiftScale->GetOutput()->SetNumberOfComponentsPerPixel(nbBands);
+
+    const double genericShiftScaleRate = Run(genericShiftScale, nbPixels);
+    const double shiftScaleRate = Run(shiftScale, nbPixels);
+
+    std::cout << nbBands << "\tShiftScale\t" << genericShiftScaleRate << "\t" << shiftScaleRate << std::endl;
+    success = CompareImages(genericShiftScale->GetOutput(), shiftScale->GetOutput()) && success;
+
+    // Integer output: the scales are converted to the output type, as
+    // the functor does
+    InputImageType::PixelType integerScale(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      integerScale[b] = 0.5f + 0.75f * b;
+      }
+
+    IntegerShiftScaleFilterType::Pointer integerShiftScale = IntegerShiftScaleFilterType::New();
+    integerShiftScale->SetInput(image);
+    integerShiftScale->SetShift(shift);
+    integerShiftScale->SetScale(integerScale);
+    integerShiftScale->Update();
+
+    GenericIntegerShiftScaleFilterType::Pointer genericIntegerShiftScale = GenericIntegerShiftScaleFilterType::New();
+    genericIntegerShiftScale->SetInput(image);
+    genericIntegerShiftScale->GetFunctor().SetShiftValues(shift);
+    genericIntegerShiftScale->GetFunctor().SetScaleValues(integerScale);
+    genericIntegerShiftScale->GetOutput()->SetNumberOfComponentsPerPixel(nbBands);
+    genericIntegerShiftScale->Update();
+
+    success = CompareImages(genericIntegerShiftScale->GetOutput(), integerShiftScale->GetOutput()) && success;
+    }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
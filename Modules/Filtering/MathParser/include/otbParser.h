@@ -66,6 +66,11 @@ public:
   /** Trigger the parsing */
   ValueType Eval();
 
+  /** Evaluate the expression bulkSize times in a single call. Each
+   * variable must point to an array of bulkSize values, evaluation i
+   * reads the value i of every variable and writes results[i]. */
+  void Eval(ValueType * results, int bulkSize);
+
   /** Define a variable */
   void DefineVar(const std::string &sName, ValueType *fVar);
 
@@ -20,9 +20,51 @@
 
 #include "otb_muparser.h"
 
+#include <vector>
+
 namespace otb
 {
 
+#ifndef OTB_MUPARSER_HAS_BULK_MODE
+namespace
+{
+/** Saves the first value of the parser variables, and restores it when
+ * destroyed, so that it is restored even if the evaluation throws */
+class FirstValuesGuard
+{
+public:
+  explicit FirstValuesGuard(const mu::varmap_type& vars) : m_Vars(vars)
+  {
+    for (mu::varmap_type::const_iterator it = m_Vars.begin(); it != m_Vars.end(); ++it)
+      {
+      m_FirstValues.push_back(*(it->second));
+      }
+  }
+
+  ~FirstValuesGuard()
+  {
+    this->Restore();
+  }
+
+  void Restore()
+  {
+    unsigned int v = 0;
+    for (mu::varmap_type::const_iterator it = m_Vars.begin(); it != m_Vars.end(); ++it, ++v)
+      {
+      *(it->second) = m_FirstValues[v];
+      }
+  }
+
+private:
+  FirstValuesGuard(const FirstValuesGuard &); //purposely not implemented
+  void operator =(const FirstValuesGuard &); //purposely not implemented
+
+  const mu::varmap_type& m_Vars;
+  std::vector<double>    m_FirstValues;
+};
+}
+#endif
+
 class ITK_EXPORT ParserImpl : public itk::LightObject
 {
 public:
@@ -92,6 +134,42 @@ public:
     return result;
   }
 
+  /** Trigger the parsing on arrays of variables */
+  void Eval(ValueType * results, int bulkSize)
+  {
+    try
+      {
+#ifdef OTB_MUPARSER_HAS_BULK_MODE
+      m_MuParser.Eval(results, bulkSize);
+#else
+      // No bulk mode: the value i of each variable is copied to the
+      // address read by the parser, and the first values are restored
+      // last, or by the guard if the evaluation throws
+      const mu::varmap_type& vars = m_MuParser.GetVar();
+      FirstValuesGuard       firstValues(vars);
+
+      for (int i = bulkSize - 1; i >= 0; --i)
+        {
+        if (i == 0)
+          {
+          firstValues.Restore();
+          }
+        else
+          {
+          for (mu::varmap_type::const_iterator it = vars.begin(); it != vars.end(); ++it)
+            {
+            *(it->second) = it->second[i];
+            }
+          }
+        results[i] = m_MuParser.Eval();
+        }
+#endif
+      }
+    catch(ExceptionType &e)
+      {
+      ExceptionHandler(e);
+      }
+  }
 
   /** Define a variable */
   void DefineVar(const std::string &sName, ValueType *fVar)
@@ -245,6 +323,11 @@ Parser::ValueType Parser::Eval()
   return m_InternalParser->Eval();
 }
 
+void Parser::Eval(Parser::ValueType * results, int bulkSize)
+{
+  m_InternalParser->Eval(results, bulkSize);
+}
+
 void Parser::DefineVar(const std::string &sName, Parser::ValueType *fVar)
 {
   m_InternalParser->DefineVar(sName, fVar);
@@ -0,0 +1,5 @@
+#include "otbBenchmarkMain.h"
+void RegisterBenchmarks()
+{
+  REGISTER_BENCHMARK(otbBandMathImageFilterBenchmark);
+}
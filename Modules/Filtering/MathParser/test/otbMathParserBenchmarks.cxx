@@ -0,0 +1,52 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbBandMathImageFilter.h"
+
+int otbBandMathImageFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " expression (with the variables b1 ... bN of the N bands)" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<double, 2>                  ImageType;
+  typedef otb::BandMathImageFilter<ImageType>    FilterType;
+
+  FilterType::Pointer filter = FilterType::New();
+
+  // One synthetic image per band, with different dynamics
+  std::vector<ImageType::Pointer> bands;
+  for (unsigned int i = 0; i < helper->GetNumberOfBands(); ++i)
+    {
+    bands.push_back(helper->GenerateImage<ImageType>(0., 100. * (i + 1)));
+    filter->SetNthInput(i, bands.back());
+    }
+  filter->SetExpression(argv[1]);
+
+  while (helper->KeepRunning())
+    {
+    filter->Modified();
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
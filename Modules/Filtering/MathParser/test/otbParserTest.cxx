@@ -112,6 +112,29 @@ void otbParserTest_LogicalOperator(void)
   otbParserTest_ThrowIfNotEqual(static_cast<int>(parser->Eval()), 1, "LogicalOperator or");
 }
 
+void otbParserTest_BulkEval(void)
+{
+  const int bulkSize = 5;
+  double var1[bulkSize] = {10.0, -3.0, 0.5, 100.0, 7.0};
+  double var2[bulkSize] = {2.0, 4.0, 0.25, -1.0, 7.0};
+  double results[bulkSize];
+
+  ParserType::Pointer parser = ParserType::New();
+  parser->DefineVar("var1", var1);
+  parser->DefineVar("var2", var2);
+  parser->SetExpr("ndvi(var1, var2)+var1*var2");
+  parser->Eval(results, bulkSize);
+
+  for (int i = 0; i < bulkSize; ++i)
+    {
+    otbParserTest_ThrowIfNotEqual(results[i], (var2[i]-var1[i])/(var2[i]+var1[i])+var1[i]*var2[i], "BulkEval");
+    }
+
+  // The values of the variables must be preserved
+  otbParserTest_ThrowIfNotEqual(var1[0], 10.0, "BulkEval variables");
+  otbParserTest_ThrowIfNotEqual(var2[0], 2.0, "BulkEval variables");
+}
+
 int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
 {
   otbParserTest_Numerical();
@@ -121,5 +144,6 @@ int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
   otbParserTest_UserDefinedVars();
   otbParserTest_Mixed();
   otbParserTest_LogicalOperator();
+  otbParserTest_BulkEval();
   return EXIT_SUCCESS;
 }
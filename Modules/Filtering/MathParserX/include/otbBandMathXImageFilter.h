@@ -51,6 +51,11 @@ namespace otb
  * If the jth input image is multidimensional, then the variable imj represents a vector whose components are related to its bands.
  * In order to access the kth band, the variable observes the following pattern : imjbk.
  *
+ * Each thread holds one parser per expression, so that the expressions are
+ * compiled only once, and evaluated one after another on each pixel. The
+ * parsers of a thread share the same variables, which are updated in place
+ * while the output region is walked line by line.
+ *
  * \sa Parser
  *
  * \ingroup Streamed
@@ -166,7 +171,7 @@ private :
   void OutputsDimensions();
 
   std::vector<std::string>                  m_Expression;
-  std::vector<ParserType::Pointer>          m_VParser;
+  std::vector< std::vector<ParserType::Pointer> > m_VParser; // one pre-compiled parser per thread and per expression
   std::vector< std::vector<adhocStruct> >   m_AImage;
   std::vector< adhocStruct >                m_VVarName;
   std::vector< adhocStruct >                m_VAllowedVarNameAuto;
@@ -24,6 +24,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkConstNeighborhoodIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
@@ -607,14 +608,17 @@ void BandMathXImageFilter<TImage>
   }
 
 
-  // Register variables for each parser (important : one parser per thread)
+  // Register variables for each parser (important : one parser per thread and per expression,
+  // so that each expression is only compiled once, and never set again inside the pixel loop)
   m_VParser.clear();
   unsigned int nbThreads = this->GetNumberOfThreads();
-  typename std::vector<ParserType::Pointer>::iterator        itParser;
+  unsigned int nbExpressions = m_Expression.size();
   m_VParser.resize(nbThreads);
-  for(itParser = m_VParser.begin(); itParser < m_VParser.end(); itParser++)
+  for(unsigned int i = 0; i < nbThreads; ++i)
     {
-      *itParser = ParserType::New();
+    m_VParser[i].resize(nbExpressions);
+    for(unsigned int IDExpression = 0; IDExpression < nbExpressions; ++IDExpression)
+      m_VParser[i][IDExpression] = ParserType::New();
     }
 
   // Important to remember that variables of m_VVarName come from a call of GetExprVar method
@@ -722,14 +726,19 @@ void BandMathXImageFilter<TImage>
         }
 
 
-        //Register variable
-        m_VParser.at(i)->DefineVar(m_AImage[i][j].name, &(m_AImage[i][j].value));
+        //Register variable (the parsers of a thread share the same variables)
+        for(unsigned int IDExpression = 0; IDExpression < nbExpressions; ++IDExpression)
+          m_VParser[i][IDExpression]->DefineVar(m_AImage[i][j].name, &(m_AImage[i][j].value));
 
 
         initValue += 0.001;
         if (initValue>1.0)
           initValue=0.1;
       }
+
+    // Expressions are set once for all, after the variables definition
+    for(unsigned int IDExpression = 0; IDExpression < nbExpressions; ++IDExpression)
+      m_VParser[i][IDExpression]->SetExpr(m_Expression[IDExpression]);
   }
 
 }
@@ -820,8 +829,7 @@ void BandMathXImageFilter< TImage >
 
   for(int i=0; i<(int) m_Expression.size(); ++i)
   {
-    m_VParser.at(0)->SetExpr(m_Expression[i]);
-    ValueType value = m_VParser.at(0)->Eval();
+    ValueType value = m_VParser.at(0).at(i)->Eval();
 
     switch (value.GetType())
     {   //ValueType
@@ -1019,178 +1027,216 @@ void BandMathXImageFilter<TImage>
 
   ValueType value;
   unsigned int nbInputImages = this->GetNumberOfInputs();
+  unsigned int nbExpressions = m_Expression.size();
+
+  // Variables and pre-compiled parsers (one per expression) of this thread
+  std::vector<adhocStruct> & vars = m_AImage[threadId];
+  std::vector<ParserType::Pointer> & parsers = m_VParser[threadId];
 
   //----------------- --------- -----------------//
   //----------------- Iterators -----------------//
   //----------------- --------- -----------------//
-  typedef itk::ImageRegionConstIterator<TImage> ImageRegionConstIteratorType;
-  std::vector< ImageRegionConstIteratorType > Vit;
+  typedef itk::ImageScanlineConstIterator<TImage> ImageScanlineConstIteratorType;
+  std::vector< ImageScanlineConstIteratorType > Vit;
   Vit.resize(nbInputImages);
   for(unsigned int j=0; j < nbInputImages; ++j)
-    Vit[j] = ImageRegionConstIteratorType (this->GetNthInput(j), outputRegionForThread);
-    
+    Vit[j] = ImageScanlineConstIteratorType (this->GetNthInput(j), outputRegionForThread);
+
 
-  std::vector< ImageRegionConstIteratorType > VoutIt;
-  VoutIt.resize(m_Expression.size());
+  std::vector< ImageScanlineConstIteratorType > VoutIt;
+  VoutIt.resize(nbExpressions);
   for(unsigned int j=0; j < VoutIt.size(); ++j)
-    VoutIt[j] = ImageRegionConstIteratorType (this->GetOutput(j), outputRegionForThread);
-    
+    VoutIt[j] = ImageScanlineConstIteratorType (this->GetOutput(j), outputRegionForThread);
+
 
   //Special case : neighborhoods
-  std::vector< itk::ConstNeighborhoodIterator<TImage> > VNit;
-  for(unsigned int j=0; j<m_VVarName.size(); ++j)
-    if (m_VVarName[j].type == 6)
+  // Only one iterator is used for each (input image, radius) couple : neighborhood
+  // variables on different bands of the same input are views over the same iterator
+  typedef itk::ConstNeighborhoodIterator<TImage> NeighborhoodIteratorType;
+  std::vector< NeighborhoodIteratorType > VNit;
+  std::vector< int > VNitInput;
+  std::vector< int > neighIndex(vars.size(),-1);
+  for(unsigned int j=0; j<vars.size(); ++j)
+    if (vars[j].type == 6)
      {
         RadiusType radius;
-        radius[0]=(int) ((m_VVarName[j].info[2]-1)/2); // Size x direction (otb convention)
-        radius[1]=(int) ((m_VVarName[j].info[3]-1)/2); // Size y direction (otb convention)
-        VNit.push_back( itk::ConstNeighborhoodIterator<TImage>(radius, this->GetNthInput(m_VVarName[j].info[0]),outputRegionForThread)); // info[0] = Input image ID
-        VNit.back().NeedToUseBoundaryConditionOn();
+        radius[0]=(int) ((vars[j].info[2]-1)/2); // Size x direction (otb convention)
+        radius[1]=(int) ((vars[j].info[3]-1)/2); // Size y direction (otb convention)
+
+        unsigned int k=0;
+        while ( (k < VNit.size()) && ( (VNitInput[k] != vars[j].info[0]) || (VNit[k].GetRadius() != radius) ) )
+          ++k;
+
+        if (k == VNit.size())
+          {
+          VNit.push_back( NeighborhoodIteratorType(radius, this->GetNthInput(vars[j].info[0]),outputRegionForThread)); // info[0] = Input image ID
+          VNit.back().NeedToUseBoundaryConditionOn();
+          VNitInput.push_back(vars[j].info[0]);
+          }
+
+        if (vars[j].info[2]*vars[j].info[3] != (int) VNit[k].Size() )
+          itkExceptionMacro(<< "Size of muparserx variable is different from its related otb neighborhood iterator")
+
+        neighIndex[j] = k;
      }
 
 
   // Support progress methods/callbacks
-  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+  const itk::SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(0);
+  itk::ProgressReporter progress(this, threadId, numberOfLinesToProcess);
 
 
   //----------------- --------------------- -----------------//
   //----------------- Variable affectations -----------------//
   //----------------- --------------------- -----------------//
   for(unsigned int j=0; j < nbInputImages; ++j)       {  Vit[j].GoToBegin();     }
-  for(unsigned int j=0; j < m_Expression.size(); ++j) {  VoutIt[j].GoToBegin();  }
+  for(unsigned int j=0; j < nbExpressions; ++j)       {  VoutIt[j].GoToBegin();  }
   for(unsigned int j=0; j < VNit.size(); ++j)         {  VNit[j].GoToBegin();    }
 
-  while(!Vit.at(0).IsAtEnd()) // For each pixel
+  while(!Vit.at(0).IsAtEnd()) // For each line
   {
 
-    int ngbhNameIndex=0; int index;
-    for(unsigned int j=0; j < m_AImage[threadId].size(); ++j) // For each variable, perform a copy
+    // idxY does not change along a line
+    for(unsigned int j=0; j < vars.size(); ++j)
+      if (vars[j].type == 1)
+        vars[j].value = static_cast<double>(Vit[0].GetIndex()[1]);
+
+    while(!Vit.at(0).IsAtEndOfLine()) // For each pixel of the line
     {
 
-       switch (m_AImage[threadId][j].type)
-        {
+      int index;
+      for(unsigned int j=0; j < vars.size(); ++j) // For each variable, perform a copy
+      {
 
-          case 0 : //idxX
-            m_AImage[threadId][j].value = static_cast<double>(Vit[0].GetIndex()[0]);
-          break;
+         switch (vars[j].type)
+          {
 
-          case 1 : //idxY
-            m_AImage[threadId][j].value = static_cast<double>(Vit[0].GetIndex()[1]);
-          break;
+            case 0 : //idxX
+              vars[j].value = static_cast<double>(Vit[0].GetIndex()[0]);
+            break;
 
-          case 2 : //Spacing X (imiPhyX)
-            //Nothing to do (already set inside BeforeThreadedGenerateData)"
-          break;
+            case 1 : //idxY
+              //Nothing to do (already set at the beginning of the line)
+            break;
 
-          case 3 : //Spacing Y (imiPhyY)
-            //Nothing to do (already set inside BeforeThreadedGenerateData)"
-          break;
+            case 2 : //Spacing X (imiPhyX)
+              //Nothing to do (already set inside BeforeThreadedGenerateData)"
+            break;
 
-          case 4 : //vector
-            // m_AImage[threadId][j].info[0] : Input image #ID
-            for(int p=0; p < m_AImage[threadId][j].value.GetCols(); ++p)
-              m_AImage[threadId][j].value.At(0,p) = Vit[m_AImage[threadId][j].info[0]].Get()[p];
-          break;
+            case 3 : //Spacing Y (imiPhyY)
+              //Nothing to do (already set inside BeforeThreadedGenerateData)"
+            break;
 
-          case 5 : //pixel
-            // m_AImage[threadId][j].info[0] : Input image #ID
-            // m_AImage[threadId][j].info[1] : Band #ID
-            m_AImage[threadId][j].value = Vit[m_AImage[threadId][j].info[0]].Get()[m_AImage[threadId][j].info[1]];
-          break;
+            case 4 : //vector
+              {
+              // vars[j].info[0] : Input image #ID
+              const PixelType pix = Vit[vars[j].info[0]].Get();
+              for(int p=0; p < vars[j].value.GetCols(); ++p)
+                vars[j].value.At(0,p) = pix[p];
+              }
+            break;
 
-          case 6 : //neighborhood
-    
-          // m_AImage[threadId][j].info[1] : Band #ID
-          if (m_AImage[threadId][j].info[2]*m_AImage[threadId][j].info[3] != (int) VNit[ngbhNameIndex].Size() )
-            itkExceptionMacro(<< "Size of muparserx variable is different from its related otb neighborhood iterator")
+            case 5 : //pixel
+              // vars[j].info[0] : Input image #ID
+              // vars[j].info[1] : Band #ID
+              vars[j].value = Vit[vars[j].info[0]].Get()[vars[j].info[1]];
+            break;
 
-          index=0;
-          for(int rows=0; rows<m_AImage[threadId][j].info[3]; ++rows)
-            for(int cols=0; cols<m_AImage[threadId][j].info[2]; ++cols)
+            case 6 : //neighborhood
               {
-                m_AImage[threadId][j].value.At(rows,cols) = VNit[ngbhNameIndex].GetPixel(index)[m_AImage[threadId][j].info[1]];
-                index++;
+              // vars[j].info[1] : Band #ID
+              // The matrix of the variable is filled in place
+              const NeighborhoodIteratorType & nit = VNit[neighIndex[j]];
+              const int band = vars[j].info[1];
+
+              index=0;
+              for(int rows=0; rows<vars[j].info[3]; ++rows)
+                for(int cols=0; cols<vars[j].info[2]; ++cols)
+                  {
+                    vars[j].value.At(rows,cols) = nit.GetPixel(index)[band];
+                    index++;
+                  }
               }
+            break;
 
-          ngbhNameIndex++;
-          break;
+            case 7 :
+            //Nothing to do : user defined variable or constant, which have already been set inside PrepareParsers (see above)
+            break;
 
-          case 7 :
-          //Nothing to do : user defined variable or constant, which have already been set inside PrepareParsers (see above)
-          break;
+            case 8 :
+            //Nothing to do : variable has already been set inside PrepareParsersGlobStats method (see above)
+            break;
 
-          case 8 :
-          //Nothing to do : variable has already been set inside PrepareParsersGlobStats method (see above)
-          break;
+            default :
+              itkExceptionMacro(<< "Type of the variable is unknown");
+            break;
+          }
+      }//End for each variable
 
-          default :
-            itkExceptionMacro(<< "Type of the variable is unknown");
-          break;
-        }
-    }//End while
 
+    //----------------- ----------- -----------------//
+    //----------------- Evaluations -----------------//
+    //----------------- ----------- -----------------//
+    for(unsigned int IDExpression=0; IDExpression<nbExpressions; ++IDExpression)
+    {
 
-  //----------------- ----------- -----------------//
-  //----------------- Evaluations -----------------//
-  //----------------- ----------- -----------------//
-  for(unsigned int IDExpression=0; IDExpression<m_Expression.size(); ++IDExpression)
-  {
+          value = parsers[IDExpression]->Eval();
 
-        m_VParser[threadId]->SetExpr(m_Expression[IDExpression]);
+          switch (value.GetType())
+          {   //ValueType
+              case 'i':
+              VoutIt[IDExpression].Get()[0] = value.GetInteger();
+              break;
 
-        value = m_VParser[threadId]->Eval();
+              case 'f':
+              VoutIt[IDExpression].Get()[0] = value.GetFloat();
+              break;
 
-        switch (value.GetType())
-        {   //ValueType
-            case 'i':
-            VoutIt[IDExpression].Get()[0] = value.GetInteger();
-            break;
+              case 'c':
+              itkExceptionMacro(<< "Complex numbers are not supported." << std::endl);
+              break;
 
-            case 'f':
-            VoutIt[IDExpression].Get()[0] = value.GetFloat();
-            break;
+              case 'm':
+              mup::matrix_type vect = value.GetArray();
 
-            case 'c':
-            itkExceptionMacro(<< "Complex numbers are not supported." << std::endl);
-            break;
+              if ( vect.GetRows() == 1 ) //Vector
+                for(int p=0; p<vect.GetCols(); ++p)
+                  VoutIt[IDExpression].Get()[p] = vect.At(0,p).GetFloat();
+              else //Matrix
+                itkExceptionMacro(<< "Result of the evaluation can't be a matrix." << std::endl);
+              break;
+          }
 
-            case 'm':
-            mup::matrix_type vect = value.GetArray();
 
-            if ( vect.GetRows() == 1 ) //Vector
-              for(int p=0; p<vect.GetCols(); ++p)
-                VoutIt[IDExpression].Get()[p] = vect.At(0,p).GetFloat();
-            else //Matrix
-              itkExceptionMacro(<< "Result of the evaluation can't be a matrix." << std::endl);
-            break;
-        }
+          //----------------- Pixel affectations -----------------//
+          for(unsigned int p=0; p<VoutIt[IDExpression].Get().GetSize(); ++p)
+          {
+              // Case value is equal to -inf or inferior to the minimum value
+              // allowed by the PixelValueType cast
+              if (VoutIt[IDExpression].Get()[p] < double(itk::NumericTraits<PixelValueType>::NonpositiveMin()))
+              {
+                  VoutIt[IDExpression].Get()[p] = itk::NumericTraits<PixelValueType>::NonpositiveMin();
+                  m_ThreadUnderflow[threadId]++;
+              }
+              // Case value is equal to inf or superior to the maximum value
+              // allowed by the PixelValueType cast
+              else if (VoutIt[IDExpression].Get()[p] > double(itk::NumericTraits<PixelValueType>::max()))
+              {
+                 VoutIt[IDExpression].Get()[p] = itk::NumericTraits<PixelValueType>::max();
+                 m_ThreadOverflow[threadId]++;
+              }
+          }
+      }
 
- 
-        //----------------- Pixel affectations -----------------//
-        for(unsigned int p=0; p<VoutIt[IDExpression].Get().GetSize(); ++p)
-        {
-            // Case value is equal to -inf or inferior to the minimum value
-            // allowed by the PixelValueType cast
-            if (VoutIt[IDExpression].Get()[p] < double(itk::NumericTraits<PixelValueType>::NonpositiveMin()))
-            {
-                VoutIt[IDExpression].Get()[p] = itk::NumericTraits<PixelValueType>::NonpositiveMin();
-                m_ThreadUnderflow[threadId]++;
-            }
-            // Case value is equal to inf or superior to the maximum value
-            // allowed by the PixelValueType cast
-            else if (VoutIt[IDExpression].Get()[p] > double(itk::NumericTraits<PixelValueType>::max()))
-            {
-               VoutIt[IDExpression].Get()[p] = itk::NumericTraits<PixelValueType>::max();
-               m_ThreadOverflow[threadId]++;
-            }
-        }
+      for(unsigned int j=0; j < nbInputImages; ++j)   {   ++Vit[j];    }
+      for(unsigned int j=0; j < nbExpressions; ++j)   {   ++VoutIt[j]; }
+      for(unsigned int j=0; j < VNit.size(); ++j)     {   ++VNit[j];   }
     }
 
-    for(unsigned int j=0; j < nbInputImages; ++j)        {   ++Vit[j];    }
-    for(unsigned int j=0; j < m_Expression.size(); ++j)  {   ++VoutIt[j]; }
-    for(unsigned int j=0; j < VNit.size(); ++j)          {   ++VNit[j];   }
+    for(unsigned int j=0; j < nbInputImages; ++j)   {   Vit[j].NextLine();    }
+    for(unsigned int j=0; j < nbExpressions; ++j)   {   VoutIt[j].NextLine(); }
 
-    progress.CompletedPixel();
+    progress.CompletedPixel(); // one line completed
   }
 
 }
@@ -540,3 +540,82 @@ int otbBandMathXImageFilterWithIdx( int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+
+int otbBandMathXImageFilterManyExpressions( int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  typedef otb::VectorImage<double, 2>                     ImageType;
+  typedef otb::BandMathXImageFilter<ImageType>            FilterType;
+
+  const unsigned int N = 100, D1=3;
+
+  ImageType::SizeType size;
+  size.Fill(N);
+  ImageType::IndexType index;
+  index.Fill(0);
+  ImageType::RegionType region;
+  region.SetSize(size);
+  region.SetIndex(index);
+
+  ImageType::Pointer image1 = ImageType::New();
+
+  image1->SetLargestPossibleRegion( region );
+  image1->SetBufferedRegion( region );
+  image1->SetRequestedRegion( region );
+  image1->SetNumberOfComponentsPerPixel(D1);
+  image1->Allocate();
+
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> IteratorType;
+  IteratorType it1(image1, region);
+
+  for (it1.GoToBegin(); !it1.IsAtEnd(); ++it1)
+  {
+    ImageType::IndexType i1 = it1.GetIndex();
+    it1.Get()[0] = i1[0] + i1[1] -50; it1.Get()[1] = i1[0] * i1[1] -50; it1.Get()[2] = i1[0] / (i1[1]+1)+5;
+  }
+
+  // Neighborhoods on several bands of the same input, with the same or with different sizes,
+  // mixed with pixel and index variables
+  std::vector<std::string> expressions;
+  expressions.push_back("mean(im1b1N3x3)");
+  expressions.push_back("mean(im1b2N3x3,im1b3N5x3)");
+  expressions.push_back("im1b1 + idxX * idxY");
+  expressions.push_back("median(im1b2N3x3) + im1b3");
+
+  // All the expressions in the same filter
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetNthInput(0, image1);
+  for(unsigned int e=0; e<expressions.size(); ++e)
+    filter->SetExpression(expressions[e]);
+  filter->UpdateOutputInformation();
+  for(unsigned int e=0; e<expressions.size(); ++e)
+    filter->GetOutput(e)->SetRequestedRegionToLargestPossibleRegion();
+  filter->Update();
+
+  // Each expression must give the same result as a filter with this single expression
+  for(unsigned int e=0; e<expressions.size(); ++e)
+    {
+    FilterType::Pointer singleFilter = FilterType::New();
+    singleFilter->SetNthInput(0, image1);
+    singleFilter->SetExpression(expressions[e]);
+    singleFilter->Update();
+
+    IteratorType itMany(filter->GetOutput(e), region);
+    IteratorType itSingle(singleFilter->GetOutput(), region);
+
+    if (filter->GetOutput(e)->GetNumberOfComponentsPerPixel() != singleFilter->GetOutput()->GetNumberOfComponentsPerPixel())
+      itkGenericExceptionMacro(<< "Expression " << expressions[e] << ": bad number of components -> TEST FAILLED");
+
+    for (itMany.GoToBegin(), itSingle.GoToBegin(); !itMany.IsAtEnd(); ++itMany, ++itSingle)
+      for(unsigned int p=0; p<itSingle.Get().GetSize(); ++p)
+        if (itMany.Get()[p] != itSingle.Get()[p])
+          {
+          itkGenericExceptionMacro(<< std::endl
+                                   << "Expression " << expressions[e] << " at " << itMany.GetIndex() << std::endl
+                                   << "Result with many expressions =  " << itMany.Get()[p]
+                                   << "     Expected =  " << itSingle.Get()[p] << "     -> TEST FAILLED" << std::endl);
+          }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,430 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbStreamingKMeansImageFilter_h
+#define __otbStreamingKMeansImageFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "otbImage.h"
+#include "itkArray.h"
+#include "itkNumericTraits.h"
+#include <vector>
+
+namespace otb
+{
+
+namespace Functor
+{
+/** \class KMeansNearestCentroidFunctor
+ * \brief Label of the centroid nearest to a sample.
+ *
+ * The centroids are stored in a single contiguous array (one centroid
+ * after the other), and the squared euclidean distances to four
+ * centroids are computed in the same pass over the components, so that
+ * the compiler can keep the partial sums in registers and vectorize
+ * the inner loop. On ties, the centroid with the lowest label wins.
+ *
+ * TInput is a VariableLengthVector-like sample, TLabel the type of the
+ * returned label (from 0 to the number of centroids minus one).
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TInput, class TLabel>
+class KMeansNearestCentroidFunctor
+{
+public:
+  typedef KMeansNearestCentroidFunctor Self;
+  typedef itk::Array<double>           CentroidsType;
+
+  KMeansNearestCentroidFunctor() : m_NumberOfComponents(0), m_NumberOfClasses(0) {}
+  virtual ~KMeansNearestCentroidFunctor() {}
+
+  /** Set the centroids, as an array of nbClasses * nbComponents values */
+  void SetCentroids(const CentroidsType& centroids, unsigned int nbComponents)
+  {
+    m_NumberOfComponents = nbComponents;
+    m_NumberOfClasses = nbComponents > 0 ? centroids.GetSize() / nbComponents : 0;
+    m_Centroids.assign(centroids.begin(), centroids.begin() + m_NumberOfClasses * nbComponents);
+  }
+
+  unsigned int GetNumberOfClasses() const
+  {
+    return m_NumberOfClasses;
+  }
+
+  unsigned int GetNumberOfComponents() const
+  {
+    return m_NumberOfComponents;
+  }
+
+  /** Label of the nearest centroid, and its squared distance to sample */
+  inline unsigned int GetNearest(const TInput& sample, double& squaredDistance) const
+  {
+    const unsigned int nbComp = m_NumberOfComponents;
+    const double *     centroid = m_Centroids.empty() ? NULL : &m_Centroids[0];
+    unsigned int       label = 0;
+    unsigned int       k = 0;
+    squaredDistance = itk::NumericTraits<double>::max();
+
+    for (; k + 4 <= m_NumberOfClasses; k += 4, centroid += 4 * nbComp)
+      {
+      double d0 = 0., d1 = 0., d2 = 0., d3 = 0.;
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        const double value = static_cast<double>(sample[c]);
+        const double e0 = value - centroid[c];
+        const double e1 = value - centroid[nbComp + c];
+        const double e2 = value - centroid[2 * nbComp + c];
+        const double e3 = value - centroid[3 * nbComp + c];
+        d0 += e0 * e0;
+        d1 += e1 * e1;
+        d2 += e2 * e2;
+        d3 += e3 * e3;
+        }
+      if (d0 < squaredDistance) { squaredDistance = d0; label = k; }
+      if (d1 < squaredDistance) { squaredDistance = d1; label = k + 1; }
+      if (d2 < squaredDistance) { squaredDistance = d2; label = k + 2; }
+      if (d3 < squaredDistance) { squaredDistance = d3; label = k + 3; }
+      }
+    for (; k < m_NumberOfClasses; ++k, centroid += nbComp)
+      {
+      double d = 0.;
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        const double e = static_cast<double>(sample[c]) - centroid[c];
+        d += e * e;
+        }
+      if (d < squaredDistance)
+        {
+        squaredDistance = d;
+        label = k;
+        }
+      }
+    return label;
+  }
+
+  inline TLabel operator ()(const TInput& sample) const
+  {
+    double squaredDistance;
+    return static_cast<TLabel>(this->GetNearest(sample, squaredDistance));
+  }
+
+  bool operator !=(const Self& other) const
+  {
+    return m_NumberOfComponents != other.m_NumberOfComponents || m_Centroids != other.m_Centroids;
+  }
+
+  bool operator ==(const Self& other) const
+  {
+    return !(*this != other);
+  }
+
+private:
+  std::vector<double> m_Centroids;
+  unsigned int        m_NumberOfComponents;
+  unsigned int        m_NumberOfClasses;
+};
+} // end namespace Functor
+
+/** \class PersistentStreamingKMeansImageFilter
+ * \brief One k-means pass over a streamed VectorImage.
+ *
+ * Each pass assigns every pixel of the input (or only the pixels where
+ * the optional mask is not zero) to its nearest centroid, and
+ * accumulates per thread the sum of the pixels and their number for
+ * each centroid, as well as the inertia (sum of the squared distances
+ * to the nearest centroid).
+ *
+ * Two update rules are available:
+ * - Lloyd (the default): the centroids are replaced by the mean of
+ *   their pixels in Synthetize(), once the whole image has been streamed.
+ * - Mini-batch (UseMiniBatch on): each stream is a batch, and the
+ *   centroids are moved toward the mean of the batch pixels at the end
+ *   of each stream, with a learning rate of (batch count / total count
+ *   of the centroid since the beginning of the pass).
+ *
+ * The centroids with no pixel are left unchanged. The initial
+ * centroids must be set with SetCentroids(), as an array of
+ * NumberOfClasses * NumberOfComponents values; GetCentroidShift() gives
+ * the largest L2 displacement of a centroid during the last pass.
+ *
+ * This filter is intended to be used through StreamingKMeansImageFilter,
+ * which iterates the passes until convergence.
+ *
+ * \sa StreamingKMeansImageFilter
+ * \sa PersistentImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template<class TInputImage, class TMaskImage = otb::Image<unsigned char, 2> >
+class ITK_EXPORT PersistentStreamingKMeansImageFilter :
+  public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentStreamingKMeansImageFilter            Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentStreamingKMeansImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                             ImageType;
+  typedef typename TInputImage::Pointer           InputImagePointer;
+  typedef typename TInputImage::RegionType        RegionType;
+  typedef typename TInputImage::PixelType         PixelType;
+  typedef typename TInputImage::InternalPixelType InternalPixelType;
+  typedef TMaskImage                              MaskImageType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+  typedef itk::Array<double>                                             CentroidsType;
+  typedef std::vector<unsigned long>                                     CountVectorType;
+  typedef Functor::KMeansNearestCentroidFunctor<PixelType, unsigned int> NearestCentroidFunctorType;
+
+  typedef typename itk::DataObject::Pointer DataObjectPointer;
+  typedef itk::ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+
+  /** Set/Get the optional mask. Only the pixels where the mask is not
+   * zero are clustered. */
+  void SetInputMask(const MaskImageType * mask);
+  const MaskImageType * GetInputMask() const;
+
+  /** Set/Get the centroids, as an array of NumberOfClasses *
+   * NumberOfComponents values. Set the initial centroids before the
+   * first pass, get the updated ones after each pass. */
+  void SetCentroids(const CentroidsType& centroids);
+  itkGetConstReferenceMacro(Centroids, CentroidsType);
+
+  /** Move the centroids after each stream (mini-batch k-means) instead
+   * of at the end of the pass (Lloyd). Off by default. */
+  itkSetMacro(UseMiniBatch, bool);
+  itkGetMacro(UseMiniBatch, bool);
+  itkBooleanMacro(UseMiniBatch);
+
+  /** Number of centroids */
+  unsigned int GetNumberOfClasses() const
+  {
+    return m_NearestCentroid.GetNumberOfClasses();
+  }
+
+  /** Largest L2 displacement of a centroid during the last pass */
+  itkGetMacro(CentroidShift, double);
+
+  /** Sum of the squared distances of the pixels to their nearest
+   * centroid (before the update of the last pass) */
+  itkGetMacro(Inertia, double);
+
+  /** Number of pixels assigned to each centroid during the last pass */
+  const CountVectorType& GetClusterSizes() const
+  {
+    return m_ClusterSizes;
+  }
+
+  /** Make a DataObject of the correct type to be used as the specified
+   * output.
+   */
+  virtual DataObjectPointer MakeOutput(DataObjectPointerArraySizeType idx);
+  using Superclass::MakeOutput;
+
+  virtual void AllocateOutputs();
+  virtual void GenerateOutputInformation();
+  virtual void Synthetize(void);
+  virtual void Reset(void);
+
+protected:
+  PersistentStreamingKMeansImageFilter();
+  virtual ~PersistentStreamingKMeansImageFilter() {}
+  virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Multi-thread version GenerateData. */
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+  /** Gather the partial sums of the threads, and update the centroids
+   * in mini-batch mode */
+  virtual void AfterThreadedGenerateData();
+
+private:
+  PersistentStreamingKMeansImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  CentroidsType              m_Centroids;
+  CentroidsType              m_PreviousCentroids;
+  NearestCentroidFunctorType m_NearestCentroid;
+  bool                       m_UseMiniBatch;
+
+  /** Partial sums of the threads */
+  std::vector<std::vector<double> > m_ThreadSums;
+  std::vector<CountVectorType>      m_ThreadCounts;
+  std::vector<double>               m_ThreadInertia;
+
+  /** Sums of the pass */
+  std::vector<double> m_Sums;
+  CountVectorType     m_ClusterSizes;
+  double              m_Inertia;
+  double              m_CentroidShift;
+};
+
+/** \class StreamingKMeansImageFilter
+ * \brief K-means clustering of a whole VectorImage, stream by stream.
+ *
+ * The filter repeats the passes of PersistentStreamingKMeansImageFilter
+ * over the streamed input until the largest displacement of a centroid
+ * is not greater than ConvergenceThreshold, or MaximumNumberOfIterations
+ * passes have been done. The memory used does not depend on the size of
+ * the image: only the centroids and the partial sums of the threads are
+ * kept between the streams. The streaming is configured through
+ * GetStreamer().
+ *
+ * The resulting centroids can be used to label the image with
+ * Functor::KMeansNearestCentroidFunctor.
+ *
+ * \code
+ * filter->SetInput(image);
+ * filter->SetCentroids(initialCentroids);
+ * filter->GetStreamer()->SetAutomaticStrippedStreaming(ram);
+ * filter->Update();
+ * centroids = filter->GetCentroids();
+ * \endcode
+ *
+ * \sa PersistentStreamingKMeansImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template<class TInputImage, class TMaskImage = otb::Image<unsigned char, 2> >
+class ITK_EXPORT StreamingKMeansImageFilter :
+  public PersistentFilterStreamingDecorator<PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage> >
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingKMeansImageFilter Self;
+  typedef PersistentFilterStreamingDecorator
+  <PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage> > Superclass;
+  typedef itk::SmartPointer<Self>                                  Pointer;
+  typedef itk::SmartPointer<const Self>                            ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingKMeansImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                                InputImageType;
+  typedef TMaskImage                                 MaskImageType;
+  typedef typename Superclass::FilterType            KMeansFilterType;
+  typedef typename KMeansFilterType::CentroidsType   CentroidsType;
+  typedef typename KMeansFilterType::CountVectorType CountVectorType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType * input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType * GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  void SetInputMask(const MaskImageType * mask)
+  {
+    this->GetFilter()->SetInputMask(mask);
+  }
+  const MaskImageType * GetInputMask()
+  {
+    return this->GetFilter()->GetInputMask();
+  }
+
+  /** Set the initial centroids, get the estimated ones */
+  void SetCentroids(const CentroidsType& centroids)
+  {
+    this->GetFilter()->SetCentroids(centroids);
+    this->Modified();
+  }
+  const CentroidsType& GetCentroids() const
+  {
+    return this->GetFilter()->GetCentroids();
+  }
+
+  /** Use mini-batch updates instead of Lloyd iterations */
+  void SetUseMiniBatch(bool flag)
+  {
+    this->GetFilter()->SetUseMiniBatch(flag);
+    this->Modified();
+  }
+  bool GetUseMiniBatch() const
+  {
+    return this->GetFilter()->GetUseMiniBatch();
+  }
+
+  /** Maximum number of passes over the image (100 by default) */
+  itkSetMacro(MaximumNumberOfIterations, unsigned int);
+  itkGetMacro(MaximumNumberOfIterations, unsigned int);
+
+  /** Largest displacement of a centroid under which the iterations
+   * stop (0.0001 by default) */
+  itkSetMacro(ConvergenceThreshold, double);
+  itkGetMacro(ConvergenceThreshold, double);
+
+  /** Number of passes done by the last update */
+  itkGetMacro(NumberOfIterations, unsigned int);
+
+  double GetCentroidShift() const
+  {
+    return this->GetFilter()->GetCentroidShift();
+  }
+  double GetInertia() const
+  {
+    return this->GetFilter()->GetInertia();
+  }
+  const CountVectorType& GetClusterSizes() const
+  {
+    return this->GetFilter()->GetClusterSizes();
+  }
+
+protected:
+  /** Constructor */
+  StreamingKMeansImageFilter();
+  /** Destructor */
+  virtual ~StreamingKMeansImageFilter() {}
+
+  /** Iterate the passes until convergence */
+  virtual void GenerateData();
+
+  virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+private:
+  StreamingKMeansImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  unsigned int m_MaximumNumberOfIterations;
+  double       m_ConvergenceThreshold;
+  unsigned int m_NumberOfIterations;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingKMeansImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,352 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbStreamingKMeansImageFilter_txx
+#define __otbStreamingKMeansImageFilter_txx
+#include "otbStreamingKMeansImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "otbMacro.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template<class TInputImage, class TMaskImage>
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::PersistentStreamingKMeansImageFilter()
+  : m_UseMiniBatch(false),
+    m_Inertia(0.),
+    m_CentroidShift(0.)
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template<class TInputImage, class TMaskImage>
+itk::DataObject::Pointer
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::MakeOutput(DataObjectPointerArraySizeType itkNotUsed(output))
+{
+  return static_cast<itk::DataObject*>(TInputImage::New().GetPointer());
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::SetInputMask(const MaskImageType * mask)
+{
+  this->itk::ProcessObject::SetNthInput(1, const_cast<MaskImageType *>(mask));
+}
+
+template<class TInputImage, class TMaskImage>
+const typename PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>::MaskImageType *
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::GetInputMask() const
+{
+  if (this->GetNumberOfInputs() < 2)
+    {
+    return NULL;
+    }
+  return static_cast<const MaskImageType *>(this->itk::ProcessObject::GetInput(1));
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::SetCentroids(const CentroidsType& centroids)
+{
+  m_Centroids = centroids;
+  this->Modified();
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+    {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+      {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+      }
+    }
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used:
+  // nothing to allocate
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::Reset()
+{
+  TInputImage * inputPtr = const_cast<TInputImage *>(this->GetInput());
+  inputPtr->UpdateOutputInformation();
+
+  const unsigned int nbComp = inputPtr->GetNumberOfComponentsPerPixel();
+  if (nbComp == 0 || m_Centroids.GetSize() == 0 || m_Centroids.GetSize() % nbComp != 0)
+    {
+    itkExceptionMacro(<< "The centroids array (" << m_Centroids.GetSize()
+                      << " values) does not match the number of components of the input (" << nbComp << ")");
+    }
+
+  const MaskImageType * mask = this->GetInputMask();
+  if (mask)
+    {
+    const_cast<MaskImageType *>(mask)->UpdateOutputInformation();
+    if (mask->GetLargestPossibleRegion() != inputPtr->GetLargestPossibleRegion())
+      {
+      itkExceptionMacro(<< "The mask and the input image have different sizes");
+      }
+    }
+
+  m_NearestCentroid.SetCentroids(m_Centroids, nbComp);
+  m_PreviousCentroids = m_Centroids;
+
+  const unsigned int nbClasses = m_NearestCentroid.GetNumberOfClasses();
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+
+  m_ThreadSums = std::vector<std::vector<double> >(numberOfThreads, std::vector<double>(nbClasses * nbComp, 0.));
+  m_ThreadCounts = std::vector<CountVectorType>(numberOfThreads, CountVectorType(nbClasses, 0));
+  m_ThreadInertia = std::vector<double>(numberOfThreads, 0.);
+
+  m_Sums = std::vector<double>(nbClasses * nbComp, 0.);
+  m_ClusterSizes = CountVectorType(nbClasses, 0);
+  m_Inertia = 0.;
+  m_CentroidShift = 0.;
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::AfterThreadedGenerateData()
+{
+  const unsigned int nbComp = m_NearestCentroid.GetNumberOfComponents();
+  const unsigned int nbClasses = m_NearestCentroid.GetNumberOfClasses();
+
+  // Partial sums of this stream
+  std::vector<double> sums(nbClasses * nbComp, 0.);
+  CountVectorType     counts(nbClasses, 0);
+  for (unsigned int t = 0; t < m_ThreadSums.size(); ++t)
+    {
+    for (unsigned int i = 0; i < sums.size(); ++i)
+      {
+      sums[i] += m_ThreadSums[t][i];
+      m_ThreadSums[t][i] = 0.;
+      }
+    for (unsigned int k = 0; k < nbClasses; ++k)
+      {
+      counts[k] += m_ThreadCounts[t][k];
+      m_ThreadCounts[t][k] = 0;
+      }
+    m_Inertia += m_ThreadInertia[t];
+    m_ThreadInertia[t] = 0.;
+    }
+
+  for (unsigned int k = 0; k < nbClasses; ++k)
+    {
+    if (counts[k] == 0)
+      {
+      continue;
+      }
+    m_ClusterSizes[k] += counts[k];
+
+    if (m_UseMiniBatch)
+      {
+      // c += (sum - n * c) / N, N being the number of pixels assigned to
+      // the centroid since the beginning of the pass
+      const double rate = 1. / static_cast<double>(m_ClusterSizes[k]);
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        double& centroid = m_Centroids[k * nbComp + c];
+        centroid += rate * (sums[k * nbComp + c] - counts[k] * centroid);
+        }
+      }
+    else
+      {
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        m_Sums[k * nbComp + c] += sums[k * nbComp + c];
+        }
+      }
+    }
+
+  if (m_UseMiniBatch)
+    {
+    m_NearestCentroid.SetCentroids(m_Centroids, nbComp);
+    }
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::Synthetize()
+{
+  const unsigned int nbComp = m_NearestCentroid.GetNumberOfComponents();
+  const unsigned int nbClasses = m_NearestCentroid.GetNumberOfClasses();
+
+  if (!m_UseMiniBatch)
+    {
+    for (unsigned int k = 0; k < nbClasses; ++k)
+      {
+      // Empty clusters keep their centroid
+      if (m_ClusterSizes[k] > 0)
+        {
+        for (unsigned int c = 0; c < nbComp; ++c)
+          {
+          m_Centroids[k * nbComp + c] = m_Sums[k * nbComp + c] / m_ClusterSizes[k];
+          }
+        }
+      }
+    }
+
+  m_CentroidShift = 0.;
+  for (unsigned int k = 0; k < nbClasses; ++k)
+    {
+    double shift = 0.;
+    for (unsigned int c = 0; c < nbComp; ++c)
+      {
+      const double e = m_Centroids[k * nbComp + c] - m_PreviousCentroids[k * nbComp + c];
+      shift += e * e;
+      }
+    m_CentroidShift = std::max(m_CentroidShift, vcl_sqrt(shift));
+    }
+
+  m_NearestCentroid.SetCentroids(m_Centroids, nbComp);
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const TInputImage *   inputPtr = this->GetInput();
+  const MaskImageType * maskPtr = this->GetInputMask();
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const unsigned int   nbComp = m_NearestCentroid.GetNumberOfComponents();
+  std::vector<double>& sums = m_ThreadSums[threadId];
+  CountVectorType&     counts = m_ThreadCounts[threadId];
+  double               inertia = 0.;
+
+  itk::ImageRegionConstIterator<TInputImage> it(inputPtr, outputRegionForThread);
+  itk::ImageRegionConstIterator<MaskImageType> maskIt;
+  if (maskPtr)
+    {
+    maskIt = itk::ImageRegionConstIterator<MaskImageType>(maskPtr, outputRegionForThread);
+    maskIt.GoToBegin();
+    }
+
+  PixelType pixel;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    bool valid = true;
+    if (maskPtr)
+      {
+      valid = (maskIt.Get() != 0);
+      ++maskIt;
+      }
+    if (valid)
+      {
+      pixel = it.Get();
+      double             squaredDistance;
+      const unsigned int k = m_NearestCentroid.GetNearest(pixel, squaredDistance);
+      double *           sum = &sums[k * nbComp];
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        sum[c] += static_cast<double>(pixel[c]);
+        }
+      ++counts[k];
+      inertia += squaredDistance;
+      }
+    progress.CompletedPixel();
+    }
+
+  m_ThreadInertia[threadId] += inertia;
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingKMeansImageFilter<TInputImage, TMaskImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseMiniBatch: " << m_UseMiniBatch << std::endl;
+  os << indent << "Centroids: " << m_Centroids << std::endl;
+  os << indent << "CentroidShift: " << m_CentroidShift << std::endl;
+  os << indent << "Inertia: " << m_Inertia << std::endl;
+}
+
+template<class TInputImage, class TMaskImage>
+StreamingKMeansImageFilter<TInputImage, TMaskImage>
+::StreamingKMeansImageFilter()
+  : m_MaximumNumberOfIterations(100),
+    m_ConvergenceThreshold(0.0001),
+    m_NumberOfIterations(0)
+{
+}
+
+template<class TInputImage, class TMaskImage>
+void
+StreamingKMeansImageFilter<TInputImage, TMaskImage>
+::GenerateData()
+{
+  m_NumberOfIterations = 0;
+  do
+    {
+    // The centroids have changed: the whole image has to be streamed
+    // again
+    this->GetFilter()->Modified();
+    Superclass::GenerateData();
+    ++m_NumberOfIterations;
+    otbMsgDevMacro(<< "K-means pass " << m_NumberOfIterations << ": inertia " << this->GetInertia()
+                   << ", largest centroid shift " << this->GetCentroidShift());
+    }
+  while (m_NumberOfIterations < m_MaximumNumberOfIterations
+         && this->GetCentroidShift() > m_ConvergenceThreshold);
+}
+
+template<class TInputImage, class TMaskImage>
+void
+StreamingKMeansImageFilter<TInputImage, TMaskImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumNumberOfIterations: " << m_MaximumNumberOfIterations << std::endl;
+  os << indent << "ConvergenceThreshold: " << m_ConvergenceThreshold << std::endl;
+  os << indent << "NumberOfIterations: " << m_NumberOfIterations << std::endl;
+}
+
+} // end namespace otb
+#endif
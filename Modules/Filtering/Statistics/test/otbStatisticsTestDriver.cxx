@@ -41,6 +41,8 @@ void RegisterTests()
   REGISTER_TEST(otbListSampleToBalancedListSampleFilter);
   REGISTER_TEST(otbStreamingStatisticsVectorImageFilter);
   REGISTER_TEST(otbStreamingMinMaxVectorImageFilter);
+  REGISTER_TEST(otbStreamingKMeansImageFilterNew);
+  REGISTER_TEST(otbStreamingKMeansImageFilter);
   REGISTER_TEST(otbListSampleGeneratorNew);
   REGISTER_TEST(otbListSampleGenerator);
   REGISTER_TEST(otbImaginaryImageToComplexImageFilterTest);
@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbStreamingKMeansImageFilter.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include <fstream>
+#include <iomanip>
+
+typedef otb::VectorImage<double, 2>                       KMeansImageType;
+typedef otb::ImageFileReader<KMeansImageType>             KMeansReaderType;
+typedef otb::StreamingKMeansImageFilter<KMeansImageType>  KMeansFilterType;
+
+static void WriteKMeansResults(KMeansFilterType * filter, const char * filename)
+{
+  const KMeansFilterType::CentroidsType&   centroids = filter->GetCentroids();
+  const KMeansFilterType::CountVectorType& sizes = filter->GetClusterSizes();
+  const unsigned int                       nbComp = centroids.GetSize() / sizes.size();
+
+  std::ofstream file;
+  file.open(filename);
+  file << std::setprecision(10);
+  for (unsigned int k = 0; k < sizes.size(); ++k)
+    {
+    file << "Class " << k << " (" << sizes[k] << " pixels):";
+    for (unsigned int c = 0; c < nbComp; ++c)
+      {
+      file << " " << centroids[k * nbComp + c];
+      }
+    file << std::endl;
+    }
+  file.close();
+}
+
+int otbStreamingKMeansImageFilterNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  KMeansFilterType::Pointer filter = KMeansFilterType::New();
+
+  std::cout << filter << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+int otbStreamingKMeansImageFilter(int itkNotUsed(argc), char * argv[])
+{
+  const char *       infname = argv[1];
+  const char *       streamedfname = argv[2];
+  const char *       wholefname = argv[3];
+  const unsigned int nbClasses = atoi(argv[4]);
+
+  KMeansReaderType::Pointer reader = KMeansReaderType::New();
+  reader->SetFileName(infname);
+  reader->UpdateOutputInformation();
+
+  // Initial centroids taken along the first line of the image
+  KMeansImageType::Pointer image = reader->GetOutput();
+  image->SetRequestedRegionToLargestPossibleRegion();
+  image->Update();
+
+  const unsigned int nbComp = image->GetNumberOfComponentsPerPixel();
+  const unsigned int sizeX = image->GetLargestPossibleRegion().GetSize()[0];
+
+  KMeansFilterType::CentroidsType initialCentroids(nbClasses * nbComp);
+  for (unsigned int k = 0; k < nbClasses; ++k)
+    {
+    KMeansImageType::IndexType index;
+    index[0] = (k * sizeX) / nbClasses;
+    index[1] = 0;
+    for (unsigned int c = 0; c < nbComp; ++c)
+      {
+      initialCentroids[k * nbComp + c] = image->GetPixel(index)[c];
+      }
+    }
+
+  // Lloyd iterations over the streamed image, with several threads
+  KMeansFilterType::Pointer streamed = KMeansFilterType::New();
+  streamed->SetInput(image);
+  streamed->SetCentroids(initialCentroids);
+  streamed->SetMaximumNumberOfIterations(50);
+  streamed->SetConvergenceThreshold(0.);
+  streamed->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  streamed->GetFilter()->SetNumberOfThreads(4);
+  streamed->Update();
+  WriteKMeansResults(streamed, streamedfname);
+
+  // Same iterations on the whole image at once, with one thread
+  KMeansFilterType::Pointer whole = KMeansFilterType::New();
+  whole->SetInput(image);
+  whole->SetCentroids(initialCentroids);
+  whole->SetMaximumNumberOfIterations(50);
+  whole->SetConvergenceThreshold(0.);
+  whole->GetStreamer()->SetNumberOfDivisionsStrippedStreaming(1);
+  whole->GetFilter()->SetNumberOfThreads(1);
+  whole->Update();
+  WriteKMeansResults(whole, wholefname);
+
+  // The mini-batch updates must end near a local minimum as well
+  KMeansFilterType::Pointer miniBatch = KMeansFilterType::New();
+  miniBatch->SetInput(image);
+  miniBatch->SetCentroids(initialCentroids);
+  miniBatch->SetUseMiniBatch(true);
+  miniBatch->SetMaximumNumberOfIterations(50);
+  miniBatch->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  miniBatch->Update();
+
+  std::cout << "Lloyd inertia: " << whole->GetInertia() << std::endl;
+  std::cout << "Mini-batch inertia: " << miniBatch->GetInertia() << std::endl;
+
+  if (miniBatch->GetInertia() > 1.1 * whole->GetInertia())
+    {
+    std::cerr << "The mini-batch k-means inertia is too high" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
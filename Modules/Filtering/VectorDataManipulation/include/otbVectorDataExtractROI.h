@@ -21,6 +21,7 @@
 #include "otbVectorDataToVectorDataFilter.h"
 #include "otbRemoteSensingRegion.h"
 #include "otbDEMHandler.h"
+#include "otbVectorDataSpatialIndex.h"
 #include "itkMacro.h"
 #include "itkPreOrderTreeIterator.h"
 
@@ -37,6 +38,13 @@ namespace otb
  * The projection of the vector data will not be modified by this filter
  * if you need to change the projection, refer to otb::VectorDataProjectionFilter
  *
+ * An optional VectorDataSpatialIndex built from the input can be set:
+ * the exact intersection tests are then only run on the features whose
+ * bounding box intersects the region, instead of on every feature. The
+ * output is the same. The index is ignored if VectorDataSpatialIndex::IsUpToDate()
+ * detects a modification of the input, and must be rebuilt after any edit
+ * of the input tree.
+ *
  * \note Parameter to this class for input and outputs are vectorData
  *
  * \sa RemoteSensingRegion
@@ -92,6 +100,8 @@ public:
   typedef typename VectorDataType::DataTreeType::TreeNodeType              InternalTreeNodeType;
   typedef typename InternalTreeNodeType::ChildrenListType                  ChildrenListType;
 
+  typedef VectorDataSpatialIndex<VectorDataType> SpatialIndexType;
+
   /** Method to Set/Get the Region of intereset*/
   void SetRegion(const RegionType&  region)
   {
@@ -101,6 +111,10 @@ public:
   const RegionType& GetRegion()
   {return m_ROI; }
 
+  /** Set/Get the spatial index of the input (optional) */
+  itkSetConstObjectMacro(SpatialIndex, SpatialIndexType);
+  itkGetConstObjectMacro(SpatialIndex, SpatialIndexType);
+
 protected:
   VectorDataExtractROI();
   virtual ~VectorDataExtractROI() {}
@@ -130,6 +144,12 @@ protected:
   virtual void ProcessNode(InternalTreeNodeType * source, InternalTreeNodeType * destination);
   using Superclass::ProcessNode;
 
+  /** Same as ProcessNode() from the root, the features being taken from the spatial index */
+  virtual void ProcessIndexedNodes(InternalTreeNodeType * destination);
+
+  /** Copy the geometry of a point, line or polygon feature if it intersects the ROI */
+  virtual bool CopyFeatureInROI(DataNodeType * source, DataNodeType * destination);
+
 private:
   VectorDataExtractROI(const Self &); //purposely not implemented
   void operator =(const Self&); //purposely not implemented
@@ -142,6 +162,8 @@ private:
   RegionType  m_GeoROI;
 
   unsigned int m_Kept;
+
+  typename SpatialIndexType::ConstPointer m_SpatialIndex;
 };
 
 } // end namespace otb
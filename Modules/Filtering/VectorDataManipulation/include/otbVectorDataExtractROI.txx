@@ -41,7 +41,8 @@ VectorDataExtractROI<TVectorData>
 ::VectorDataExtractROI() :
   m_ProjectionNeeded(false),
   m_ROI(),
-  m_Kept(0)
+  m_Kept(0),
+  m_SpatialIndex(NULL)
 {
 }
 
@@ -54,6 +55,7 @@ VectorDataExtractROI<TVectorData>
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "SpatialIndex: " << m_SpatialIndex.GetPointer() << std::endl;
 }
 
 /**
@@ -109,7 +111,18 @@ VectorDataExtractROI<TVectorData>
   // Start recursive processing
   itk::TimeProbe chrono;
   chrono.Start();
-  ProcessNode(inputRoot, outputRoot);
+  if (m_SpatialIndex.IsNotNull() && m_SpatialIndex->IsUpToDate(inputPtr))
+    {
+    this->ProcessIndexedNodes(outputRoot);
+    }
+  else
+    {
+    if (m_SpatialIndex.IsNotNull())
+      {
+      itkWarningMacro(<< "The spatial index has not been built from the current input, it is ignored");
+      }
+    ProcessNode(inputRoot, outputRoot);
+    }
   chrono.Stop();
   otbMsgDevMacro(
     << "VectorDataExtractROI: " << m_Kept << " Features processed in " << chrono.GetMean() << " seconds.");
@@ -163,35 +176,11 @@ VectorDataExtractROI<TVectorData>
         break;
         }
       case FEATURE_POINT:
-        {
-        if (m_GeoROI.IsInside(this->PointToContinuousIndex(dataNode->GetPoint())))
-          {
-          newDataNode->SetPoint(dataNode->GetPoint());
-          newContainer = InternalTreeNodeType::New();
-          newContainer->Set(newDataNode);
-          destination->AddChild(newContainer);
-          ++m_Kept;
-          }
-        break;
-        }
       case FEATURE_LINE:
-        {
-        if (this->IsLineIntersectionNotNull(dataNode->GetLine()))
-          {
-          newDataNode->SetLine(dataNode->GetLine());
-          newContainer = InternalTreeNodeType::New();
-          newContainer->Set(newDataNode);
-          destination->AddChild(newContainer);
-          ++m_Kept;
-          }
-        break;
-        }
       case FEATURE_POLYGON:
         {
-        if (this->IsPolygonIntersectionNotNull(dataNode->GetPolygonExteriorRing()))
+        if (this->CopyFeatureInROI(dataNode, newDataNode))
           {
-          newDataNode->SetPolygonExteriorRing(dataNode->GetPolygonExteriorRing());
-          newDataNode->SetPolygonInteriorRings(dataNode->GetPolygonInteriorRings());
           newContainer = InternalTreeNodeType::New();
           newContainer->Set(newDataNode);
           destination->AddChild(newContainer);
@@ -239,6 +228,109 @@ VectorDataExtractROI<TVectorData>
     }
 }
 
+template <class TVectorData>
+void
+VectorDataExtractROI<TVectorData>
+::ProcessIndexedNodes(InternalTreeNodeType * destination)
+{
+  // Candidate features: those whose bounding box intersects the ROI
+  typename SpatialIndexType::BoxType roiBox(m_GeoROI.GetOrigin(0), m_GeoROI.GetOrigin(1),
+                                            m_GeoROI.GetOrigin(0) + m_GeoROI.GetSize(0),
+                                            m_GeoROI.GetOrigin(1) + m_GeoROI.GetSize(1));
+  typename SpatialIndexType::IndexListType candidates;
+  m_SpatialIndex->Search(roiBox, candidates);
+
+  otbMsgDevMacro(<< "VectorDataExtractROI: " << candidates.size() << " candidates out of "
+                 << m_SpatialIndex->GetNumberOfFeatures() << " features");
+
+  // Rebuild the tree as ProcessNode() does: all the containers are kept,
+  // containers and candidates being inserted in their input pre-order so
+  // that the children keep their order
+  std::vector<InternalTreeNodeType *> outputContainers(m_SpatialIndex->GetNumberOfContainers());
+  unsigned long                       container = 0;
+  typename SpatialIndexType::IndexListType::const_iterator candidateIt = candidates.begin();
+
+  while (container < outputContainers.size() || candidateIt != candidates.end())
+    {
+    const bool isContainer = candidateIt == candidates.end()
+      || (container < outputContainers.size()
+          && m_SpatialIndex->GetContainerOrder(container) < m_SpatialIndex->GetFeatureOrder(*candidateIt));
+
+    const long parent = isContainer ? m_SpatialIndex->GetContainerParent(container)
+                                    : m_SpatialIndex->GetFeatureParent(*candidateIt);
+    InternalTreeNodeType * parentNode = parent < 0 ? destination : outputContainers[parent];
+
+    DataNodePointerType dataNode = isContainer ? m_SpatialIndex->GetContainerTreeNode(container)->Get()
+                                               : m_SpatialIndex->GetFeature(*candidateIt);
+    DataNodePointerType newDataNode = DataNodeType::New();
+    newDataNode->SetNodeType(dataNode->GetNodeType());
+    newDataNode->SetNodeId(dataNode->GetNodeId());
+    newDataNode->SetMetaDataDictionary(dataNode->GetMetaDataDictionary());
+
+    if (isContainer || this->CopyFeatureInROI(dataNode, newDataNode))
+      {
+      typename InternalTreeNodeType::Pointer newContainer = InternalTreeNodeType::New();
+      newContainer->Set(newDataNode);
+      parentNode->AddChild(newContainer);
+      ++m_Kept;
+      if (isContainer)
+        {
+        outputContainers[container] = newContainer;
+        }
+      }
+
+    if (isContainer)
+      {
+      ++container;
+      }
+    else
+      {
+      ++candidateIt;
+      }
+    }
+}
+
+template <class TVectorData>
+bool
+VectorDataExtractROI<TVectorData>
+::CopyFeatureInROI(DataNodeType * source, DataNodeType * destination)
+{
+  switch (source->GetNodeType())
+    {
+    case FEATURE_POINT:
+      {
+      if (m_GeoROI.IsInside(this->PointToContinuousIndex(source->GetPoint())))
+        {
+        destination->SetPoint(source->GetPoint());
+        return true;
+        }
+      break;
+      }
+    case FEATURE_LINE:
+      {
+      if (this->IsLineIntersectionNotNull(source->GetLine()))
+        {
+        destination->SetLine(source->GetLine());
+        return true;
+        }
+      break;
+      }
+    case FEATURE_POLYGON:
+      {
+      if (this->IsPolygonIntersectionNotNull(source->GetPolygonExteriorRing()))
+        {
+        destination->SetPolygonExteriorRing(source->GetPolygonExteriorRing());
+        destination->SetPolygonInteriorRings(source->GetPolygonInteriorRings());
+        return true;
+        }
+      break;
+      }
+    default:
+      break;
+    }
+  return false;
+}
+
 /**
  *
  */
@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbVectorDataExtractROI.h"
+#include "otbVectorDataSpatialIndex.h"
+#include "otbVectorData.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+typedef otb::VectorData<>                            VectorDataType;
+typedef VectorDataType::DataNodeType                 DataNodeType;
+typedef VectorDataType::DataTreeType                 DataTreeType;
+typedef DataTreeType::TreeNodeType                   TreeNodeType;
+typedef DataNodeType::PointType                      PointType;
+typedef DataNodeType::LineType                       LineType;
+typedef DataNodeType::PolygonType                    PolygonType;
+typedef PolygonType::VertexType                      VertexType;
+typedef PolygonType::VertexListType                  VertexListType;
+typedef otb::VectorDataExtractROI<VectorDataType>    ExtractROIFilterType;
+typedef otb::VectorDataSpatialIndex<VectorDataType>  SpatialIndexType;
+typedef ExtractROIFilterType::RegionType             RegionType;
+
+DataNodeType::Pointer AddNode(VectorDataType * data, DataNodeType * parent, otb::NodeType type, const std::string& id)
+{
+  DataNodeType::Pointer node = DataNodeType::New();
+  node->SetNodeType(type);
+  node->SetNodeId(id);
+  data->GetDataTree()->Add(node, parent);
+  return node;
+}
+
+void AddPoint(VectorDataType * data, DataNodeType * parent, double x, double y)
+{
+  PointType p;
+  p[0] = x;
+  p[1] = y;
+  AddNode(data, parent, otb::FEATURE_POINT, "point")->SetPoint(p);
+}
+
+void AddLine(VectorDataType * data, DataNodeType * parent, double x, double y)
+{
+  LineType::Pointer line = LineType::New();
+  VertexType        v;
+  v[0] = x;
+  v[1] = y;
+  line->AddVertex(v);
+  v[0] = x + 6.;
+  v[1] = y + 3.;
+  line->AddVertex(v);
+  v[1] = y + 9.;
+  line->AddVertex(v);
+  AddNode(data, parent, otb::FEATURE_LINE, "line")->SetLine(line);
+}
+
+void AddPolygon(VectorDataType * data, DataNodeType * parent, double x, double y)
+{
+  PolygonType::Pointer exterior = PolygonType::New();
+  VertexType           v;
+  v[0] = x;
+  v[1] = y;
+  exterior->AddVertex(v);
+  v[0] = x + 7.;
+  exterior->AddVertex(v);
+  v[1] = y + 7.;
+  exterior->AddVertex(v);
+  v[0] = x;
+  exterior->AddVertex(v);
+  v[1] = y;
+  exterior->AddVertex(v);
+
+  PolygonType::Pointer interior = PolygonType::New();
+  v[0] = x + 2.;
+  v[1] = y + 2.;
+  interior->AddVertex(v);
+  v[0] = x + 4.;
+  interior->AddVertex(v);
+  v[1] = y + 4.;
+  interior->AddVertex(v);
+  DataNodeType::PolygonListPointerType interiors = DataNodeType::PolygonListType::New();
+  interiors->PushBack(interior);
+
+  DataNodeType::Pointer node = AddNode(data, parent, otb::FEATURE_POLYGON, "polygon");
+  node->SetPolygonExteriorRing(exterior);
+  node->SetPolygonInteriorRings(interiors);
+}
+
+bool SameVertices(const VertexListType * list1, const VertexListType * list2)
+{
+  if (list1->Size() != list2->Size())
+    {
+    return false;
+    }
+  for (unsigned int i = 0; i < list1->Size(); ++i)
+    {
+    if (list1->GetElement(i) != list2->GetElement(i))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+/** Compare two trees node by node, and count their features */
+bool SameTree(TreeNodeType * node1, TreeNodeType * node2, unsigned int& nbFeatures)
+{
+  DataNodeType::Pointer data1 = node1->Get();
+  DataNodeType::Pointer data2 = node2->Get();
+
+  if (data1->GetNodeType() != data2->GetNodeType() || data1->GetNodeId() != data2->GetNodeId())
+    {
+    std::cerr << "Nodes differ: " << data1->GetNodeTypeAsString() << " " << data1->GetNodeId()
+              << " and " << data2->GetNodeTypeAsString() << " " << data2->GetNodeId() << std::endl;
+    return false;
+    }
+
+  bool same = true;
+  if (data1->IsPointFeature())
+    {
+    same = data1->GetPoint() == data2->GetPoint();
+    ++nbFeatures;
+    }
+  else if (data1->IsLineFeature())
+    {
+    same = SameVertices(data1->GetLine()->GetVertexList(), data2->GetLine()->GetVertexList());
+    ++nbFeatures;
+    }
+  else if (data1->IsPolygonFeature())
+    {
+    same = SameVertices(data1->GetPolygonExteriorRing()->GetVertexList(),
+                        data2->GetPolygonExteriorRing()->GetVertexList())
+      && data1->GetPolygonInteriorRings()->Size() == data2->GetPolygonInteriorRings()->Size();
+    ++nbFeatures;
+    }
+  if (!same)
+    {
+    std::cerr << "Geometries of " << data1->GetNodeTypeAsString() << " differ" << std::endl;
+    return false;
+    }
+
+  TreeNodeType::ChildrenListType children1 = node1->GetChildrenList();
+  TreeNodeType::ChildrenListType children2 = node2->GetChildrenList();
+  if (children1.size() != children2.size())
+    {
+    std::cerr << data1->GetNodeTypeAsString() << " " << data1->GetNodeId() << ": " << children1.size()
+              << " children without index, " << children2.size() << " with index" << std::endl;
+    return false;
+    }
+  for (unsigned int i = 0; i < children1.size(); ++i)
+    {
+    if (!SameTree(children1[i], children2[i], nbFeatures))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbVectorDataExtractROISpatialIndex(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  // Document with nested folders, and multi-geometries and collections
+  // holding points, lines and polygons spread over a 200x200 square
+  VectorDataType::Pointer data = VectorDataType::New();
+  DataNodeType::Pointer   root = data->GetDataTree()->GetRoot()->Get();
+  DataNodeType::Pointer   document = AddNode(data, root, otb::DOCUMENT, "document");
+
+  for (unsigned int f = 0; f < 4; ++f)
+    {
+    std::ostringstream folderId;
+    folderId << "folder" << f;
+    DataNodeType::Pointer folder = AddNode(data, document, otb::FOLDER, folderId.str());
+    DataNodeType::Pointer subFolder = AddNode(data, folder, otb::FOLDER, folderId.str() + "/sub");
+    DataNodeType::Pointer multiPoint = AddNode(data, folder, otb::FEATURE_MULTIPOINT, "multipoint");
+    DataNodeType::Pointer multiLine = AddNode(data, subFolder, otb::FEATURE_MULTILINE, "multiline");
+    DataNodeType::Pointer multiPolygon = AddNode(data, subFolder, otb::FEATURE_MULTIPOLYGON, "multipolygon");
+    DataNodeType::Pointer collection = AddNode(data, folder, otb::FEATURE_COLLECTION, "collection");
+
+    for (unsigned int i = 0; i < 40; ++i)
+      {
+      const double x = (i * 37 + f * 53) % 200;
+      const double y = (i * 71 + f * 29) % 200;
+      switch (i % 6)
+        {
+        case 0:
+          AddPoint(data, folder, x, y);
+          break;
+        case 1:
+          AddPoint(data, multiPoint, x, y);
+          break;
+        case 2:
+          AddLine(data, i % 4 == 0 ? subFolder : multiLine, x, y);
+          break;
+        case 3:
+          AddPolygon(data, multiPolygon, x, y);
+          break;
+        case 4:
+          AddPolygon(data, folder, x, y);
+          break;
+        default:
+          AddLine(data, collection, x, y);
+          AddPoint(data, collection, x + 1., y + 1.);
+          break;
+        }
+      }
+    }
+
+  SpatialIndexType::Pointer index = SpatialIndexType::New();
+  index->Build(data);
+
+  const double rois[4][4] = {{20., 30., 60., 50.}, {0., 0., 200., 200.}, {150., 10., 25., 120.}, {300., 300., 10., 10.}};
+
+  for (unsigned int r = 0; r < 4; ++r)
+    {
+    RegionType           region;
+    RegionType::IndexType origin;
+    RegionType::SizeType  size;
+    origin[0] = rois[r][0];
+    origin[1] = rois[r][1];
+    size[0] = rois[r][2];
+    size[1] = rois[r][3];
+    region.SetOrigin(origin);
+    region.SetSize(size);
+
+    ExtractROIFilterType::Pointer reference = ExtractROIFilterType::New();
+    reference->SetInput(data);
+    reference->SetRegion(region);
+    reference->Update();
+
+    ExtractROIFilterType::Pointer indexed = ExtractROIFilterType::New();
+    indexed->SetInput(data);
+    indexed->SetRegion(region);
+    indexed->SetSpatialIndex(index);
+    indexed->Update();
+
+    unsigned int nbFeatures = 0;
+    if (!SameTree(reference->GetOutput()->GetDataTree()->GetRoot(),
+                  indexed->GetOutput()->GetDataTree()->GetRoot(), nbFeatures))
+      {
+      std::cerr << "ROI " << r << ": the outputs with and without spatial index differ" << std::endl;
+      return EXIT_FAILURE;
+      }
+    std::cout << "ROI " << r << ": " << nbFeatures << " features kept out of "
+              << index->GetNumberOfFeatures() << std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
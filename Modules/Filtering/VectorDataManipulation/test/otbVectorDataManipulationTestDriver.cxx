@@ -12,6 +12,7 @@ void RegisterTests()
   REGISTER_TEST(otbConcatenateVectorDataFilterNew);
   REGISTER_TEST(otbConcatenateVectorDataFilter);
   REGISTER_TEST(otbVectorDataExtractROINew);
+  REGISTER_TEST(otbVectorDataExtractROISpatialIndex);
   REGISTER_TEST(otbRadiometryHomogenousWithNeighborhoodDataNodeFeatureFunctionNew);
   REGISTER_TEST(otbRadiometryHomogenousWithNeighborhoodDataNodeFeatureFunction);
 }
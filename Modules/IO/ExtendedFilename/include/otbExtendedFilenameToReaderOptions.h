@@ -32,6 +32,9 @@ namespace otb
  * - &resol : resolution factor for jpeg200 files
  * - &skipcarto : switch to skip the cartographic informations
  * - &skipgeom  : switch to skip the geometric informations
+ * - &skiprpctag : switch to skip the RPC tags
+ * - &bands : comma separated list of the bands to read (1 based,
+ *            for instance &bands=1,4,3)
  *
  *  \sa ImageFileReader
  *
@@ -64,6 +67,7 @@ public:
     std::pair< bool, bool         >  skipCarto;
     std::pair< bool, bool         >  skipGeom;
     std::pair< bool, bool         >  skipRpcTag;
+    std::pair< bool, std::vector<unsigned int> > bandList;
     std::vector<std::string>         optionList;
   };
 
@@ -84,6 +88,9 @@ public:
   bool GetSkipGeom () const;
   bool SkipRpcTagIsSet () const;
   bool GetSkipRpcTag () const;
+  bool BandListIsSet () const;
+  /** Bands to read, 0 based */
+  const std::vector<unsigned int>& GetBandList () const;
 
 protected:
   ExtendedFilenameToReaderOptions();
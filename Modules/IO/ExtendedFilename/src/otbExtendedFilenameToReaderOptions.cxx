@@ -47,12 +47,15 @@ ExtendedFilenameToReaderOptions
   m_Options.skipRpcTag.first  = false;
   m_Options.skipRpcTag.second = false;
 
+  m_Options.bandList.first = false;
+
   m_Options.optionList.push_back("geom");
   m_Options.optionList.push_back("sdataidx");
   m_Options.optionList.push_back("resol");
   m_Options.optionList.push_back("skipcarto");
   m_Options.optionList.push_back("skipgeom");
   m_Options.optionList.push_back("skiprpctag");
+  m_Options.optionList.push_back("bands");
 }
 
 void
@@ -122,7 +125,27 @@ ExtendedFilenameToReaderOptions
       m_Options.skipRpcTag.second = true;
       }
     }
-  
+
+  m_Options.bandList.first = false;
+  m_Options.bandList.second.clear();
+  if (!map["bands"].empty())
+    {
+    std::vector<std::string> bands;
+    boost::split(bands, map["bands"], boost::is_any_of(","));
+    for (unsigned int i = 0; i < bands.size(); ++i)
+      {
+      boost::trim(bands[i]);
+      int band = atoi(bands[i].c_str());
+      if (band < 1)
+        {
+        itkExceptionMacro(<< "Invalid band \"" << bands[i] << "\" in the band list \""
+                          << map["bands"] << "\" (bands are numbered from 1)");
+        }
+      m_Options.bandList.second.push_back(static_cast<unsigned int>(band - 1));
+      }
+    m_Options.bandList.first = true;
+    }
+
   //Option Checking
   MapIteratorType it;
   for ( it=map.begin(); it != map.end(); it++ )
@@ -229,4 +252,17 @@ ExtendedFilenameToReaderOptions
   return m_Options.skipRpcTag.second;
 }
 
+bool
+ExtendedFilenameToReaderOptions
+::BandListIsSet () const
+{
+  return m_Options.bandList.first;
+}
+const std::vector<unsigned int>&
+ExtendedFilenameToReaderOptions
+::GetBandList () const
+{
+  return m_Options.bandList.second;
+}
+
 } // end namespace otb
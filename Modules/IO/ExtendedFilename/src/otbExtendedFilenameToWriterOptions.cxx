@@ -92,6 +92,7 @@ ExtendedFilenameToWriterOptions
     if(map["streaming:type"] == "auto"
        || map["streaming:type"] == "tiled"
        || map["streaming:type"] == "stripped"
+       || map["streaming:type"] == "footprint"
        || map["streaming:type"] == "none")
       {
       m_Options.streamingType.first=true;
@@ -99,7 +100,7 @@ ExtendedFilenameToWriterOptions
       }
     else
       {
-      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,tiled,stripped.");
+      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,tiled,stripped,footprint,none.");
       }
     }
 
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "otbImageIOBase.h"
+#include "otbRawRasterReader.h"
 
 namespace otb
 {
@@ -177,6 +178,9 @@ private:
   std::vector<std::string>    m_ChannelsFileName;
   std::fstream * m_ChannelsFile;
 
+  /** Memory mapped channel files, for reading */
+  std::vector<RawRasterReader::Pointer> m_ChannelsReader;
+
 };
 
 } // end namespace otb
@@ -128,8 +128,7 @@ void BSQImageIO::ReadVolume(void*)
 // Read image
 void BSQImageIO::Read(void* buffer)
 {
-  unsigned long step = this->GetNumberOfComponents();
-  char *        p = static_cast<char *>(buffer);
+  char * p = static_cast<char *>(buffer);
 
   int lNbLines   = this->GetIORegion().GetSize()[1];
   int lNbColumns = this->GetIORegion().GetSize()[0];
@@ -141,81 +140,30 @@ void BSQImageIO::Read(void* buffer)
   otbMsgDevMacro(<< " Region read (IORegion)  : " << this->GetIORegion());
   otbMsgDevMacro(<< " Nb Of Components       : " << this->GetNumberOfComponents());
 
-  std::streamoff  headerLength(0);
-  std::streamoff  numberOfBytesPerLines = static_cast<std::streamoff>(this->GetComponentSize() * m_Dimensions[0]);
-  std::streamoff  offset;
-  std::streamsize numberOfBytesToBeRead = this->GetComponentSize() * lNbColumns;
-  std::streamsize numberOfBytesRead;
-  unsigned long   cpt = 0;
-
-  // Update the step variable
-  step = step * (unsigned long) (this->GetComponentSize());
+  const unsigned int componentSize = this->GetComponentSize();
+  std::streamoff     headerLength(0);
+  std::streamoff     numberOfBytesPerLines = static_cast<std::streamoff>(componentSize * m_Dimensions[0]);
 
-  char * value = new char[numberOfBytesToBeRead];
-  if (value == NULL)
-    {
-    itkExceptionMacro(<< "BSQImageIO::Read(): Bad alloc");
-    return;
-    }
+  // Step between two pixels in the (interleaved) buffer
+  unsigned long step = (unsigned long) (this->GetNumberOfComponents()) * (unsigned long) (componentSize);
 
-  otbMsgDevMacro(<< " sizeof(streamsize)    : " << sizeof(std::streamsize));
-  otbMsgDevMacro(<< " sizeof(streampos)     : " << sizeof(std::streampos));
-  otbMsgDevMacro(<< " sizeof(streamoff)     : " << sizeof(std::streamoff));
-  otbMsgDevMacro(<< " sizeof(std::ios::beg) : " << sizeof(std::ios::beg));
-  otbMsgDevMacro(<< " sizeof(size_t)        : " << sizeof(size_t));
-  otbMsgDevMacro(<< " sizeof(unsigned long) : " << sizeof(unsigned long));
+  // Swap bytes if necessary
+  unsigned int swapWordSize = (m_ByteOrder != m_FileByteOrder) ? componentSize : 0;
 
+  // Each channel file is mapped in memory, and its pixels are copied
+  // (and swapped) directly at their place in the interleaved buffer
+  m_ChannelsReader.resize(this->GetNumberOfComponents());
   for (unsigned int nbComponents = 0; nbComponents < this->GetNumberOfComponents(); ++nbComponents)
     {
-    cpt = (unsigned long) (nbComponents) * (unsigned long) (this->GetComponentSize());
-    //Read region of the channel
-    for (int LineNo = lFirstLine; LineNo < lFirstLine + lNbLines; LineNo++)
+    if (m_ChannelsReader[nbComponents].IsNull())
       {
-      offset  =  headerLength + numberOfBytesPerLines * static_cast<std::streamoff>(LineNo);
-      offset +=  static_cast<std::streamoff>(this->GetComponentSize() * lFirstColumn);
-      m_ChannelsFile[nbComponents].seekg(offset, std::ios::beg);
-      //Read a line
-      m_ChannelsFile[nbComponents].read(static_cast<char *>(value), numberOfBytesToBeRead);
-      numberOfBytesRead = m_ChannelsFile[nbComponents].gcount();
-#ifdef __APPLE_CC__
-      // fail() is broken in the Mac. It returns true when reaches eof().
-      if (numberOfBytesRead != numberOfBytesToBeRead)
-#else
-      if ((numberOfBytesRead != numberOfBytesToBeRead)  || m_ChannelsFile[nbComponents].fail())
-#endif
-        {
-        itkExceptionMacro(<< "BSQImageIO::Read() Can Read the specified Region"); // read failed
-        }
-//                        cpt = (unsigned long )(nbComponents)* (unsigned long)(this->GetComponentSize()) + numberOfBytesToBeRead * this->GetNumberOfComponents() * LineNo;
-//                        cpt = (unsigned long )(nbComponents)* (unsigned long)(this->GetComponentSize()) + numberOfBytesToBeRead * this->GetNumberOfComponents();
-      for (std::streamsize i = 0;
-           i < numberOfBytesToBeRead;
-           i = i + static_cast<std::streamsize>(this->GetComponentSize()))
-        {
-        memcpy((void*) (&(p[cpt])), (const void*) (&(value[i])), (size_t) (this->GetComponentSize()));
-        cpt += step;
-        }
+      m_ChannelsReader[nbComponents] = RawRasterReader::New();
       }
-    }
-  unsigned long numberOfPixelsOfRegion = lNbLines * lNbColumns * this->GetNumberOfComponents();
-
-  delete[] value;
-
-  // Swap bytes if necessary
-  if (0) {}
-  otbSwappFileToSystemMacro(unsigned short, USHORT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(short, SHORT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(char, CHAR, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned char, UCHAR, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned int, UINT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(int, INT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(long, LONG, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned long, ULONG, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(float, FLOAT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(double, DOUBLE, buffer, numberOfPixelsOfRegion)
-  else
-    {
-    itkExceptionMacro(<< "BSQImageIO::Read() undefined component type! ");
+    m_ChannelsReader[nbComponents]->Open(m_ChannelsFileName[nbComponents]);
+    m_ChannelsReader[nbComponents]->ReadRegion(p + (unsigned long) (nbComponents) * (unsigned long) (componentSize),
+                                               headerLength, numberOfBytesPerLines, componentSize,
+                                               lFirstColumn, lFirstLine, lNbColumns, lNbLines,
+                                               step, swapWordSize);
     }
 }
 
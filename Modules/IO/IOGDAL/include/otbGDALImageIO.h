@@ -56,7 +56,11 @@ class GDALDataTypeWrapper;
  * physical space as GDAL physical space : a given point of
  * image has the same physical location in OTB and in GDAL.
  *
- * The streaming read is implemented.
+ * The streaming read is implemented. When the file is compressed and
+ * organized in blocks, a requested region spanning several blocks is
+ * split into block-aligned windows, decoded concurrently by several
+ * threads, each one with its own GDAL dataset handle (see
+ * ConfigurationManager::GetGDALReadThreads()).
  *
  * \ingroup IOFilters
  *
@@ -133,6 +137,22 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void* buffer);
 
+  /** RasterIO() converts the pixels during the read, for the lossless
+   * conversions of non complex, non indexed images. */
+  virtual bool CanReadAs(IOComponentType componentType) const;
+
+  /** Reads the data from disk into the memory buffer provided, as
+   * components of the given type. */
+  virtual void ReadAs(void* buffer, IOComponentType componentType);
+
+  /** The band list is passed to RasterIO() as its band map, except for
+   * indexed images. */
+  virtual bool CanReadBandSubset() const;
+
+  /** 4 for indexed images (the color of the index), 2 for complex
+   * images read as vectors of scalars, 1 otherwise. */
+  virtual unsigned int GetNumberOfComponentsPerBand() const;
+
   /** Reads 3D data from multiple files assuming one slice per file. */
   virtual void ReadVolume(void* buffer);
 
@@ -188,6 +208,9 @@ protected:
   void PrintSelf(std::ostream& os, itk::Indent indent) const;
   /** Read all information on the image*/
   void InternalReadImageInformation();
+  /** Read the IORegion into the buffer, as components of the given type
+   *  (UNKNOWNCOMPONENTTYPE for the component type of the file) */
+  void InternalRead(void* buffer, IOComponentType bufferComponentType);
   /** Write all information on the image*/
   void InternalWriteImageInformation(const void* buffer);
   /** Number of bands of the image*/
@@ -226,6 +249,23 @@ private:
   GDALDatasetWrapperPointer m_Dataset;
 
   GDALDataTypeWrapper*    m_PxType;
+  /** Band map of RasterIO() (1 based), empty to read every band */
+  std::vector<int>        m_BandMap;
+
+  /** Number of dataset handles to read the window of the file from
+   *  (firstColumn, firstLine) of nbColumns x nbLines pixels, opening the
+   *  missing handles. Returns 1 if the window is read at once. */
+  unsigned int PrepareConcurrentRead(int firstColumn, int firstLine, int nbColumns, int nbLines);
+
+  /** Name of the opened dataset, to open additional handles */
+  std::string m_DatasetName;
+  /** Block size of the file, at full resolution */
+  int m_BlockSizeX;
+  int m_BlockSizeY;
+  /** Whether the blocks of the file are compressed */
+  bool m_IsCompressed;
+  /** Additional handles on the dataset, for the concurrent reads */
+  std::vector<GDALDatasetWrapperPointer> m_ReadDatasets;
   /** Nombre d'octets par pixel */
   int m_BytePerPixel;
 
@@ -19,6 +19,7 @@
 #include <vector>
 #include <boost/algorithm/string/predicate.hpp>
 #include "otbSystem.h"
+#include "otbConfigurationManager.h"
 
 namespace otb
 {
@@ -73,6 +74,14 @@ GDALDriverManagerWrapper::GDALDriverManagerWrapper()
     if (driver)
       GetGDALDriverManager()->DeregisterDriver( driver );
 
+    // Tie the GDAL block cache to the RAM hint, unless the user sets it:
+    // the blocks decoded for a stream division are kept until the next
+    // one, which often shares them
+    if (CPLGetConfigOption("GDAL_CACHEMAX", NULL) == NULL)
+      {
+      GDALSetCacheMax64(static_cast<GIntBig>(ConfigurationManager::GetMaxRAMHint()) * 1024 * 1024);
+      }
+
 // #ifndef CHECK_HDF4OPEN_SYMBOL
 //     // Get rid of the HDF4 driver when it is buggy
 //     driver = GetGDALDriverManager()->GetDriverByName( "hdf4" );
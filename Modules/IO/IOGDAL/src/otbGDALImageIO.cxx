@@ -18,6 +18,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 
 #include "otbGDALImageIO.h"
 #include "otbMacro.h"
@@ -33,12 +34,14 @@
 #include "itkRGBPixel.h"
 #include "itkRGBAPixel.h"
 #include "itkTimeProbe.h"
+#include "itkMultiThreader.h"
 
 #include "cpl_conv.h"
 #include "ogr_spatialref.h"
 #include "ogr_srs_api.h"
 
 #include "otbGDALDriverManagerWrapper.h"
+#include "otbConfigurationManager.h"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include "otbOGRHelpers.h"
@@ -121,6 +124,103 @@ void printDataBuffer(unsigned char *pData, GDALDataType pxlType, int nbBands, in
 };
 */
 
+/** GDAL data type of the buffer components of type componentType
+ * (GDT_Unknown if there is none). */
+static GDALDataType ComponentTypeToGDALDataType(ImageIOBase::IOComponentType componentType)
+{
+  switch (componentType)
+    {
+    case ImageIOBase::UCHAR:
+      return GDT_Byte;
+    case ImageIOBase::USHORT:
+      return GDT_UInt16;
+    case ImageIOBase::SHORT:
+      return GDT_Int16;
+    case ImageIOBase::UINT:
+      return GDT_UInt32;
+    case ImageIOBase::INT:
+      return GDT_Int32;
+    case ImageIOBase::ULONG:
+      return (sizeof(unsigned long) == 4) ? GDT_UInt32 : GDT_Unknown;
+    case ImageIOBase::LONG:
+      return (sizeof(long) == 4) ? GDT_Int32 : GDT_Unknown;
+    case ImageIOBase::FLOAT:
+      return GDT_Float32;
+    case ImageIOBase::DOUBLE:
+      return GDT_Float64;
+    default:
+      return GDT_Unknown;
+    }
+}
+
+/** Window of the file read by one RasterIO() of a concurrent read */
+struct GDALReadWindow
+{
+  int firstColumn;
+  int firstLine;
+  int nbColumns;
+  int nbLines;
+};
+
+/** Parameters of a concurrent read, shared by the threads */
+struct GDALConcurrentRead
+{
+  std::vector<GDALDataset*>   datasets; // one per thread
+  std::vector<GDALReadWindow> windows;
+  unsigned char *             buffer;   // buffer of the whole region
+  int                         firstColumn;
+  int                         firstLine;
+  GDALDataType                bufferType;
+  int                         nbBands;
+  int *                       bandMap;
+  int                         pixelOffset;
+  int                         lineOffset;
+  int                         bandOffset;
+  std::vector<std::string>    errors;   // one per thread, empty on success
+};
+
+/** Read the windows ThreadID, ThreadID + NumberOfThreads... with the
+ * dataset handle of the thread */
+static ITK_THREAD_RETURN_TYPE GDALConcurrentReadCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  GDALConcurrentRead * read = static_cast<GDALConcurrentRead *>(info->UserData);
+  const unsigned int   threadId = info->ThreadID;
+  if (threadId >= read->datasets.size())
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  GDALDataset * dataset = read->datasets[threadId];
+  for (unsigned int i = threadId; i < read->windows.size(); i += info->NumberOfThreads)
+    {
+    const GDALReadWindow& window = read->windows[i];
+    unsigned char * p = read->buffer
+      + static_cast<std::streamoff>(window.firstLine - read->firstLine) * read->lineOffset
+      + static_cast<std::streamoff>(window.firstColumn - read->firstColumn) * read->pixelOffset;
+    CPLErr lCrGdal = dataset->RasterIO(GF_Read,
+                                       window.firstColumn,
+                                       window.firstLine,
+                                       window.nbColumns,
+                                       window.nbLines,
+                                       p,
+                                       window.nbColumns,
+                                       window.nbLines,
+                                       read->bufferType,
+                                       read->nbBands,
+                                       read->bandMap,
+                                       read->pixelOffset,
+                                       read->lineOffset,
+                                       read->bandOffset);
+    if (lCrGdal == CE_Failure)
+      {
+      read->errors[threadId] = CPLGetLastErrorMsg();
+      break;
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 GDALImageIO::GDALImageIO()
 {
   // By default set number of dimensions to two.
@@ -159,6 +259,10 @@ GDALImageIO::GDALImageIO()
   m_NumberOfOverviews = 0;
   m_ResolutionFactor = 0;
   m_BytePerPixel = 0;
+
+  m_BlockSizeX = 0;
+  m_BlockSizeY = 0;
+  m_IsCompressed = false;
 }
 
 GDALImageIO::~GDALImageIO()
@@ -176,6 +280,7 @@ bool GDALImageIO::CanReadFile(const char* file)
     return false;
     }
   m_Dataset = GDALDriverManagerWrapper::GetInstance().Open(file);
+  m_DatasetName = file;
   return m_Dataset.IsNotNull();
 }
 
@@ -195,6 +300,34 @@ void GDALImageIO::ReadVolume(void*)
 
 // Read image with GDAL
 void GDALImageIO::Read(void* buffer)
+{
+  this->InternalRead(buffer, UNKNOWNCOMPONENTTYPE);
+}
+
+bool GDALImageIO::CanReadAs(IOComponentType componentType) const
+{
+  // Let RasterIO() convert the pixels, only in the nominal case (the
+  // complex and indexed cases have their own buffer layouts)
+  if (m_Dataset.IsNull() || m_IsIndexed || m_IsComplex
+      || GDALDataTypeIsComplex(m_PxType->pixType))
+    {
+    return false;
+    }
+  return IsLosslessComponentConversion(this->GetComponentType(), componentType)
+         && ComponentTypeToGDALDataType(componentType) != GDT_Unknown;
+}
+
+void GDALImageIO::ReadAs(void* buffer, IOComponentType componentType)
+{
+  if (!this->CanReadAs(componentType))
+    {
+    itkExceptionMacro(<< "Can not read " << m_FileName << " as "
+                      << this->GetComponentTypeAsString(componentType) << " components");
+    }
+  this->InternalRead(buffer, componentType);
+}
+
+void GDALImageIO::InternalRead(void* buffer, IOComponentType bufferComponentType)
 {
   // Convert buffer from void * to unsigned char *
   unsigned char *p = static_cast<unsigned char *>(buffer);
@@ -375,9 +508,19 @@ void GDALImageIO::Read(void* buffer)
   else
     {
     /********  Nominal case ***********/
-    int pixelOffset = m_BytePerPixel * m_NbBands;
-    int lineOffset  = m_BytePerPixel * m_NbBands * lNbColumnsRegion;
-    int bandOffset  = m_BytePerPixel;
+    // RasterIO() converts the pixels to the buffer type if it is not
+    // the one of the file
+    GDALDataType bufferType = m_PxType->pixType;
+    int bytePerPixel = m_BytePerPixel;
+    if (bufferComponentType != UNKNOWNCOMPONENTTYPE)
+      {
+      bufferType = ComponentTypeToGDALDataType(bufferComponentType);
+      bytePerPixel = GDALGetDataTypeSize(bufferType) / 8;
+      }
+
+    int pixelOffset = bytePerPixel * m_NbBands;
+    int lineOffset  = bytePerPixel * m_NbBands * lNbColumnsRegion;
+    int bandOffset  = bytePerPixel;
     int nbBands     = m_NbBands;
 
     // In some cases, we need to change some parameters for RasterIO
@@ -398,6 +541,7 @@ void GDALImageIO::Read(void* buffer)
                    << " Buffer Size X = " << lNbColumnsRegion << "\n"
                    << " Buffer Size Y = " << lNbLinesRegion << "\n"
                    << " GDAL Data Type = " << GDALGetDataTypeName(m_PxType->pixType) << "\n"
+                   << " Buffer Data Type = " << GDALGetDataTypeName(bufferType) << "\n"
                    << " nbBands = " << nbBands << "\n"
                    << " pixelOffset = " << pixelOffset << "\n"
                    << " lineOffset = " << lineOffset << "\n"
@@ -405,33 +549,142 @@ void GDALImageIO::Read(void* buffer)
 
     itk::TimeProbe chrono;
     chrono.Start();
-    CPLErr lCrGdal = m_Dataset->GetDataSet()->RasterIO(GF_Read,
-                                                       lFirstColumn,
-                                                       lFirstLine,
-                                                       lNbColumns,
-                                                       lNbLines,
-                                                       p,
-                                                       lNbColumnsRegion,
-                                                       lNbLinesRegion,
-                                                       m_PxType->pixType,
-                                                       nbBands,
-                                                       // We want to read all bands
-                                                       NULL,
-                                                       pixelOffset,
-                                                       lineOffset,
-                                                       bandOffset);
+    // The blocks of a compressed file are decoded concurrently, if the
+    // buffer has the size of the window (RasterIO() resamples otherwise)
+    unsigned int nbHandles = 1;
+    if (lNbColumns == lNbColumnsRegion && lNbLines == lNbLinesRegion)
+      {
+      nbHandles = this->PrepareConcurrentRead(lFirstColumn, lFirstLine, lNbColumns, lNbLines);
+      }
+    if (nbHandles > 1)
+      {
+      // Split the window on the block boundaries of the file, each thread
+      // reading its windows with its own dataset handle
+      GDALConcurrentRead read;
+      read.datasets.push_back(m_Dataset->GetDataSet());
+      for (unsigned int i = 0; i + 1 < nbHandles; ++i)
+        {
+        read.datasets.push_back(m_ReadDatasets[i]->GetDataSet());
+        }
+      read.buffer = p;
+      read.firstColumn = lFirstColumn;
+      read.firstLine = lFirstLine;
+      read.bufferType = bufferType;
+      read.nbBands = nbBands;
+      read.bandMap = m_BandMap.empty() ? NULL : &m_BandMap[0];
+      read.pixelOffset = pixelOffset;
+      read.lineOffset = lineOffset;
+      read.bandOffset = bandOffset;
+      read.errors.resize(nbHandles);
+
+      // Strips are grouped, so that each thread has a few windows to read
+      const int firstBlockLine = lFirstLine / m_BlockSizeY;
+      const int lastBlockLine = (lFirstLine + lNbLines - 1) / m_BlockSizeY;
+      const int firstBlockColumn = lFirstColumn / m_BlockSizeX;
+      const int lastBlockColumn = (lFirstColumn + lNbColumns - 1) / m_BlockSizeX;
+      int blockLinesPerWindow = 1;
+      if (firstBlockColumn == lastBlockColumn)
+        {
+        blockLinesPerWindow = std::max(1, (lastBlockLine - firstBlockLine + 1) / static_cast<int>(4 * nbHandles));
+        }
+      for (int by = firstBlockLine; by <= lastBlockLine; by += blockLinesPerWindow)
+        {
+        for (int bx = firstBlockColumn; bx <= lastBlockColumn; ++bx)
+          {
+          GDALReadWindow window;
+          window.firstColumn = std::max(bx * m_BlockSizeX, lFirstColumn);
+          window.firstLine = std::max(by * m_BlockSizeY, lFirstLine);
+          window.nbColumns = std::min((bx + 1) * m_BlockSizeX, lFirstColumn + lNbColumns) - window.firstColumn;
+          window.nbLines = std::min((by + blockLinesPerWindow) * m_BlockSizeY, lFirstLine + lNbLines) - window.firstLine;
+          read.windows.push_back(window);
+          }
+        }
+
+      otbMsgDevMacro(<< "Concurrent RasterIO: " << read.windows.size() << " windows, "
+                     << nbHandles << " threads");
+
+      itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+      threader->SetNumberOfThreads(nbHandles);
+      threader->SetSingleMethod(GDALConcurrentReadCallback, &read);
+      threader->SingleMethodExecute();
+
+      for (unsigned int i = 0; i < read.errors.size(); ++i)
+        {
+        if (!read.errors[i].empty())
+          {
+          itkExceptionMacro(<< "Error while reading image (GDAL format) '"
+            << m_FileName.c_str() << "' : " << read.errors[i]);
+          }
+        }
+      }
+    else
+      {
+      CPLErr lCrGdal = m_Dataset->GetDataSet()->RasterIO(GF_Read,
+                                                         lFirstColumn,
+                                                         lFirstLine,
+                                                         lNbColumns,
+                                                         lNbLines,
+                                                         p,
+                                                         lNbColumnsRegion,
+                                                         lNbLinesRegion,
+                                                         bufferType,
+                                                         nbBands,
+                                                         // All the bands, or the selected ones
+                                                         m_BandMap.empty() ? NULL : &m_BandMap[0],
+                                                         pixelOffset,
+                                                         lineOffset,
+                                                         bandOffset);
+
+      // Check if gdal call succeed
+      if (lCrGdal == CE_Failure)
+        {
+        itkExceptionMacro(<< "Error while reading image (GDAL format) '"
+          << m_FileName.c_str() << "' : " << CPLGetLastErrorMsg());
+        return;
+        }
+      }
     chrono.Stop();
     otbMsgDevMacro(<< "RasterIO Read took " << chrono.GetTotal() << " sec")
+    //printDataBuffer(p, m_PxType->pixType, m_NbBands, lNbColumnsRegion*lNbLinesRegion);
+    }
+}
 
-    // Check if gdal call succeed
-    if (lCrGdal == CE_Failure)
+unsigned int GDALImageIO::PrepareConcurrentRead(int firstColumn, int firstLine, int nbColumns, int nbLines)
+{
+  // Only the compressed blocks are worth decoding concurrently, and the
+  // windows are read at full resolution
+  if (!m_IsCompressed || m_ResolutionFactor != 0 || m_BlockSizeX <= 0 || m_BlockSizeY <= 0
+      || nbColumns <= 0 || nbLines <= 0 || m_DatasetName.empty())
+    {
+    return 1;
+    }
+
+  const unsigned int nbBlocks =
+    ((firstColumn + nbColumns - 1) / m_BlockSizeX - firstColumn / m_BlockSizeX + 1)
+    * ((firstLine + nbLines - 1) / m_BlockSizeY - firstLine / m_BlockSizeY + 1);
+
+  unsigned int nbThreads = ConfigurationManager::GetGDALReadThreads();
+  if (nbThreads == 0)
+    {
+    nbThreads = std::min(4u, static_cast<unsigned int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()));
+    }
+  nbThreads = std::min(nbThreads, nbBlocks);
+  if (nbThreads <= 1)
+    {
+    return 1;
+    }
+
+  // The first thread uses m_Dataset, the others their own handle
+  while (m_ReadDatasets.size() + 1 < nbThreads)
+    {
+    GDALDatasetWrapperPointer dataset = GDALDriverManagerWrapper::GetInstance().Open(m_DatasetName);
+    if (dataset.IsNull())
       {
-      itkExceptionMacro(<< "Error while reading image (GDAL format) '"
-        << m_FileName.c_str() << "' : " << CPLGetLastErrorMsg());
-      return;
+      break;
       }
-    //printDataBuffer(p, m_PxType->pixType, m_NbBands, lNbColumnsRegion*lNbLinesRegion);
+    m_ReadDatasets.push_back(dataset);
     }
+  return std::min(nbThreads, static_cast<unsigned int>(m_ReadDatasets.size()) + 1);
 }
 
 bool GDALImageIO::GetSubDatasetInfo(std::vector<std::string> &names, std::vector<std::string> &desc)
@@ -585,6 +838,7 @@ void GDALImageIO::InternalReadImageInformation()
       {
       otbMsgDevMacro(<< "Reading: " << names[m_DatasetNumber]);
       m_Dataset = GDALDriverManagerWrapper::GetInstance().Open(names[m_DatasetNumber]);
+      m_DatasetName = names[m_DatasetNumber];
       }
     else
       {
@@ -817,6 +1071,13 @@ void GDALImageIO::InternalReadImageInformation()
 
     dataset->GetRasterBand(1)->GetBlockSize(&blockSizeX, &blockSizeY);
 
+    // Keep the block size for the concurrent reads of compressed files
+    m_BlockSizeX = blockSizeX;
+    m_BlockSizeY = blockSizeY;
+    const char * compression = dataset->GetMetadataItem("COMPRESSION", "IMAGE_STRUCTURE");
+    m_IsCompressed = (compression != NULL && !EQUAL(compression, "NONE")) || m_Dataset->IsJPEG2000();
+    m_ReadDatasets.clear();
+
     if(blockSizeX > 0 && blockSizeY > 0)
       {
       otbMsgDevMacro(<< "Original blockSize: "<< blockSizeX << " x " << blockSizeY );
@@ -1192,6 +1453,54 @@ void GDALImageIO::InternalReadImageInformation()
     this->SetPixelType(VECTOR);
     }
 
+  /* -------------------------------------------------------------------- */
+  /* Bands selection                                                      */
+  /* -------------------------------------------------------------------- */
+  // RasterIO() reads the selected bands only, through its band map. A
+  // complex band read into a vector of scalars gives two components.
+  // Indexed images are read from their first band and translated to
+  // colors, so the reader selects their components itself.
+  m_BandMap.clear();
+  const std::vector<unsigned int>& bandList = this->GetBandList();
+  if (!bandList.empty() && !m_IsIndexed)
+    {
+    const unsigned int componentsPerBand = this->GetNumberOfComponentsPerBand();
+    for (unsigned int i = 0; i < bandList.size(); ++i)
+      {
+      if (static_cast<int>(bandList[i]) >= dataset->GetRasterCount())
+        {
+        itkExceptionMacro(<< "Band " << bandList[i] + 1 << " requested, but "
+                          << m_FileName << " has " << dataset->GetRasterCount() << " bands");
+        }
+      m_BandMap.push_back(static_cast<int>(bandList[i]) + 1);
+      }
+    m_NbBands = static_cast<int>(m_BandMap.size());
+    this->SetNumberOfComponents(m_NbBands * componentsPerBand);
+    if (this->GetPixelType() != COMPLEX)
+      {
+      this->SetPixelType(this->GetNumberOfComponents() == 1 ? SCALAR : VECTOR);
+      }
+    }
+}
+
+bool GDALImageIO::CanReadBandSubset() const
+{
+  return !m_BandMap.empty();
+}
+
+unsigned int GDALImageIO::GetNumberOfComponentsPerBand() const
+{
+  if (m_IsIndexed)
+    {
+    // Red, green, blue and alpha of the color table
+    return 4;
+    }
+  if (GDALDataTypeIsComplex(m_PxType->pixType) && !m_IsComplex && m_IsVectorImage)
+    {
+    // Real and imaginary parts
+    return 2;
+    }
+  return 1;
 }
 
 bool GDALImageIO::CanWriteFile(const char* name)
@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itksys/SystemTools.hxx"
+
+typedef otb::VectorImage<unsigned short, 2>  ImageType;
+typedef otb::ImageFileReader<ImageType>      ReaderType;
+typedef otb::ImageFileWriter<ImageType>      WriterType;
+
+/** Read a region of the file, with the given number of GDAL read threads */
+static ImageType::Pointer ReadRegion(const std::string& filename, const ImageType::RegionType& region,
+                                     const std::string& nbThreads)
+{
+  itksys::SystemTools::PutEnv((std::string("OTB_GDAL_READ_THREADS=") + nbThreads).c_str());
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(filename);
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->PropagateRequestedRegion();
+  reader->GetOutput()->UpdateOutputData();
+
+  ImageType::Pointer image = reader->GetOutput();
+  image->DisconnectPipeline();
+  return image;
+}
+
+int otbGDALImageIOConcurrentRead(int itkNotUsed(argc), char * argv[])
+{
+  const char * infname = argv[1];
+  const char * outfname = argv[2];
+
+  // Write a compressed file with small blocks
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(std::string(outfname)
+                      + "?&gdal:co:COMPRESS=DEFLATE&gdal:co:TILED=YES&gdal:co:BLOCKXSIZE=16&gdal:co:BLOCKYSIZE=16");
+  writer->Update();
+
+  // Whole image, and a region which is not aligned on the blocks
+  ImageType::RegionType largest = reader->GetOutput()->GetLargestPossibleRegion();
+  ImageType::RegionType unaligned = largest;
+  unaligned.ShrinkByRadius(7);
+
+  ImageType::RegionType regions[2] = {largest, unaligned};
+  for (unsigned int r = 0; r < 2; ++r)
+    {
+    ImageType::Pointer reference = ReadRegion(outfname, regions[r], "1");
+    ImageType::Pointer concurrent = ReadRegion(outfname, regions[r], "4");
+
+    if (concurrent->GetBufferedRegion() != regions[r])
+      {
+      std::cerr << "Buffered region " << concurrent->GetBufferedRegion()
+                << " instead of " << regions[r] << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    itk::ImageRegionConstIterator<ImageType> itRef(reference, regions[r]);
+    itk::ImageRegionConstIterator<ImageType> it(concurrent, regions[r]);
+    for (itRef.GoToBegin(), it.GoToBegin(); !it.IsAtEnd(); ++itRef, ++it)
+      {
+      if (it.Get() != itRef.Get())
+        {
+        std::cerr << "Pixel " << it.GetIndex() << ": " << it.Get()
+                  << " read concurrently, " << itRef.Get() << " expected" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
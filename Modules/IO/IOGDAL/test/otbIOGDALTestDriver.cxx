@@ -14,4 +14,5 @@ void RegisterTests()
   REGISTER_TEST(otbGDALImageIOTestCanRead);
   REGISTER_TEST(otbMultiDatasetReadingInfo);
   REGISTER_TEST(otbOGRVectorDataIOTestCanRead);
+  REGISTER_TEST(otbGDALImageIOConcurrentRead);
 }
@@ -19,6 +19,7 @@
 #define __otbLUMImageIO_h
 
 #include "otbImageIOBase.h"
+#include "otbRawRasterReader.h"
 #include <fstream>
 #include <string>
 #include <vector>
@@ -185,6 +186,8 @@ private:
   std::string                 m_TypeLum; //used for write
   otb::ImageIOBase::ByteOrder m_FileByteOrder;
   std::fstream                m_File;
+  /** Memory mapped file, for reading */
+  RawRasterReader::Pointer    m_RawReader;
 
 };
 
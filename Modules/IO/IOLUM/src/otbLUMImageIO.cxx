@@ -138,48 +138,21 @@ void LUMImageIO::Read(void* buffer)
   otbMsgDevMacro(<< " Region read (IORegion)  : " << this->GetIORegion());
   otbMsgDevMacro(<< " Nb Of Components       : " << this->GetNumberOfComponents());
 
-  std::streamoff  headerLength = static_cast<std::streamoff>(this->GetComponentSize() * m_Dimensions[0]);
-  std::streamoff  numberOfBytesPerLines = headerLength;
-  std::streamoff  offset;
-  std::streamsize numberOfBytesToBeRead = static_cast<std::streamsize>(this->GetComponentSize() * lNbColumns);
-  std::streamsize numberOfBytesRead;
-  std::streamsize cpt = 0;
-  for (int LineNo = lFirstLine; LineNo < lFirstLine + lNbLines; LineNo++)
-    {
-    offset  =  headerLength + numberOfBytesPerLines * static_cast<std::streamoff>(LineNo);
-    offset +=  static_cast<std::streamoff>(this->GetComponentSize() * lFirstColumn);
-    m_File.seekg(offset, std::ios::beg);
-    m_File.read(static_cast<char *>(p + cpt), numberOfBytesToBeRead);
-    numberOfBytesRead = m_File.gcount();
-#ifdef __APPLE_CC__
-    // fail() is broken in the Mac. It returns true when reaches eof().
-    if (numberOfBytesRead != numberOfBytesToBeRead)
-#else
-    if ((numberOfBytesRead != numberOfBytesToBeRead)  || m_File.fail())
-#endif
-      {
-      itkExceptionMacro(<< "LUMImageIO::Read() Can Read the specified Region"); // read failed
-      }
-    cpt += numberOfBytesToBeRead;
-    }
+  const unsigned int componentSize = this->GetComponentSize();
+  std::streamoff     headerLength = static_cast<std::streamoff>(componentSize * m_Dimensions[0]);
+  std::streamoff     numberOfBytesPerLines = headerLength;
 
-  unsigned long numberOfPixelsPerLines = lNbLines * lNbColumns;
   // Swap bytes if necessary
-  if (0) {}
-  otbSwappFileToSystemMacro(unsigned short, USHORT, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(short, SHORT, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(char, CHAR, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(unsigned char, UCHAR, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(unsigned int, UINT, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(int, INT, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(long, LONG, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(unsigned long, ULONG, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(float, FLOAT, buffer, numberOfPixelsPerLines)
-  otbSwappFileToSystemMacro(double, DOUBLE, buffer, numberOfPixelsPerLines)
-  else
+  unsigned int swapWordSize = (m_ByteOrder != m_FileByteOrder) ? componentSize : 0;
+
+  if (m_RawReader.IsNull())
     {
-    itkExceptionMacro(<< "LUMImageIO::Read() undefined component type! ");
+    m_RawReader = RawRasterReader::New();
     }
+  m_RawReader->Open(m_FileName);
+  m_RawReader->ReadRegion(p, headerLength, numberOfBytesPerLines, componentSize,
+                          lFirstColumn, lFirstLine, lNbColumns, lNbLines,
+                          componentSize, swapWordSize);
 }
 
 void LUMImageIO::ReadImageInformation()
@@ -19,6 +19,7 @@
 #define __otbMWImageIO_h
 
 #include "otbImageIOBase.h"
+#include "otbRawRasterReader.h"
 #include <fstream>
 #include <string>
 #include <vector>
@@ -176,6 +177,8 @@ private:
   std::string                 m_TypeMW; //used for write
   otb::ImageIOBase::ByteOrder m_FileByteOrder;
   std::fstream                m_File;
+  /** Memory mapped file, for reading */
+  RawRasterReader::Pointer    m_RawReader;
   unsigned int                m_Ncom;
 
 };
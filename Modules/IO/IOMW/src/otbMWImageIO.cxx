@@ -123,40 +123,27 @@ void MWImageIO::Read(void* buffer)
   otbMsgDevMacro(<< " Region lue (IORegion)  : " << this->GetIORegion());
   otbMsgDevMacro(<< " Nb Of Components       : " << this->GetNumberOfComponents());
 
-  std::streamoff headerLength =
-    static_cast<std::streamoff> (64 * sizeof(char)) + static_cast<std::streamoff> (m_Ncom * sizeof(char));
-  std::streamoff  numberOfBytesPerLines = static_cast<std::streamoff>(this->GetComponentSize() * m_Dimensions[0]);
-  std::streamoff  offset;
-  std::streamsize numberOfBytesToBeRead = static_cast<std::streamsize>(this->GetComponentSize() * lNbColonnes);
-  std::streamsize numberOfBytesRead;
-  std::streamsize cpt = 0;
-  for (int LineNo = lPremiereLigne; LineNo < lPremiereLigne + lNbLignes; LineNo++)
+  if (this->GetComponentType() != FLOAT)
     {
-    offset  =  headerLength + numberOfBytesPerLines * static_cast<std::streamoff>(LineNo);
-    offset +=  static_cast<std::streamoff>(this->GetComponentSize() * lPremiereColonne);
-    m_File.seekg(offset, std::ios::beg);
-    m_File.read(static_cast<char *>(p + cpt), numberOfBytesToBeRead);
-    numberOfBytesRead = m_File.gcount();
-#ifdef __APPLE_CC__
-    // fail() is broken in the Mac. It returns true when reaches eof().
-    if (numberOfBytesRead != numberOfBytesToBeRead)
-#else
-    if ((numberOfBytesRead != numberOfBytesToBeRead)  || m_File.fail())
-#endif
-      {
-      itkExceptionMacro(<< "MWImageIO::Read() Can Read the specified Region"); // read failed
-      }
-    cpt += numberOfBytesToBeRead;
+    itkExceptionMacro(<< "MWImageIO::Read() undefined component type! ");
     }
 
-  unsigned long numberOfPixelsPerLines = lNbLignes * lNbColonnes;
+  const unsigned int componentSize = this->GetComponentSize();
+  std::streamoff headerLength =
+    static_cast<std::streamoff> (64 * sizeof(char)) + static_cast<std::streamoff> (m_Ncom * sizeof(char));
+  std::streamoff numberOfBytesPerLines = static_cast<std::streamoff>(componentSize * m_Dimensions[0]);
+
   // Swap bytes if necessary
-  if (0) {}
-  otbSwappFileToSystemMacro(float, FLOAT, buffer, numberOfPixelsPerLines)
-  else
+  unsigned int swapWordSize = (m_ByteOrder != m_FileByteOrder) ? componentSize : 0;
+
+  if (m_RawReader.IsNull())
     {
-    itkExceptionMacro(<< "MWImageIO::Read() undefined component type! ");
+    m_RawReader = RawRasterReader::New();
     }
+  m_RawReader->Open(m_FileName);
+  m_RawReader->ReadRegion(p, headerLength, numberOfBytesPerLines, componentSize,
+                          lPremiereColonne, lPremiereLigne, lNbColonnes, lNbLignes,
+                          componentSize, swapWordSize);
 }
 
 void MWImageIO::ReadImageInformation()
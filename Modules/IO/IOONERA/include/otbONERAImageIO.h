@@ -20,6 +20,7 @@
 
 #include "itkByteSwapper.h"
 #include "otbImageIOBase.h"
+#include "otbRawRasterReader.h"
 #include <fstream>
 
 namespace otb
@@ -143,6 +144,8 @@ protected:
   //float **pafimas;
   std::fstream m_Datafile;
   std::fstream m_Headerfile;
+  /** Memory mapped data file, for reading */
+  RawRasterReader::Pointer m_RawReader;
 
 private:
   ONERAImageIO(const Self &); //purposely not implemented
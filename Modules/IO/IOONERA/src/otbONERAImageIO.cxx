@@ -162,15 +162,7 @@ void ONERAImageIO::ReadVolume(void*)
 // Read image
 void ONERAImageIO::Read(void* buffer)
 {
-  unsigned int       dim;
-  const unsigned int dimensions = this->GetNumberOfDimensions();
-  unsigned long      numberOfPixels = 1;
-  for (dim = 0; dim < dimensions; ++dim)
-    {
-    numberOfPixels *= m_Dimensions[dim];
-    }
-
-  unsigned char * p = static_cast<unsigned char *>(buffer);
+  char * p = static_cast<char *>(buffer);
 
   int lNbLines   = this->GetIORegion().GetSize()[1];
   int lNbColumns = this->GetIORegion().GetSize()[0];
@@ -182,56 +174,27 @@ void ONERAImageIO::Read(void* buffer)
   otbMsgDevMacro(<< " Region read (IORegion)  : " << this->GetIORegion());
   otbMsgDevMacro(<< " Nb Of Components  : " << this->GetNumberOfComponents());
 
-  //read header information file:
-  if (!this->OpenOneraDataFileForReading(m_FileName.c_str()))
+  if ((this->GetComponentType() != FLOAT) && (this->GetComponentType() != DOUBLE))
     {
-    itkExceptionMacro(<< "Cannot read requested file");
+    itkExceptionMacro(<< "ONERAImageIO::Read() undefined component type! ");
     }
 
-  std::streamoff  numberOfBytesPerLines = static_cast<std::streamoff>(2 * m_width * m_BytePerPixel);
-  std::streamoff  headerLength = ONERA_HEADER_LENGTH + numberOfBytesPerLines;
-  std::streamoff  offset;
-  std::streamsize numberOfBytesToBeRead = 2 * m_BytePerPixel * lNbColumns;
-  std::streamsize numberOfBytesRead;
-
-  char*           value = new char[numberOfBytesToBeRead];
-  std::streamsize cpt = 0;
-
-  for (int LineNo = lFirstLine; LineNo < lFirstLine + lNbLines; LineNo++)
-    {
-    offset  =  headerLength + numberOfBytesPerLines * static_cast<std::streamoff>(LineNo);
-    offset +=  static_cast<std::streamoff>(m_BytePerPixel * lFirstColumn);
-    m_Datafile.seekg(offset, std::ios::beg);
-    m_Datafile.read(static_cast<char *>(value), numberOfBytesToBeRead);
-    numberOfBytesRead = m_Datafile.gcount();
-#ifdef __APPLE_CC__
-    // fail() is broken in the Mac. It returns true when reaches eof().
-    if (numberOfBytesRead != numberOfBytesToBeRead)
-#else
-    if ((numberOfBytesRead != numberOfBytesToBeRead)  || m_Datafile.fail())
-#endif
-      {
-      itkExceptionMacro(<< "ONERAImageIO::Read() Can Read the specified Region"); // read failed
-      }
+  // Pixels are complex: real and imaginary parts are stored one after the other
+  unsigned int   pixelSize = 2 * m_BytePerPixel;
+  std::streamoff numberOfBytesPerLines = static_cast<std::streamoff>(pixelSize * m_width);
+  std::streamoff headerLength = ONERA_HEADER_LENGTH + numberOfBytesPerLines;
 
-    memcpy((void*) (&(p[cpt])), (const void*) (value), (size_t) (numberOfBytesToBeRead));
-    cpt += numberOfBytesToBeRead;
-    }
+  // Swap bytes if necessary, one part after the other
+  unsigned int swapWordSize = (m_ByteOrder != m_FileByteOrder) ? m_BytePerPixel : 0;
 
-  //byte swapping depending on pixel type:
-  unsigned long numberOfPixelsPerRegion = lNbLines * lNbColumns * 2;
-  // Swap bytes if necessary
-  if (0) {}
-  otbSwappFileToSystemMacro(float, FLOAT, buffer, numberOfPixelsPerRegion)
-  otbSwappFileToSystemMacro(double, DOUBLE, buffer, numberOfPixelsPerRegion)
-  else
+  if (m_RawReader.IsNull())
     {
-    itkExceptionMacro(<< "ONERAImageIO::Read() undefined component type! ");
+    m_RawReader = RawRasterReader::New();
     }
-
-  delete[] value;
-  value = NULL;
-
+  m_RawReader->Open(System::GetRootName(m_FileName) + ".dat");
+  m_RawReader->ReadRegion(p, headerLength, numberOfBytesPerLines, pixelSize,
+                          lFirstColumn, lFirstLine, lNbColumns, lNbLines,
+                          pixelSize, swapWordSize);
 }
 
 bool ONERAImageIO::OpenOneraDataFileForReading(const char* filename)
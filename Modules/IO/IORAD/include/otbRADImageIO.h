@@ -19,6 +19,7 @@
 #define __otbRADImageIO_h
 
 #include "otbImageIOBase.h"
+#include "otbRawRasterReader.h"
 #include <fstream>
 #include <string>
 #include <vector>
@@ -176,6 +177,9 @@ private:
   std::string                 m_TypeRAD;
   std::vector<std::string>    m_ChannelsFileName;
   std::fstream *              m_ChannelsFile;
+
+  /** Memory mapped channel files, for reading */
+  std::vector<RawRasterReader::Pointer> m_ChannelsReader;
   unsigned int                m_NbOfChannels;
   int                         m_BytePerPixel;
 
@@ -132,8 +132,7 @@ void RADImageIO::ReadVolume(void*)
 // Read image
 void RADImageIO::Read(void* buffer)
 {
-  unsigned long step = this->GetNumberOfComponents();
-  char *        p = static_cast<char *>(buffer);
+  char * p = static_cast<char *>(buffer);
 
   int lNbLines   = this->GetIORegion().GetSize()[1];
   int lNbColumns = this->GetIORegion().GetSize()[0];
@@ -147,81 +146,35 @@ void RADImageIO::Read(void* buffer)
   otbMsgDevMacro(<< " Size Of Components     : " << this->GetComponentSize());
   otbMsgDevMacro(<< " Nb Of Channels         : " << m_NbOfChannels);
 
-  std::streamoff  headerLength(0);
-  std::streamoff  offset;
-  std::streamoff  numberOfBytesPerLines = static_cast<std::streamoff>(m_BytePerPixel * m_Dimensions[0]);
-  std::streamsize numberOfBytesToBeRead = m_BytePerPixel * lNbColumns;
-  std::streamsize numberOfBytesRead;
-  unsigned long   cpt = 0;
+  std::streamoff headerLength(0);
+  std::streamoff numberOfBytesPerLines = static_cast<std::streamoff>(m_BytePerPixel * m_Dimensions[0]);
 
-  // Update the step variable
-  step = step * (unsigned long) (this->GetComponentSize());
+  // Step between two pixels in the (interleaved) buffer
+  unsigned long step = (unsigned long) (this->GetNumberOfComponents()) * (unsigned long) (this->GetComponentSize());
 
-  char * value = new char[numberOfBytesToBeRead];
-  if (value == NULL)
+  // Swap bytes if necessary. The words of a channel pixel (real and
+  // imaginary parts) are swapped separately.
+  unsigned int swapWordSize = 0;
+  if ((m_ByteOrder != m_FileByteOrder) && (m_BytePerPixel % this->GetComponentSize() == 0))
     {
-    itkExceptionMacro(<< "RADImageIO::Read(): Bad alloc");
-    return;
+    swapWordSize = this->GetComponentSize();
     }
 
-  otbMsgDevMacro(<< " sizeof(streamsize)    : " << sizeof(std::streamsize));
-  otbMsgDevMacro(<< " sizeof(streampos)     : " << sizeof(std::streampos));
-  otbMsgDevMacro(<< " sizeof(streamoff)     : " << sizeof(std::streamoff));
-  otbMsgDevMacro(<< " sizeof(std::ios::beg) : " << sizeof(std::ios::beg));
-  otbMsgDevMacro(<< " sizeof(size_t)        : " << sizeof(size_t));
-  otbMsgDevMacro(<< " sizeof(unsigned long) : " << sizeof(unsigned long));
-
+  // Each channel file is mapped in memory, and its pixels are copied
+  // (and swapped) directly at their place in the interleaved buffer
+  m_ChannelsReader.resize(m_NbOfChannels);
   for (unsigned int numChannel = 0; numChannel < m_NbOfChannels; ++numChannel)
     {
-    cpt = (unsigned long) (numChannel) * (unsigned long) (m_BytePerPixel);
-    //Read region of the channel
-    for (int LineNo = lFirstLine; LineNo < lFirstLine + lNbLines; LineNo++)
+    if (m_ChannelsReader[numChannel].IsNull())
       {
-      offset  =  headerLength + numberOfBytesPerLines * static_cast<std::streamoff>(LineNo);
-      offset +=  static_cast<std::streamoff>(m_BytePerPixel * lFirstColumn);
-      m_ChannelsFile[numChannel].seekg(offset, std::ios::beg);
-      //Read a line
-      m_ChannelsFile[numChannel].read(static_cast<char *>(value), numberOfBytesToBeRead);
-
-      numberOfBytesRead = m_ChannelsFile[numChannel].gcount();
-#ifdef __APPLE_CC__
-      // fail() is broken in the Mac. It returns true when reaches eof().
-      if (numberOfBytesRead != numberOfBytesToBeRead)
-#else
-      if ((numberOfBytesRead != numberOfBytesToBeRead)  || m_ChannelsFile[numChannel].fail())
-#endif
-        {
-        itkExceptionMacro(<< "RADImageIO::Read() Can Read the specified Region"); // read failed
-        }
-      for (std::streamsize i = 0; i < numberOfBytesToBeRead; i = i + static_cast<std::streamsize>(m_BytePerPixel))
-        {
-        memcpy((void*) (&(p[cpt])), (const void*) (&(value[i])), (size_t) (m_BytePerPixel));
-        cpt += step;
-        }
+      m_ChannelsReader[numChannel] = RawRasterReader::New();
       }
+    m_ChannelsReader[numChannel]->Open(m_ChannelsFileName[numChannel]);
+    m_ChannelsReader[numChannel]->ReadRegion(p + (unsigned long) (numChannel) * (unsigned long) (m_BytePerPixel),
+                                             headerLength, numberOfBytesPerLines, m_BytePerPixel,
+                                             lFirstColumn, lFirstLine, lNbColumns, lNbLines,
+                                             step, swapWordSize);
     }
-  unsigned long numberOfPixelsOfRegion = lNbLines * lNbColumns * this->GetNumberOfComponents();
-
-  // Swap bytes if necessary
-  if (0) {}
-  otbSwappFileToSystemMacro(unsigned short, USHORT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(short, SHORT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(char, CHAR, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned char, UCHAR, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned int, UINT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(int, INT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(long, LONG, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(unsigned long, ULONG, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(float, FLOAT, buffer, numberOfPixelsOfRegion)
-  otbSwappFileToSystemMacro(double, DOUBLE, buffer, numberOfPixelsOfRegion)
-  else
-    {
-    itkExceptionMacro(<< "RADImageIO::Read() undefined component type! ");
-    }
-
-  delete[] value;
-  value = NULL;
-
 }
 
 void RADImageIO::ReadImageInformation()
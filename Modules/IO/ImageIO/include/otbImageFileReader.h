@@ -156,8 +156,10 @@ protected:
   virtual ~ImageFileReader();
   void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
-  /** Convert a block of pixels from one type to another. */
-  void DoConvertBuffer(void* buffer, size_t numberOfPixels);
+  /** Convert a block of pixels from one type to another, into the
+   * output buffer from its pixel firstPixel. The pixels of the block
+   * have the components of the selected bands only. */
+  void DoConvertBuffer(void* buffer, size_t numberOfPixels, size_t firstPixel = 0);
 
 private:
   /** Test whether the given filename exist and it is readable,
@@ -167,6 +169,14 @@ private:
       appropriate message will be thrown. */
   void TestFileExistanceAndReadability();
 
+  /** Number of components of the pixels delivered by the reader (the
+   * components of the selected bands if the reader selects them itself). */
+  unsigned int GetNumberOfReadComponents() const
+  {
+    return m_BandList.empty() ? m_ImageIO->GetNumberOfComponents()
+                              : static_cast<unsigned int>(m_BandList.size()) * m_ComponentsPerBand;
+  }
+
   /** Generate the filename (for GDALImageI for example). If filename is a directory, look if is a
     * CEOS product (file "DAT...") In this case, the GdalFileName contain the open image file.
     */
@@ -192,6 +202,13 @@ private:
   FNameHelperType::Pointer m_FilenameHelper;
 
   unsigned int m_AdditionalNumber;
+
+  // The bands selected by the extended filename, when the ImageIO reads
+  // every band (empty otherwise): they are extracted by the reader
+  std::vector<unsigned int> m_BandList;
+
+  // Number of components of each band of the ImageIO buffer
+  unsigned int m_ComponentsPerBand;
 };
 
 } //namespace otb
@@ -24,6 +24,8 @@
 #include "otbSystem.h"
 #include <itksys/SystemTools.hxx>
 #include <fstream>
+#include <algorithm>
+#include <vector>
 
 #include "itkImageIOFactory.h"
 #include "itkPixelTraits.h"
@@ -35,6 +37,7 @@
 #include "otbMetaDataKey.h"
 
 #include "otbMacro.h"
+#include "otbPipelineProfiler.h"
 
 
 namespace otb
@@ -61,7 +64,8 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
    m_ExceptionMessage(""),
    m_ActualIORegion(),
    m_FilenameHelper(FNameHelperType::New()),
-   m_AdditionalNumber(0)
+   m_AdditionalNumber(0),
+   m_ComponentsPerBand(1)
 {
 }
 
@@ -171,10 +175,18 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
 
   this->m_ImageIO->SetIORegion(ioRegion);
 
+  PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+  if (profiler->IsEnabled())
+    {
+    profiler->AddBytesRead(this, static_cast<unsigned long>(ioRegion.GetNumberOfPixels())
+                           * this->m_ImageIO->GetComponentSize() * this->m_ImageIO->GetNumberOfComponents());
+    }
+
   typedef otb::DefaultConvertPixelTraits<typename TOutputImage::IOPixelType> ConvertIOPixelTraits;
   typedef otb::DefaultConvertPixelTraits<typename TOutputImage::PixelType>   ConvertOutputPixelTraits;
 
-  if (this->m_ImageIO->GetComponentTypeInfo()
+  if (m_BandList.empty()
+      && this->m_ImageIO->GetComponentTypeInfo()
       == typeid(typename ConvertOutputPixelTraits::ComponentType)
       && (this->m_ImageIO->GetNumberOfComponents()
           == ConvertIOPixelTraits::GetNumberOfComponents()))
@@ -185,26 +197,90 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
     }
   else // a type conversion is necessary
     {
+    // The ImageIO may convert the components itself, directly into the
+    // output buffer, when the conversion is a cast of each component
+    // (scalar pixels or VectorImage)
+    const bool isVectorImage = (strcmp(output->GetNameOfClass(), "VectorImage") == 0);
+    const ImageIOBase::IOComponentType outputComponentType =
+      ImageIOBase::GetComponentTypeFromTypeInfo(typeid(typename ConvertOutputPixelTraits::ComponentType));
+
+    if (m_BandList.empty()
+        && (isVectorImage
+         || (this->m_ImageIO->GetNumberOfComponents() == 1
+             && ConvertIOPixelTraits::GetNumberOfComponents() == 1)))
+        && this->m_ImageIO->CanReadAs(outputComponentType))
+      {
+      otbMsgDevMacro(<< "ImageIO reads " << this->m_ImageIO->GetComponentTypeAsString(this->m_ImageIO->GetComponentType())
+                     << " components as " << this->m_ImageIO->GetComponentTypeAsString(outputComponentType));
+      this->m_ImageIO->ReadAs(buffer, outputComponentType);
+      return;
+      }
+
+    // Otherwise, the region is read and converted by strips of lines, so
+    // that the load buffer stays small and in the cache while it is
+    // converted. A non streamable ImageIO reads the whole image at once.
     // note: char is used here because the buffer is read in bytes
     // regardless of the actual type of the pixels.
-    ImageRegionType region = output->GetBufferedRegion();
+    const std::streamoff bytesPerPixel = this->m_ImageIO->GetComponentSize() * this->m_ImageIO->GetNumberOfComponents();
+    const std::streamoff nbColumns = ioSize[0];
+    const std::streamoff nbLines = (nbColumns > 0) ? static_cast<std::streamoff>(ioRegion.GetNumberOfPixels()) / nbColumns : 0;
+
+    // about the size of a L2 cache
+    const std::streamoff stripSizeInBytes = 1 << 20;
+    std::streamoff linesPerStrip = nbLines;
+    if (this->m_ImageIO->CanStreamRead() && TOutputImage::ImageDimension == 2)
+      {
+      linesPerStrip = std::max(static_cast<std::streamoff>(1),
+                               std::min(nbLines, stripSizeInBytes / (bytesPerPixel * nbColumns)));
+      }
 
-    // Adapt the image size with the region
-    std::streamoff nbBytes = (this->m_ImageIO->GetComponentSize() * this->m_ImageIO->GetNumberOfComponents())
-                             * static_cast<std::streamoff>(region.GetNumberOfPixels());
+    std::vector<char> loadBuffer(static_cast<size_t>(bytesPerPixel * nbColumns * linesPerStrip));
 
-    char * loadBuffer = new char[nbBytes];
+    // Components of the selected bands, when the reader extracts them
+    const size_t componentSize = this->m_ImageIO->GetComponentSize();
+    const size_t nbIOComponents = this->m_ImageIO->GetNumberOfComponents();
+    const size_t bandSize = componentSize * m_ComponentsPerBand;
+    std::vector<char> selectBuffer(bandSize * m_BandList.size() * static_cast<size_t>(nbColumns * linesPerStrip));
 
-    otbMsgDevMacro(<< "size of Buffer to GDALImageIO::read = " << nbBytes << " = \n"
+    otbMsgDevMacro(<< "size of Buffer to ImageIO::Read = " << loadBuffer.size() << " = \n"
         << "ComponentSize ("<< this->m_ImageIO->GetComponentSize() << ") x " \
         << "Nb of Component (" << this->m_ImageIO->GetNumberOfComponents() << ") x " \
-        << "Nb of Pixel to read (" << region.GetNumberOfPixels() << ")" );
+        << "Nb of Pixel to read (" << nbColumns * linesPerStrip << ")" );
 
-    this->m_ImageIO->Read(loadBuffer);
+    itk::ImageIORegion stripRegion = ioRegion;
+    for (std::streamoff line = 0; line < nbLines; line += linesPerStrip)
+      {
+      const std::streamoff stripLines = std::min(linesPerStrip, nbLines - line);
+      if (linesPerStrip < nbLines)
+        {
+        stripRegion.SetIndex(1, ioStart[1] + line);
+        stripRegion.SetSize(1, stripLines);
+        this->m_ImageIO->SetIORegion(stripRegion);
+        }
 
-    this->DoConvertBuffer(loadBuffer, region.GetNumberOfPixels());
+      this->m_ImageIO->Read(&loadBuffer[0]);
 
-    delete[] loadBuffer;
+      char * convertBuffer = &loadBuffer[0];
+      if (!m_BandList.empty())
+        {
+        const size_t nbPixels = static_cast<size_t>(nbColumns * stripLines);
+        char * out = &selectBuffer[0];
+        for (size_t pixel = 0; pixel < nbPixels; ++pixel)
+          {
+          const char * in = &loadBuffer[pixel * nbIOComponents * componentSize];
+          for (unsigned int band = 0; band < m_BandList.size(); ++band, out += bandSize)
+            {
+            memcpy(out, in + m_BandList[band] * bandSize, bandSize);
+            }
+          }
+        convertBuffer = &selectBuffer[0];
+        }
+
+      this->DoConvertBuffer(convertBuffer, static_cast<size_t>(nbColumns * stripLines),
+                            static_cast<size_t>(nbColumns * line));
+      }
+
+    this->m_ImageIO->SetIORegion(ioRegion);
     }
 }
 
@@ -342,11 +418,41 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
   // This value is used by JPEG2000ImageIO and not by the others ImageIO
   itk::EncapsulateMetaData<unsigned int>(dict, MetaDataKey::CacheSizeInBytes, 135000000);
 
+  // Pass the bands selection
+  std::vector<unsigned int> bandList;
+  if (m_FilenameHelper->BandListIsSet())
+    {
+    bandList = m_FilenameHelper->GetBandList();
+    }
+  this->m_ImageIO->SetBandList(bandList);
+
   // Got to allocate space for the image. Determine the characteristics of
   // the image.
   //
   this->m_ImageIO->SetFileName(this->m_FileName.c_str());
   this->m_ImageIO->ReadImageInformation();
+
+  // If the ImageIO can not read a subset of the bands, it reads them all
+  // and the reader extracts the components of the selected ones
+  m_BandList.clear();
+  m_ComponentsPerBand = std::max(1U, this->m_ImageIO->GetNumberOfComponentsPerBand());
+  if (!bandList.empty() && !this->m_ImageIO->CanReadBandSubset())
+    {
+    const unsigned int nbBands = this->m_ImageIO->GetNumberOfComponents() / m_ComponentsPerBand;
+    for (unsigned int i = 0; i < bandList.size(); ++i)
+      {
+      if (bandList[i] >= nbBands)
+        {
+        otb::ImageFileReaderException e(__FILE__, __LINE__);
+        std::ostringstream msg;
+        msg << "Band " << bandList[i] + 1 << " requested, but "
+            << this->m_FileName << " has " << nbBands << " bands";
+        e.SetDescription(msg.str().c_str());
+        throw e;
+        }
+      }
+    m_BandList = bandList;
+    }
   // Initialization du nombre de Composante par pixel
 // THOMAS ceci n'est pas dans ITK !!
 //  output->SetNumberOfComponentsPerPixel(this->m_ImageIO->GetNumberOfComponents());
@@ -511,7 +617,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
   if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
     {
     typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-    AccessorFunctorType::SetVectorLength(output, this->m_ImageIO->GetNumberOfComponents());
+    AccessorFunctorType::SetVectorLength(output, this->GetNumberOfReadComponents());
     }
 
   output->SetLargestPossibleRegion(region);
@@ -680,11 +786,14 @@ template <class TOutputImage, class ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>
 ::DoConvertBuffer(void* inputData,
-                  size_t numberOfPixels)
+                  size_t numberOfPixels,
+                  size_t firstPixel)
 {
   // get the pointer to the destination buffer
   OutputImagePixelType *outputData =
-    this->GetOutput()->GetPixelContainer()->GetBufferPointer();
+    this->GetOutput()->GetPixelContainer()->GetBufferPointer()
+    + firstPixel * (strcmp(this->GetOutput()->GetNameOfClass(), "VectorImage") == 0 ?
+                    this->GetOutput()->GetNumberOfComponentsPerPixel() : 1);
 
   // TODO:
   // Pass down the PixelType (RGB, VECTOR, etc.) so that any vector to
@@ -714,7 +823,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
       >                                                 \
       ::ConvertVectorImage(                             \
        static_cast<type*>(inputData),                  \
-       m_ImageIO->GetNumberOfComponents(),             \
+       this->GetNumberOfReadComponents(),             \
        outputData,                                     \
        numberOfPixels);              \
      } \
@@ -727,7 +836,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
       >                                                 \
       ::Convert(                                        \
         static_cast<type*>(inputData),                  \
-        m_ImageIO->GetNumberOfComponents(),             \
+        this->GetNumberOfReadComponents(),             \
         outputData,                                     \
         numberOfPixels);              \
       } \
@@ -749,7 +858,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
         >                                                 \
         ::ConvertComplexVectorImageToVectorImageComplex(                             \
          static_cast<type*>(inputData),                \
-         m_ImageIO->GetNumberOfComponents(),             \
+         this->GetNumberOfReadComponents(),             \
          outputData,                                     \
          numberOfPixels); \
        }\
@@ -762,7 +871,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
         >                                                  \
         ::ConvertComplexVectorImageToVectorImage(                             \
          static_cast<type*>(inputData),                \
-         m_ImageIO->GetNumberOfComponents(),             \
+         this->GetNumberOfReadComponents(),             \
          outputData,                                     \
          numberOfPixels);              \
        }\
@@ -776,7 +885,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
       >                                                 \
       ::ConvertComplexToGray(                                        \
        static_cast<type*>(inputData),                  \
-       m_ImageIO->GetNumberOfComponents(),             \
+       this->GetNumberOfReadComponents(),             \
        outputData,                                     \
        numberOfPixels);              \
      } \
@@ -156,6 +156,16 @@ public:
    *   is set from the CMake configuration option */
   void SetAutomaticAdaptativeStreaming(unsigned int availableRAM = 0, double bias = 1.0);
 
+  /**  Set the streaming mode to 'footprint' and configure the number of MB
+   *   available. Square tiles are computed from the estimated memory
+   *   consumption of the pipeline, then refined and ordered according to
+   *   their footprint in the input files, so that input tiles decoded for
+   *   one tile are reused by the next ones (see RAMDrivenFootprintStreamingManager).
+   *   Setting the availableRAM or inputCacheSize parameters to 0 means that
+   *   the value is set from the configuration */
+  void SetAutomaticFootprintStreaming(unsigned int availableRAM = 0, double bias = 1.0,
+                                      unsigned int inputCacheSize = 0);
+
   /** Set the only input of the writer */
   using Superclass::SetInput;
   virtual void SetInput(const InputImageType *input);
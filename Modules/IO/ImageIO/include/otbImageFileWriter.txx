@@ -41,6 +41,9 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbRAMDrivenFootprintStreamingManager.h"
+
+#include "otbPipelineProfiler.h"
 
 #include <boost/foreach.hpp>
 #include <boost/tokenizer.hpp>
@@ -171,6 +174,19 @@ ImageFileWriter<TInputImage>
   m_StreamingManager = streamingManager;
 }
 
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::SetAutomaticFootprintStreaming(unsigned int availableRAM, double bias, unsigned int inputCacheSize)
+{
+  typedef RAMDrivenFootprintStreamingManager<TInputImage> RAMDrivenFootprintStreamingManagerType;
+  typename RAMDrivenFootprintStreamingManagerType::Pointer streamingManager = RAMDrivenFootprintStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  streamingManager->SetInputCacheSizeInMB(inputCacheSize);
+  m_StreamingManager = streamingManager;
+}
+
 #ifndef ITK_LEGACY_REMOVE
 
 #endif // ITK_LEGACY_REMOVE
@@ -314,6 +330,18 @@ ImageFileWriter<TInputImage>
         }
       this->SetAutomaticAdaptativeStreaming(sizevalue);
       }
+    else if(type == "footprint")
+      {
+      if(sizemode != "auto")
+        {
+        itkWarningMacro(<<"In footprint streaming type, the sizemode option will be ignored.");
+        }
+      if(sizevalue == 0.)
+        {
+        itkWarningMacro("sizemode is auto but sizevalue is 0. Value will be fetched from the OTB_MAX_RAM_HINT environment variable if set, or else use the default value");
+        }
+      this->SetAutomaticFootprintStreaming(sizevalue);
+      }
     else if(type == "tiled")
       {
       if(sizemode == "auto")
@@ -623,16 +651,39 @@ ImageFileWriter<TInputImage>
     itkWarningMacro(<< "Could not get the source process object. Progress report might be buggy");
     }
 
+  // Record the streaming in the pipeline profiling report, if enabled
+  PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+  const bool profiling = profiler->IsEnabled();
+  if (profiling)
+    {
+    std::ostringstream region;
+    region << inputRegion.GetIndex() << " " << inputRegion.GetSize();
+    profiler->BeginStreaming(this, inputPtr, m_StreamingManager->GetNameOfClass(), m_NumberOfDivisions, region.str());
+    }
+  PipelineProfiler::StreamingGuard profilingGuard(profiling ? this : NULL);
+
   for (m_CurrentDivision = 0;
        m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
        m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
     {
     streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
 
+    if (profiling)
+      {
+      std::ostringstream region;
+      region << streamRegion.GetIndex() << " " << streamRegion.GetSize();
+      profiler->BeginDivision(this, m_CurrentDivision, region.str());
+      }
+
     inputPtr->SetRequestedRegion(streamRegion);
     inputPtr->PropagateRequestedRegion();
     inputPtr->UpdateOutputData();
 
+    if (profiling)
+      {
+      profiler->BeginDivisionWrite(this);
+      }
+
     // Write the whole image
     itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
     for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
@@ -647,8 +698,16 @@ ImageFileWriter<TInputImage>
 
     // Start writing stream region in the image file
     this->GenerateData();
+
+    if (profiling)
+      {
+      profiler->EndDivision(this, static_cast<unsigned long>(streamRegion.GetNumberOfPixels())
+                                  * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+      }
     }
 
+  profilingGuard.End();
+
   /**
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+
+// Read the bands 3,1 (&bands=3,1) and the band 2 (&bands=2) of a 3 bands
+// image, and compare them with the bands of the whole image
+int otbImageFileReaderBandList(int itkNotUsed(argc), char* argv[])
+{
+  const std::string inputFilename = argv[1];
+
+  typedef otb::VectorImage<float, 2>           VectorImageType;
+  typedef otb::Image<float, 2>                 ImageType;
+  typedef otb::ImageFileReader<VectorImageType> VectorReaderType;
+  typedef otb::ImageFileReader<ImageType>       ReaderType;
+
+  VectorReaderType::Pointer reference = VectorReaderType::New();
+  reference->SetFileName(inputFilename);
+  reference->Update();
+
+  VectorReaderType::Pointer vectorReader = VectorReaderType::New();
+  vectorReader->SetFileName(inputFilename + "?&bands=3,1");
+  vectorReader->Update();
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFilename + "?&bands=2");
+  reader->Update();
+
+  if (vectorReader->GetOutput()->GetNumberOfComponentsPerPixel() != 2)
+    {
+    std::cerr << "Wrong number of components: " << vectorReader->GetOutput()->GetNumberOfComponentsPerPixel()
+              << " instead of 2" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator<VectorImageType> refIt(reference->GetOutput(),
+                                                       reference->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<VectorImageType> vectorIt(vectorReader->GetOutput(),
+                                                          reference->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> it(reader->GetOutput(),
+                                              reference->GetOutput()->GetLargestPossibleRegion());
+
+  for (refIt.GoToBegin(), vectorIt.GoToBegin(), it.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++vectorIt, ++it)
+    {
+    if (vectorIt.Get()[0] != refIt.Get()[2] || vectorIt.Get()[1] != refIt.Get()[0]
+        || it.Get() != refIt.Get()[1])
+      {
+      std::cerr << "Pixel " << refIt.GetIndex() << ": read " << vectorIt.Get() << " and " << it.Get()
+                << " from " << refIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+// Read the bands 2 (&bands=2) and 3,1 (&bands=3,1) of a 3 bands complex
+// image into vectors of real and imaginary parts, and compare them with
+// the bands of the whole image
+int otbImageFileReaderBandListComplex(int itkNotUsed(argc), char* argv[])
+{
+  const std::string inputFilename = argv[1];
+
+  typedef otb::VectorImage<float, 2>            VectorImageType;
+  typedef otb::ImageFileReader<VectorImageType> ReaderType;
+
+  ReaderType::Pointer reference = ReaderType::New();
+  reference->SetFileName(inputFilename);
+  reference->Update();
+
+  ReaderType::Pointer band2Reader = ReaderType::New();
+  band2Reader->SetFileName(inputFilename + "?&bands=2");
+  band2Reader->Update();
+
+  ReaderType::Pointer bands31Reader = ReaderType::New();
+  bands31Reader->SetFileName(inputFilename + "?&bands=3,1");
+  bands31Reader->Update();
+
+  if (reference->GetOutput()->GetNumberOfComponentsPerPixel() != 6
+      || band2Reader->GetOutput()->GetNumberOfComponentsPerPixel() != 2
+      || bands31Reader->GetOutput()->GetNumberOfComponentsPerPixel() != 4)
+    {
+    std::cerr << "Wrong number of components: " << reference->GetOutput()->GetNumberOfComponentsPerPixel()
+              << ", " << band2Reader->GetOutput()->GetNumberOfComponentsPerPixel()
+              << " and " << bands31Reader->GetOutput()->GetNumberOfComponentsPerPixel()
+              << " instead of 6, 2 and 4" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const VectorImageType::RegionType region = reference->GetOutput()->GetLargestPossibleRegion();
+  itk::ImageRegionConstIterator<VectorImageType> refIt(reference->GetOutput(), region);
+  itk::ImageRegionConstIterator<VectorImageType> band2It(band2Reader->GetOutput(), region);
+  itk::ImageRegionConstIterator<VectorImageType> bands31It(bands31Reader->GetOutput(), region);
+
+  for (refIt.GoToBegin(), band2It.GoToBegin(), bands31It.GoToBegin(); !refIt.IsAtEnd();
+       ++refIt, ++band2It, ++bands31It)
+    {
+    const VectorImageType::PixelType ref = refIt.Get();
+    const VectorImageType::PixelType band2 = band2It.Get();
+    const VectorImageType::PixelType bands31 = bands31It.Get();
+    if (band2[0] != ref[2] || band2[1] != ref[3]
+        || bands31[0] != ref[4] || bands31[1] != ref[5] || bands31[2] != ref[0] || bands31[3] != ref[1])
+      {
+      std::cerr << "Pixel " << refIt.GetIndex() << ": read " << band2 << " and " << bands31
+                << " from " << ref << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
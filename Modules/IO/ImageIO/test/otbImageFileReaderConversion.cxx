@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+
+// Read a region of an image as TImage, the pixels being converted from
+// unsigned char components, and compare them with the unsigned char
+// reference
+template <class TImage>
+bool otbImageFileReaderConversionCheck(const char * filename,
+                                       const otb::VectorImage<unsigned char, 2> * reference,
+                                       const typename TImage::RegionType& region)
+{
+  typedef otb::ImageFileReader<TImage> ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(filename);
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+
+  typedef otb::VectorImage<unsigned char, 2> ReferenceImageType;
+  itk::ImageRegionConstIterator<ReferenceImageType> refIt(reference, region);
+  itk::ImageRegionConstIterator<TImage> it(reader->GetOutput(), region);
+
+  for (refIt.GoToBegin(), it.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++it)
+    {
+    typename TImage::PixelType pixel = it.Get();
+    for (unsigned int band = 0; band < refIt.Get().Size(); ++band)
+      {
+      if (static_cast<double>(pixel[band]) != static_cast<double>(refIt.Get()[band]))
+        {
+        std::cerr << "Pixel " << it.GetIndex() << ", band " << band << ": read "
+                  << static_cast<double>(pixel[band]) << " as " << TImage::New()->GetNameOfClass()
+                  << ", expected " << static_cast<double>(refIt.Get()[band]) << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+int otbImageFileReaderConversion(int itkNotUsed(argc), char* argv[])
+{
+  const char * inputFilename = argv[1];
+
+  typedef otb::VectorImage<unsigned char, 2> ReferenceImageType;
+  typedef otb::ImageFileReader<ReferenceImageType> ReferenceReaderType;
+
+  ReferenceReaderType::Pointer reference = ReferenceReaderType::New();
+  reference->SetFileName(inputFilename);
+  reference->Update();
+
+  ReferenceImageType::RegionType largest = reference->GetOutput()->GetLargestPossibleRegion();
+
+  // A region which does not start at the origin of the image
+  ReferenceImageType::RegionType region;
+  region.SetIndex(0, largest.GetSize()[0] / 3);
+  region.SetIndex(1, largest.GetSize()[1] / 4);
+  region.SetSize(0, largest.GetSize()[0] / 2);
+  region.SetSize(1, largest.GetSize()[1] / 2);
+
+  bool ok = true;
+  ok = ok && otbImageFileReaderConversionCheck< otb::VectorImage<unsigned short, 2> >(inputFilename, reference->GetOutput(), largest);
+  ok = ok && otbImageFileReaderConversionCheck< otb::VectorImage<float, 2> >(inputFilename, reference->GetOutput(), largest);
+  ok = ok && otbImageFileReaderConversionCheck< otb::VectorImage<float, 2> >(inputFilename, reference->GetOutput(), region);
+  ok = ok && otbImageFileReaderConversionCheck< otb::VectorImage<double, 2> >(inputFilename, reference->GetOutput(), region);
+  ok = ok && otbImageFileReaderConversionCheck< otb::VectorImage<int, 2> >(inputFilename, reference->GetOutput(), region);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
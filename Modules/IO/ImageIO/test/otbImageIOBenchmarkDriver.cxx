@@ -0,0 +1,6 @@
+#include "otbBenchmarkMain.h"
+void RegisterBenchmarks()
+{
+  REGISTER_BENCHMARK(otbImageFileReaderBenchmark);
+  REGISTER_BENCHMARK(otbImageFileWriterBenchmark);
+}
@@ -0,0 +1,75 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+
+typedef otb::VectorImage<unsigned short, 2>  BenchmarkImageType;
+typedef otb::ImageFileReader<BenchmarkImageType> BenchmarkReaderType;
+typedef otb::ImageFileWriter<BenchmarkImageType> BenchmarkWriterType;
+
+int otbImageFileWriterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " outputFileName" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  BenchmarkImageType::Pointer image = helper->GenerateImage<BenchmarkImageType>(0., 4095.);
+
+  BenchmarkWriterType::Pointer writer = BenchmarkWriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(argv[1]);
+
+  while (helper->KeepRunning())
+    {
+    writer->Modified();
+    writer->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbImageFileReaderBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " temporaryFileName" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Write the synthetic image, which is then read
+  BenchmarkWriterType::Pointer writer = BenchmarkWriterType::New();
+  writer->SetInput(helper->GenerateImage<BenchmarkImageType>(0., 4095.));
+  writer->SetFileName(argv[1]);
+  writer->Update();
+
+  BenchmarkReaderType::Pointer reader = BenchmarkReaderType::New();
+  reader->SetFileName(argv[1]);
+
+  while (helper->KeepRunning())
+    {
+    reader->Modified();
+    reader->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -48,6 +48,9 @@ void RegisterTests()
   REGISTER_TEST(otbPipelineMetadataHandlingTest);
   REGISTER_TEST(otbMultiResolutionReadingInfo);
   REGISTER_TEST(otbImageFileReaderTestFloat);
+  REGISTER_TEST(otbImageFileReaderConversion);
+  REGISTER_TEST(otbImageFileReaderBandList);
+  REGISTER_TEST(otbImageFileReaderBandListComplex);
   REGISTER_TEST(otbVectorImageComplexNew);
   REGISTER_TEST(otbVectorImageComplexFloatTest);
   REGISTER_TEST(otbVectorImageComplexDoubleTest);
@@ -19,6 +19,8 @@
 #define __otbKmzProductWriter_h
 
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "itkObjectFactory.h"
 
@@ -33,6 +35,7 @@
 #include "otbGenericRSTransform.h"
 #include "otbStreamingShrinkImageFilter.h"
 #include "itkCastImageFilter.h"
+#include "itkMultiThreader.h"
 
 // Possiblity to includes vectordatas necessary includes
 #include "otbVectorData.h"
@@ -53,6 +56,12 @@ namespace otb
  * SetTileSize(unsigned int), the user can also specify the name of
  * the output Kmz filename via SetPath().
  *
+ * Each level of the tile pyramid is shrunk from the previous (finer)
+ * one. Tiles are produced one strip at a time: the strip is rescaled
+ * to 8 bits, its tiles are encoded to jpeg concurrently (using the
+ * global default number of threads), and the encoded tiles and their
+ * kml are added to the kmz directly from memory.
+ *
  *
  *
  * \ingroup IO
@@ -100,6 +109,9 @@ public:
   // Writer
   typedef ImageFileWriter< VectorImage<OutputPixelType> >             VectorWriterType;
 
+  // 8 bits strip of tiles
+  typedef VectorImage<OutputPixelType>                                TileImageType;
+
   // Resampler
   typedef StreamingShrinkImageFilter<InputImageType, InputImageType > StreamingShrinkImageFilterType;
 
@@ -201,10 +213,10 @@ private:
   /** KML root generate */
   void GenerateKMLRoot(const std::string& title, double north, double south, double east, double west, bool extended);
 
-  /** KML generate  Filename - PathName - tile number - North - South - East - West */
-  void GenerateKML(const std::string& pathname, int depth, int x, int y, double north, double south, double east, double west);
+  /** KML generate  Stream - tile number - North - South - East - West */
+  void GenerateKML(std::ostream& fileTest, int depth, int x, int y, double north, double south, double east, double west);
 
-  void GenerateKMLExtended(const std::string& pathname,
+  void GenerateKMLExtended(std::ostream& fileTest,
                            int depth,
                            int x,
                            int y,
@@ -214,18 +226,19 @@ private:
                            OutputPointType upperLeft);
 
   /** KML with link generate */
-  void GenerateKMLWithLink(const std::string& pathname,
+  void GenerateKMLWithLink(std::ostream& fileTest,
                            int depth, int x, int y, int tileStartX, int tileStartY,
                            double north, double south, double east, double west,
                            double centerLong, double centerLat);
-  void GenerateKMLExtendedWithLink(const std::string& pathname,
+  void GenerateKMLExtendedWithLink(std::ostream& fileTest,
                                    int depth, int x, int y, int tileStartX, int tileStartY,
                                    OutputPointType lowerLeft, OutputPointType lowerRight,
                                    OutputPointType upperRight, OutputPointType upperLeft,
                                    double centerLong, double centerLat);
 
   /** Method to create the bounding kml of the "iteration" th product */
-  void GenerateBoundingKML(double north, double south,
+  void GenerateBoundingKML(std::ostream& fileTest,
+                           double north, double south,
                            double east,  double west);
 
 
@@ -247,6 +260,26 @@ private:
    */
   virtual int AddFileToKMZ(const std::ostringstream&  absolutePath, const std::ostringstream&   kmz_in_path);
 
+  /** Add in-memory data to KMZ */
+  void AddDataToKMZ(const std::string& data, const std::string& kmz_in_path);
+
+  /** Strip of tiles shared with the encoding threads */
+  struct TileEncodingStruct
+  {
+    const TileImageType *    Strip;
+    unsigned int             TileSize;
+    std::vector<std::string> Tiles;
+    std::vector<std::string> Errors;
+    const Self *             Writer;
+  };
+
+  /** Encode the tiles of a strip to jpeg, in parallel */
+  static ITK_THREAD_RETURN_TYPE TileEncodingThreaderCallback(void *arg);
+
+  /** Encode a tile of a band-interleaved 8 bits buffer to jpeg, in memory */
+  static std::string EncodeTile(const OutputPixelType * buffer, unsigned int nbBands, unsigned int lineLength,
+                                unsigned int sizeX, unsigned int sizeY, const std::string& vsiFileName);
+
   /**Cut the image file name to built the directory name*/
   std::string GetCuttenFileName(const std::string& description, unsigned int idx);
 
@@ -295,8 +328,8 @@ private:
   // KMZ file name
   std::ostringstream     m_KmzFileName;
 
-  // the kml root ofstream
-  std::ofstream          m_RootKmlFile;
+  // the kml root, built in memory
+  std::ostringstream     m_RootKmlFile;
   std::ofstream          m_TempRootKmlFile;
 
     // File and path name
@@ -24,6 +24,8 @@
 #include "itksys/SystemTools.hxx"
 
 #include "otbMetaDataKey.h"
+#include "otbGDALDriverManagerWrapper.h"
+#include "cpl_vsi.h"
 #include "otbVectorDataKeywordlist.h"
 
 namespace otb
@@ -290,14 +292,29 @@ KmzProductWriter<TInputImage>
   m_MaxDepth = maxDepth;
   m_CurIdx = 0;
 
-  // Compute nbTile
-  int nbTile = 0;
+  if (!itksys::SystemTools::MakeDirectory(m_Path.c_str()))
+    {
+    itkExceptionMacro(<< "Error while creating cache directory" << m_Path);
+    }
 
-  for (unsigned int i = 0; i <= maxDepth; ++i)
+  // Build the pyramid: only the first level is shrunk from the full
+  // resolution image, each coarser level is shrunk by a factor 2 from
+  // the previous one (the samples are the same as the ones of a
+  // direct shrink by 2^(maxDepth - depth))
+  std::vector<InputImagePointer> levels(maxDepth + 1);
+  levels[maxDepth] = m_VectorImage;
+
+  for (int depth = static_cast<int>(maxDepth) - 1; depth >= 0; --depth)
     {
-    unsigned int ratio = static_cast<unsigned int>(vcl_pow(2.,static_cast<int>((static_cast<int>(maxDepth) - i))));
-    nbTile += (((sizeX / ratio) / m_TileSize) + 1)  * (((sizeY / ratio) / m_TileSize) + 1);
+    m_StreamingShrinkImageFilter = StreamingShrinkImageFilterType::New();
+    m_StreamingShrinkImageFilter->SetShrinkFactor(2);
+    m_StreamingShrinkImageFilter->SetInput(levels[depth + 1]);
+    m_StreamingShrinkImageFilter->GetStreamer()->SetAutomaticStrippedStreaming(0);
+    m_StreamingShrinkImageFilter->Update();
+
+    levels[depth] = m_StreamingShrinkImageFilter->GetOutput();
     }
+  m_StreamingShrinkImageFilter = NULL;
 
   // Extract size & index
   SizeType  extractSize;
@@ -311,59 +328,29 @@ KmzProductWriter<TInputImage>
     // Resample image to the max Depth
     int sampleRatioValue = (1 << (maxDepth - depth));
 
-    if (sampleRatioValue > 1)
-      {
-      m_StreamingShrinkImageFilter = StreamingShrinkImageFilterType::New();
-
-      m_StreamingShrinkImageFilter->SetShrinkFactor(sampleRatioValue);
-      m_StreamingShrinkImageFilter->SetInput(m_VectorImage);
-      m_StreamingShrinkImageFilter->GetStreamer()->SetAutomaticStrippedStreaming(0);
-      m_StreamingShrinkImageFilter->Update();
-
-      m_VectorRescaleIntensityImageFilter = VectorRescaleIntensityImageFilterType::New();
-      m_VectorRescaleIntensityImageFilter->SetInput(m_StreamingShrinkImageFilter->GetOutput());
-      m_VectorRescaleIntensityImageFilter->SetOutputMinimum(outMin);
-      m_VectorRescaleIntensityImageFilter->SetOutputMaximum(outMax);
-
-      if (depth == 0)
-        {
-        m_VectorRescaleIntensityImageFilter->Update();
-        inMin = m_VectorRescaleIntensityImageFilter->GetInputMinimum();
-        inMax = m_VectorRescaleIntensityImageFilter->GetInputMaximum();
-        }
-      else
-        {
-        m_VectorRescaleIntensityImageFilter->SetInputMinimum(inMin);
-        m_VectorRescaleIntensityImageFilter->SetInputMaximum(inMax);
-        m_VectorRescaleIntensityImageFilter->SetAutomaticInputMinMaxComputation(false);
-        }
+    m_VectorRescaleIntensityImageFilter = VectorRescaleIntensityImageFilterType::New();
+    m_VectorRescaleIntensityImageFilter->SetInput(levels[depth]);
+    m_VectorRescaleIntensityImageFilter->SetOutputMinimum(outMin);
+    m_VectorRescaleIntensityImageFilter->SetOutputMaximum(outMax);
 
-      // New resample vector image
-      m_ResampleVectorImage = m_VectorRescaleIntensityImageFilter->GetOutput();
+    if (depth == 0)
+      {
+      // The intensity range is estimated on the coarsest level, which
+      // fits in a single tile
+      m_VectorRescaleIntensityImageFilter->SetAutomaticInputMinMaxComputation(true);
+      m_VectorRescaleIntensityImageFilter->Update();
+      inMin = m_VectorRescaleIntensityImageFilter->GetInputMinimum();
+      inMax = m_VectorRescaleIntensityImageFilter->GetInputMaximum();
       }
     else
       {
-      m_VectorRescaleIntensityImageFilter = VectorRescaleIntensityImageFilterType::New();
-      m_VectorRescaleIntensityImageFilter->SetInput(m_VectorImage);
-      m_VectorRescaleIntensityImageFilter->SetOutputMinimum(outMin);
-      m_VectorRescaleIntensityImageFilter->SetOutputMaximum(outMax);
-
-      // Case of input image with size lower than the tileSize
-      // this case is illustrated with depth==0 and
-      // sampleRatioValue==1
-      if(depth==0 && sampleRatioValue == 1)
-        {
-        m_VectorRescaleIntensityImageFilter->SetAutomaticInputMinMaxComputation(true);
-        }
-      else
-        {
-        m_VectorRescaleIntensityImageFilter->SetInputMinimum(inMin);
-        m_VectorRescaleIntensityImageFilter->SetInputMaximum(inMax);
-        m_VectorRescaleIntensityImageFilter->SetAutomaticInputMinMaxComputation(false);
-        }
-      m_ResampleVectorImage = m_VectorRescaleIntensityImageFilter->GetOutput();
+      m_VectorRescaleIntensityImageFilter->SetInputMinimum(inMin);
+      m_VectorRescaleIntensityImageFilter->SetInputMaximum(inMax);
+      m_VectorRescaleIntensityImageFilter->SetAutomaticInputMinMaxComputation(false);
       }
 
+    // New resample vector image
+    m_ResampleVectorImage = m_VectorRescaleIntensityImageFilter->GetOutput();
     m_ResampleVectorImage->UpdateOutputInformation();
 
     // Get the image size
@@ -372,82 +359,67 @@ KmzProductWriter<TInputImage>
     sizeX = size[0];
     sizeY = size[1];
 
-    // Tiling resample image
-    for (unsigned int tx = 0, x = 0; tx < sizeX; tx += m_TileSize, ++x)
+    // Lat/Lon transform of this level
+    m_Transform = TransformType::New();
+    m_Transform->SetInputKeywordList(m_ResampleVectorImage->GetImageKeywordlist());
+    m_Transform->SetInputProjectionRef(m_VectorImage->GetProjectionRef());
+    m_Transform->SetOutputProjectionRef(wgsRef);
+    m_Transform->InstanciateTransform();
+
+    // Tiling resample image, one strip of tiles at a time
+    for (unsigned int ty = 0, y = 0; ty < sizeY; ty += m_TileSize, ++y)
       {
-      for (unsigned int ty = 0, y = 0; ty < sizeY; ty += m_TileSize, ++y)
+      extractIndex[1] = ty;
+      extractSize[1] = std::min(m_TileSize, sizeY - ty);
+
+      // Extract the strip, rescaled and cast to 8 bits
+      m_VectorImageExtractROIFilter = VectorImageExtractROIFilterType::New();
+      m_VectorImageExtractROIFilter->SetStartX(0);
+      m_VectorImageExtractROIFilter->SetStartY(extractIndex[1]);
+      m_VectorImageExtractROIFilter->SetSizeX(sizeX);
+      m_VectorImageExtractROIFilter->SetSizeY(extractSize[1]);
+
+      // Set Channel to extract
+      if(m_VectorImage->GetNumberOfComponentsPerPixel()>3)
         {
-        if ((tx + m_TileSize) >= sizeX)
-          {
-          extractIndex[0] = tx;
-          extractSize[0] = sizeX - tx;
-          }
-        else
-          {
-          extractIndex[0] = tx;
-          extractSize[0] = m_TileSize;
-          }
+        m_VectorImageExtractROIFilter->SetChannel(1); //m_ProductVector[m_CurrentProduct].m_Composition[0] + 1);
+        m_VectorImageExtractROIFilter->SetChannel(2); //m_ProductVector[m_CurrentProduct].m_Composition[1] + 1);
+        m_VectorImageExtractROIFilter->SetChannel(3); //m_ProductVector[m_CurrentProduct].m_Composition[2] + 1);
+        }
 
-        if ((ty + m_TileSize) >= sizeY)
-          {
-          extractIndex[1] = ty;
-          extractSize[1] = sizeY - ty;
-          }
-        else
-          {
-          extractIndex[1] = ty;
-          extractSize[1] = m_TileSize;
-          }
+      m_VectorImageExtractROIFilter->SetInput(m_ResampleVectorImage);
+      m_VectorImageExtractROIFilter->Update();
 
-        // Generate pathname
-        if (!itksys::SystemTools::MakeDirectory(m_Path.c_str()))
-          {
-          itkExceptionMacro(<< "Error while creating cache directory" << m_Path);
-          }
-        std::ostringstream path;
-        path << m_Path;
-
-        // Generate Tile filename
-        std::ostringstream ossFileName;
-        ossFileName << m_Path;
-        ossFileName << "/";
-        ossFileName << y;
-        ossFileName << ".jpg";
-
-        // Extract ROI
-        m_VectorImageExtractROIFilter = VectorImageExtractROIFilterType::New();
-
-        // Set extract roi parameters
-        m_VectorImageExtractROIFilter->SetStartX(extractIndex[0]);
-        m_VectorImageExtractROIFilter->SetStartY(extractIndex[1]);
-        m_VectorImageExtractROIFilter->SetSizeX(extractSize[0]);
-        m_VectorImageExtractROIFilter->SetSizeY(extractSize[1]);
-
-        // Set Channel to extract
-        if(m_VectorImage->GetNumberOfComponentsPerPixel()>3)
+      // Encode the tiles of the strip concurrently
+      TileEncodingStruct str;
+      str.Strip = m_VectorImageExtractROIFilter->GetOutput();
+      str.TileSize = m_TileSize;
+      str.Tiles.resize((sizeX + m_TileSize - 1) / m_TileSize);
+      str.Errors.resize(str.Tiles.size());
+      str.Writer = this;
+
+      unsigned int nbThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+      if (nbThreads > str.Tiles.size())
+        {
+        nbThreads = str.Tiles.size();
+        }
+      this->GetMultiThreader()->SetNumberOfThreads(nbThreads);
+      this->GetMultiThreader()->SetSingleMethod(this->TileEncodingThreaderCallback, &str);
+      this->GetMultiThreader()->SingleMethodExecute();
+
+      // Generate the kml of each tile, and stream the tiles to the kmz
+      for (unsigned int tx = 0, x = 0; tx < sizeX; tx += m_TileSize, ++x)
+        {
+        if (!str.Errors[x].empty())
           {
-          m_VectorImageExtractROIFilter->SetChannel(1); //m_ProductVector[m_CurrentProduct].m_Composition[0] + 1);
-          m_VectorImageExtractROIFilter->SetChannel(2); //m_ProductVector[m_CurrentProduct].m_Composition[1] + 1);
-          m_VectorImageExtractROIFilter->SetChannel(3); //m_ProductVector[m_CurrentProduct].m_Composition[2] + 1);
+          itkExceptionMacro(<< "Error while encoding tile " << x << "/" << y << " of level " << depth
+                            << ": " << str.Errors[x]);
           }
 
-        // Set extract roi input
-        m_VectorImageExtractROIFilter->SetInput(m_ResampleVectorImage);
-
-        // Configure writer
-        m_VectorWriter = VectorWriterType::New();
-        m_VectorWriter->SetFileName(ossFileName.str().c_str());
-        m_VectorWriter->SetInput(m_VectorImageExtractROIFilter->GetOutput());
-        m_VectorWriter->Update();
+        extractIndex[0] = tx;
+        extractSize[0] = std::min(m_TileSize, sizeX - tx);
 
-        /** TODO : Generate KML for this tile */
         // Search Lat/Lon box
-        m_Transform = TransformType::New();
-        m_Transform->SetInputKeywordList(m_ResampleVectorImage->GetImageKeywordlist());
-        m_Transform->SetInputProjectionRef(m_VectorImage->GetProjectionRef());
-        m_Transform->SetOutputProjectionRef(wgsRef);
-        m_Transform->InstanciateTransform();
-
         InputPointType  inputPoint;
         OutputPointType outputPoint;
         double          sizeTile[2];
@@ -523,16 +495,17 @@ KmzProductWriter<TInputImage>
         OutputPointType upperRightCorner = outputPoint;
         /** END GX LAT LON */
 
-        // Create KML - Filename - PathName - tile number - North - South - East - West
+        // Create KML - tile number - North - South - East - West
+        std::ostringstream kml;
         if (sampleRatioValue == 1)
           {
           if (!m_UseExtendMode) // Extended format
             {
-            this->GenerateKML(path.str(), depth, x, y, north, south, east, west);
+            this->GenerateKML(kml, depth, x, y, north, south, east, west);
             }
           else
             {
-            this->GenerateKMLExtended(path.str(), depth,
+            this->GenerateKMLExtended(kml, depth,
                                       x, y, lowerLeftCorner,
                                       lowerRightCorner,
                                       upperRightCorner, upperLeftCorner);
@@ -547,13 +520,13 @@ KmzProductWriter<TInputImage>
           // Create KML with link
           if (!m_UseExtendMode)
             {
-            this->GenerateKMLWithLink(path.str(), depth, x, y, tileXStart, tileYStart,
+            this->GenerateKMLWithLink(kml, depth, x, y, tileXStart, tileYStart,
                                       north, south, east, west, centerLong, centerLat);
             }
           else
             {
             this->GenerateKMLExtendedWithLink(
-              path.str(), depth, x, y, tileXStart, tileYStart,
+              kml, depth, x, y, tileXStart, tileYStart,
               lowerLeftCorner, lowerRightCorner, upperRightCorner, upperLeftCorner,
               centerLong, centerLat);
             }
@@ -577,26 +550,112 @@ KmzProductWriter<TInputImage>
         jpg_in_kmz << m_CurrentImageName << "/" << depth << "/" << x << "/" << y << ".jpg";
         kml_in_kmz << m_CurrentImageName << "/" << depth << "/" << x << "/" << y << m_KmlExtension;
 
-        // Absolute path where are stored the files
-        std::ostringstream jpg_absolute_path, kml_absolute_path;
-        jpg_absolute_path << m_Path << "/" << y << ".jpg";
-        kml_absolute_path << m_Path << "/" << y << m_KmlExtension;
-
-        //Add the files to the kmz
-        this->AddFileToKMZ(jpg_absolute_path, jpg_in_kmz);
-        this->AddFileToKMZ(kml_absolute_path, kml_in_kmz);
+        this->AddDataToKMZ(str.Tiles[x], jpg_in_kmz.str());
+        this->AddDataToKMZ(kml.str(), kml_in_kmz.str());
 
-        // Remove the unecessary files with stdio method :remove
-        if (remove(kml_absolute_path.str().c_str())  ||  remove(jpg_absolute_path.str().c_str()))
-          {
-          itkExceptionMacro(
-            << "Error while deleting the file" << kml_absolute_path.str() << "or file " << jpg_absolute_path.str());
-          }
+        // Release the encoded tile
+        std::string().swap(str.Tiles[x]);
         }
       }
+
+    // This level is not needed anymore
+    levels[depth] = NULL;
+    }
+
+  CPLFree(wgsRef);
+}
+
+/**
+ * Encode the tiles of a strip, tiles are interleaved between threads
+ */
+template <class TInputImage>
+ITK_THREAD_RETURN_TYPE
+KmzProductWriter<TInputImage>
+::TileEncodingThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  TileEncodingStruct *    str = static_cast<TileEncodingStruct *>(info->UserData);
+
+  const TileImageType * strip = str->Strip;
+  const unsigned int    nbBands = strip->GetNumberOfComponentsPerPixel();
+  const unsigned int    stripSizeX = strip->GetBufferedRegion().GetSize()[0];
+  const unsigned int    stripSizeY = strip->GetBufferedRegion().GetSize()[1];
+
+  // Each thread encodes in its own in-memory file
+  std::ostringstream vsiFileName;
+  vsiFileName << "/vsimem/otbKmzProductWriter_" << str->Writer << "_" << threadId << ".jpg";
+
+  for (unsigned int i = threadId; i < str->Tiles.size(); i += threadCount)
+    {
+    const unsigned int tx = i * str->TileSize;
+    try
+      {
+      str->Tiles[i] = EncodeTile(strip->GetBufferPointer() + tx * nbBands, nbBands, stripSizeX,
+                                 std::min(str->TileSize, stripSizeX - tx), stripSizeY,
+                                 vsiFileName.str());
+      }
+    catch (itk::ExceptionObject& err)
+      {
+      str->Errors[i] = err.GetDescription();
+      }
     }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
+/**
+ * Encode a tile of a band-interleaved 8 bits buffer to jpeg, in memory
+ */
+template <class TInputImage>
+std::string
+KmzProductWriter<TInputImage>
+::EncodeTile(const OutputPixelType * buffer, unsigned int nbBands, unsigned int lineLength,
+             unsigned int sizeX, unsigned int sizeY, const std::string& vsiFileName)
+{
+  GDALDriver * memDriver = GDALDriverManagerWrapper::GetInstance().GetDriverByName("MEM");
+  GDALDriver * jpegDriver = GDALDriverManagerWrapper::GetInstance().GetDriverByName("JPEG");
+
+  if (memDriver == NULL || jpegDriver == NULL)
+    {
+    itkGenericExceptionMacro(<< "GDAL MEM and JPEG drivers are needed to encode the tiles");
+    }
+
+  GDALDataset * memDataset = memDriver->Create("", sizeX, sizeY, nbBands, GDT_Byte, NULL);
+  if (memDataset == NULL)
+    {
+    itkGenericExceptionMacro(<< "Unable to allocate a " << sizeX << "x" << sizeY << " tile");
+    }
+
+  CPLErr err = memDataset->RasterIO(GF_Write, 0, 0, sizeX, sizeY,
+                                    const_cast<OutputPixelType *>(buffer), sizeX, sizeY, GDT_Byte,
+                                    nbBands, NULL,
+                                    nbBands, nbBands * lineLength, 1);
+
+  GDALDataset * jpegDataset = NULL;
+  if (err == CE_None)
+    {
+    jpegDataset = jpegDriver->CreateCopy(vsiFileName.c_str(), memDataset, FALSE, NULL, NULL, NULL);
+    }
+  GDALClose(memDataset);
+
+  if (jpegDataset == NULL)
+    {
+    VSIUnlink(vsiFileName.c_str());
+    itkGenericExceptionMacro(<< "Jpeg encoding failed: " << CPLGetLastErrorMsg());
+    }
+  GDALClose(jpegDataset);
+
+  // Take the ownership of the encoded buffer, the in-memory file is removed
+  vsi_l_offset length = 0;
+  GByte *      data = VSIGetMemFileBuffer(vsiFileName.c_str(), &length, TRUE);
+  std::string  tile(reinterpret_cast<char *>(data), static_cast<size_t>(length));
+  CPLFree(data);
+
+  return tile;
+}
 
 /**
 *
@@ -622,6 +681,20 @@ KmzProductWriter<TInputImage>
   return errs;
 }
 
+/**
+*
+*/
+template <class TInputImage>
+void
+KmzProductWriter<TInputImage>
+::AddDataToKMZ(const std::string& data, const std::string& kmz_in_path)
+{
+  if (!m_KmzFile->AddFile(data, kmz_in_path))
+    {
+    itkExceptionMacro(<< "Error while adding " << kmz_in_path << " to " << m_KmzFileName.str());
+    }
+}
+
 
 /**
  * Actually the root kml is not fully generated :
@@ -639,13 +712,9 @@ KmzProductWriter<TInputImage>
       double west,
       bool itkNotUsed(extended))
 {
-  // Give a name to the root file
-  std::ostringstream kmlname;
-  kmlname << m_Path;
-  kmlname << "/";
-  kmlname << m_FileName;
-  kmlname << m_KmlExtension;
-  m_RootKmlFile.open(kmlname.str().c_str());
+  // The root kml is built in memory, and added to the kmz when closed
+  m_RootKmlFile.str("");
+  m_RootKmlFile.clear();
   m_RootKmlFile << std::fixed << std::setprecision(6);
 
   m_RootKmlFile << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -685,17 +754,7 @@ KmzProductWriter<TInputImage>
   std::ostringstream root_in_kmz;
   root_in_kmz << m_FileName << m_KmlExtension;
 
-  std::ostringstream root_absolute_path;
-  root_absolute_path << m_Path << "/" << root_in_kmz.str();
-
-  // Add the root file in the kmz
-  this->AddFileToKMZ(root_absolute_path, root_in_kmz);
-
-  // Remove the root files with stdio method :remove
-  if (remove(root_absolute_path.str().c_str()) != 0)
-    {
-    itkExceptionMacro(<< "Error while deleting the file" << root_absolute_path.str());
-    }
+  this->AddDataToKMZ(m_RootKmlFile.str(), root_in_kmz.str());
 }
 
 /**
@@ -731,7 +790,6 @@ KmzProductWriter<TInputImage>
 
   m_RootKmlFile << "\t</Document>" << std::endl;
   m_RootKmlFile << "</kml>" << std::endl;
-  m_RootKmlFile.close();
 }
 
 
@@ -833,22 +891,14 @@ KmzProductWriter<TInputImage>
 ::BoundingBoxKmlProcess(double north, double south, double east, double west)
 {
   // Create the bounding kml
-  this->GenerateBoundingKML(north, south,  east, west);
+  std::ostringstream boundKml;
+  this->GenerateBoundingKML(boundKml, north, south,  east, west);
 
-  // Add the root kml in the kmz
+  // Add the bounding kml in the kmz
   std::ostringstream bound_in_kmz;
   bound_in_kmz << "bounds/bound_0"<< m_KmlExtension;
-  std::ostringstream bound_absolute_path;
-  bound_absolute_path << m_Path << "/bound_0"<< m_KmlExtension;
-
-  // Add the root file in the kmz
-  this->AddFileToKMZ(bound_absolute_path, bound_in_kmz);
 
-  // Remove the bounding files with stdio method :remove
-  if (remove(bound_absolute_path.str().c_str()) != 0)
-    {
-    itkExceptionMacro(<< "Error while deleting the file" << bound_absolute_path.str());
-    }
+  this->AddDataToKMZ(boundKml.str(), bound_in_kmz.str());
 }
 
 /**
@@ -886,16 +936,10 @@ KmzProductWriter<TInputImage>
 template <class TInputImage>
 void
 KmzProductWriter<TInputImage>
-::GenerateKMLExtended(const std::string& pathname, int depth, int itkNotUsed(x), int y,
+::GenerateKMLExtended(std::ostream& fileTest, int depth, int itkNotUsed(x), int y,
           OutputPointType lowerLeft, OutputPointType lowerRight,
           OutputPointType upperRight, OutputPointType upperLeft)
 {
-  std::ostringstream kmlname;
-  kmlname << pathname;
-  kmlname << "/";
-  kmlname << y << "xt.kml";
-  std::ofstream fileTest(kmlname.str().c_str());
-
   fileTest << std::fixed << std::setprecision(6);
 
   fileTest << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -933,24 +977,16 @@ KmzProductWriter<TInputImage>
   fileTest << "\t\t</GroundOverlay>" << std::endl;
   fileTest << "\t</Document>" << std::endl;
   fileTest << "</kml>" << std::endl;
-
-  fileTest.close();
 }
 
 
 template <class TInputImage>
 void
 KmzProductWriter<TInputImage>
-::GenerateKML(const std::string& pathname, int depth,
+::GenerateKML(std::ostream& fileTest, int depth,
               int itkNotUsed(x), int y, double north, double south,
               double east, double west)
 {
-  std::ostringstream kmlname;
-  kmlname << pathname;
-  kmlname << "/";
-  kmlname << y << ".kml";
-  std::ofstream fileTest(kmlname.str().c_str());
-
   fileTest << std::fixed << std::setprecision(6);
 
   fileTest << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -985,25 +1021,17 @@ KmzProductWriter<TInputImage>
   fileTest << "\t\t</GroundOverlay>" << std::endl;
   fileTest << "\t</Document>" << std::endl;
   fileTest << "</kml>" << std::endl;
-
-  fileTest.close();
 }
 
 template <class TInputImage>
 void
 KmzProductWriter<TInputImage>
-::GenerateKMLExtendedWithLink(const std::string& pathname,
+::GenerateKMLExtendedWithLink(std::ostream& fileTest,
                               int depth, int itkNotUsed(x), int y, int tileStartX, int tileStartY,
                               OutputPointType lowerLeft, OutputPointType lowerRight,
                               OutputPointType upperRight, OutputPointType upperLeft,
                               double centerLong, double centerLat)
 {
-  std::ostringstream kmlname;
-  kmlname << pathname;
-  kmlname << "/";
-  kmlname << y << "xt.kml";
-  std::ofstream fileTest(kmlname.str().c_str());
-
   fileTest << std::fixed << std::setprecision(6);
 
   fileTest << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -1170,23 +1198,16 @@ KmzProductWriter<TInputImage>
 
   fileTest << "\t</Document>" << std::endl;
   fileTest << "</kml>" << std::endl;
-  fileTest.close();
 
 }
 
 template <class TInputImage>
 void
 KmzProductWriter<TInputImage>
-::GenerateKMLWithLink(const std::string& pathname,
+::GenerateKMLWithLink(std::ostream& fileTest,
                       int depth, int itkNotUsed(x), int y, int tileStartX, int tileStartY,
                       double north, double south, double east, double west, double centerLong, double centerLat)
 {
-  std::ostringstream kmlname;
-  kmlname << pathname;
-  kmlname << "/";
-  kmlname << y << ".kml";
-  std::ofstream fileTest(kmlname.str().c_str());
-
   fileTest << std::fixed << std::setprecision(6);
 
   fileTest << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -1349,7 +1370,6 @@ KmzProductWriter<TInputImage>
 
   fileTest << "\t</Document>" << std::endl;
   fileTest << "</kml>" << std::endl;
-  fileTest.close();
 
 }
 
@@ -1357,14 +1377,8 @@ KmzProductWriter<TInputImage>
 template <class TInputImage>
 void
 KmzProductWriter<TInputImage>
-::GenerateBoundingKML(double north, double south, double east, double west)
+::GenerateBoundingKML(std::ostream& fileTest, double north, double south, double east, double west)
 {
-  std::ostringstream kmlname;
-  kmlname << m_Path;
-  kmlname << "/";
-  kmlname << "bound_0" << m_KmlExtension;
-  std::ofstream fileTest(kmlname.str().c_str());
-
   fileTest << std::fixed << std::setprecision(6);
 
   fileTest << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
@@ -1395,8 +1409,6 @@ KmzProductWriter<TInputImage>
 
   fileTest << "\t</Document>" << std::endl;
   fileTest << "</kml>" << std::endl;
-
-  fileTest.close();
 }
 
 
@@ -3,6 +3,8 @@ by Google Earth).")
 
 otb_module(OTBKMZWriter
   DEPENDS
+    OTBGDAL
+    OTBIOGDAL
     OTBITK
     OTBImageBase
     OTBImageIO
@@ -0,0 +1,208 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbBenchmarkHelper_h
+#define __otbBenchmarkHelper_h
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace otb
+{
+/**
+ * \class BenchmarkHelper
+ * \brief Helper class to time the kernels of the benchmark drivers
+ *
+ * A benchmark kernel (see otbBenchmarkMain.h) builds its pipeline on the
+ * synthetic images given by GenerateImage(), then repeats the processing
+ * to time in a loop driven by KeepRunning():
+ *
+ * \code
+ * while (helper->KeepRunning())
+ *   {
+ *   filter->Modified();
+ *   filter->Update();
+ *   }
+ * \endcode
+ *
+ * The first NumberOfWarmUps iterations are not recorded. The duration
+ * (wall time) of the NumberOfRepetitions following ones are, without the
+ * time spent between PauseTiming() and ResumeTiming(). WriteResults()
+ * writes the samples, their median, percentiles and the throughput in
+ * Mpixels/s, computed from PixelsPerRepetition (the size of the synthetic
+ * images by default), as a JSON document.
+ *
+ * \ingroup OTBTestKernel
+ */
+class ITK_ABI_EXPORT BenchmarkHelper : public itk::Object
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef BenchmarkHelper               Self;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+  typedef itk::Object                   Superclass;
+
+  itkTypeMacro(BenchmarkHelper, itk::Object);
+  itkNewMacro(Self);
+
+  typedef std::vector<double> SampleList;
+
+  /** Name of the benchmark, reported in the results */
+  itkSetStringMacro(BenchmarkName);
+  itkGetStringMacro(BenchmarkName);
+
+  /** Size of the synthetic images */
+  itkSetMacro(SizeX, unsigned int);
+  itkGetMacro(SizeX, unsigned int);
+  itkSetMacro(SizeY, unsigned int);
+  itkGetMacro(SizeY, unsigned int);
+
+  /** Number of bands of the synthetic VectorImage */
+  itkSetMacro(NumberOfBands, unsigned int);
+  itkGetMacro(NumberOfBands, unsigned int);
+
+  /** Number of threads of the filters (reported in the results, the
+   *  driver sets the global default number of threads) */
+  itkSetMacro(NumberOfThreads, unsigned int);
+  itkGetMacro(NumberOfThreads, unsigned int);
+
+  /** Number of iterations executed before the timing starts */
+  itkSetMacro(NumberOfWarmUps, unsigned int);
+  itkGetMacro(NumberOfWarmUps, unsigned int);
+
+  /** Number of timed iterations */
+  itkSetMacro(NumberOfRepetitions, unsigned int);
+  itkGetMacro(NumberOfRepetitions, unsigned int);
+
+  /** Number of pixels processed by one iteration. If 0 (the default),
+   *  SizeX * SizeY is used. */
+  itkSetMacro(PixelsPerRepetition, unsigned long);
+  unsigned long GetPixelsPerRepetition() const;
+
+  /** Start the next iteration, recording the duration of the previous
+   *  one. Returns false when all the iterations are done. A new loop
+   *  starts with a Reset(). */
+  bool KeepRunning();
+
+  /** Clear the samples and restart from the first warm-up iteration */
+  void Reset();
+
+  /** Exclude a part of an iteration from the timing */
+  void PauseTiming();
+  void ResumeTiming();
+
+  /** Durations of the timed iterations, in seconds */
+  const SampleList& GetSamples() const
+  {
+    return m_Samples;
+  }
+
+  /** Percentile p (in [0, 100]) of the samples, linearly interpolated */
+  double GetPercentile(double p) const;
+
+  /** Median of the samples, in seconds */
+  double GetMedian() const
+  {
+    return this->GetPercentile(50.);
+  }
+
+  /** Mpixels processed per second, at the median duration */
+  double GetMegaPixelsPerSecond() const;
+
+  /** Write a summary of the results on a stream */
+  void PrintResults(std::ostream& os) const;
+
+  /** Write the results as a JSON document. Throws an exception if the
+   *  file can not be written. */
+  void WriteResults(const std::string& filename) const;
+
+  /** Generate a synthetic image of SizeX by SizeY pixels (and
+   *  NumberOfBands bands if TImage is a VectorImage), filled with a
+   *  smooth pattern and a deterministic noise, with values in [min, max].
+   *  TImage must have scalar internal pixels (Image of scalars or
+   *  VectorImage). */
+  template <class TImage>
+  typename TImage::Pointer GenerateImage(double min = 0., double max = 255.) const
+  {
+    typedef typename TImage::InternalPixelType ValueType;
+
+    typename TImage::RegionType region;
+    region.SetSize(0, m_SizeX);
+    region.SetSize(1, m_SizeY);
+
+    typename TImage::Pointer image = TImage::New();
+    image->SetRegions(region);
+    image->SetNumberOfComponentsPerPixel(m_NumberOfBands);
+    image->Allocate();
+
+    const unsigned int nbComponents = image->GetNumberOfComponentsPerPixel();
+    ValueType *        buffer = image->GetBufferPointer();
+    unsigned long      seed = 1;
+    for (unsigned int y = 0; y < m_SizeY; ++y)
+      {
+      for (unsigned int x = 0; x < m_SizeX; ++x)
+        {
+        for (unsigned int b = 0; b < nbComponents; ++b)
+          {
+          // Linear congruential generator, so that the images are the
+          // same on every platform
+          seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+          const double noise = static_cast<double>(seed) / 0x7fffffffUL;
+          const double frequency = 0.02 * (b + 1);
+          const double value = 0.5 + 0.3 * std::sin(frequency * x) * std::cos(frequency * y) + 0.2 * (noise - 0.5);
+          *buffer++ = static_cast<ValueType>(min + value * (max - min));
+          }
+        }
+      }
+    return image;
+  }
+
+protected:
+  BenchmarkHelper();
+  ~BenchmarkHelper() {}
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+private:
+  BenchmarkHelper(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  std::string   m_BenchmarkName;
+  unsigned int  m_SizeX;
+  unsigned int  m_SizeY;
+  unsigned int  m_NumberOfBands;
+  unsigned int  m_NumberOfThreads;
+  unsigned int  m_NumberOfWarmUps;
+  unsigned int  m_NumberOfRepetitions;
+  unsigned long m_PixelsPerRepetition;
+
+  /** Timing state */
+  unsigned int m_Iteration;
+  double       m_IterationStart;
+  double       m_PauseStart;
+  double       m_PausedTime;
+  SampleList   m_Samples;
+};
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbBenchmarkMain_h
+#define __otbBenchmarkMain_h
+
+#include "otbConfigure.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <iostream>
+
+#include "itkMultiThreader.h"
+#include "itkMacro.h"
+
+#include "otbOGRDriversInit.h"
+#include "otbBenchmarkHelper.h"
+
+/** A benchmark kernel receives the helper, already configured by the
+ * command line, and the remaining arguments (argv[0] is the name of the
+ * kernel). It returns EXIT_SUCCESS if the processing went well. */
+typedef int (*BenchmarkFuncPointer)(otb::BenchmarkHelper *, int, char*[]);
+std::map<std::string, BenchmarkFuncPointer> StringToBenchmarkFunctionMap;
+
+#define REGISTER_BENCHMARK(benchmark) \
+  extern int benchmark(otb::BenchmarkHelper *, int, char*[]); \
+  StringToBenchmarkFunctionMap[# benchmark] = benchmark
+
+void RegisterBenchmarks();
+void PrintAvailableBenchmarks()
+{
+  std::cout << "Benchmarks available:\n";
+  std::map<std::string, BenchmarkFuncPointer>::iterator j = StringToBenchmarkFunctionMap.begin();
+  int                                                   i = 0;
+  while (j != StringToBenchmarkFunctionMap.end())
+    {
+    std::cout << i << ". " << j->first << "\n";
+    ++i;
+    ++j;
+    }
+}
+
+void BenchmarkUsage(const char * driver)
+{
+  std::cerr << "usage: " << driver << " [options] benchmark [args]" << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Options:" << std::endl;
+  std::cerr << "  --size X Y           Size of the synthetic images (default 1000 1000)" << std::endl;
+  std::cerr << "  --bands N            Number of bands of the synthetic images (default 4)" << std::endl;
+  std::cerr << "  --threads N          Number of threads (default: ITK default)" << std::endl;
+  std::cerr << "  --warmup N           Number of untimed iterations (default 1)" << std::endl;
+  std::cerr << "  --repetitions N      Number of timed iterations (default 5)" << std::endl;
+  std::cerr << "  --output FILE        Write the results in FILE (JSON)" << std::endl;
+  std::cerr << std::endl;
+  PrintAvailableBenchmarks();
+}
+
+int main(int ac, char* av[])
+{
+  otb::ogr::Drivers::Init();
+  otb::BenchmarkHelper::Pointer helper = otb::BenchmarkHelper::New();
+  std::string                   outputFileName;
+
+  RegisterBenchmarks();
+
+  const char * driver = av[0];
+  ++av;
+  --ac;
+  while (ac > 0 && strncmp(av[0], "--", 2) == 0)
+    {
+    if (strcmp(av[0], "--size") == 0 && ac > 2)
+      {
+      helper->SetSizeX(atoi(av[1]));
+      helper->SetSizeY(atoi(av[2]));
+      av += 3;
+      ac -= 3;
+      }
+    else if (strcmp(av[0], "--bands") == 0 && ac > 1)
+      {
+      helper->SetNumberOfBands(atoi(av[1]));
+      av += 2;
+      ac -= 2;
+      }
+    else if (strcmp(av[0], "--threads") == 0 && ac > 1)
+      {
+      itk::MultiThreader::SetGlobalDefaultNumberOfThreads(atoi(av[1]));
+      av += 2;
+      ac -= 2;
+      }
+    else if (strcmp(av[0], "--warmup") == 0 && ac > 1)
+      {
+      helper->SetNumberOfWarmUps(atoi(av[1]));
+      av += 2;
+      ac -= 2;
+      }
+    else if (strcmp(av[0], "--repetitions") == 0 && ac > 1)
+      {
+      helper->SetNumberOfRepetitions(atoi(av[1]));
+      av += 2;
+      ac -= 2;
+      }
+    else if (strcmp(av[0], "--output") == 0 && ac > 1)
+      {
+      outputFileName = av[1];
+      av += 2;
+      ac -= 2;
+      }
+    else
+      {
+      std::cerr << "Unknown or incomplete option " << av[0] << std::endl;
+      BenchmarkUsage(driver);
+      return EXIT_FAILURE;
+      }
+    }
+
+  if (ac < 1)
+    {
+    BenchmarkUsage(driver);
+    return EXIT_FAILURE;
+    }
+
+  const std::string benchmarkToRun = av[0];
+  std::map<std::string, BenchmarkFuncPointer>::iterator j = StringToBenchmarkFunctionMap.find(benchmarkToRun);
+  if (j == StringToBenchmarkFunctionMap.end())
+    {
+    PrintAvailableBenchmarks();
+    std::cerr << "Failure: " << benchmarkToRun << ": no benchmark identified " << benchmarkToRun << "\n";
+    return EXIT_FAILURE;
+    }
+
+  helper->SetBenchmarkName(benchmarkToRun);
+  helper->SetNumberOfThreads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+
+  try
+    {
+    if ((*j->second)(helper, ac, av) != EXIT_SUCCESS)
+      {
+      std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': the benchmark returned EXIT_FAILURE" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (helper->GetSamples().empty())
+      {
+      std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': no iteration has been timed" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    helper->PrintResults(std::cout);
+    if (!outputFileName.empty())
+      {
+      helper->WriteResults(outputFileName);
+      }
+    }
+  catch (itk::ExceptionObject& e)
+    {
+    std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': ITK Exception thrown:" << std::endl;
+    std::cerr << e.GetFile() << ":" << e.GetLine() << ":" << std::endl;
+    std::cerr << e.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (std::bad_alloc& err)
+    {
+    std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': Exception bad_alloc thrown: " << std::endl;
+    std::cerr << (char*) err.what() << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (const std::exception& e)
+    {
+    std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': std::exception  thrown:" << std::endl;
+    std::cerr << e.what() <<  std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (...)
+    {
+    std::cerr << "otbBenchmarkMain '" << benchmarkToRun << "': Unknown exception thrown !" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbBenchmarkHelper.h"
+#include "otbConfigure.h"
+
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace otb
+{
+
+BenchmarkHelper::BenchmarkHelper() :
+  m_SizeX(1000),
+  m_SizeY(1000),
+  m_NumberOfBands(4),
+  m_NumberOfThreads(0),
+  m_NumberOfWarmUps(1),
+  m_NumberOfRepetitions(5),
+  m_PixelsPerRepetition(0),
+  m_Iteration(0),
+  m_IterationStart(0.),
+  m_PauseStart(0.),
+  m_PausedTime(0.)
+{
+}
+
+unsigned long BenchmarkHelper::GetPixelsPerRepetition() const
+{
+  if (m_PixelsPerRepetition == 0)
+    {
+    return static_cast<unsigned long>(m_SizeX) * m_SizeY;
+    }
+  return m_PixelsPerRepetition;
+}
+
+bool BenchmarkHelper::KeepRunning()
+{
+  const double now = itksys::SystemTools::GetTime();
+
+  // A new loop does not add to the samples of the previous one
+  if (m_Iteration == 0)
+    {
+    this->Reset();
+    }
+
+  // Record the iteration which ends
+  if (m_Iteration > m_NumberOfWarmUps)
+    {
+    m_Samples.push_back(now - m_IterationStart - m_PausedTime);
+    }
+
+  if (m_Iteration == m_NumberOfWarmUps + m_NumberOfRepetitions)
+    {
+    m_Iteration = 0;
+    return false;
+    }
+
+  ++m_Iteration;
+  m_PausedTime = 0.;
+  m_IterationStart = itksys::SystemTools::GetTime();
+  return true;
+}
+
+void BenchmarkHelper::Reset()
+{
+  m_Iteration = 0;
+  m_PausedTime = 0.;
+  m_Samples.clear();
+}
+
+void BenchmarkHelper::PauseTiming()
+{
+  m_PauseStart = itksys::SystemTools::GetTime();
+}
+
+void BenchmarkHelper::ResumeTiming()
+{
+  m_PausedTime += itksys::SystemTools::GetTime() - m_PauseStart;
+}
+
+double BenchmarkHelper::GetPercentile(double p) const
+{
+  if (m_Samples.empty())
+    {
+    return 0.;
+    }
+
+  SampleList sorted(m_Samples);
+  std::sort(sorted.begin(), sorted.end());
+
+  const double       position = std::min(std::max(p, 0.), 100.) / 100. * (sorted.size() - 1);
+  const unsigned int lower = static_cast<unsigned int>(position);
+  if (lower + 1 >= sorted.size())
+    {
+    return sorted.back();
+    }
+  const double weight = position - lower;
+  return (1. - weight) * sorted[lower] + weight * sorted[lower + 1];
+}
+
+double BenchmarkHelper::GetMegaPixelsPerSecond() const
+{
+  const double median = this->GetMedian();
+  if (median <= 0.)
+    {
+    return 0.;
+    }
+  return this->GetPixelsPerRepetition() / median / 1.e6;
+}
+
+void BenchmarkHelper::PrintResults(std::ostream& os) const
+{
+  os << m_BenchmarkName << ": " << m_SizeX << "x" << m_SizeY << " pixels, "
+     << m_NumberOfBands << " bands, " << m_NumberOfThreads << " threads, "
+     << m_Samples.size() << " repetitions" << std::endl;
+  os << "  median " << this->GetMedian() << " s (p10 " << this->GetPercentile(10.)
+     << " s, p90 " << this->GetPercentile(90.) << " s), "
+     << this->GetMegaPixelsPerSecond() << " Mpixels/s" << std::endl;
+}
+
+void BenchmarkHelper::WriteResults(const std::string& filename) const
+{
+  const std::string directory = itksys::SystemTools::GetFilenamePath(filename);
+  if (!directory.empty())
+    {
+    itksys::SystemTools::MakeDirectory(directory.c_str());
+    }
+
+  std::ofstream file(filename.c_str());
+  if (!file)
+    {
+    itkExceptionMacro(<< "Can not write the benchmark results in " << filename);
+    }
+
+  file << std::setprecision(9);
+  file << "{\n";
+  file << "\"benchmark\": \"" << m_BenchmarkName << "\",\n";
+  file << "\"otbVersion\": \"" << OTB_VERSION_STRING << "\",\n";
+  file << "\"sizeX\": " << m_SizeX << ",\n";
+  file << "\"sizeY\": " << m_SizeY << ",\n";
+  file << "\"bands\": " << m_NumberOfBands << ",\n";
+  file << "\"threads\": " << m_NumberOfThreads << ",\n";
+  file << "\"warmUps\": " << m_NumberOfWarmUps << ",\n";
+  file << "\"repetitions\": " << m_Samples.size() << ",\n";
+  file << "\"pixelsPerRepetition\": " << this->GetPixelsPerRepetition() << ",\n";
+  file << "\"samples\": [";
+  for (unsigned int i = 0; i < m_Samples.size(); ++i)
+    {
+    file << (i == 0 ? "" : ", ") << m_Samples[i];
+    }
+  file << "],\n";
+  file << "\"min\": " << this->GetPercentile(0.) << ",\n";
+  file << "\"p10\": " << this->GetPercentile(10.) << ",\n";
+  file << "\"median\": " << this->GetMedian() << ",\n";
+  file << "\"p90\": " << this->GetPercentile(90.) << ",\n";
+  file << "\"max\": " << this->GetPercentile(100.) << ",\n";
+  file << "\"mpixelsPerSecond\": " << this->GetMegaPixelsPerSecond() << "\n";
+  file << "}\n";
+}
+
+void BenchmarkHelper::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "BenchmarkName: " << m_BenchmarkName << std::endl;
+  os << indent << "Size: " << m_SizeX << "x" << m_SizeY << std::endl;
+  os << indent << "NumberOfBands: " << m_NumberOfBands << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "NumberOfWarmUps: " << m_NumberOfWarmUps << std::endl;
+  os << indent << "NumberOfRepetitions: " << m_NumberOfRepetitions << std::endl;
+  os << indent << "PixelsPerRepetition: " << this->GetPixelsPerRepetition() << std::endl;
+}
+
+} // end namespace otb
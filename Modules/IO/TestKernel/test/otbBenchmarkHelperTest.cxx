@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include <iostream>
+#include <cmath>
+
+#include "otbBenchmarkHelper.h"
+#include "otbVectorImage.h"
+
+int otbBenchmarkHelperTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0];
+    std::cerr << " resultsFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  otb::BenchmarkHelper::Pointer helper = otb::BenchmarkHelper::New();
+  helper->SetBenchmarkName("otbBenchmarkHelperTest");
+  helper->SetSizeX(100);
+  helper->SetSizeY(50);
+  helper->SetNumberOfBands(3);
+  helper->SetNumberOfWarmUps(2);
+  helper->SetNumberOfRepetitions(4);
+
+  // Synthetic image
+  typedef otb::VectorImage<unsigned char, 2> ImageType;
+  ImageType::Pointer image = helper->GenerateImage<ImageType>(10., 20.);
+  if (image->GetLargestPossibleRegion().GetNumberOfPixels() != 5000
+      || image->GetNumberOfComponentsPerPixel() != 3)
+    {
+    std::cerr << "Wrong synthetic image " << image->GetLargestPossibleRegion()
+              << image->GetNumberOfComponentsPerPixel() << " components" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (unsigned long i = 0; i < 5000 * 3; ++i)
+    {
+    const unsigned char value = image->GetBufferPointer()[i];
+    if (value < 10 || value > 20)
+      {
+      std::cerr << "Synthetic value " << static_cast<int>(value) << " out of [10, 20]" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Warm-ups are executed but not recorded
+  unsigned int iterations = 0;
+  while (helper->KeepRunning())
+    {
+    ++iterations;
+    }
+  if (iterations != 6 || helper->GetSamples().size() != 4)
+    {
+    std::cerr << iterations << " iterations, " << helper->GetSamples().size() << " samples" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A second loop replaces the samples
+  helper->SetNumberOfRepetitions(3);
+  while (helper->KeepRunning())
+    {
+    }
+  if (helper->GetSamples().size() != 3)
+    {
+    std::cerr << helper->GetSamples().size() << " samples after a second loop" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  helper->Reset();
+  if (!helper->GetSamples().empty())
+    {
+    std::cerr << "Reset() should clear the samples" << std::endl;
+    return EXIT_FAILURE;
+    }
+  while (helper->KeepRunning())
+    {
+    }
+
+  const double median = helper->GetMedian();
+  if (median < helper->GetPercentile(0.) || median > helper->GetPercentile(100.))
+    {
+    std::cerr << "Median " << median << " out of the samples range" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  helper->PrintResults(std::cout);
+  helper->WriteResults(argv[1]);
+
+  return EXIT_SUCCESS;
+}
@@ -8,4 +8,5 @@ void RegisterTests()
   REGISTER_TEST(otbCompareAsciiTestScientificNotation);
   REGISTER_TEST(otbCompareAsciiTests);
   REGISTER_TEST(otbCompareAsciiTestsEpsilon3_WhiteSpace);
+  REGISTER_TEST(otbBenchmarkHelperTest);
 }
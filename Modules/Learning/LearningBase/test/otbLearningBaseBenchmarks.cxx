@@ -0,0 +1,68 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbKMeansImageClassificationFilter.h"
+
+int otbKMeansImageClassificationFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " nbClasses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::VectorImage<double, 2>                                        ImageType;
+  typedef otb::Image<unsigned short, 2>                                      LabeledImageType;
+  typedef otb::KMeansImageClassificationFilter<ImageType, LabeledImageType>  FilterType;
+  typedef FilterType::KMeansParametersType                                   KMeansParametersType;
+
+  const unsigned int nbClasses = atoi(argv[1]);
+  const unsigned int sampleSize = FilterType::MaxSampleDimension;
+  if (helper->GetNumberOfBands() > sampleSize)
+    {
+    std::cerr << "The classification filter supports at most " << sampleSize << " bands" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Centroids regularly spread over the dynamic of the synthetic image
+  KMeansParametersType parameters;
+  parameters.SetSize(nbClasses * sampleSize);
+  parameters.Fill(0);
+  for (unsigned int i = 0; i < nbClasses; ++i)
+    {
+    for (unsigned int j = 0; j < helper->GetNumberOfBands(); ++j)
+      {
+      parameters[i * sampleSize + j] = 255. * (i + 0.5) / nbClasses;
+      }
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(helper->GenerateImage<ImageType>(0., 255.));
+  filter->SetCentroids(parameters);
+
+  while (helper->KeepRunning())
+    {
+    filter->Modified();
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbMRFEnergyFunctors_h
+#define __otbMRFEnergyFunctors_h
+
+#include <vector>
+#include "vcl_cmath.h"
+#include "itkArray.h"
+#include "itkMacro.h"
+#include "otbMath.h"
+
+namespace otb
+{
+
+namespace Functor
+{
+
+/** \class MRFPottsEnergy
+ * \brief Potts model energy, as a functor.
+ *
+ * Functor version of otb::MRFEnergyPotts, to be used as the fidelity
+ * energy (to regularize an existing classification) or the
+ * regularization energy of otb::MarkovRandomFieldCheckerboardFilter:
+ * \f[  U(x_s, x_t) = -\beta \textrm{ if } x_s = x_t \f]
+ * \f[  U(x_s, x_t) = +\beta \textrm{ if } x_s \neq x_t \f]
+ *
+ * \ingroup OTBMarkov
+ */
+template <class TInput, class TLabel>
+class MRFPottsEnergy
+{
+public:
+  MRFPottsEnergy() : m_Beta(1.0) {}
+  virtual ~MRFPottsEnergy() {}
+
+  void SetBeta(double beta)
+  {
+    m_Beta = beta;
+  }
+  double GetBeta() const
+  {
+    return m_Beta;
+  }
+
+  inline double operator ()(const TInput& value, const TLabel& label) const
+  {
+    return (value != static_cast<TInput>(label)) ? m_Beta : -m_Beta;
+  }
+
+private:
+  double m_Beta;
+};
+
+/** \class MRFGaussianClassificationEnergy
+ * \brief Gaussian classification energy, as a functor.
+ *
+ * Functor version of otb::MRFEnergyGaussianClassification, to be used as
+ * the fidelity energy of otb::MarkovRandomFieldCheckerboardFilter:
+ * \f[  U(x_s, y_s) = \frac{(y_s-\mu_{x_s})^2}{2\sigma^2_{x_s}} + \log{\sqrt{2\pi}\sigma_{x_s}} \f]
+ *
+ * The parameters are the mean and the standard deviation of each class
+ * (mean of class 0, standard deviation of class 0, mean of class 1...).
+ * The terms which do not depend on the pixel value are computed once
+ * by SetParameters().
+ *
+ * \ingroup OTBMarkov
+ */
+template <class TInput, class TLabel>
+class MRFGaussianClassificationEnergy
+{
+public:
+  typedef itk::Array<double> ParametersType;
+
+  MRFGaussianClassificationEnergy() {}
+  virtual ~MRFGaussianClassificationEnergy() {}
+
+  void SetParameters(const ParametersType& parameters)
+  {
+    if (parameters.Size() % 2 != 0)
+      {
+      itkGenericExceptionMacro(<< "The parameters must be pairs of mean and standard deviation");
+      }
+    const unsigned int nbClasses = parameters.Size() / 2;
+    m_Means.resize(nbClasses);
+    m_InverseTwoVariances.resize(nbClasses);
+    m_LogNormalizations.resize(nbClasses);
+    for (unsigned int label = 0; label < nbClasses; ++label)
+      {
+      const double sigma = parameters[2 * label + 1];
+      m_Means[label] = parameters[2 * label];
+      m_InverseTwoVariances[label] = 1.0 / (2 * sigma * sigma);
+      m_LogNormalizations[label] = vcl_log(vcl_sqrt(CONST_2PI) * sigma);
+      }
+  }
+
+  /** Number of classes described by the parameters */
+  unsigned int GetNumberOfClasses() const
+  {
+    return m_Means.size();
+  }
+
+  /** The label is not checked against the number of classes */
+  inline double operator ()(const TInput& value, const TLabel& label) const
+  {
+    const unsigned int l = static_cast<unsigned int>(label);
+    const double       diff = static_cast<double>(value) - m_Means[l];
+    return diff * diff * m_InverseTwoVariances[l] + m_LogNormalizations[l];
+  }
+
+private:
+  std::vector<double> m_Means;
+  std::vector<double> m_InverseTwoVariances;
+  std::vector<double> m_LogNormalizations;
+};
+
+} // end namespace Functor
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbMarkovRandomFieldCheckerboardFilter_h
+#define __otbMarkovRandomFieldCheckerboardFilter_h
+
+#include <vector>
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "otbMRFEnergyFunctors.h"
+
+namespace otb
+{
+/**
+ * \class MarkovRandomFieldCheckerboardFilter
+ * \brief Multi-threaded and streamable ICM optimization of a Markov Random Field.
+ *
+ * This filter processes 2D images.
+ *
+ * This filter minimizes the same energy as otb::MarkovRandomFieldFilter
+ * used with otb::MRFSamplerMAP and otb::MRFOptimizerICM: each pixel takes
+ * the label minimizing
+ * \f[ U_{fidelity}(y_s, x_s) + \lambda \frac{1}{|N_s|} \sum_{t \in N_s} U_{regularization}(x_t, x_s) \f]
+ * where \f$ N_s \f$ is the square neighborhood of radius NeighborhoodRadius.
+ *
+ * The energies are functors (see otbMRFEnergyFunctors.h) given as template
+ * parameters, so that they are inlined in the optimization loop.
+ *
+ * The pixels are updated by a checkerboard scheme: the pixels are colored
+ * by the position of their index modulo NeighborhoodRadius+1 in each
+ * direction, so that two pixels of the same color are never neighbors
+ * (with a radius of 1 and 4-connected neighborhoods, this is the classic
+ * red-black scheme; the diagonal neighbors of the 8-connected neighborhood
+ * require 4 colors). An iteration updates the colors one after the other,
+ * each color being processed by all the threads at once.
+ *
+ * The filter is streamable: the output requested region is enlarged by
+ * a halo of HaloRadius pixels, optimized, and only the requested region
+ * is kept. The colors depend on the absolute index of the pixels, and
+ * a label change can only influence pixels NeighborhoodRadius pixels
+ * away per color, so the default halo (MaximumNumberOfIterations *
+ * number of colors * NeighborhoodRadius) gives the same result as the
+ * processing of the whole image, as long as ErrorTolerance is 0. A
+ * smaller halo gives an approximation at a lower cost.
+ *
+ * If no training image is given, the initial label of each pixel is the
+ * one minimizing the fidelity energy (instead of a random label), so that
+ * the initialization does not depend on the tiling either.
+ *
+ * \code
+ *   markovFilter->SetNumberOfClasses(4);
+ *   markovFilter->SetMaximumNumberOfIterations(30);
+ *   markovFilter->SetLambda(1.0);
+ *   markovFilter->SetNeighborhoodRadius(1);
+ *   markovFilter->GetFidelityFunctor().SetParameters(parameters);
+ * \endcode
+ *
+ * \sa MarkovRandomFieldFilter
+ *
+ * \ingroup OTBMarkov
+ */
+template <class TInputImage, class TClassifiedImage,
+          class TFidelityFunctor = Functor::MRFGaussianClassificationEnergy<typename TInputImage::PixelType,
+                                                                            typename TClassifiedImage::PixelType>,
+          class TRegularizationFunctor = Functor::MRFPottsEnergy<typename TClassifiedImage::PixelType,
+                                                                 typename TClassifiedImage::PixelType> >
+class ITK_EXPORT MarkovRandomFieldCheckerboardFilter :
+  public itk::ImageToImageFilter<TInputImage, TClassifiedImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MarkovRandomFieldCheckerboardFilter                    Self;
+  typedef itk::ImageToImageFilter<TInputImage, TClassifiedImage> Superclass;
+  typedef itk::SmartPointer<Self>                                Pointer;
+  typedef itk::SmartPointer<const Self>                          ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MarkovRandomFieldCheckerboardFilter, itk::ImageToImageFilter);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  typedef TInputImage                            InputImageType;
+  typedef typename InputImageType::PixelType     InputImagePixelType;
+  typedef TClassifiedImage                       LabelledImageType;
+  typedef TClassifiedImage                       TrainingImageType;
+  typedef typename LabelledImageType::PixelType  LabelledImagePixelType;
+  typedef typename LabelledImageType::RegionType RegionType;
+  typedef typename LabelledImageType::IndexType  IndexType;
+  typedef typename LabelledImageType::SizeType   SizeType;
+
+  typedef TFidelityFunctor       FidelityFunctorType;
+  typedef TRegularizationFunctor RegularizationFunctorType;
+
+  itkStaticConstMacro(InputImageDimension, unsigned int, TInputImage::ImageDimension);
+  itkStaticConstMacro(ClassifiedImageDimension, unsigned int, TClassifiedImage::ImageDimension);
+
+  /** Get the fidelity and regularization functors, to set their
+   * parameters. Call Modified() after a change. */
+  FidelityFunctorType& GetFidelityFunctor()
+  {
+    return m_FidelityFunctor;
+  }
+  void SetFidelityFunctor(const FidelityFunctorType& functor)
+  {
+    m_FidelityFunctor = functor;
+    this->Modified();
+  }
+  RegularizationFunctorType& GetRegularizationFunctor()
+  {
+    return m_RegularizationFunctor;
+  }
+  void SetRegularizationFunctor(const RegularizationFunctorType& functor)
+  {
+    m_RegularizationFunctor = functor;
+    this->Modified();
+  }
+
+  /** Set/Get the number of classes. */
+  itkSetMacro(NumberOfClasses, unsigned int);
+  itkGetMacro(NumberOfClasses, unsigned int);
+
+  /** Set/Get the maximum number of iterations (50 by default). */
+  itkSetMacro(MaximumNumberOfIterations, unsigned int);
+  itkGetMacro(MaximumNumberOfIterations, unsigned int);
+
+  /** Set/Get the fraction of changed pixels under which the iterations
+   * stop. With 0 (the default), they stop when no pixel changes. */
+  itkSetMacro(ErrorTolerance, double);
+  itkGetMacro(ErrorTolerance, double);
+
+  /** Set/Get the regularization coefficient. */
+  itkSetMacro(Lambda, double);
+  itkGetMacro(Lambda, double);
+
+  /** Set/Get the neighborhood radius (1 by default). */
+  itkSetMacro(NeighborhoodRadius, unsigned int);
+  itkGetMacro(NeighborhoodRadius, unsigned int);
+
+  /** Set/Get the halo, in pixels, added around the requested region. A
+   * negative value (the default) means MaximumNumberOfIterations *
+   * number of colors * NeighborhoodRadius. */
+  itkSetMacro(HaloRadius, int);
+  itkGetMacro(HaloRadius, int);
+
+  /** Number of colors of the checkerboard scheme */
+  unsigned int GetNumberOfColors() const
+  {
+    return (m_NeighborhoodRadius + 1) * (m_NeighborhoodRadius + 1);
+  }
+
+  /** Set the training image for the starting point (optional). It
+   * should contain class numbers (consecutive integers from 0). */
+  void SetTrainingInput(const TrainingImageType * trainingImage);
+  const TrainingImageType* GetTrainingInput();
+
+  /** Enum to get the stopping condition */
+  typedef enum
+    {
+    MaximumNumberOfIterations = 1,
+    ErrorTolerance
+    } StopConditionType;
+
+  /** Get the stopping condition of the last processed region */
+  itkGetConstReferenceMacro(StopCondition, StopConditionType);
+
+  /** Get the number of iterations of the last processed region */
+  itkGetConstReferenceMacro(NumberOfIterations, unsigned int);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro(SameDimensionCheck,
+                  (itk::Concept::SameDimension<InputImageDimension, ClassifiedImageDimension>));
+  itkConceptMacro(TwoDimensionsCheck,
+                  (itk::Concept::SameDimension<InputImageDimension, 2>));
+  itkConceptMacro(UnsignedIntConvertibleToClassifiedCheck,
+                  (itk::Concept::Convertible<unsigned int, LabelledImagePixelType>));
+  /** End concept checking */
+#endif
+
+protected:
+  MarkovRandomFieldCheckerboardFilter();
+  virtual ~MarkovRandomFieldCheckerboardFilter() {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Enlarge the requested region of the inputs by the halo */
+  virtual void GenerateInputRequestedRegion();
+
+  virtual void GenerateData();
+
+  /** Requested region enlarged by the halo, cropped by the largest
+   * possible region */
+  RegionType GetHaloRegion() const;
+
+  /** Data shared by the threads of a color pass */
+  struct ThreadStruct
+  {
+    Self *                               Filter;
+    const InputImageType *               Input;
+    RegionType                           Region;     // halo region
+    std::vector<LabelledImagePixelType> *Labels;  // labels of the halo region
+    int                                  Color;   // -1 to initialize the labels
+    std::vector<unsigned long>           Changes; // per thread
+  };
+
+  /** Process the lines of a thread, for one color */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void * arg);
+
+  /** Initialize the labels of lines [firstLine, endLine[ with the
+   * fidelity MAP */
+  void InitializeLines(ThreadStruct * str, long firstLine, long endLine) const;
+
+  /** Update the pixels of one color in lines [firstLine, endLine[, and
+   * return the number of changed pixels */
+  unsigned long UpdateLines(ThreadStruct * str, long firstLine, long endLine) const;
+
+private:
+  MarkovRandomFieldCheckerboardFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  FidelityFunctorType       m_FidelityFunctor;
+  RegularizationFunctorType m_RegularizationFunctor;
+
+  unsigned int      m_NumberOfClasses;
+  unsigned int      m_MaximumNumberOfIterations;
+  double            m_ErrorTolerance;
+  double            m_Lambda;
+  unsigned int      m_NeighborhoodRadius;
+  int               m_HaloRadius;
+  unsigned int      m_NumberOfIterations;
+  StopConditionType m_StopCondition;
+};
+
+} // namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbMarkovRandomFieldCheckerboardFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,363 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbMarkovRandomFieldCheckerboardFilter_txx
+#define __otbMarkovRandomFieldCheckerboardFilter_txx
+
+#include "otbMarkovRandomFieldCheckerboardFilter.h"
+
+#include <algorithm>
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::MarkovRandomFieldCheckerboardFilter() :
+  m_NumberOfClasses(0),
+  m_MaximumNumberOfIterations(50),
+  m_ErrorTolerance(0.0),
+  m_Lambda(1.0),
+  m_NeighborhoodRadius(1),
+  m_HaloRadius(-1),
+  m_NumberOfIterations(0),
+  m_StopCondition(MaximumNumberOfIterations)
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+void
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::SetTrainingInput(const TrainingImageType * trainingImage)
+{
+  // Process object is not const-correct so the const_cast is required here
+  this->itk::ProcessObject::SetNthInput(1, const_cast<TrainingImageType *>(trainingImage));
+  this->Modified();
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+const typename MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor,
+                                                   TRegularizationFunctor>::TrainingImageType *
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::GetTrainingInput()
+{
+  if (this->GetNumberOfInputs() < 2)
+    {
+    return 0;
+    }
+  return static_cast<const TrainingImageType *>(this->itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+typename MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor,
+                                             TRegularizationFunctor>::RegionType
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::GetHaloRegion() const
+{
+  unsigned long halo = m_HaloRadius;
+  if (m_HaloRadius < 0)
+    {
+    halo = m_MaximumNumberOfIterations * this->GetNumberOfColors() * m_NeighborhoodRadius;
+    }
+
+  RegionType region = this->GetOutput()->GetRequestedRegion();
+  region.PadByRadius(halo);
+  region.Crop(this->GetOutput()->GetLargestPossibleRegion());
+  return region;
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+void
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  const RegionType region = this->GetHaloRegion();
+
+  InputImageType * inputPtr = const_cast<InputImageType *>(this->GetInput());
+  if (inputPtr)
+    {
+    inputPtr->SetRequestedRegion(region);
+    }
+
+  TrainingImageType * trainingPtr = const_cast<TrainingImageType *>(this->GetTrainingInput());
+  if (trainingPtr)
+    {
+    trainingPtr->SetRequestedRegion(region);
+    }
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+void
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::GenerateData()
+{
+  if (m_NumberOfClasses == 0)
+    {
+    itkExceptionMacro(<< "NumberOfClasses has to be greater than 0.");
+    }
+
+  this->AllocateOutputs();
+
+  const RegionType                    region = this->GetHaloRegion();
+  const unsigned long                 nbPixels = region.GetNumberOfPixels();
+  std::vector<LabelledImagePixelType> labels(nbPixels);
+
+  ThreadStruct str;
+  str.Filter = this;
+  str.Input = this->GetInput();
+  str.Region = region;
+  str.Labels = &labels;
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  str.Changes.assign(this->GetMultiThreader()->GetNumberOfThreads(), 0);
+
+  // Starting point: the training image, or the fidelity MAP
+  const TrainingImageType * trainingImage = this->GetTrainingInput();
+  if (trainingImage)
+    {
+    itk::ImageRegionConstIterator<TrainingImageType> trainingIt(trainingImage, region);
+    typename std::vector<LabelledImagePixelType>::iterator labelIt = labels.begin();
+    for (trainingIt.GoToBegin(); !trainingIt.IsAtEnd(); ++trainingIt, ++labelIt)
+      {
+      *labelIt = trainingIt.Get();
+      }
+    }
+  else
+    {
+    str.Color = -1;
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  // ICM iterations, one color after the other
+  const unsigned long maxNumPixelError = static_cast<unsigned long>(m_ErrorTolerance * nbPixels);
+  const unsigned int  nbColors = this->GetNumberOfColors();
+
+  m_NumberOfIterations = 0;
+  m_StopCondition = MaximumNumberOfIterations;
+  while (m_NumberOfIterations < m_MaximumNumberOfIterations)
+    {
+    unsigned long changes = 0;
+    for (unsigned int color = 0; color < nbColors; ++color)
+      {
+      str.Color = color;
+      std::fill(str.Changes.begin(), str.Changes.end(), 0);
+      this->GetMultiThreader()->SingleMethodExecute();
+      for (unsigned int i = 0; i < str.Changes.size(); ++i)
+        {
+        changes += str.Changes[i];
+        }
+      }
+    ++m_NumberOfIterations;
+
+    otbMsgDevMacro(<< "Iteration " << m_NumberOfIterations << ": " << changes << " changed pixels");
+    this->UpdateProgress(static_cast<float>(m_NumberOfIterations) / m_MaximumNumberOfIterations);
+
+    if (changes <= maxNumPixelError)
+      {
+      m_StopCondition = ErrorTolerance;
+      break;
+      }
+    }
+
+  // Keep the requested region
+  LabelledImageType * outputPtr = this->GetOutput();
+  const long          width = region.GetSize()[0];
+  itk::ImageRegionIteratorWithIndex<LabelledImageType> outIt(outputPtr, outputPtr->GetRequestedRegion());
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+    {
+    const IndexType& index = outIt.GetIndex();
+    outIt.Set(labels[(index[1] - region.GetIndex()[1]) * width + index[0] - region.GetIndex()[0]]);
+    }
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+ITK_THREAD_RETURN_TYPE
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::ThreaderCallback(void * arg)
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+  ThreadStruct * str = (ThreadStruct *) (pInfo->UserData);
+  const unsigned int threadId = pInfo->ThreadID;
+  const unsigned int nbThreads = pInfo->NumberOfThreads;
+
+  // Contiguous blocks of lines
+  const long nbLines = str->Region.GetSize()[1];
+  const long linesPerThread = (nbLines + nbThreads - 1) / nbThreads;
+  const long firstLine = threadId * linesPerThread;
+  const long endLine = std::min(firstLine + linesPerThread, nbLines);
+  if (firstLine >= endLine)
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  if (str->Color < 0)
+    {
+    str->Filter->InitializeLines(str, firstLine, endLine);
+    }
+  else
+    {
+    str->Changes[threadId] = str->Filter->UpdateLines(str, firstLine, endLine);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+void
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::InitializeLines(ThreadStruct * str, long firstLine, long endLine) const
+{
+  const long                           width = str->Region.GetSize()[0];
+  std::vector<LabelledImagePixelType>& labels = *str->Labels;
+
+  IndexType index;
+  for (long y = firstLine; y < endLine; ++y)
+    {
+    index[1] = str->Region.GetIndex()[1] + y;
+    for (long x = 0; x < width; ++x)
+      {
+      index[0] = str->Region.GetIndex()[0] + x;
+      const InputImagePixelType& value = str->Input->GetPixel(index);
+
+      LabelledImagePixelType best = 0;
+      double                 bestEnergy = m_FidelityFunctor(value, best);
+      for (unsigned int label = 1; label < m_NumberOfClasses; ++label)
+        {
+        const double energy = m_FidelityFunctor(value, static_cast<LabelledImagePixelType>(label));
+        if (energy < bestEnergy)
+          {
+          bestEnergy = energy;
+          best = static_cast<LabelledImagePixelType>(label);
+          }
+        }
+      labels[y * width + x] = best;
+      }
+    }
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+unsigned long
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::UpdateLines(ThreadStruct * str, long firstLine, long endLine) const
+{
+  const long                           radius = m_NeighborhoodRadius;
+  const long                           period = radius + 1;
+  const long                           width = str->Region.GetSize()[0];
+  const long                           height = str->Region.GetSize()[1];
+  const IndexType                      origin = str->Region.GetIndex();
+  std::vector<LabelledImagePixelType>& labels = *str->Labels;
+
+  // The color depends on the absolute index, so that all the tilings
+  // give the same result
+  const long colorX = str->Color % period;
+  const long colorY = str->Color / period;
+  const long firstX = ((colorX - origin[0]) % period + period) % period;
+
+  unsigned long changes = 0;
+  IndexType     index;
+  for (long y = firstLine; y < endLine; ++y)
+    {
+    if (((origin[1] + y) % period + period) % period != colorY)
+      {
+      continue;
+      }
+    index[1] = origin[1] + y;
+    const long minY = std::max(0L, y - radius);
+    const long maxY = std::min(height - 1, y + radius);
+
+    for (long x = firstX; x < width; x += period)
+      {
+      index[0] = origin[0] + x;
+      const long minX = std::max(0L, x - radius);
+      const long maxX = std::min(width - 1, x + radius);
+      const long nbNeighbors = (maxY - minY + 1) * (maxX - minX + 1) - 1;
+      const double weight = nbNeighbors > 0 ? m_Lambda / nbNeighbors : 0.0;
+
+      const InputImagePixelType&   value = str->Input->GetPixel(index);
+      const LabelledImagePixelType current = labels[y * width + x];
+
+      // The current label is kept unless another one has a strictly
+      // lower energy, as MRFSamplerMAP and MRFOptimizerICM do
+      LabelledImagePixelType best = current;
+      double                 bestEnergy = 0.0;
+      for (unsigned int label = 0; label <= m_NumberOfClasses; ++label)
+        {
+        // The current label is evaluated first
+        const LabelledImagePixelType candidate =
+          (label == 0) ? current : static_cast<LabelledImagePixelType>(label - 1);
+        if (label > 0 && candidate == current)
+          {
+          continue;
+          }
+
+        double regularization = 0.0;
+        for (long ny = minY; ny <= maxY; ++ny)
+          {
+          const LabelledImagePixelType * neighbor = &labels[ny * width + minX];
+          for (long nx = minX; nx <= maxX; ++nx, ++neighbor)
+            {
+            if (ny != y || nx != x)
+              {
+              regularization += m_RegularizationFunctor(*neighbor, candidate);
+              }
+            }
+          }
+
+        const double energy = m_FidelityFunctor(value, candidate) + weight * regularization;
+        if (label == 0 || energy < bestEnergy)
+          {
+          bestEnergy = energy;
+          best = candidate;
+          }
+        }
+
+      if (best != current)
+        {
+        labels[y * width + x] = best;
+        ++changes;
+        }
+      }
+    }
+  return changes;
+}
+
+template <class TInputImage, class TClassifiedImage, class TFidelityFunctor, class TRegularizationFunctor>
+void
+MarkovRandomFieldCheckerboardFilter<TInputImage, TClassifiedImage, TFidelityFunctor, TRegularizationFunctor>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfClasses: " << m_NumberOfClasses << std::endl;
+  os << indent << "MaximumNumberOfIterations: " << m_MaximumNumberOfIterations << std::endl;
+  os << indent << "ErrorTolerance: " << m_ErrorTolerance << std::endl;
+  os << indent << "Lambda: " << m_Lambda << std::endl;
+  os << indent << "NeighborhoodRadius: " << m_NeighborhoodRadius << std::endl;
+  os << indent << "HaloRadius: " << m_HaloRadius << std::endl;
+  os << indent << "NumberOfIterations: " << m_NumberOfIterations << std::endl;
+  os << indent << "StopCondition: " << m_StopCondition << std::endl;
+}
+
+} // namespace otb
+
+#endif
@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbImage.h"
+#include "otbMarkovRandomFieldCheckerboardFilter.h"
+
+int otbMarkovRandomFieldCheckerboardFilter(int itkNotUsed(argc), char* argv[])
+{
+  const unsigned int Dimension = 2;
+
+  typedef double                                   InternalPixelType;
+  typedef unsigned char                            LabelledPixelType;
+  typedef otb::Image<InternalPixelType, Dimension> InputImageType;
+  typedef otb::Image<LabelledPixelType, Dimension> LabelledImageType;
+  typedef otb::ImageFileReader<InputImageType>     ReaderType;
+  typedef otb::ImageFileWriter<LabelledImageType>  WriterType;
+
+  typedef otb::MarkovRandomFieldCheckerboardFilter<InputImageType, LabelledImageType> MarkovFilterType;
+
+  const char *       inputFilename  = argv[1];
+  const char *       referenceFilename = argv[2];
+  const char *       streamedFilename = argv[3];
+  const double       lambda = atof(argv[4]);
+  const unsigned int nbIterations = atoi(argv[5]);
+  const unsigned int nbDivisions = atoi(argv[6]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFilename);
+
+  unsigned int nClass = 4;
+  MarkovFilterType::FidelityFunctorType::ParametersType parameters(2 * nClass);
+  parameters[0] = 10.0; //Class 0 mean
+  parameters[1] = 10.0; //Class 0 stdev
+  parameters[2] = 80.0; //Class 1 mean
+  parameters[3] = 10.0; //Class 1 stdev
+  parameters[4] = 150.0; //Class 2 mean
+  parameters[5] = 10.0; //Class 2 stdev
+  parameters[6] = 220.0; //Class 3 mean
+  parameters[7] = 10.0; //Class 3 stdev
+
+  // Whole image, single thread
+  MarkovFilterType::Pointer referenceFilter = MarkovFilterType::New();
+  referenceFilter->SetInput(reader->GetOutput());
+  referenceFilter->SetNumberOfClasses(nClass);
+  referenceFilter->SetMaximumNumberOfIterations(nbIterations);
+  referenceFilter->SetLambda(lambda);
+  referenceFilter->SetNeighborhoodRadius(1);
+  referenceFilter->GetFidelityFunctor().SetParameters(parameters);
+  referenceFilter->SetNumberOfThreads(1);
+
+  WriterType::Pointer referenceWriter = WriterType::New();
+  referenceWriter->SetInput(referenceFilter->GetOutput());
+  referenceWriter->SetFileName(referenceFilename);
+  referenceWriter->SetNumberOfDivisionsStrippedStreaming(1);
+  referenceWriter->Update();
+
+  std::cout << "Reference: " << referenceFilter->GetNumberOfIterations() << " iterations" << std::endl;
+
+  // Streamed, with the default number of threads: the default halo
+  // gives the same result
+  MarkovFilterType::Pointer streamedFilter = MarkovFilterType::New();
+  streamedFilter->SetInput(reader->GetOutput());
+  streamedFilter->SetNumberOfClasses(nClass);
+  streamedFilter->SetMaximumNumberOfIterations(nbIterations);
+  streamedFilter->SetLambda(lambda);
+  streamedFilter->SetNeighborhoodRadius(1);
+  streamedFilter->GetFidelityFunctor().SetParameters(parameters);
+
+  WriterType::Pointer streamedWriter = WriterType::New();
+  streamedWriter->SetInput(streamedFilter->GetOutput());
+  streamedWriter->SetFileName(streamedFilename);
+  streamedWriter->SetNumberOfDivisionsStrippedStreaming(nbDivisions);
+  streamedWriter->Update();
+
+  return EXIT_SUCCESS;
+}
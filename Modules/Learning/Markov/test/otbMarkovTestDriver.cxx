@@ -7,6 +7,7 @@ void RegisterTests()
   REGISTER_TEST(otbMRFEnergyPottsNew);
   REGISTER_TEST(otbMRFSamplerMAPNew);
   REGISTER_TEST(otbMarkovRandomFieldFilter);
+  REGISTER_TEST(otbMarkovRandomFieldCheckerboardFilter);
   REGISTER_TEST(otbMRFSamplerRandomMAPNew);
   REGISTER_TEST(otbMRFSamplerRandomNew);
   REGISTER_TEST(otbMRFEnergyGaussianNew);
@@ -47,6 +47,8 @@ namespace otb
  * The SOMMap produced as output can be either initialized with a constant custom value or randomly
  * generated following a normal law. The seed for the random intialization can be modified.
  *
+ * The mini-batch training of SOM is not available: BatchSize must be 0.
+ *
  * \sa SOMMap
  * \sa SOMActivationBuilder
  * \sa CzihoSOMLearningBehaviorFunctor
@@ -119,6 +121,14 @@ protected:
   {
     Superclass::Step(currentIteration);
   }
+  /**
+  * The mini-batch training does not wrap the neighborhood around the
+  * torus: a BatchSize other than 0 is rejected.
+  */
+  virtual void BatchStep(unsigned int itkNotUsed(currentIteration))
+  {
+    itkExceptionMacro(<< "PeriodicSOM does not support the mini-batch training, set BatchSize to 0");
+  }
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const
   {
@@ -20,8 +20,10 @@
 #ifndef __otbSOM_h
 #define __otbSOM_h
 
+#include <vector>
 #include "itkImageToImageFilter.h"
 #include "itkEuclideanDistanceMetric.h"
+#include "itkMultiThreader.h"
 
 #include "otbCzihoSOMLearningBehaviorFunctor.h"
 #include "otbCzihoSOMNeighborhoodBehaviorFunctor.h"
@@ -46,6 +48,13 @@ namespace otb
  * The SOMMap produced as output can be either initialized with a constant custom value or randomly
  * generated following a normal law. The seed for the random intialization can be modified.
  *
+ * If BatchSize is not 0, the map is trained by mini-batches instead of sample by sample: the
+ * winners of the samples of a batch are computed by several threads. Then each thread handles a
+ * band of the map, and moves each of its neurons towards the neighborhood-weighted mean of the
+ * samples of the batch, by the learning coefficient. The samples are summed in the same order
+ * whatever the number of threads, so that the trained map does not depend on it. With a learning coefficient of 1 and a batch
+ * containing all the samples, this is the classic batch SOM algorithm.
+ *
  * \sa SOMMap
  * \sa SOMActivationBuilder
  * \sa CzihoSOMLearningBehaviorFunctor
@@ -106,6 +115,11 @@ public:
   itkGetMacro(RandomInit, bool);
   itkSetMacro(Seed, unsigned int);
   itkGetMacro(Seed, unsigned int);
+  /** Number of samples of the mini-batches. 0 (the default) means the
+   * sequential training, sample by sample */
+  itkSetMacro(BatchSize, unsigned int);
+  itkGetMacro(BatchSize, unsigned int);
+
   itkGetObjectMacro(ListSample, ListSampleType);
   itkSetObjectMacro(ListSample, ListSampleType);
 
@@ -141,6 +155,11 @@ protected:
    * Step one iteration.
    */
   virtual void Step(unsigned int currentIteration);
+
+  /**
+   * Step one iteration of the mini-batch training.
+   */
+  virtual void BatchStep(unsigned int currentIteration);
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
@@ -171,6 +190,27 @@ private:
   SOMLearningBehaviorFunctorType m_BetaFunctor;
   /** Behavior of the Neighborhood extent */
   SOMNeighborhoodBehaviorFunctorType m_NeighborhoodSizeFunctor;
+  /** Number of samples of the mini-batches (0 for the sequential training) */
+  unsigned int m_BatchSize;
+
+  /** Data shared by the threads of a mini-batch */
+  struct BatchThreadStruct
+  {
+    Self *                 Filter;
+    unsigned long          FirstSample;
+    unsigned long          EndSample;
+    SizeType               Radius;
+    double                 Beta;
+    std::vector<IndexType> Winners;      // per sample of the batch
+    std::vector<double>    Numerators;   // neurons x components
+    std::vector<double>    Denominators; // per neuron
+  };
+
+  /** Find the winners of the samples of a thread */
+  static ITK_THREAD_RETURN_TYPE BatchWinnersThreaderCallback(void * arg);
+
+  /** Update the neurons of the band of the map of a thread */
+  static ITK_THREAD_RETURN_TYPE BatchUpdateThreaderCallback(void * arg);
 
 };
 } // end namespace otb
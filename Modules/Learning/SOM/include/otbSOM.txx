@@ -22,7 +22,10 @@
 #define __otbSOM_txx
 
 #include "otbSOM.h"
+
+#include <algorithm>
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkFixedArray.h"
 #include "otbMacro.h"
 #include "itkImageRegionIterator.h"
@@ -51,6 +54,7 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
   m_MaxWeight = static_cast<ValueType>(128.0);
   m_RandomInit = false;
   m_Seed = 123574651;
+  m_BatchSize = 0;
 }
 /**
  * Destructor
@@ -156,6 +160,195 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
     UpdateMap(it.GetMeasurementVector(), newBeta, newSize);
     }
 }
+/**
+ * Step one iteration of the mini-batch training.
+ */
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+void
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::BatchStep(unsigned int currentIteration)
+{
+  // Compute the new learning coefficient
+  double newBeta = m_BetaFunctor(
+    currentIteration, m_NumberOfIterations, m_BetaInit, m_BetaEnd);
+
+  // Compute the new neighborhood size
+  SizeType newSize = m_NeighborhoodSizeFunctor(
+    currentIteration, m_NumberOfIterations, m_NeighborhoodSizeInit);
+
+  otbMsgDebugMacro(<< "Beta: " << newBeta << ", radius: " << newSize << ", batch size: " << m_BatchSize);
+
+  const MapType *     map = this->GetOutput(0);
+  const unsigned int  nbComponents = map->GetNumberOfComponentsPerPixel();
+  const unsigned long nbNeurons = map->GetBufferedRegion().GetNumberOfPixels();
+  const unsigned long nbSamples = m_ListSample->Size();
+
+  BatchThreadStruct str;
+  str.Filter = this;
+  str.Radius = newSize;
+  str.Beta = newBeta;
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+
+  for (unsigned long first = 0; first < nbSamples; first += m_BatchSize)
+    {
+    str.FirstSample = first;
+    str.EndSample = std::min(first + m_BatchSize, nbSamples);
+    str.Winners.resize(str.EndSample - str.FirstSample);
+
+    this->GetMultiThreader()->SetSingleMethod(this->BatchWinnersThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    str.Numerators.assign(nbNeurons * nbComponents, 0.);
+    str.Denominators.assign(nbNeurons, 0.);
+
+    this->GetMultiThreader()->SetSingleMethod(this->BatchUpdateThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+}
+
+/**
+ * Find the winners of the samples of a thread.
+ */
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+ITK_THREAD_RETURN_TYPE
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::BatchWinnersThreaderCallback(void * arg)
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+  BatchThreadStruct * str = (BatchThreadStruct *) (pInfo->UserData);
+  const unsigned int threadId = pInfo->ThreadID;
+  const unsigned int nbThreads = pInfo->NumberOfThreads;
+
+  // Contiguous blocks of samples
+  const unsigned long nbSamples = str->EndSample - str->FirstSample;
+  const unsigned long samplesPerThread = (nbSamples + nbThreads - 1) / nbThreads;
+  const unsigned long first = std::min(threadId * samplesPerThread, nbSamples);
+  const unsigned long end = std::min(first + samplesPerThread, nbSamples);
+
+  const MapType *        map = str->Filter->GetOutput(0);
+  const ListSampleType * listSample = str->Filter->m_ListSample;
+
+  for (unsigned long id = first; id < end; ++id)
+    {
+    str->Winners[id] = map->ComputeIndex(
+      map->GetWinnerOffset(listSample->GetMeasurementVector(str->FirstSample + id)));
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Move the neurons of the band of the map of a thread towards the
+ * neighborhood-weighted mean of the samples of the batch.
+ */
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+ITK_THREAD_RETURN_TYPE
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::BatchUpdateThreaderCallback(void * arg)
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+  BatchThreadStruct * str = (BatchThreadStruct *) (pInfo->UserData);
+  const unsigned int threadId = pInfo->ThreadID;
+  const unsigned int nbThreads = pInfo->NumberOfThreads;
+
+  MapType *          map = str->Filter->GetOutput(0);
+  const unsigned int nbComponents = map->GetNumberOfComponentsPerPixel();
+  const unsigned int lastDimension = MapType::ImageDimension - 1;
+
+  // Band of the map along the last dimension
+  RegionType          threadRegion = map->GetLargestPossibleRegion();
+  const unsigned long nbLines = threadRegion.GetSize()[lastDimension];
+  const unsigned long linesPerThread = (nbLines + nbThreads - 1) / nbThreads;
+  const unsigned long firstLine = threadId * linesPerThread;
+  if (firstLine >= nbLines)
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+  IndexType threadIndex = threadRegion.GetIndex();
+  SizeType  threadSize = threadRegion.GetSize();
+  threadIndex[lastDimension] += firstLine;
+  threadSize[lastDimension] = std::min(linesPerThread, nbLines - firstLine);
+  threadRegion.SetIndex(threadIndex);
+  threadRegion.SetSize(threadSize);
+
+  const ListSampleType * listSample = str->Filter->m_ListSample;
+  std::vector<double>&   numerators = str->Numerators;
+  std::vector<double>&   denominators = str->Denominators;
+
+  typedef itk::ImageRegionConstIteratorWithIndex<MapType> IteratorType;
+
+  // The samples are summed in their order, whatever the number of threads
+  for (unsigned long id = 0; id < str->Winners.size(); ++id)
+    {
+    const IndexType& position = str->Winners[id];
+
+    // Local neighborhood definition
+    RegionType localRegion;
+    IndexType  localIndex = position - str->Radius;
+    SizeType   localSize;
+    for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+      {
+      localSize[i] = 2 * str->Radius[i] + 1;
+      }
+    localRegion.SetIndex(localIndex);
+    localRegion.SetSize(localSize);
+    if (!localRegion.Crop(threadRegion))
+      {
+      continue;
+      }
+
+    const typename ListSampleType::MeasurementVectorType& sample =
+      listSample->GetMeasurementVector(str->FirstSample + id);
+
+    // Same neighborhood weight as UpdateMap(), without the learning
+    // coefficient
+    for (IteratorType it(map, localRegion); !it.IsAtEnd(); ++it)
+      {
+      double squaredDistance = 0.;
+      for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+        {
+        const double d = static_cast<double>(it.GetIndex()[i] - position[i]);
+        squaredDistance += d * d;
+        }
+      const double weight = 1. / (1. + vcl_sqrt(squaredDistance));
+
+      const unsigned long n = map->ComputeOffset(it.GetIndex());
+      denominators[n] += weight;
+      for (unsigned int c = 0; c < nbComponents; ++c)
+        {
+        numerators[n * nbComponents + c] += weight * sample[c];
+        }
+      }
+    }
+
+  // Move each neuron towards the weighted mean of the samples which
+  // influenced it
+  typename MapType::InternalPixelType * weights = map->GetBufferPointer();
+  for (IteratorType it(map, threadRegion); !it.IsAtEnd(); ++it)
+    {
+    const unsigned long n = map->ComputeOffset(it.GetIndex());
+    if (denominators[n] <= 0.)
+      {
+      continue;
+      }
+    for (unsigned int c = 0; c < nbComponents; ++c)
+      {
+      typename MapType::InternalPixelType& weight = weights[n * nbComponents + c];
+      weight += static_cast<typename MapType::InternalPixelType>(
+        (numerators[n * nbComponents + c] / denominators[n] - weight) * str->Beta);
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 /**
  *  Output information redefinition
  */
@@ -244,7 +437,14 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
     {
     //otbMsgDebugMacro(<<"Step "<<i+1<<" / "<<m_NumberOfIterations);
     std::cerr << "Step " << i + 1 << " / " << m_NumberOfIterations << "                         \r";
-    Step(i);
+    if (m_BatchSize > 0)
+      {
+      BatchStep(i);
+      }
+    else
+      {
+      Step(i);
+      }
     }
 
   this->AfterThreadedGenerateData();
@@ -260,6 +460,7 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "BatchSize: " << m_BatchSize << std::endl;
 }
 
 } // end namespace otb
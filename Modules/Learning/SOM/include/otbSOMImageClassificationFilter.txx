@@ -66,6 +66,13 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
     {
     itkGenericExceptionMacro(<< "No model for classification");
     }
+  // The extra components of the input pixels are ignored
+  if (this->GetInput()->GetNumberOfComponentsPerPixel() < m_Map->GetNumberOfComponentsPerPixel())
+    {
+    itkExceptionMacro(<< "The input image has " << this->GetInput()->GetNumberOfComponentsPerPixel()
+                      << " components while the neurons of the map have "
+                      << m_Map->GetNumberOfComponentsPerPixel());
+    }
 }
 
 template <class TInputImage, class TOutputImage, class TSOMMap, class TMaskImage>
@@ -81,10 +88,8 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
   typedef itk::ImageRegionConstIterator<MaskImageType>  MaskIteratorType;
   typedef itk::ImageRegionIterator<OutputImageType>     OutputIteratorType;
 
-  ListSamplePointerType listSample = ListSampleType::New();
-  listSample->SetMeasurementVectorSize(inputPtr->GetNumberOfComponentsPerPixel());
-
-  InputIteratorType inIt(inputPtr, outputRegionForThread);
+  InputIteratorType  inIt(inputPtr, outputRegionForThread);
+  OutputIteratorType outIt(outputPtr, outputRegionForThread);
 
   MaskIteratorType maskIt;
   if (inputMaskPtr)
@@ -92,13 +97,14 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
     maskIt = MaskIteratorType(inputMaskPtr, outputRegionForThread);
     maskIt.GoToBegin();
     }
-  unsigned int maxDimension = m_Map->GetNumberOfComponentsPerPixel();
-  unsigned int sampleSize = std::min(inputPtr->GetNumberOfComponentsPerPixel(),
-                                     maxDimension);
-  bool validPoint = true;
 
-  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  // The winner search reads the pixels directly, without building a
+  // list sample. The labels are the ones of SOMClassifier.
+  const typename SOMMapType::SizeType size = m_Map->GetLargestPossibleRegion().GetSize();
+
+  for (inIt.GoToBegin(), outIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++outIt)
     {
+    bool validPoint = true;
     if (inputMaskPtr)
       {
       validPoint = maskIt.Get() > 0;
@@ -106,56 +112,13 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
       }
     if (validPoint)
       {
-      SampleType sample;
-      sample.SetSize(sampleSize);
-      sample.Fill(itk::NumericTraits<ValueType>::ZeroValue());
-      for (unsigned int i = 0; i < sampleSize; ++i)
-        {
-        sample[i] = inIt.Get()[i];
-        }
-      listSample->PushBack(sample);
+      const typename SOMMapType::IndexType index = m_Map->ComputeIndex(m_Map->GetWinnerOffset(inIt.Get()));
+      outIt.Set(static_cast<LabelType>((index[1] * size[1]) + index[0]));
       }
-    }
-  ClassifierPointerType classifier = ClassifierType::New();
-  classifier->SetMap(m_Map);
-  classifier->SetSample(listSample);
-  classifier->Update();
-
-  typename ClassifierType::OutputType::Pointer       membershipSample = classifier->GetOutput();
-  typename ClassifierType::OutputType::ConstIterator sampleIter = membershipSample->Begin();
-  typename ClassifierType::OutputType::ConstIterator sampleLast = membershipSample->End();
-
-  OutputIteratorType outIt(outputPtr, outputRegionForThread);
-
-  outIt.GoToBegin();
-
-  while (!outIt.IsAtEnd() && (sampleIter != sampleLast))
-    {
-    outIt.Set(m_DefaultLabel);
-    ++outIt;
-    }
-
-  outIt.GoToBegin();
-
-  if (inputMaskPtr)
-    {
-    maskIt.GoToBegin();
-    }
-  validPoint = true;
-
-  while (!outIt.IsAtEnd() && (sampleIter != sampleLast))
-    {
-    if (inputMaskPtr)
-      {
-      validPoint = maskIt.Get() > 0;
-      ++maskIt;
-      }
-    if (validPoint)
+    else
       {
-      outIt.Set(sampleIter.GetClassLabel());
-      ++sampleIter;
+      outIt.Set(m_DefaultLabel);
       }
-    ++outIt;
     }
 }
 /**
@@ -27,6 +27,24 @@ See GETCopyright.txt for details.
 
 namespace otb
 {
+/** \class SOMMapDistanceTraits
+ * \brief Tells SOMMap whether its distance is the Euclidean distance,
+ * for which the winner search has a fast implementation.
+ *
+ * \ingroup OTBSOM
+ */
+template <class TDistance>
+struct SOMMapDistanceTraits
+{
+  static const bool IsEuclidean = false;
+};
+
+template <class TVector>
+struct SOMMapDistanceTraits<itk::Statistics::EuclideanDistanceMetric<TVector> >
+{
+  static const bool IsEuclidean = true;
+};
+
 /**
  * \class SOMMap
  * \brief This class represent a Self Organizing Map.
@@ -39,6 +57,11 @@ namespace otb
  * Thanks to the extension of the Image object, reading and writing is supported through standard image
  * readers and writers.
  *
+ * The neuron weights are stored in the image buffer, as a contiguous
+ * matrix (one neuron after the other). With the Euclidean distance, the
+ * winner search compares the sample to several neurons at once, reading
+ * the buffer directly, and is safe to call from several threads.
+ *
  * The training is done via the SOM class, and the activation map can be produced with the SOMActivationBuilder
  * class.
  *
@@ -74,18 +97,30 @@ public:
   typedef typename DistanceType::Pointer DistancePointerType;
 
   /** Superclass related typedefs */
-  typedef typename Superclass::IndexType     IndexType;
-  typedef typename Superclass::SizeType      SizeType;
-  typedef typename Superclass::DirectionType DirectionType;
-  typedef typename Superclass::RegionType    RegionType;
-  typedef typename Superclass::SpacingType   SpacingType;
-  typedef typename Superclass::PointType     PointType;
+  typedef typename Superclass::IndexType         IndexType;
+  typedef typename Superclass::SizeType          SizeType;
+  typedef typename Superclass::DirectionType     DirectionType;
+  typedef typename Superclass::RegionType        RegionType;
+  typedef typename Superclass::SpacingType       SpacingType;
+  typedef typename Superclass::PointType         PointType;
+  typedef typename Superclass::OffsetValueType   OffsetValueType;
+  typedef typename Superclass::InternalPixelType InternalPixelType;
   /**
    * Get The index of the winning neuron for a sample.
    * \param sample the sample.
    * \return The index of the winning neuron.
    */
-  IndexType GetWinner(const NeuronType& sample);
+  IndexType GetWinner(const NeuronType& sample) const;
+
+  /**
+   * Get the offset in the buffer of the winning neuron for a sample.
+   * \param sample the sample: any vector with operator[] and the same
+   * number of components as the neurons (a pixel of a VectorImage for
+   * instance).
+   * \return The offset of the winning neuron (see ComputeIndex()).
+   */
+  template <class TSample>
+  OffsetValueType GetWinnerOffset(const TSample& sample) const;
 
 protected:
   /** Constructor */
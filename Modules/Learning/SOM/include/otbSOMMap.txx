@@ -21,7 +21,10 @@ See GETCopyright.txt for details.
 #ifndef __otbSOMMap_txx
 #define __otbSOMMap_txx
 
+#include "otbSOMMap.h"
+#include "itkImageRegionConstIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkNumericTraits.h"
 
 namespace otb
 {
@@ -48,36 +51,107 @@ template <class TNeuron, class TDistance, unsigned int VMapDimension>
 typename SOMMap<TNeuron, TDistance, VMapDimension>
 ::IndexType
 SOMMap<TNeuron, TDistance, VMapDimension>
-::GetWinner(const NeuronType& sample)
+::GetWinner(const NeuronType& sample) const
 {
-  // Some typedefs
-  typedef itk::ImageRegionIteratorWithIndex<Self> IteratorType;
+  return this->ComputeIndex(this->GetWinnerOffset(sample));
+}
+
+/**
+ * Get the offset of the winning neuron for a sample.
+ * \param sample The sample
+ * \return The offset of the winning neuron.
+ */
+template <class TNeuron, class TDistance, unsigned int VMapDimension>
+template <class TSample>
+typename SOMMap<TNeuron, TDistance, VMapDimension>
+::OffsetValueType
+SOMMap<TNeuron, TDistance, VMapDimension>
+::GetWinnerOffset(const TSample& sample) const
+{
+  const unsigned int        nbComponents = this->GetNumberOfComponentsPerPixel();
+  const OffsetValueType     nbNeurons = this->GetBufferedRegion().GetNumberOfPixels();
+  const InternalPixelType * weights = this->GetBufferPointer();
+
+  // As in the generic search below, the last neuron at the minimum
+  // distance wins
+  OffsetValueType minPos = 0;
+
+  if (SOMMapDistanceTraits<DistanceType>::IsEuclidean)
+    {
+    // The squared distances give the same winner. Four neurons are
+    // compared at once, to use several accumulators.
+    double          minDistance = itk::NumericTraits<double>::max();
+    OffsetValueType n = 0;
+    for (; n + 4 <= nbNeurons; n += 4)
+      {
+      const InternalPixelType * w0 = weights + n * nbComponents;
+      const InternalPixelType * w1 = w0 + nbComponents;
+      const InternalPixelType * w2 = w1 + nbComponents;
+      const InternalPixelType * w3 = w2 + nbComponents;
+      double d0 = 0., d1 = 0., d2 = 0., d3 = 0.;
+      for (unsigned int c = 0; c < nbComponents; ++c)
+        {
+        const double s = static_cast<double>(sample[c]);
+        const double e0 = s - w0[c];
+        const double e1 = s - w1[c];
+        const double e2 = s - w2[c];
+        const double e3 = s - w3[c];
+        d0 += e0 * e0;
+        d1 += e1 * e1;
+        d2 += e2 * e2;
+        d3 += e3 * e3;
+        }
+      if (d0 <= minDistance) { minDistance = d0; minPos = n; }
+      if (d1 <= minDistance) { minDistance = d1; minPos = n + 1; }
+      if (d2 <= minDistance) { minDistance = d2; minPos = n + 2; }
+      if (d3 <= minDistance) { minDistance = d3; minPos = n + 3; }
+      }
+    for (; n < nbNeurons; ++n)
+      {
+      const InternalPixelType * w = weights + n * nbComponents;
+      double                    d = 0.;
+      for (unsigned int c = 0; c < nbComponents; ++c)
+        {
+        const double e = static_cast<double>(sample[c]) - w[c];
+        d += e * e;
+        }
+      if (d <= minDistance)
+        {
+        minDistance = d;
+        minPos = n;
+        }
+      }
+    return minPos;
+    }
 
-  // Define the euclidean distance used to compute the neural response
+  // Define the distance used to compute the neural response
   DistancePointerType activation = DistanceType::New();
 
-  // Define the iterator used to walk through the map
-  IteratorType it(this, this->GetLargestPossibleRegion());
-  it.GoToBegin();
+  NeuronType neuronSample(nbComponents);
+  for (unsigned int c = 0; c < nbComponents; ++c)
+    {
+    neuronSample[c] = static_cast<typename NeuronType::ValueType>(sample[c]);
+    }
 
-  // Define the minimum distance and position
-  IndexType minPos = it.GetIndex();
+  typedef itk::ImageRegionConstIterator<Self> IteratorType;
+  IteratorType it(this, this->GetBufferedRegion());
+  it.GoToBegin();
 
-  double minDistance = activation->Evaluate(sample, it.Get());
+  double minDistance = activation->Evaluate(neuronSample, it.Get());
 
   // Iterate through the map to get the minimum distance position
-  for (; !it.IsAtEnd(); ++it)
+  for (OffsetValueType n = 0; !it.IsAtEnd(); ++it, ++n)
     {
-    double tempDistance = activation->Evaluate(sample, it.Get());
+    double tempDistance = activation->Evaluate(neuronSample, it.Get());
     if (tempDistance <= minDistance)
       {
       minDistance = tempDistance;
-      minPos = it.GetIndex();
+      minPos = n;
       }
     }
-  // Return the index of the winner
   return minPos;
 }
+
 template <class TNeuron, class TDistance, unsigned int VMapDimension>
 void
 SOMMap<TNeuron, TDistance, VMapDimension>
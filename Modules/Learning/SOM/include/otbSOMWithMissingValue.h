@@ -32,7 +32,8 @@ namespace otb
  *  by the EuclideanDistanceMetricWithMissingValue class in the SOMMap distance
  *  template. Nevertheless, this class re-implements the UpdateMap method to
  *  adapt the evaluation of each component of the 'newNeuron' when dealing
- *  with missing values.
+ *  with missing values. The mini-batch training of SOM is not available:
+ *  BatchSize must be 0.
  *
  *  TMap has to be templeted with EuclideanDistanceMetricWithMissingValuePow2
  *
@@ -105,6 +106,12 @@ protected:
   {
     Superclass::Step(currentIteration);
   }
+  /** The mini-batch training does not handle the missing values: a
+   *  BatchSize other than 0 is rejected. */
+  virtual void BatchStep(unsigned int itkNotUsed(currentIteration))
+  {
+    itkExceptionMacro(<< "SOMWithMissingValue does not support the mini-batch training, set BatchSize to 0");
+  }
   /** PrintSelf method */
 void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
@@ -24,7 +24,7 @@
 #include "itkListSample.h"
 #include "itkImageRegionIterator.h"
 
-int otbSOM(int itkNotUsed(argc), char* argv[])
+int otbSOM(int argc, char* argv[])
 {
   const unsigned int Dimension = 2;
   char *             inputFileName = argv[1];
@@ -37,6 +37,7 @@ int otbSOM(int itkNotUsed(argc), char* argv[])
   double             betaInit = atof(argv[8]);
   double             betaEnd = atof(argv[9]);
   double             initValue = atof(argv[10]);
+  unsigned int       batchSize = (argc > 11 ? atoi(argv[11]) : 0);
 
   typedef double                                          ComponentType;
   typedef itk::VariableLengthVector<ComponentType>        PixelType;
@@ -84,6 +85,11 @@ int otbSOM(int itkNotUsed(argc), char* argv[])
   som->SetBetaEnd(betaEnd);
   som->SetMaxWeight(initValue);
   som->SetRandomInit(false);
+  som->SetBatchSize(batchSize);
+  if (argc > 12)
+    {
+    som->SetNumberOfThreads(atoi(argv[12]));
+    }
 
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName(outputFileName);
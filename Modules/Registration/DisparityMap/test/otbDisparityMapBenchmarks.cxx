@@ -0,0 +1,72 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbPixelWiseBlockMatchingImageFilter.h"
+
+#include <algorithm>
+
+int otbPixelWiseBlockMatchingImageFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 4)
+    {
+    std::cerr << "Usage: " << argv[0] << " radius minimumDisparity maximumDisparity" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<unsigned short, 2> ImageType;
+  typedef otb::Image<float, 2>          FloatImageType;
+  typedef otb::PixelWiseBlockMatchingImageFilter<ImageType, FloatImageType, FloatImageType, ImageType> FilterType;
+
+  const int minimumDisparity = atoi(argv[2]);
+  const int maximumDisparity = atoi(argv[3]);
+
+  // The right image is the left one shifted by the mean of the disparity range
+  ImageType::Pointer left = helper->GenerateImage<ImageType>(0., 1023.);
+  ImageType::Pointer right = ImageType::New();
+  right->SetRegions(left->GetLargestPossibleRegion());
+  right->Allocate();
+
+  const long sizeX = helper->GetSizeX();
+  const long shift = (minimumDisparity + maximumDisparity) / 2;
+  for (unsigned int y = 0; y < helper->GetSizeY(); ++y)
+    {
+    const ImageType::PixelType * leftLine = left->GetBufferPointer() + y * sizeX;
+    ImageType::PixelType *       rightLine = right->GetBufferPointer() + y * sizeX;
+    for (long x = 0; x < sizeX; ++x)
+      {
+      rightLine[x] = leftLine[std::min(std::max(x - shift, 0L), sizeX - 1)];
+      }
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetLeftInput(left);
+  filter->SetRightInput(right);
+  filter->SetRadius(atoi(argv[1]));
+  filter->SetMinimumHorizontalDisparity(minimumDisparity);
+  filter->SetMaximumHorizontalDisparity(maximumDisparity);
+
+  while (helper->KeepRunning())
+    {
+    filter->Modified();
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
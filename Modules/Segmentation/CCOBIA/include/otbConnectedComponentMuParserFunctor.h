@@ -25,6 +25,9 @@
 #include "otbParser.h"
 #include "otbMacro.h"
 
+#include <algorithm>
+#include <vector>
+
 
 #include <vnl/algo/vnl_lsqr.h>
 #include <vnl/vnl_sparse_matrix_linear_system.h>
@@ -228,6 +231,204 @@ private:
   unsigned int m_NbOfBands;
   double m_ParserResult;
 
+};
+
+/** \class ConnectedComponentMuParserBulkFunctor
+ *  \brief Evaluate the connection criteria of ConnectedComponentMuParserFunctor
+ *  on batches of pixel pairs
+ *
+ * The variables (p1bX, p2bX, distance, spectralAngle, intensity_p1 and
+ * intensity_p2) are the same as ConnectedComponentMuParserFunctor ones,
+ * but they are arrays of BulkSize values: the pairs are stored with
+ * SetPair(), then Evaluate() runs the parser once for all of them
+ * (see Parser::Eval(ValueType *, int)).
+ *
+ * Unlike ConnectedComponentMuParserFunctor, this functor can be copied:
+ * the copy has its own parser, with the same expression, so that each
+ * thread can evaluate its own batches.
+ *
+ * \sa ConnectedComponentMuParserImageFilter
+ *
+ * \ingroup OTBCCOBIA
+ */
+template<class TInput>
+class ITK_EXPORT ConnectedComponentMuParserBulkFunctor
+{
+
+public:
+  typedef Parser ParserType;
+  typedef ConnectedComponentMuParserBulkFunctor Self;
+
+  std::string GetNameOfClass()
+  {
+    return "ConnectedComponentMuParserBulkFunctor";
+  }
+
+  /** Store the pair number i of the batch */
+  inline void SetPair(unsigned int i, const TInput &p1, const TInput &p2)
+  {
+    double distance = 0.0;
+    double intensityP1 = 0.0;
+    double intensityP2 = 0.0;
+    double scalarProd = 0.0;
+    double normProd1 = 0.0;
+    double normProd2 = 0.0;
+
+    // Same computations as ConnectedComponentMuParserFunctor, so that
+    // both functors connect the same pixels
+    for (unsigned int b = 0; b < m_NbOfBands; ++b)
+      {
+      m_AImageP1[b][i] = static_cast<double> (p1[b]);
+      m_AImageP2[b][i] = static_cast<double> (p2[b]);
+      distance += (p1[b] - p2[b]) * (p1[b] - p2[b]);
+      intensityP1 += p1[b];
+      intensityP2 += p2[b];
+      scalarProd += p1[b] * p2[b];
+      normProd1 += p1[b] * p1[b];
+      normProd2 += p2[b] * p2[b];
+      }
+
+    m_IntensityP1[i] = intensityP1 / (static_cast<double> (m_NbOfBands));
+    m_IntensityP2[i] = intensityP2 / (static_cast<double> (m_NbOfBands));
+    m_Distance[i] = vcl_sqrt(distance);
+
+    const double normProd = normProd1 * normProd2;
+    if (normProd == 0.0)
+      {
+      m_SpectralAngle[i] = 0.0;
+      }
+    else
+      {
+      m_SpectralAngle[i] = vcl_acos(scalarProd / vcl_sqrt(normProd));
+      }
+  }
+
+  /** Evaluate the nbPairs first pairs of the batch. The pair i is
+   * connected if the returned value i is not 0. */
+  const double * Evaluate(unsigned int nbPairs)
+  {
+    if (nbPairs > 0)
+      {
+      m_Parser->Eval(&(m_Results[0]), nbPairs);
+      }
+    return &(m_Results[0]);
+  }
+
+  void SetExpression(const std::string expression)
+  {
+    m_Expression = expression;
+    m_Parser->SetExpr(m_Expression);
+  }
+
+  /** Return the expression to be parsed */
+  std::string GetExpression() const
+  {
+    return m_Expression;
+  }
+
+  /** Check the expression */
+  bool CheckExpression()
+  {
+    return m_Parser->CheckExpr();
+  }
+
+  /** Allocate the variables for pixels of NbOfBands bands, and batches
+   * of at most BulkSize pairs */
+  void Initialize(unsigned int NbOfBands, unsigned int BulkSize)
+  {
+    m_NbOfBands = NbOfBands;
+    m_BulkSize = std::max(BulkSize, 1U);
+
+    m_AImageP1.assign(m_NbOfBands, std::vector<double>(m_BulkSize, 0.0));
+    m_AImageP2.assign(m_NbOfBands, std::vector<double>(m_BulkSize, 0.0));
+    m_Distance.assign(m_BulkSize, 0.0);
+    m_SpectralAngle.assign(m_BulkSize, 0.0);
+    m_IntensityP1.assign(m_BulkSize, 0.0);
+    m_IntensityP2.assign(m_BulkSize, 0.0);
+    m_Results.assign(m_BulkSize, 0.0);
+
+    // The arrays have moved: the variables are defined again
+    m_Parser->ClearVar();
+    std::ostringstream varName;
+    for (unsigned int i = 0; i < m_NbOfBands; ++i)
+      {
+      varName << "p1b" << i + 1;
+      m_Parser->DefineVar(varName.str(), &(m_AImageP1[i][0]));
+      varName.str("");
+      varName << "p2b" << i + 1;
+      m_Parser->DefineVar(varName.str(), &(m_AImageP2[i][0]));
+      varName.str("");
+      }
+    m_Parser->DefineVar("distance", &(m_Distance[0]));
+    m_Parser->DefineVar("spectralAngle", &(m_SpectralAngle[0]));
+    m_Parser->DefineVar("intensity_p1", &(m_IntensityP1[0]));
+    m_Parser->DefineVar("intensity_p2", &(m_IntensityP2[0]));
+  }
+
+  unsigned int GetNumberOfBands() const
+  {
+    return m_NbOfBands;
+  }
+
+  unsigned int GetBulkSize() const
+  {
+    return m_BulkSize;
+  }
+
+  ConnectedComponentMuParserBulkFunctor()
+  {
+    m_Parser = ParserType::New();
+    m_NbOfBands = 0;
+    m_BulkSize = 0;
+  }
+
+  ConnectedComponentMuParserBulkFunctor(const Self & other)
+  {
+    m_Parser = ParserType::New();
+    m_NbOfBands = 0;
+    m_BulkSize = 0;
+    if (!other.m_Expression.empty())
+      {
+      this->SetExpression(other.m_Expression);
+      }
+    if (other.m_BulkSize > 0)
+      {
+      this->Initialize(other.m_NbOfBands, other.m_BulkSize);
+      }
+  }
+
+  Self & operator =(const Self & other)
+  {
+    if (this != &other)
+      {
+      m_Expression = other.m_Expression;
+      m_Parser->SetExpr(m_Expression);
+      if (other.m_BulkSize > 0)
+        {
+        this->Initialize(other.m_NbOfBands, other.m_BulkSize);
+        }
+      }
+    return *this;
+  }
+
+  ~ConnectedComponentMuParserBulkFunctor()
+  {
+  }
+
+private:
+
+  std::string                      m_Expression;
+  ParserType::Pointer              m_Parser;
+  std::vector<std::vector<double> > m_AImageP1;
+  std::vector<std::vector<double> > m_AImageP2;
+  std::vector<double>              m_Distance;
+  std::vector<double>              m_IntensityP1;
+  std::vector<double>              m_IntensityP2;
+  std::vector<double>              m_SpectralAngle;
+  std::vector<double>              m_Results;
+  unsigned int                     m_NbOfBands;
+  unsigned int                     m_BulkSize;
+
 };
 } // end of Functor namespace
 
@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbConnectedComponentMuParserImageFilter_h
+#define __otbConnectedComponentMuParserImageFilter_h
+
+#include <utility>
+#include <vector>
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "otbConnectedComponentMuParserFunctor.h"
+
+namespace otb
+{
+/**
+ * \class ConnectedComponentMuParserImageFilter
+ * \brief Multi-threaded connected component labeling with a muParser
+ * connection criteria.
+ *
+ * This filter processes 2D images.
+ *
+ * It gives the same partition as itk::ConnectedComponentFunctorImageFilter
+ * used with Functor::ConnectedComponentMuParserFunctor: two neighbor pixels
+ * inside the mask belong to the same component if the expression (see
+ * ConnectedComponentMuParserFunctor for the variables) is true for the
+ * pair (current pixel, previous neighbor in raster order).
+ *
+ * The region is split in blocks of lines, one per thread. Each thread
+ * evaluates the expression for the pairs of one line at once with
+ * Functor::ConnectedComponentMuParserBulkFunctor (it has its own parser),
+ * and merges the connected pixels of its block in a union-find forest.
+ * The pairs crossing the border of two blocks are merged once all the
+ * threads are done. The root of each tree is its first pixel in raster
+ * order, so the components are numbered from 1 in the raster order of
+ * their first pixel. Pixels outside the mask are set to 0.
+ *
+ * As the ITK filter, the whole largest possible region is processed.
+ *
+ * \code
+ *   connected->GetFunctor().SetExpression("distance<40");
+ *   connected->SetMaskImage(mask);
+ * \endcode
+ *
+ * \sa ConnectedComponentMuParserFunctor
+ *
+ * \ingroup OTBCCOBIA
+ */
+template <class TInputImage, class TOutputImage, class TMaskImage = TOutputImage>
+class ITK_EXPORT ConnectedComponentMuParserImageFilter :
+  public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ConnectedComponentMuParserImageFilter              Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>                            Pointer;
+  typedef itk::SmartPointer<const Self>                      ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ConnectedComponentMuParserImageFilter, itk::ImageToImageFilter);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  typedef TInputImage                          InputImageType;
+  typedef typename InputImageType::PixelType   InputImagePixelType;
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::PixelType  OutputImagePixelType;
+  typedef TMaskImage                           MaskImageType;
+  typedef typename MaskImageType::PixelType    MaskImagePixelType;
+  typedef typename OutputImageType::RegionType RegionType;
+  typedef typename OutputImageType::IndexType  IndexType;
+
+  typedef Functor::ConnectedComponentMuParserBulkFunctor<InputImagePixelType> FunctorType;
+
+  /** Identifier of a pixel in the union-find forest */
+  typedef unsigned long NodeType;
+
+  itkStaticConstMacro(InputImageDimension, unsigned int, TInputImage::ImageDimension);
+  itkStaticConstMacro(OutputImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  /** Get the functor, to set the expression */
+  FunctorType& GetFunctor()
+  {
+    this->Modified();
+    return m_Functor;
+  }
+  const FunctorType& GetFunctor() const
+  {
+    return m_Functor;
+  }
+
+  /** Set the connection expression (same as GetFunctor().SetExpression()) */
+  void SetExpression(const std::string& expression);
+  std::string GetExpression() const
+  {
+    return m_Functor.GetExpression();
+  }
+
+  /** Set/Get the mask image (optional). Pixels where the mask is 0 are
+   * background. */
+  void SetMaskImage(const MaskImageType * mask);
+  const MaskImageType * GetMaskImage() const;
+
+  /** Set/Get whether the diagonal neighbors are connected (false by
+   * default, as in itk::ConnectedComponentFunctorImageFilter) */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /** Number of components found by the last update */
+  itkGetConstReferenceMacro(ObjectCount, unsigned long);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro(SameDimensionCheck,
+                  (itk::Concept::SameDimension<InputImageDimension, OutputImageDimension>));
+  itkConceptMacro(TwoDimensionsCheck,
+                  (itk::Concept::SameDimension<InputImageDimension, 2>));
+  /** End concept checking */
+#endif
+
+protected:
+  ConnectedComponentMuParserImageFilter();
+  virtual ~ConnectedComponentMuParserImageFilter() {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** The whole image is labeled */
+  virtual void GenerateInputRequestedRegion();
+  virtual void EnlargeOutputRequestedRegion(itk::DataObject * output);
+
+  virtual void GenerateData();
+
+  typedef std::pair<NodeType, NodeType> NodePairType;
+
+  /** Data shared by the threads */
+  struct ThreadStruct
+  {
+    Self *                                   Filter;
+    const InputImageType *                   Input;
+    const MaskImageType *                    Mask;
+    RegionType                               Region;
+    std::vector<NodeType> *                  Parents;   // union-find forest
+    std::vector<FunctorType> *               Functors;  // per thread
+    std::vector<std::vector<NodePairType> >  Crossings; // per thread, connected pairs crossing the block border
+  };
+
+  /** Label the block of lines of a thread */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void * arg);
+
+  /** Merge the connected pixels of lines [firstLine, endLine[ */
+  void LabelLines(ThreadStruct * str, unsigned int threadId, long firstLine, long endLine) const;
+
+  /** Root of the tree of a node, with path halving */
+  static NodeType FindRoot(std::vector<NodeType>& parents, NodeType node)
+  {
+    while (parents[node] != node)
+      {
+      parents[node] = parents[parents[node]];
+      node = parents[node];
+      }
+    return node;
+  }
+
+  /** Merge the trees of two nodes: the smallest root is kept */
+  static void Union(std::vector<NodeType>& parents, NodeType a, NodeType b)
+  {
+    a = FindRoot(parents, a);
+    b = FindRoot(parents, b);
+    if (a < b)
+      {
+      parents[b] = a;
+      }
+    else if (b < a)
+      {
+      parents[a] = b;
+      }
+  }
+
+private:
+  ConnectedComponentMuParserImageFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  FunctorType   m_Functor;
+  bool          m_FullyConnected;
+  unsigned long m_ObjectCount;
+};
+
+} // namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbConnectedComponentMuParserImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbConnectedComponentMuParserImageFilter_txx
+#define __otbConnectedComponentMuParserImageFilter_txx
+
+#include "otbConnectedComponentMuParserImageFilter.h"
+
+#include <algorithm>
+#include "itkNumericTraits.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::ConnectedComponentMuParserImageFilter() :
+  m_FullyConnected(false),
+  m_ObjectCount(0)
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::SetExpression(const std::string& expression)
+{
+  m_Functor.SetExpression(expression);
+  this->Modified();
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::SetMaskImage(const MaskImageType * mask)
+{
+  // Process object is not const-correct so the const_cast is required here
+  this->itk::ProcessObject::SetNthInput(1, const_cast<MaskImageType *>(mask));
+  this->Modified();
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+const typename ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>::MaskImageType *
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::GetMaskImage() const
+{
+  if (this->GetNumberOfInputs() < 2)
+    {
+    return 0;
+    }
+  return static_cast<const MaskImageType *>(this->itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * inputPtr = const_cast<InputImageType *>(this->GetInput());
+  if (inputPtr)
+    {
+    inputPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+
+  MaskImageType * maskPtr = const_cast<MaskImageType *>(this->GetMaskImage());
+  if (maskPtr)
+    {
+    maskPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::EnlargeOutputRequestedRegion(itk::DataObject * output)
+{
+  Superclass::EnlargeOutputRequestedRegion(output);
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::GenerateData()
+{
+  this->AllocateOutputs();
+
+  OutputImageType *   outputPtr = this->GetOutput();
+  const RegionType    region = outputPtr->GetRequestedRegion();
+  const unsigned long nbPixels = region.GetNumberOfPixels();
+  std::vector<NodeType> parents(nbPixels);
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+  const unsigned int nbThreads = this->GetMultiThreader()->GetNumberOfThreads();
+
+  // One functor per thread, each one holding the pairs of a line. The
+  // expression is checked here, so that parsing errors are not thrown
+  // by the threads.
+  const unsigned int nbNeighbors = m_FullyConnected ? 4 : 2;
+  m_Functor.Initialize(this->GetInput()->GetNumberOfComponentsPerPixel(),
+                       nbNeighbors * region.GetSize()[0]);
+  m_Functor.CheckExpression();
+  std::vector<FunctorType> functors(nbThreads, m_Functor);
+
+  ThreadStruct str;
+  str.Filter = this;
+  str.Input = this->GetInput();
+  str.Mask = this->GetMaskImage();
+  str.Region = region;
+  str.Parents = &parents;
+  str.Functors = &functors;
+  str.Crossings.resize(nbThreads);
+
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Merge the components across the borders of the blocks
+  for (unsigned int threadId = 0; threadId < nbThreads; ++threadId)
+    {
+    const std::vector<NodePairType>& crossings = str.Crossings[threadId];
+    for (unsigned int i = 0; i < crossings.size(); ++i)
+      {
+      Union(parents, crossings[i].first, crossings[i].second);
+      }
+    }
+
+  // The root of a component is its first pixel in raster order, so it is
+  // labeled before the other pixels of the component
+  const NodeType         background = itk::NumericTraits<NodeType>::max();
+  const unsigned long    maxLabel = itk::NumericTraits<OutputImagePixelType>::max();
+  OutputImagePixelType * labels = outputPtr->GetBufferPointer();
+  m_ObjectCount = 0;
+  for (NodeType node = 0; node < nbPixels; ++node)
+    {
+    if (parents[node] == background)
+      {
+      labels[node] = itk::NumericTraits<OutputImagePixelType>::Zero;
+      continue;
+      }
+    const NodeType root = FindRoot(parents, node);
+    if (root == node)
+      {
+      if (m_ObjectCount == maxLabel)
+        {
+        itkExceptionMacro(<< "Number of components exceeds the maximum value of the output pixel type.");
+        }
+      labels[node] = static_cast<OutputImagePixelType>(++m_ObjectCount);
+      }
+    else
+      {
+      labels[node] = labels[root];
+      }
+    }
+
+  otbMsgDevMacro(<< m_ObjectCount << " components labeled with " << nbThreads << " threads");
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+ITK_THREAD_RETURN_TYPE
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::ThreaderCallback(void * arg)
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+  ThreadStruct * str = (ThreadStruct *) (pInfo->UserData);
+  const unsigned int threadId = pInfo->ThreadID;
+  const unsigned int nbThreads = pInfo->NumberOfThreads;
+
+  // Contiguous blocks of lines
+  const long nbLines = str->Region.GetSize()[1];
+  const long linesPerThread = (nbLines + nbThreads - 1) / nbThreads;
+  const long firstLine = threadId * linesPerThread;
+  const long endLine = std::min(firstLine + linesPerThread, nbLines);
+  if (firstLine < endLine)
+    {
+    str->Filter->LabelLines(str, threadId, firstLine, endLine);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::LabelLines(ThreadStruct * str, unsigned int threadId, long firstLine, long endLine) const
+{
+  const long             width = str->Region.GetSize()[0];
+  const IndexType        origin = str->Region.GetIndex();
+  const NodeType         background = itk::NumericTraits<NodeType>::max();
+  std::vector<NodeType>& parents = *str->Parents;
+  FunctorType&           functor = (*str->Functors)[threadId];
+  const NodeType         firstNode = firstLine * width;
+
+  // Previous neighbors in raster order: left and up, then the diagonals
+  const long         offsetsX[4] = {-1, 0, -1, 1};
+  const long         offsetsY[4] = {0, -1, -1, -1};
+  const unsigned int nbNeighbors = m_FullyConnected ? 4 : 2;
+
+  // Mask of the current line and of the previous one
+  std::vector<char> inMask(width, 1);
+  std::vector<char> previousInMask(width, 1);
+
+  std::vector<NodePairType> pairs;
+  pairs.reserve(nbNeighbors * width);
+
+  IndexType index;
+  for (long y = (firstLine > 0 ? firstLine - 1 : firstLine); y < endLine; ++y)
+    {
+    index[1] = origin[1] + y;
+    inMask.swap(previousInMask);
+    if (str->Mask)
+      {
+      for (long x = 0; x < width; ++x)
+        {
+        index[0] = origin[0] + x;
+        inMask[x] = (str->Mask->GetPixel(index) != itk::NumericTraits<MaskImagePixelType>::Zero);
+        }
+      }
+    else
+      {
+      std::fill(inMask.begin(), inMask.end(), 1);
+      }
+
+    if (y < firstLine)
+      {
+      // Line of the previous block: only its mask is needed
+      continue;
+      }
+
+    // Store the pairs of the line
+    pairs.clear();
+    for (long x = 0; x < width; ++x)
+      {
+      const NodeType node = y * width + x;
+      if (!inMask[x])
+        {
+        parents[node] = background;
+        continue;
+        }
+      parents[node] = node;
+
+      index[0] = origin[0] + x;
+      const InputImagePixelType value = str->Input->GetPixel(index);
+
+      for (unsigned int n = 0; n < nbNeighbors; ++n)
+        {
+        const long nx = x + offsetsX[n];
+        const long ny = y + offsetsY[n];
+        if (nx < 0 || nx >= width || ny < 0)
+          {
+          continue;
+          }
+        if ((ny == y && !inMask[nx]) || (ny < y && !previousInMask[nx]))
+          {
+          continue;
+          }
+
+        IndexType neighborIndex;
+        neighborIndex[0] = origin[0] + nx;
+        neighborIndex[1] = origin[1] + ny;
+        functor.SetPair(pairs.size(), value, str->Input->GetPixel(neighborIndex));
+        pairs.push_back(NodePairType(node, ny * width + nx));
+        }
+      }
+
+    // Evaluate them at once, and merge the connected pixels. The upper
+    // line of the first line of the block belongs to another thread: the
+    // pairs are kept for later.
+    const double * connected = functor.Evaluate(pairs.size());
+    for (unsigned int i = 0; i < pairs.size(); ++i)
+      {
+      if (connected[i] == 0.0)
+        {
+        continue;
+        }
+      if (pairs[i].second < firstNode)
+        {
+        str->Crossings[threadId].push_back(pairs[i]);
+        }
+      else
+        {
+        Union(parents, pairs[i].first, pairs[i].second);
+        }
+      }
+    }
+}
+
+template <class TInputImage, class TOutputImage, class TMaskImage>
+void
+ConnectedComponentMuParserImageFilter<TInputImage, TOutputImage, TMaskImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Expression: " << m_Functor.GetExpression() << std::endl;
+  os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
+  os << indent << "ObjectCount: " << m_ObjectCount << std::endl;
+}
+
+} // namespace otb
+
+#endif
@@ -22,7 +22,7 @@
 #include "otbPersistentFilterStreamingDecorator.h"
 
 #include "otbConnectedComponentMuParserFunctor.h"
-#include "itkConnectedComponentFunctorImageFilter.h"
+#include "otbConnectedComponentMuParserImageFilter.h"
 #include "otbMaskMuParserFilter.h"
 #include "itkRelabelComponentImageFilter.h"
 #include "otbAttributesMapLabelObject.h"
@@ -45,6 +45,9 @@ namespace otb {
 *  OBIA filtering and conversion to VectorData.
 *  An optional mask can be applied to segment only the pixels inside the mask.
 *
+*  The connected components of each tile are labeled by all the threads
+*  (see ConnectedComponentMuParserImageFilter).
+*
 *  Parameters of the chain are :
 *  - MaskExpression : mathematical expression to apply on the input image to make a mask
 *  - ConnectedComponentExpression : mathematical expression which connects two pixels
@@ -85,13 +88,12 @@ public:
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       TVImage::ImageDimension);
 
-  // Mask generation
-  typedef Functor::ConnectedComponentMuParserFunctor<VectorImagePixelType> FunctorType;
-  typedef itk::ConnectedComponentFunctorImageFilter<
+  // Connected components segmentation (multi-threaded)
+  typedef otb::ConnectedComponentMuParserImageFilter<
       VectorImageType,
       LabelImageType,
-      FunctorType,
       MaskImageType > ConnectedComponentFilterType;
+  typedef typename ConnectedComponentFilterType::FunctorType FunctorType;
 
   // mask typedef
   typedef otb::MaskMuParserFilter<VectorImageType, MaskImageType> MaskMuParserFilterType;
@@ -4,6 +4,8 @@ void RegisterTests()
   REGISTER_TEST(otbStreamingConnectedComponentSegmentationOBIAToVectorDataFilterNew);
   REGISTER_TEST(otbStreamingConnectedComponentSegmentationOBIAToVectorDataFilter);
   REGISTER_TEST(otbConnectedComponentMuParserFunctorTest);
+  REGISTER_TEST(otbConnectedComponentMuParserImageFilterNew);
+  REGISTER_TEST(otbConnectedComponentMuParserImageFilter);
   REGISTER_TEST(otbMeanShiftStreamingConnectedComponentSegmentationOBIAToVectorDataFilter);
   REGISTER_TEST(otbLabelObjectOpeningMuParserFilterNew);
   REGISTER_TEST(otbLabelObjectOpeningMuParserFilterTest);
@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "itkMacro.h"
+
+#include <iostream>
+#include <map>
+#include "otbVectorImage.h"
+#include "otbImage.h"
+
+#include "otbConnectedComponentMuParserFunctor.h"
+#include "otbConnectedComponentMuParserImageFilter.h"
+#include "itkConnectedComponentFunctorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "otbImageFileReader.h"
+
+typedef float InputPixelType;
+const unsigned int Dimension = 2;
+
+typedef otb::VectorImage<InputPixelType, Dimension> InputVectorImageType;
+typedef otb::Image<unsigned int, Dimension>         MaskImageType;
+typedef otb::Image<unsigned int, Dimension>         LabelImageType;
+typedef otb::ImageFileReader<InputVectorImageType>  ReaderType;
+typedef otb::ImageFileReader<MaskImageType>         MaskReaderType;
+
+typedef otb::ConnectedComponentMuParserImageFilter<InputVectorImageType, LabelImageType, MaskImageType> FilterType;
+
+typedef otb::Functor::ConnectedComponentMuParserFunctor<InputVectorImageType::PixelType> FunctorType;
+typedef itk::ConnectedComponentFunctorImageFilter
+  <InputVectorImageType, LabelImageType, FunctorType, MaskImageType> ITKFilterType;
+
+int otbConnectedComponentMuParserImageFilterNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  FilterType::Pointer filter = FilterType::New();
+  std::cout << filter << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+int otbConnectedComponentMuParserImageFilter(int argc, char * argv[])
+{
+  const char * inputFilename  = argv[1];
+  const char * expression     = argv[2];
+  const bool   fullyConnected = atoi(argv[3]) != 0;
+  const int    nbThreads      = atoi(argv[4]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFilename);
+
+  MaskReaderType::Pointer maskReader;
+  if (argc > 5)
+    {
+    maskReader = MaskReaderType::New();
+    maskReader->SetFileName(argv[5]);
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(reader->GetOutput());
+  filter->SetExpression(expression);
+  filter->SetFullyConnected(fullyConnected);
+  filter->SetNumberOfThreads(nbThreads);
+
+  ITKFilterType::Pointer reference = ITKFilterType::New();
+  reference->SetInput(reader->GetOutput());
+  reference->GetFunctor().SetExpression(expression);
+  reference->SetFullyConnected(fullyConnected);
+
+  if (maskReader.IsNotNull())
+    {
+    filter->SetMaskImage(maskReader->GetOutput());
+    reference->SetMaskImage(maskReader->GetOutput());
+    }
+
+  filter->Update();
+  reference->Update();
+
+  // Both filters must give the same partition: the labels may differ,
+  // but they must be in a one-to-one correspondence
+  std::map<LabelImageType::PixelType, LabelImageType::PixelType> labelToReference;
+  std::map<LabelImageType::PixelType, LabelImageType::PixelType> referenceToLabel;
+
+  itk::ImageRegionConstIterator<LabelImageType> it(filter->GetOutput(),
+                                                   filter->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<LabelImageType> refIt(reference->GetOutput(),
+                                                      reference->GetOutput()->GetLargestPossibleRegion());
+  for (it.GoToBegin(), refIt.GoToBegin(); !it.IsAtEnd(); ++it, ++refIt)
+    {
+    const LabelImageType::PixelType label = it.Get();
+    const LabelImageType::PixelType refLabel = refIt.Get();
+
+    if ((label == 0) != (refLabel == 0))
+      {
+      std::cerr << "Background mismatch at " << it.GetIndex() << ": " << label << " and " << refLabel << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (label == 0)
+      {
+      continue;
+      }
+
+    if (labelToReference.count(label) == 0 && referenceToLabel.count(refLabel) == 0)
+      {
+      labelToReference[label] = refLabel;
+      referenceToLabel[refLabel] = label;
+      }
+    else if (labelToReference[label] != refLabel || referenceToLabel[refLabel] != label)
+      {
+      std::cerr << "Partition mismatch at " << it.GetIndex() << ": " << label << " and " << refLabel << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << filter->GetObjectCount() << " components" << std::endl;
+  if (filter->GetObjectCount() != labelToReference.size())
+    {
+    std::cerr << "ObjectCount is " << filter->GetObjectCount() << ", " << labelToReference.size()
+              << " labels found in the output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
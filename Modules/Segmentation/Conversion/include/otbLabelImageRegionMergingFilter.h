@@ -21,8 +21,9 @@
 #include "otbImage.h"
 #include "otbVectorImage.h"
 #include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
 
-#include <set>
+#include <vector>
 
 namespace otb
 {
@@ -33,6 +34,15 @@ namespace otb
  * This class merges regions in the input label image according to the input
  * image of spectral values and the RangeBandwidth parameter.
  *
+ * The region adjacency graph is built once from the label image, by
+ * several threads, and stored in compressed sparse row form. At each
+ * iteration, adjacent regions whose modes are closer than half the
+ * RangeBandwidth are grouped with a union-find structure, and the graph
+ * is contracted without scanning the label image again. The label image
+ * is only relabelled once, at the end.
+ *
+ * Region labels are expected to be positive; the label 0 is left as is
+ * and never merged.
  *
  * \ingroup ImageSegmentation
  *
@@ -70,6 +80,7 @@ public:
 
   typedef TInputSpectralImage                     InputSpectralImageType;
   typedef typename TInputSpectralImage::PixelType SpectralPixelType;
+  typedef typename itk::NumericTraits<SpectralPixelType>::ValueType SpectralValueType;
 
   typedef TOutputLabelImage                        OutputLabelImageType;
   typedef typename OutputLabelImageType::PixelType OutputLabelType;
@@ -83,10 +94,13 @@ public:
 
   itkStaticConstMacro(ImageDimension, unsigned int, InputLabelImageType::ImageDimension);
 
-  /** Typedefs for region adjacency map */
   typedef InputLabelType      LabelType;
-  typedef std::set<LabelType> AdjacentLabelsContainerType;
-  typedef std::vector<AdjacentLabelsContainerType> RegionAdjacencyMapType;
+
+  /** Typedefs for the compressed sparse row region adjacency graph:
+   * the neighbours of region i are m_Neighbors[m_Offsets[i]] to
+   * m_Neighbors[m_Offsets[i+1]-1], in increasing order */
+  typedef std::pair<LabelType, LabelType> EdgeType;
+  typedef std::vector<EdgeType>           EdgeListType;
 
 
   /** Setters / Getters */
@@ -127,23 +141,54 @@ protected:
   /** PrintSelf method */
   virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
-  /** Method to build a map of adjacent regions */
-  RegionAdjacencyMapType LabelImageToRegionAdjacencyMap(typename OutputLabelImageType::Pointer inputLabelImage);
+  /** Static function used as a "callback" by the MultiThreader to
+   * compute the point counts, the first pixel and the adjacency of
+   * each label on a piece of the label image */
+  static ITK_THREAD_RETURN_TYPE AdjacencyThreaderCallback(void * arg);
 
 private:
   LabelImageRegionMergingFilter(const Self &);     //purposely not implemented
   void operator =(const Self&);             //purposely not implemented
 
+  /** Data shared by the adjacency threads */
+  struct AdjacencyThreadStruct
+  {
+    Self *                                             Filter;
+    const InputLabelImageType *                        LabelImage;
+    RegionType                                         Region;
+    std::vector<std::vector<unsigned int> >            PointCounts;
+    std::vector<std::vector<std::pair<LabelType, InputIndexType> > > FirstPixels;
+    std::vector<EdgeListType>                          Edges;
+  };
+
+  /** Sort the edges and remove the duplicates */
+  static void SortAndUniqueEdges(EdgeListType& edges);
+
+  /** Build the compressed sparse row graph of regions 0 to regionCount */
+  void BuildAdjacencyGraph(const EdgeListType& edges, unsigned int regionCount);
+
+  /** Union-find root, with path compression */
+  LabelType FindRoot(LabelType label);
+
+  /** Union-find union by rank */
+  void UnionRegions(LabelType label1, LabelType label2);
+
   /** Range bandwidth */
   RealType                       m_RangeBandwidth;
   /** Number of components per pixel in the input image */
   unsigned int                   m_NumberOfComponentsPerPixel;
   /** This contains the label to which each label will be merged */
   std::vector<LabelType>         m_CanonicalLabels;
-  /** Contains the spectral value for each region */
-  std::vector<SpectralPixelType> m_Modes;
+  /** Union-find ranks */
+  std::vector<unsigned char>     m_Ranks;
+  /** Contains the spectral value for each region, m_NumberOfComponentsPerPixel values per region */
+  std::vector<SpectralValueType> m_Modes;
   /** Number of points in each region */
   std::vector<unsigned int>      m_PointCounts;
+  /** Region adjacency graph offsets */
+  std::vector<unsigned long>     m_Offsets;
+  /** Region adjacency graph neighbours */
+  std::vector<LabelType>         m_Neighbors;
 };
 
 } // end namespace otb
@@ -23,6 +23,9 @@
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include "itkMultiThreader.h"
+
+#include <algorithm>
 
 
 namespace otb
@@ -178,310 +181,404 @@ LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabe
   outputClusteredImage->Allocate();
 
   m_NumberOfComponentsPerPixel = spectralImage->GetNumberOfComponentsPerPixel();
+  const unsigned int nbComp = m_NumberOfComponentsPerPixel;
 
-  //std::cout << "Copy input label image to output label image" << std::endl;
-  // Copy input label image to output label image
-  typename itk::ImageRegionConstIterator<InputLabelImageType> inputIt(inputLabelImage, outputLabelImage->GetRequestedRegion());
-  typename itk::ImageRegionIterator<OutputLabelImageType> outputIt(outputLabelImage, outputLabelImage->GetRequestedRegion());
-  inputIt.GoToBegin();
-  outputIt.GoToBegin();
-  while(!inputIt.IsAtEnd())
+  // Find the maximum label value
+  itk::ImageRegionConstIterator<InputLabelImageType> inputIt(inputLabelImage, outputLabelImage->GetRequestedRegion());
+  LabelType maxLabel = 0;
+  for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt)
     {
-    outputIt.Set(inputIt.Get());
-    ++inputIt;
-    ++outputIt;
+    maxLabel = vcl_max(maxLabel, inputIt.Get());
     }
+  unsigned int regionCount = maxLabel;
+
+  // Point counts, first pixel and adjacency of each label, computed
+  // by several threads
+  AdjacencyThreadStruct str;
+  str.Filter = this;
+  str.LabelImage = inputLabelImage;
+  str.Region = outputLabelImage->GetRequestedRegion();
+
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+  str.PointCounts.resize(numberOfThreads);
+  str.FirstPixels.resize(numberOfThreads);
+  str.Edges.resize(numberOfThreads);
 
-  RegionAdjacencyMapType regionAdjacencyMap = LabelImageToRegionAdjacencyMap(outputLabelImage);
-  unsigned int regionCount = regionAdjacencyMap.size() - 1;
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->AdjacencyThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
 
   // Initialize arrays for mode information
-  m_CanonicalLabels.clear();
-  m_CanonicalLabels.resize(regionCount+1);
+  m_PointCounts.assign(regionCount+1, 0);
+  m_Modes.assign((regionCount+1)*nbComp, itk::NumericTraits<SpectralValueType>::Zero);
 
-  m_Modes.clear();
-  m_Modes.reserve(regionCount+1);
-  for(unsigned int i = 0; i < regionCount+1; ++i)
+  EdgeListType edges;
+  for (unsigned int threadId = 0; threadId < numberOfThreads; ++threadId)
     {
-    m_Modes.push_back( SpectralPixelType(m_NumberOfComponentsPerPixel) );
-    }
+    const std::vector<unsigned int>& counts = str.PointCounts[threadId];
+    for (unsigned int label = 0; label < counts.size(); ++label)
+      {
+      m_PointCounts[label] += counts[label];
+      }
 
-  m_PointCounts.clear();
-  m_PointCounts.resize(regionCount+1); // = std::vector<unsigned int>(regionCount+1);
+    // Pieces follow the order of the image lines, so that the mode of
+    // a label is the value of its first pixel in the first piece
+    for (unsigned int i = 0; i < str.FirstPixels[threadId].size(); ++i)
+      {
+      const LabelType label = str.FirstPixels[threadId][i].first;
+      if (m_PointCounts[label] == counts[label])
+        {
+        const SpectralPixelType& pixel = spectralImage->GetPixel(str.FirstPixels[threadId][i].second);
+        for (unsigned int comp = 0; comp < nbComp; ++comp)
+          {
+          m_Modes[label*nbComp+comp] = pixel[comp];
+          }
+        }
+      }
 
+    edges.insert(edges.end(), str.Edges[threadId].begin(), str.Edges[threadId].end());
+    str.PointCounts[threadId].clear();
+    str.FirstPixels[threadId].clear();
+    str.Edges[threadId].clear();
+    }
+  SortAndUniqueEdges(edges);
+  this->BuildAdjacencyGraph(edges, regionCount);
 
-  // Associate each label to a spectral value, a canonical label and a point count
-  typename itk::ImageRegionConstIterator<InputLabelImageType> inputItWithIndex(inputLabelImage, outputLabelImage->GetRequestedRegion());
-  inputItWithIndex.GoToBegin();
-  while(!inputItWithIndex.IsAtEnd())
+  // Current label of each input label
+  std::vector<LabelType> labelMap(maxLabel+1);
+  for (unsigned int i = 0; i < maxLabel+1; ++i)
     {
-    LabelType label = inputItWithIndex.Get();
-    // if label has not been initialized yet ..
-    if(m_PointCounts[label] == 0)
-      {
-     // m_CanonicalLabels[label] = label;
-      m_Modes[label] = spectralImage->GetPixel(inputItWithIndex.GetIndex());
-      }
-    m_PointCounts[label]++;
-    ++inputItWithIndex;
+    labelMap[i] = i;
     }
-  // Region Merging
 
+  // Region Merging
   bool finishedMerging = false;
   unsigned int mergeIterations = 0;
 
-  //std::cout << "Start merging" << std::endl;
+  std::vector<SpectralValueType> newModes;
+  std::vector<unsigned int>      newPointCounts;
+  std::vector<LabelType>         newLabels;
+  std::vector<LabelType>         groupLabels;
+
   // Iterate until no more merge to do
- // while(!finishedMerging)
- //   {
-    while(!finishedMerging)
+  while(!finishedMerging)
+    {
+    // Initialize Canonical Labels
+    m_CanonicalLabels.resize(regionCount+1);
+    m_Ranks.assign(regionCount+1, 0);
+    for(LabelType curLabel = 0; curLabel <= regionCount; ++curLabel)
       {
-
-      // Initialize Canonical Labels
-      for(LabelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-        m_CanonicalLabels[curLabel] = curLabel;
+      m_CanonicalLabels[curLabel] = curLabel;
+      }
 
     // Iterate over all regions
-
-      for(LabelType curLabel = 1; curLabel <= regionCount; ++curLabel)
+    for(LabelType curLabel = 1; curLabel <= regionCount; ++curLabel)
       {
-
       if(m_PointCounts[curLabel] == 0)
         {
         // do not process empty regions
         continue;
         }
-     // std::cout<<" point in label "<<curLabel<<" "<<m_PointCounts[curLabel]<<std::endl;
-      const SpectralPixelType & curSpectral = m_Modes[curLabel];
+      const SpectralValueType * curSpectral = &m_Modes[curLabel*nbComp];
 
       // Iterate over all adjacent regions and check for merge
-      typename AdjacentLabelsContainerType::const_iterator adjIt = regionAdjacencyMap[curLabel].begin();
-      while (adjIt != regionAdjacencyMap[curLabel].end())
+      for (unsigned long k = m_Offsets[curLabel]; k < m_Offsets[curLabel+1]; ++k)
         {
-        LabelType adjLabel = *adjIt;
-        assert(adjLabel <= regionCount);
-        const SpectralPixelType & adjSpectral = m_Modes[adjLabel];
+        const LabelType adjLabel = m_Neighbors[k];
+        const SpectralValueType * adjSpectral = &m_Modes[adjLabel*nbComp];
+
         // Check condition to merge regions
-        bool isSimilar = true;
         RealType norm2 = 0;
-         for(unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+        for(unsigned int comp = 0; comp < nbComp; ++comp)
           {
           RealType e;
           e = (curSpectral[comp] - adjSpectral[comp]) / m_RangeBandwidth;
           norm2 += e*e;
           }
-        isSimilar = norm2 < 0.25;
 
-        if(isSimilar)
+        if(norm2 < 0.25)
           {
-          // Find canonical label for current region
-          LabelType curCanLabel = curLabel; //m_CanonicalLabels[curLabel];
-          while(m_CanonicalLabels[curCanLabel] != curCanLabel)
-            {
-            curCanLabel = m_CanonicalLabels[curCanLabel];
-            }
-
-          // Find canonical label for adjacent region
-          LabelType adjCanLabel = adjLabel; //m_CanonicalLabels[curLabel];
-          while(m_CanonicalLabels[adjCanLabel] != adjCanLabel)
-            {
-            adjCanLabel = m_CanonicalLabels[adjCanLabel];
-            }
-
-          // Assign same canonical label to both regions
-          if(curCanLabel < adjCanLabel)
-            {
-            m_CanonicalLabels[adjCanLabel] = curCanLabel;
-            }
-          else
-            {
-            m_CanonicalLabels[m_CanonicalLabels[curCanLabel]] = adjCanLabel;
-            m_CanonicalLabels[curCanLabel] = adjCanLabel;
-            }
+          this->UnionRegions(curLabel, adjLabel);
           }
-        ++adjIt;
         } // end of loop over adjacent labels
       } // end of loop over labels
 
-    //std::cout << "Simplify the table of canonical labels" << std::endl;
-    /* Simplify the table of canonical labels */
-    for(LabelType i = 1; i < regionCount+1; ++i)
-      {
-      LabelType can = i;
-      while(m_CanonicalLabels[can] != can)
-        {
-        can = m_CanonicalLabels[can];
-        }
-      m_CanonicalLabels[i] = can;
-      }
-
-    //std::cout << "merge regions with same canonical label" << std::endl;
     /* Merge regions with same canonical label */
     /* - update modes and point counts */
-    std::vector<SpectralPixelType> newModes;
-    newModes.reserve(regionCount+1); //(regionCount+1, SpectralPixelType(m_NumberOfComponentsPerPixel));
-    for(unsigned int i = 0; i < regionCount+1; ++i)
-      {
-      newModes.push_back( SpectralPixelType(m_NumberOfComponentsPerPixel) );
-      }
-    std::vector<unsigned int> newPointCounts(regionCount+1);
-
-    for(unsigned int i = 1; i < regionCount+1; ++i)
-      {
-      newModes[i].Fill(0);
-      newPointCounts[i] = 0;
-      }
+    newModes.assign((regionCount+1)*nbComp, itk::NumericTraits<SpectralValueType>::Zero);
+    newPointCounts.assign(regionCount+1, 0);
 
     for(unsigned int i = 1; i < regionCount+1; ++i)
       {
-      LabelType canLabel = m_CanonicalLabels[i];
+      LabelType canLabel = this->FindRoot(i);
       unsigned int nPoints = m_PointCounts[i];
-      for(unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+      for(unsigned int comp = 0; comp < nbComp; ++comp)
         {
-        newModes[canLabel][comp] += nPoints * m_Modes[i][comp];
+        newModes[canLabel*nbComp+comp] += nPoints * m_Modes[i*nbComp+comp];
         }
       newPointCounts[canLabel] += nPoints;
       }
 
-    //std::cout << "re-labeling" << std::endl;
-    /* re-labeling */
-    std::vector<LabelType> newLabels(regionCount+1);
-    std::vector<bool> newLabelSet(regionCount+1);
-    for(unsigned int i = 1; i < regionCount+1; ++i)
-      {
-      newLabelSet[i] = false;
-      }
+    /* re-labeling, in the order of the lowest label of each group */
+    newLabels.assign(regionCount+1, 0);
+    groupLabels.assign(regionCount+1, 0);
 
     LabelType label = 0;
     for(unsigned int i = 1; i < regionCount+1; ++i)
       {
-      LabelType canLabel = m_CanonicalLabels[i];
-      if(newLabelSet[canLabel] == false)
+      LabelType canLabel = this->FindRoot(i);
+      if(groupLabels[canLabel] == 0)
         {
-        newLabelSet[canLabel] = true;
         label++;
-        newLabels[canLabel] = label;
+        groupLabels[canLabel] = label;
         unsigned int nPoints = newPointCounts[canLabel];
-        for(unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+        for(unsigned int comp = 0; comp < nbComp; ++comp)
           {
-          m_Modes[label][comp] = newModes[canLabel][comp] / nPoints;
+          m_Modes[label*nbComp+comp] = newModes[canLabel*nbComp+comp] / nPoints;
           }
 
         m_PointCounts[label] = newPointCounts[canLabel];
         }
+      newLabels[i] = groupLabels[canLabel];
       }
 
     unsigned int oldRegionCount = regionCount;
     regionCount = label;
 
-    /* reassign labels in label image */
-    outputIt.GoToBegin();
-    while(!outputIt.IsAtEnd())
+    for (unsigned int i = 1; i < maxLabel+1; ++i)
       {
-
-      LabelType l = outputIt.Get();
-      LabelType canLabel;
-      assert(m_CanonicalLabels[l] <= oldRegionCount);
-      canLabel = newLabels[m_CanonicalLabels[l]];
-      outputIt.Set( canLabel );
-
-      ++outputIt;
+      labelMap[i] = newLabels[labelMap[i]];
       }
 
     finishedMerging = oldRegionCount == regionCount || mergeIterations >= 10 || regionCount == 1;
 
-    // only one iteration for now
-
     if(!finishedMerging)
       {
-      /* Update adjacency table */
-      regionAdjacencyMap = LabelImageToRegionAdjacencyMap(outputLabelImage);
+      /* Update adjacency graph, by contraction of the previous one */
+      edges.clear();
+      for (LabelType curLabel = 1; curLabel <= oldRegionCount; ++curLabel)
+        {
+        for (unsigned long k = m_Offsets[curLabel]; k < m_Offsets[curLabel+1]; ++k)
+          {
+          const LabelType adjLabel = m_Neighbors[k];
+          if (curLabel < adjLabel && newLabels[curLabel] != newLabels[adjLabel])
+            {
+            edges.push_back(EdgeType(vcl_min(newLabels[curLabel], newLabels[adjLabel]),
+                                     vcl_max(newLabels[curLabel], newLabels[adjLabel])));
+            }
+          }
+        }
+      SortAndUniqueEdges(edges);
+      this->BuildAdjacencyGraph(edges, regionCount);
       }
 
     mergeIterations++;
     } // end of main iteration loop
-  // std::cout << "merge iterations: " << mergeIterations << std::endl;
-  // std::cout << "number of label objects: " << regionCount << std::endl;
 
-  // Generate clustered output
+  // Generate the label and clustered outputs
+  itk::ImageRegionIterator<OutputLabelImageType> outputIt(outputLabelImage, outputLabelImage->GetRequestedRegion());
   itk::ImageRegionIterator<OutputClusteredImageType> outputClusteredIt(outputClusteredImage, outputClusteredImage->GetRequestedRegion() );
-  outputClusteredIt.GoToBegin();
-  outputIt.GoToBegin();
-  while( !outputClusteredIt.IsAtEnd() )
+  typename OutputClusteredImageType::PixelType p(nbComp);
+
+  for (inputIt.GoToBegin(), outputIt.GoToBegin(), outputClusteredIt.GoToBegin();
+       !outputIt.IsAtEnd(); ++inputIt, ++outputIt, ++outputClusteredIt)
     {
-    LabelType label = outputIt.Get();
-    const SpectralPixelType & p = m_Modes[ label ];
+    LabelType label = labelMap[inputIt.Get()];
+    outputIt.Set(static_cast<OutputLabelType>(label));
+    for(unsigned int comp = 0; comp < nbComp; ++comp)
+      {
+      p[comp] = m_Modes[label*nbComp+comp];
+      }
     outputClusteredIt.Set(p);
-    ++outputClusteredIt;
-    ++outputIt;
     }
+
+  // Free the graph memory
+  std::vector<unsigned long>().swap(m_Offsets);
+  std::vector<LabelType>().swap(m_Neighbors);
 }
 
 template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
-void
+ITK_THREAD_RETURN_TYPE
 LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
-::PrintSelf(std::ostream& os, itk::Indent indent) const
+::AdjacencyThreaderCallback(void * arg)
 {
-  Superclass::PrintSelf(os, indent);
-  os << indent << "Range bandwidth: "                  << m_RangeBandwidth                 << std::endl;
-}
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo = (itk::MultiThreader::ThreadInfoStruct *) (arg);
+  AdjacencyThreadStruct * str = (AdjacencyThreadStruct *) (pInfo->UserData);
+  const unsigned int threadId = pInfo->ThreadID;
 
+  RegionType splitRegion;
+  const unsigned int total = str->Filter->SplitRequestedRegion(threadId, pInfo->NumberOfThreads, splitRegion);
+  if (threadId >= total)
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
 
-template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
-typename LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>::RegionAdjacencyMapType
-LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
-::LabelImageToRegionAdjacencyMap(typename OutputLabelImageType::Pointer  labelImage)
-{
-  // declare the output map
-  RegionAdjacencyMapType ram;
+  const InputLabelImageType * labelImage = str->LabelImage;
 
-  // Find the maximum label value
-  itk::ImageRegionConstIterator<OutputLabelImageType> it(labelImage, labelImage->GetRequestedRegion());
-  it.GoToBegin();
-  LabelType maxLabel = 0;
-  while(!it.IsAtEnd())
+  // Right and bottom neighbours only exist before the end of the region
+  InputIndexType endIndex = str->Region.GetIndex();
+  for (unsigned int d = 0; d < ImageDimension; ++d)
     {
-    LabelType label = it.Get();
-    maxLabel = vcl_max(maxLabel, label);
-    ++it;
+    endIndex[d] += str->Region.GetSize()[d];
     }
 
-  // Set the size of the adjacency map
-  ram.resize(maxLabel+1);
+  std::vector<unsigned int>&                          counts = str->PointCounts[threadId];
+  std::vector<std::pair<LabelType, InputIndexType> >& firstPixels = str->FirstPixels[threadId];
+  EdgeListType&                                       edges = str->Edges[threadId];
 
-  // set the image region without bottom and right borders so that bottom and
-  // right neighbors always exist
-  RegionType regionWithoutBottomRightBorders  = labelImage->GetRequestedRegion();
-  SizeType size = regionWithoutBottomRightBorders.GetSize();
-  for(unsigned int d = 0; d < ImageDimension; ++d) size[d] -= 1;
-  regionWithoutBottomRightBorders.SetSize(size);
-  itk::ImageRegionConstIteratorWithIndex<OutputLabelImageType> inputIt(labelImage, regionWithoutBottomRightBorders);
+  // Duplicated edges are removed from time to time, to bound the memory.
+  // The threshold grows with the number of distinct edges, so that the
+  // compaction cost stays proportional to the number of pixels
+  unsigned long maxEdges = 1 << 20;
 
-  inputIt.GoToBegin();
-  while(!inputIt.IsAtEnd())
+  itk::ImageRegionConstIteratorWithIndex<InputLabelImageType> it(labelImage, splitRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
     {
-    const InputIndexType & index = inputIt.GetIndex();
-    LabelType label = inputIt.Get();
+    const LabelType label = it.Get();
+    const InputIndexType & index = it.GetIndex();
+
+    if (label >= counts.size())
+      {
+      counts.resize(label+1, 0);
+      }
+    if (counts[label]++ == 0)
+      {
+      firstPixels.push_back(std::make_pair(label, index));
+      }
+
+    if (label == 0)
+      {
+      continue;
+      }
 
     // check neighbors
-    for(unsigned int d = 0; d < ImageDimension; ++d)
+    for (unsigned int d = 0; d < ImageDimension; ++d)
       {
+      if (index[d] + 1 >= endIndex[d])
+        {
+        continue;
+        }
       InputIndexType neighborIndex = index;
       neighborIndex[d]++;
 
-      LabelType neighborLabel = labelImage->GetPixel(neighborIndex);
+      const LabelType neighborLabel = labelImage->GetPixel(neighborIndex);
 
       // add adjacency if different labels
-      if(neighborLabel != label)
+      if (neighborLabel != label && neighborLabel != 0)
         {
-        ram[label].insert(neighborLabel);
-        ram[neighborLabel].insert(label);
+        const EdgeType edge(vcl_min(label, neighborLabel), vcl_max(label, neighborLabel));
+        if (edges.empty() || edges.back() != edge)
+          {
+          edges.push_back(edge);
+          }
         }
       }
-    ++inputIt;
+
+    if (edges.size() >= maxEdges)
+      {
+      SortAndUniqueEdges(edges);
+      maxEdges = vcl_max(maxEdges, static_cast<unsigned long>(2 * edges.size()));
+      }
+    }
+
+  SortAndUniqueEdges(edges);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
+void
+LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
+::SortAndUniqueEdges(EdgeListType& edges)
+{
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
+void
+LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
+::BuildAdjacencyGraph(const EdgeListType& edges, unsigned int regionCount)
+{
+  // Number of neighbours of each region
+  m_Offsets.assign(regionCount+2, 0);
+  for (typename EdgeListType::const_iterator it = edges.begin(); it != edges.end(); ++it)
+    {
+    ++m_Offsets[it->first+1];
+    ++m_Offsets[it->second+1];
+    }
+  for (unsigned int i = 1; i < regionCount+2; ++i)
+    {
+    m_Offsets[i] += m_Offsets[i-1];
     }
 
-  return ram;
+  // Edges are sorted, so that the neighbours of each region are sorted too
+  m_Neighbors.resize(m_Offsets[regionCount+1]);
+  std::vector<unsigned long> positions(m_Offsets.begin(), m_Offsets.end()-1);
+  for (typename EdgeListType::const_iterator it = edges.begin(); it != edges.end(); ++it)
+    {
+    m_Neighbors[positions[it->second]++] = it->first;
+    }
+  for (typename EdgeListType::const_iterator it = edges.begin(); it != edges.end(); ++it)
+    {
+    m_Neighbors[positions[it->first]++] = it->second;
+    }
+}
+
+template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
+typename LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>::LabelType
+LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
+::FindRoot(LabelType label)
+{
+  LabelType root = label;
+  while (m_CanonicalLabels[root] != root)
+    {
+    root = m_CanonicalLabels[root];
+    }
+  // Path compression
+  while (m_CanonicalLabels[label] != root)
+    {
+    LabelType next = m_CanonicalLabels[label];
+    m_CanonicalLabels[label] = root;
+    label = next;
+    }
+  return root;
+}
+
+template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
+void
+LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
+::UnionRegions(LabelType label1, LabelType label2)
+{
+  LabelType root1 = this->FindRoot(label1);
+  LabelType root2 = this->FindRoot(label2);
+  if (root1 == root2)
+    {
+    return;
+    }
+  // Union by rank
+  if (m_Ranks[root1] < m_Ranks[root2])
+    {
+    m_CanonicalLabels[root1] = root2;
+    }
+  else if (m_Ranks[root1] > m_Ranks[root2])
+    {
+    m_CanonicalLabels[root2] = root1;
+    }
+  else
+    {
+    m_CanonicalLabels[root2] = root1;
+    ++m_Ranks[root1];
+    }
+}
+
+template <class TInputLabelImage, class TInputSpectralImage, class TOutputLabelImage, class TOutputClusteredImage>
+void
+LabelImageRegionMergingFilter<TInputLabelImage, TInputSpectralImage, TOutputLabelImage, TOutputClusteredImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Range bandwidth: "                  << m_RangeBandwidth                 << std::endl;
 }
 
 } // end namespace otb
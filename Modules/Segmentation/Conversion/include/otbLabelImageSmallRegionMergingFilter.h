@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbLabelImageSmallRegionMergingFilter_h
+#define __otbLabelImageSmallRegionMergingFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentLabelImageSmallRegionMergingFilter
+ * \brief Merge the small regions of a label image with their
+ * radiometrically closest neighbour.
+ *
+ * While the label image and the spectral image are streamed through
+ * this filter, the region adjacency graph and the size and sum of the
+ * spectral values of each region are accumulated. The requested region
+ * of the label image is padded by one pixel on its right and bottom
+ * sides, so that the adjacency between two pieces is only seen once,
+ * and the graph does not depend on the streaming.
+ *
+ * When the streaming is over, Synthetize() merges the regions smaller
+ * than MinSize, in memory, by increasing size: first all regions of 1
+ * pixel are merged with the adjacent region with the closest mean, then
+ * all regions of 2 pixels, and so on until MinSize. The decisions for a
+ * given size are taken with the region means and adjacency available
+ * before any merging of this size. Small regions are ordered in a
+ * priority queue, and merged regions are tracked with a union-find
+ * structure, each group of regions being labelled with its lowest
+ * label. The distance between a region and a neighbour is the squared
+ * difference between the mean of the region and the mean of the
+ * neighbour truncated to integers. This is the merging order of the
+ * former tile-by-tile implementation of LSMSSmallRegionsMerging.
+ *
+ * The result is a look-up table giving the new label of each merged
+ * label (GetLUT()), which can be applied with an
+ * itk::ChangeLabelImageFilter in a second streaming pass.
+ *
+ * This filter only works on 2D images.
+ *
+ * \sa LabelImageSmallRegionMergingFilter
+ * \sa LabelImageRegionPruningFilter
+ * \ingroup ImageSegmentation
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBConversion
+ */
+template <class TInputLabelImage, class TInputSpectralImage>
+class ITK_EXPORT PersistentLabelImageSmallRegionMergingFilter
+  : public PersistentImageFilter<TInputLabelImage, TInputLabelImage>
+{
+public:
+  /** Standard class typedef */
+  typedef PersistentLabelImageSmallRegionMergingFilter              Self;
+  typedef PersistentImageFilter<TInputLabelImage, TInputLabelImage> Superclass;
+  typedef itk::SmartPointer<Self>                                   Pointer;
+  typedef itk::SmartPointer<const Self>                             ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+  itkTypeMacro(PersistentLabelImageSmallRegionMergingFilter, PersistentImageFilter);
+
+  /** Template parameters typedefs */
+  typedef TInputLabelImage                         InputLabelImageType;
+  typedef typename InputLabelImageType::PixelType  LabelType;
+  typedef typename InputLabelImageType::RegionType RegionType;
+  typedef typename InputLabelImageType::IndexType  IndexType;
+  typedef typename InputLabelImageType::SizeType   SizeType;
+
+  typedef TInputSpectralImage                      InputSpectralImageType;
+
+  typedef double RealType;
+
+  /** Look-up table from the merged labels to their new label */
+  typedef std::map<LabelType, LabelType> LUTType;
+
+  /** Size and sum of the spectral values of a region */
+  struct RegionStatistics
+  {
+    RegionStatistics() : m_Count(0) {}
+    unsigned long         m_Count;
+    std::vector<RealType> m_Sum;
+  };
+
+  typedef std::map<LabelType, RegionStatistics>     RegionStatisticsMapType;
+  typedef std::set<std::pair<LabelType, LabelType> > EdgeSetType;
+
+  /** Regions smaller than this size (in pixels) are merged */
+  itkSetMacro(MinSize, unsigned int);
+  itkGetConstMacro(MinSize, unsigned int);
+
+  /** Sets the input image where the value of a pixel is the region id */
+  void SetInputLabelImage(const InputLabelImageType * labelImage);
+  /** Sets the input image representing spectral values */
+  void SetInputSpectralImage(const InputSpectralImageType * spectralImage);
+  /** Returns input label image */
+  const InputLabelImageType * GetInputLabelImage();
+  /** Returns input spectral image */
+  const InputSpectralImageType * GetInputSpectralImage();
+
+  /** Returns the look-up table computed by Synthetize() */
+  const LUTType& GetLUT() const
+  {
+    return m_LUT;
+  }
+
+  /** Returns the number of regions in the input label image */
+  itkGetConstMacro(NumberOfRegions, unsigned long);
+  /** Returns the number of regions after merging */
+  itkGetConstMacro(NumberOfMergedRegions, unsigned long);
+
+  virtual void AllocateOutputs();
+  virtual void GenerateOutputInformation();
+  virtual void GenerateInputRequestedRegion();
+  virtual void Reset(void);
+  virtual void Synthetize(void);
+
+protected:
+  PersistentLabelImageSmallRegionMergingFilter();
+  virtual ~PersistentLabelImageSmallRegionMergingFilter() {}
+  virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Accumulate the region statistics and adjacency of a piece */
+  virtual void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+private:
+  PersistentLabelImageSmallRegionMergingFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** Merge the small regions, once the statistics and adjacency of
+   *  the whole image are known */
+  void MergeSmallRegions(const std::vector<LabelType>& labels,
+                         std::vector<RegionStatistics>& statistics,
+                         std::vector<std::set<unsigned long> >& adjacency);
+
+  /** Squared distance between the mean of r1 and the integer part of the mean of r2 */
+  static RealType MeanDistance(const RegionStatistics& r1, const RegionStatistics& r2);
+
+  /** Union-find root, with path compression */
+  static unsigned long FindRoot(std::vector<unsigned long>& parents, unsigned long node);
+
+  unsigned int  m_MinSize;
+  unsigned int  m_NumberOfComponentsPerPixel;
+  unsigned long m_NumberOfRegions;
+  unsigned long m_NumberOfMergedRegions;
+
+  /** Per thread statistics and adjacency */
+  std::vector<RegionStatisticsMapType> m_ThreadStatistics;
+  std::vector<EdgeSetType>             m_ThreadEdges;
+
+  LUTType m_LUT;
+};
+
+/** \class LabelImageSmallRegionMergingFilter
+ * \brief Merge the small regions of a large label image with their
+ * radiometrically closest neighbour, using streaming.
+ *
+ * This filter reads its inputs once, piece by piece, through a
+ * PersistentLabelImageSmallRegionMergingFilter. The resulting LUT can
+ * then be applied to the label image:
+ *
+ * \code
+ * merging->SetInputLabelImage(labelImage);
+ * merging->SetInputSpectralImage(image);
+ * merging->SetMinSize(50);
+ * merging->Update();
+ *
+ * changeLabel->SetInput(labelImage);
+ * changeLabel->SetChangeMap(merging->GetLUT());
+ * \endcode
+ *
+ * \sa PersistentLabelImageSmallRegionMergingFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \ingroup ImageSegmentation
+ * \ingroup Streamed
+ *
+ * \ingroup OTBConversion
+ */
+template <class TInputLabelImage, class TInputSpectralImage>
+class ITK_EXPORT LabelImageSmallRegionMergingFilter :
+  public PersistentFilterStreamingDecorator<
+    PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage> >
+{
+public:
+  /** Standard Self typedef */
+  typedef LabelImageSmallRegionMergingFilter Self;
+  typedef PersistentFilterStreamingDecorator
+  <PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage> > Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(LabelImageSmallRegionMergingFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputLabelImage                                 InputLabelImageType;
+  typedef TInputSpectralImage                              InputSpectralImageType;
+  typedef typename Superclass::FilterType::LUTType         LUTType;
+
+  void SetInputLabelImage(const InputLabelImageType * labelImage)
+  {
+    this->GetFilter()->SetInputLabelImage(labelImage);
+  }
+  void SetInputSpectralImage(const InputSpectralImageType * spectralImage)
+  {
+    this->GetFilter()->SetInputSpectralImage(spectralImage);
+  }
+
+  void SetMinSize(unsigned int minSize)
+  {
+    this->GetFilter()->SetMinSize(minSize);
+  }
+  unsigned int GetMinSize() const
+  {
+    return this->GetFilter()->GetMinSize();
+  }
+
+  /** Returns the look-up table from the merged labels to their new label */
+  const LUTType& GetLUT() const
+  {
+    return this->GetFilter()->GetLUT();
+  }
+
+protected:
+  /** Constructor */
+  LabelImageSmallRegionMergingFilter() {}
+  /** Destructor */
+  virtual ~LabelImageSmallRegionMergingFilter() {}
+
+private:
+  LabelImageSmallRegionMergingFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLabelImageSmallRegionMergingFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,490 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbLabelImageSmallRegionMergingFilter_txx
+#define __otbLabelImageSmallRegionMergingFilter_txx
+
+#include "otbLabelImageSmallRegionMergingFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "otbMacro.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace otb
+{
+
+template <class TInputLabelImage, class TInputSpectralImage>
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::PersistentLabelImageSmallRegionMergingFilter()
+  : m_MinSize(1),
+    m_NumberOfComponentsPerPixel(0),
+    m_NumberOfRegions(0),
+    m_NumberOfMergedRegions(0)
+{
+  this->SetNumberOfRequiredInputs(2);
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::SetInputLabelImage(const TInputLabelImage * labelImage)
+{
+  // Process object is not const-correct so the const casting is required.
+  this->SetNthInput(0, const_cast<TInputLabelImage *>(labelImage));
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::SetInputSpectralImage(const TInputSpectralImage * spectralImage)
+{
+  // Process object is not const-correct so the const casting is required.
+  this->SetNthInput(1, const_cast<TInputSpectralImage *>(spectralImage));
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+const TInputLabelImage *
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::GetInputLabelImage()
+{
+  return dynamic_cast<const TInputLabelImage *>(itk::ProcessObject::GetInput(0));
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+const TInputSpectralImage *
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::GetInputSpectralImage()
+{
+  return dynamic_cast<const TInputSpectralImage *>(itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+    {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+      {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+      }
+    }
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputLabelImageType * labelImage = const_cast<InputLabelImageType *>(this->GetInputLabelImage());
+  if (!labelImage)
+    {
+    return;
+    }
+
+  // Pad the label region by one pixel on the right and bottom sides,
+  // to see the adjacency with the next pieces
+  RegionType region = this->GetOutput()->GetRequestedRegion();
+  SizeType   size = region.GetSize();
+  for (unsigned int dim = 0; dim < InputLabelImageType::ImageDimension; ++dim)
+    {
+    size[dim] += 1;
+    }
+  region.SetSize(size);
+  region.Crop(labelImage->GetLargestPossibleRegion());
+
+  labelImage->SetRequestedRegion(region);
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used.
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::Reset()
+{
+  InputLabelImageType * labelImage = const_cast<InputLabelImageType *>(this->GetInputLabelImage());
+  InputSpectralImageType * spectralImage = const_cast<InputSpectralImageType *>(this->GetInputSpectralImage());
+
+  if (!labelImage || !spectralImage)
+    {
+    itkExceptionMacro(<< "Both the label image and the spectral image must be set");
+    }
+
+  labelImage->UpdateOutputInformation();
+  spectralImage->UpdateOutputInformation();
+
+  if (labelImage->GetLargestPossibleRegion() != spectralImage->GetLargestPossibleRegion())
+    {
+    itkExceptionMacro(<< "The label image region " << labelImage->GetLargestPossibleRegion()
+                      << " and the spectral image region " << spectralImage->GetLargestPossibleRegion()
+                      << " differ");
+    }
+
+  m_NumberOfComponentsPerPixel = spectralImage->GetNumberOfComponentsPerPixel();
+
+  unsigned int numberOfThreads = this->GetNumberOfThreads();
+  m_ThreadStatistics.clear();
+  m_ThreadStatistics.resize(numberOfThreads);
+  m_ThreadEdges.clear();
+  m_ThreadEdges.resize(numberOfThreads);
+
+  m_LUT.clear();
+  m_NumberOfRegions = 0;
+  m_NumberOfMergedRegions = 0;
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const InputLabelImageType *    labelImage = this->GetInputLabelImage();
+  const InputSpectralImageType * spectralImage = this->GetInputSpectralImage();
+
+  // The label image is buffered one pixel further than the processed
+  // region, on the right and bottom sides, except on the image borders
+  const RegionType& labelRegion = labelImage->GetBufferedRegion();
+
+  RegionStatisticsMapType& statistics = m_ThreadStatistics[threadId];
+  EdgeSetType&             edges = m_ThreadEdges[threadId];
+
+  itk::ImageRegionConstIteratorWithIndex<InputLabelImageType> labelIt(labelImage, outputRegionForThread);
+  itk::ImageRegionConstIterator<InputSpectralImageType>       spectralIt(spectralImage, outputRegionForThread);
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Labels are mostly constant along a line, so the last region
+  // statistics are kept to avoid looking them up at each pixel
+  typename RegionStatisticsMapType::iterator current = statistics.end();
+
+  for (labelIt.GoToBegin(), spectralIt.GoToBegin(); !labelIt.IsAtEnd(); ++labelIt, ++spectralIt)
+    {
+    const LabelType label = labelIt.Get();
+
+    if (current == statistics.end() || current->first != label)
+      {
+      current = statistics.find(label);
+      if (current == statistics.end())
+        {
+        current = statistics.insert(std::make_pair(label, RegionStatistics())).first;
+        current->second.m_Sum.resize(m_NumberOfComponentsPerPixel, 0.);
+        }
+      }
+
+    RegionStatistics& region = current->second;
+    ++region.m_Count;
+
+    const typename InputSpectralImageType::PixelType& pixel = spectralIt.Get();
+    for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+      {
+      region.m_Sum[comp] += static_cast<RealType>(pixel[comp]);
+      }
+
+    // Adjacency with the right and bottom neighbours only, so that each
+    // pair of adjacent pixels is seen once
+    IndexType index = labelIt.GetIndex();
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      ++index[dim];
+      if (labelRegion.IsInside(index))
+        {
+        const LabelType neighbour = labelImage->GetPixel(index);
+        if (neighbour != label)
+          {
+          edges.insert(std::make_pair(std::min(label, neighbour), std::max(label, neighbour)));
+          }
+        }
+      --index[dim];
+      }
+
+    progress.CompletedPixel();
+    }
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::Synthetize()
+{
+  // Gather the statistics of all threads
+  RegionStatisticsMapType statisticsMap;
+  for (unsigned int threadId = 0; threadId < m_ThreadStatistics.size(); ++threadId)
+    {
+    typename RegionStatisticsMapType::const_iterator it = m_ThreadStatistics[threadId].begin();
+    for (; it != m_ThreadStatistics[threadId].end(); ++it)
+      {
+      RegionStatistics& region = statisticsMap[it->first];
+      if (region.m_Sum.empty())
+        {
+        region.m_Sum.resize(m_NumberOfComponentsPerPixel, 0.);
+        }
+      region.m_Count += it->second.m_Count;
+      for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+        {
+        region.m_Sum[comp] += it->second.m_Sum[comp];
+        }
+      }
+    m_ThreadStatistics[threadId].clear();
+    }
+
+  // Regions are then indexed by increasing label
+  std::vector<LabelType>        labels;
+  std::vector<RegionStatistics> statistics;
+  labels.reserve(statisticsMap.size());
+  statistics.reserve(statisticsMap.size());
+
+  for (typename RegionStatisticsMapType::const_iterator it = statisticsMap.begin(); it != statisticsMap.end(); ++it)
+    {
+    labels.push_back(it->first);
+    statistics.push_back(it->second);
+    }
+  statisticsMap.clear();
+
+  // Region adjacency graph
+  std::vector<std::set<unsigned long> > adjacency(labels.size());
+  for (unsigned int threadId = 0; threadId < m_ThreadEdges.size(); ++threadId)
+    {
+    typename EdgeSetType::const_iterator it = m_ThreadEdges[threadId].begin();
+    for (; it != m_ThreadEdges[threadId].end(); ++it)
+      {
+      const unsigned long first = std::lower_bound(labels.begin(), labels.end(), it->first) - labels.begin();
+      const unsigned long second = std::lower_bound(labels.begin(), labels.end(), it->second) - labels.begin();
+      adjacency[first].insert(second);
+      adjacency[second].insert(first);
+      }
+    m_ThreadEdges[threadId].clear();
+    }
+
+  m_NumberOfRegions = labels.size();
+
+  this->MergeSmallRegions(labels, statistics, adjacency);
+
+  otbMsgDevMacro(<< "Merged " << m_NumberOfRegions << " regions into " << m_NumberOfMergedRegions
+                 << " regions (minimum size " << m_MinSize << ")");
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::MergeSmallRegions(const std::vector<LabelType>& labels,
+                    std::vector<RegionStatistics>& statistics,
+                    std::vector<std::set<unsigned long> >& adjacency)
+{
+  const unsigned long nbRegions = labels.size();
+
+  std::vector<unsigned long> parents(nbRegions);
+  for (unsigned long i = 0; i < nbRegions; ++i)
+    {
+    parents[i] = i;
+    }
+
+  // Small regions, ordered by size then by label
+  typedef std::pair<unsigned long, unsigned long> QueueElementType;
+  std::priority_queue<QueueElementType, std::vector<QueueElementType>, std::greater<QueueElementType> > queue;
+
+  for (unsigned long i = 0; i < nbRegions; ++i)
+    {
+    if (statistics[i].m_Count < m_MinSize)
+      {
+      queue.push(QueueElementType(statistics[i].m_Count, i));
+      }
+    }
+
+  std::vector<unsigned long>                      candidates;
+  std::vector<std::pair<unsigned long, unsigned long> > merges;
+
+  while (!queue.empty())
+    {
+    const unsigned long size = queue.top().first;
+
+    // Regions of the current size. Regions which have been merged, or
+    // which have grown since they were queued, are outdated.
+    candidates.clear();
+    while (!queue.empty() && queue.top().first == size)
+      {
+      const unsigned long node = queue.top().second;
+      queue.pop();
+      if (parents[node] == node && statistics[node].m_Count == size
+          && (candidates.empty() || candidates.back() != node))
+        {
+        candidates.push_back(node);
+        }
+      }
+
+    // Search the closest neighbour of each region, before any merging
+    // of this size
+    merges.clear();
+    for (std::vector<unsigned long>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+      {
+      const unsigned long node = *it;
+      bool                found = false;
+      unsigned long       closest = node;
+      RealType            minDistance = itk::NumericTraits<RealType>::max();
+
+      for (std::set<unsigned long>::const_iterator adjIt = adjacency[node].begin();
+           adjIt != adjacency[node].end(); ++adjIt)
+        {
+        const unsigned long neighbour = FindRoot(parents, *adjIt);
+        if (neighbour == node)
+          {
+          continue;
+          }
+        const RealType distance = MeanDistance(statistics[node], statistics[neighbour]);
+        if (!found || distance < minDistance || (distance == minDistance && neighbour < closest))
+          {
+          found = true;
+          minDistance = distance;
+          closest = neighbour;
+          }
+        }
+
+      if (found)
+        {
+        merges.push_back(std::make_pair(node, closest));
+        }
+      }
+
+    // Merge the regions, the group keeping the lowest label
+    for (unsigned long i = 0; i < merges.size(); ++i)
+      {
+      unsigned long root = FindRoot(parents, merges[i].first);
+      unsigned long child = FindRoot(parents, merges[i].second);
+      if (root == child)
+        {
+        continue;
+        }
+      if (child < root)
+        {
+        std::swap(root, child);
+        }
+
+      parents[child] = root;
+
+      statistics[root].m_Count += statistics[child].m_Count;
+      for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+        {
+        statistics[root].m_Sum[comp] += statistics[child].m_Sum[comp];
+        }
+
+      // Outdated neighbours are resolved with FindRoot() when used
+      if (adjacency[root].size() < adjacency[child].size())
+        {
+        adjacency[root].swap(adjacency[child]);
+        }
+      adjacency[root].insert(adjacency[child].begin(), adjacency[child].end());
+      std::set<unsigned long>().swap(adjacency[child]);
+      }
+
+    // Regions still too small are processed again with their new size
+    for (unsigned long i = 0; i < merges.size(); ++i)
+      {
+      const unsigned long root = FindRoot(parents, merges[i].first);
+      if (statistics[root].m_Count < m_MinSize)
+        {
+        queue.push(QueueElementType(statistics[root].m_Count, root));
+        }
+      }
+    }
+
+  m_LUT.clear();
+  m_NumberOfMergedRegions = 0;
+  for (unsigned long i = 0; i < nbRegions; ++i)
+    {
+    const unsigned long root = FindRoot(parents, i);
+    if (root != i)
+      {
+      m_LUT[labels[i]] = labels[root];
+      }
+    else
+      {
+      ++m_NumberOfMergedRegions;
+      }
+    }
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+typename PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>::RealType
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::MeanDistance(const RegionStatistics& r1, const RegionStatistics& r2)
+{
+  // The mean of the neighbour is truncated to an integer, as in the
+  // former tile-by-tile implementation of LSMSSmallRegionsMerging, so
+  // that the merging decisions, and its baselines, are unchanged
+  RealType distance = 0.;
+  for (unsigned int comp = 0; comp < r1.m_Sum.size(); ++comp)
+    {
+    const int      neighbourMean = static_cast<int>(r2.m_Sum[comp] / r2.m_Count);
+    const RealType diff = r1.m_Sum[comp] / r1.m_Count - neighbourMean;
+    distance += diff * diff;
+    }
+  return distance;
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+unsigned long
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::FindRoot(std::vector<unsigned long>& parents, unsigned long node)
+{
+  unsigned long root = node;
+  while (parents[root] != root)
+    {
+    root = parents[root];
+    }
+  while (parents[node] != root)
+    {
+    const unsigned long next = parents[node];
+    parents[node] = root;
+    node = next;
+    }
+  return root;
+}
+
+template <class TInputLabelImage, class TInputSpectralImage>
+void
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage, TInputSpectralImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Minimum region size: " << m_MinSize << std::endl;
+  os << indent << "Number of regions: " << m_NumberOfRegions << std::endl;
+  os << indent << "Number of merged regions: " << m_NumberOfMergedRegions << std::endl;
+}
+
+} // end namespace otb
+
+#endif
@@ -22,6 +22,7 @@
 #include "otbMacro.h"
 
 #include "otbVectorData.h"
+#include "otbPackedRTree.h"
 
 #include "gdal.h"
 #include "ogr_api.h"
@@ -150,6 +151,9 @@ private:
   // Vector Of OGRGeometyH
   std::vector< OGRGeometryH >   m_SrcDataSetGeometries;
 
+  // Envelopes of m_SrcDataSetGeometries
+  PackedRTree                   m_GeometriesIndex;
+
   std::vector<double>           m_BurnValues;
   std::vector<double>           m_FullBurnValues;
   std::vector<int>              m_BandsToBurn;
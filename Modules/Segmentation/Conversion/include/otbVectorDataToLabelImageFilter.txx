@@ -247,6 +247,17 @@ VectorDataToLabelImageFilter<TVectorData, TOutputImage>
       }
       }
     }
+
+  // Index the envelopes of the geometries, so that each tile only
+  // rasterizes the geometries it intersects
+  PackedRTree::BoxListType envelopes(m_SrcDataSetGeometries.size());
+  for (unsigned int idx = 0; idx < m_SrcDataSetGeometries.size(); ++idx)
+    {
+    OGREnvelope envelope;
+    OGR_G_GetEnvelope(m_SrcDataSetGeometries[idx], &envelope);
+    envelopes[idx] = PackedRTree::BoxType(envelope.MinX, envelope.MinY, envelope.MaxX, envelope.MaxY);
+    }
+  m_GeometriesIndex.Build(envelopes);
 }
 
 template<class TVectorData, class TOutputImage>
@@ -299,16 +310,37 @@ VectorDataToLabelImageFilter<TVectorData, TOutputImage>::GenerateData()
   geoTransform[4] = 0.;
   GDALSetGeoTransform(dataset,const_cast<double*>(geoTransform.GetDataPointer()));
 
+  // Select the geometries whose envelope intersects the buffered region
+  PackedRTree::BoxType tileBox(geoTransform[0], geoTransform[3],
+                               geoTransform[0] + bufferedRegion.GetSize()[0] * geoTransform[1],
+                               geoTransform[3] + bufferedRegion.GetSize()[1] * geoTransform[5]);
+  PackedRTree::IndexListType selected;
+  m_GeometriesIndex.Search(tileBox, selected);
+
+  std::vector<OGRGeometryH> tileGeometries(selected.size());
+  std::vector<double>       tileBurnValues(selected.size());
+  for (unsigned int idx = 0; idx < selected.size(); ++idx)
+    {
+    tileGeometries[idx] = m_SrcDataSetGeometries[selected[idx]];
+    tileBurnValues[idx] = m_FullBurnValues[selected[idx]];
+    }
+
+  otbMsgDevMacro(<< "Rasterizing " << selected.size() << " geometries out of " << m_SrcDataSetGeometries.size()
+                 << " in region " << bufferedRegion.GetIndex() << " " << bufferedRegion.GetSize());
+
   // Burn the geometries into the dataset
    if (dataset != NULL)
      {
-     GDALRasterizeGeometries( dataset, m_BandsToBurn.size(),
-                          &(m_BandsToBurn[0]),
-                          m_SrcDataSetGeometries.size(),
-                          &(m_SrcDataSetGeometries[0]),
-                          NULL, NULL, &(m_FullBurnValues[0]),
-                          NULL,
-                          GDALDummyProgress, NULL );
+     if (!tileGeometries.empty())
+       {
+       GDALRasterizeGeometries( dataset, m_BandsToBurn.size(),
+                            &(m_BandsToBurn[0]),
+                            tileGeometries.size(),
+                            &(tileGeometries[0]),
+                            NULL, NULL, &(tileBurnValues[0]),
+                            NULL,
+                            GDALDummyProgress, NULL );
+       }
 
      // release the dataset
      GDALClose( dataset );
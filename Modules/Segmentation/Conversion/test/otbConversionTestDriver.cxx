@@ -16,6 +16,8 @@ void RegisterTests()
   REGISTER_TEST(otbVectorDataRasterizeFilter);
   REGISTER_TEST(otbLabelImageRegionPruningFilter);
   REGISTER_TEST(otbLabelImageRegionMergingFilter);
+  REGISTER_TEST(otbLabelImageRegionMergingFilterBenchmark);
+  REGISTER_TEST(otbLabelImageSmallRegionMergingFilter);
   REGISTER_TEST(otbLabelMapToVectorDataFilter);
   REGISTER_TEST(otbLabelMapToVectorDataFilterNew);
 }
@@ -0,0 +1,315 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "itkMacro.h"
+#include "otbImageFileReader.h"
+#include "otbMeanShiftSmoothingImageFilter.h"
+#include "otbLabelImageRegionMergingFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+
+#include <set>
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef float                                                    PixelType;
+typedef otb::VectorImage<PixelType, Dimension>                   ImageType;
+typedef otb::MeanShiftSmoothingImageFilter<ImageType, ImageType> SmoothingFilterType;
+typedef SmoothingFilterType::OutputLabelImageType                LabelImageType;
+typedef LabelImageType::PixelType                                LabelType;
+typedef std::vector<std::set<LabelType> >                        RegionAdjacencyMapType;
+
+RegionAdjacencyMapType LabelImageToRegionAdjacencyMap(const LabelImageType * labelImage)
+{
+  RegionAdjacencyMapType ram;
+
+  itk::ImageRegionConstIterator<LabelImageType> it(labelImage, labelImage->GetRequestedRegion());
+  LabelType maxLabel = 0;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    maxLabel = std::max(maxLabel, it.Get());
+    }
+  ram.resize(maxLabel + 1);
+
+  LabelImageType::RegionType region = labelImage->GetRequestedRegion();
+  LabelImageType::SizeType   size = region.GetSize();
+  for (unsigned int d = 0; d < Dimension; ++d) size[d] -= 1;
+  region.SetSize(size);
+
+  itk::ImageRegionConstIteratorWithIndex<LabelImageType> inputIt(labelImage, region);
+  for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt)
+    {
+    LabelType label = inputIt.Get();
+    for (unsigned int d = 0; d < Dimension; ++d)
+      {
+      LabelImageType::IndexType neighborIndex = inputIt.GetIndex();
+      neighborIndex[d]++;
+      LabelType neighborLabel = labelImage->GetPixel(neighborIndex);
+      if (neighborLabel != label)
+        {
+        ram[label].insert(neighborLabel);
+        ram[neighborLabel].insert(label);
+        }
+      }
+    }
+  return ram;
+}
+
+/** Region merging with std::set adjacency, recomputed from the label
+ *  image at each iteration, and union-find without path compression, as
+ *  done by LabelImageRegionMergingFilter before the compressed sparse
+ *  row graph */
+void ReferenceRegionMerging(const LabelImageType * inputLabelImage, const ImageType * spectralImage,
+                            double rangeBandwidth, LabelImageType * outputLabelImage, ImageType * outputClusteredImage)
+{
+  typedef ImageType::PixelType SpectralPixelType;
+
+  const LabelImageType::RegionType region = inputLabelImage->GetLargestPossibleRegion();
+  const unsigned int nbComp = spectralImage->GetNumberOfComponentsPerPixel();
+
+  outputLabelImage->SetRegions(region);
+  outputLabelImage->Allocate();
+  outputClusteredImage->SetRegions(region);
+  outputClusteredImage->SetNumberOfComponentsPerPixel(nbComp);
+  outputClusteredImage->Allocate();
+
+  itk::ImageRegionConstIteratorWithIndex<LabelImageType> inputIt(inputLabelImage, region);
+  itk::ImageRegionIterator<LabelImageType>               outputIt(outputLabelImage, region);
+  for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+    outputIt.Set(inputIt.Get());
+    }
+
+  RegionAdjacencyMapType regionAdjacencyMap = LabelImageToRegionAdjacencyMap(outputLabelImage);
+  unsigned int regionCount = regionAdjacencyMap.size() - 1;
+
+  std::vector<LabelType>         canonicalLabels(regionCount + 1);
+  std::vector<SpectralPixelType> modes(regionCount + 1, SpectralPixelType(nbComp));
+  std::vector<unsigned int>      pointCounts(regionCount + 1, 0);
+  for (unsigned int i = 0; i < regionCount + 1; ++i)
+    {
+    modes[i].Fill(0);
+    }
+
+  for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt)
+    {
+    LabelType label = inputIt.Get();
+    if (pointCounts[label] == 0)
+      {
+      modes[label] = spectralImage->GetPixel(inputIt.GetIndex());
+      }
+    pointCounts[label]++;
+    }
+
+  bool finishedMerging = false;
+  unsigned int mergeIterations = 0;
+
+  while (!finishedMerging)
+    {
+    for (LabelType curLabel = 1; curLabel <= regionCount; ++curLabel)
+      canonicalLabels[curLabel] = curLabel;
+
+    for (LabelType curLabel = 1; curLabel <= regionCount; ++curLabel)
+      {
+      if (pointCounts[curLabel] == 0)
+        {
+        continue;
+        }
+      const SpectralPixelType & curSpectral = modes[curLabel];
+
+      std::set<LabelType>::const_iterator adjIt = regionAdjacencyMap[curLabel].begin();
+      for (; adjIt != regionAdjacencyMap[curLabel].end(); ++adjIt)
+        {
+        LabelType adjLabel = *adjIt;
+        const SpectralPixelType & adjSpectral = modes[adjLabel];
+        double norm2 = 0;
+        for (unsigned int comp = 0; comp < nbComp; ++comp)
+          {
+          double e = (curSpectral[comp] - adjSpectral[comp]) / rangeBandwidth;
+          norm2 += e * e;
+          }
+
+        if (norm2 < 0.25)
+          {
+          LabelType curCanLabel = curLabel;
+          while (canonicalLabels[curCanLabel] != curCanLabel)
+            {
+            curCanLabel = canonicalLabels[curCanLabel];
+            }
+          LabelType adjCanLabel = adjLabel;
+          while (canonicalLabels[adjCanLabel] != adjCanLabel)
+            {
+            adjCanLabel = canonicalLabels[adjCanLabel];
+            }
+          if (curCanLabel < adjCanLabel)
+            {
+            canonicalLabels[adjCanLabel] = curCanLabel;
+            }
+          else
+            {
+            canonicalLabels[canonicalLabels[curCanLabel]] = adjCanLabel;
+            canonicalLabels[curCanLabel] = adjCanLabel;
+            }
+          }
+        }
+      }
+
+    for (LabelType i = 1; i < regionCount + 1; ++i)
+      {
+      LabelType can = i;
+      while (canonicalLabels[can] != can)
+        {
+        can = canonicalLabels[can];
+        }
+      canonicalLabels[i] = can;
+      }
+
+    std::vector<SpectralPixelType> newModes(regionCount + 1, SpectralPixelType(nbComp));
+    std::vector<unsigned int>      newPointCounts(regionCount + 1, 0);
+    for (unsigned int i = 0; i < regionCount + 1; ++i)
+      {
+      newModes[i].Fill(0);
+      }
+
+    for (unsigned int i = 1; i < regionCount + 1; ++i)
+      {
+      LabelType canLabel = canonicalLabels[i];
+      unsigned int nPoints = pointCounts[i];
+      for (unsigned int comp = 0; comp < nbComp; ++comp)
+        {
+        newModes[canLabel][comp] += nPoints * modes[i][comp];
+        }
+      newPointCounts[canLabel] += nPoints;
+      }
+
+    std::vector<LabelType> newLabels(regionCount + 1, 0);
+    std::vector<bool>      newLabelSet(regionCount + 1, false);
+
+    LabelType label = 0;
+    for (unsigned int i = 1; i < regionCount + 1; ++i)
+      {
+      LabelType canLabel = canonicalLabels[i];
+      if (newLabelSet[canLabel] == false)
+        {
+        newLabelSet[canLabel] = true;
+        label++;
+        newLabels[canLabel] = label;
+        for (unsigned int comp = 0; comp < nbComp; ++comp)
+          {
+          modes[label][comp] = newModes[canLabel][comp] / newPointCounts[canLabel];
+          }
+        pointCounts[label] = newPointCounts[canLabel];
+        }
+      }
+
+    unsigned int oldRegionCount = regionCount;
+    regionCount = label;
+
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+      {
+      outputIt.Set(newLabels[canonicalLabels[outputIt.Get()]]);
+      }
+
+    finishedMerging = oldRegionCount == regionCount || mergeIterations >= 10 || regionCount == 1;
+
+    if (!finishedMerging)
+      {
+      regionAdjacencyMap = LabelImageToRegionAdjacencyMap(outputLabelImage);
+      }
+
+    mergeIterations++;
+    }
+
+  itk::ImageRegionIterator<ImageType> outputClusteredIt(outputClusteredImage, region);
+  for (outputClusteredIt.GoToBegin(), outputIt.GoToBegin(); !outputClusteredIt.IsAtEnd(); ++outputClusteredIt, ++outputIt)
+    {
+    outputClusteredIt.Set(modes[outputIt.Get()]);
+    }
+}
+}
+
+/** Benchmark LabelImageRegionMergingFilter against the previous std::set
+ *  based implementation on a MeanShift segmentation, and check that both
+ *  give the same results */
+int otbLabelImageRegionMergingFilterBenchmark(int itkNotUsed(argc), char * argv[])
+{
+  const char *       infname          = argv[1];
+  const double       spatialBandwidth = atof(argv[2]);
+  const double       rangeBandwidth   = atof(argv[3]);
+
+  typedef otb::ImageFileReader<ImageType>                               ReaderType;
+  typedef otb::LabelImageRegionMergingFilter<LabelImageType, ImageType> MergeFilterType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+
+  SmoothingFilterType::Pointer smoothing = SmoothingFilterType::New();
+  smoothing->SetSpatialBandwidth(spatialBandwidth);
+  smoothing->SetRangeBandwidth(rangeBandwidth);
+  smoothing->SetThreshold(0.1);
+  smoothing->SetMaxIterationNumber(100);
+  smoothing->SetInput(reader->GetOutput());
+  smoothing->GetLabelOutput()->SetRequestedRegionToLargestPossibleRegion();
+  smoothing->Update();
+
+  LabelImageType::Pointer labelImage = smoothing->GetLabelOutput();
+  ImageType::Pointer      spectralImage = smoothing->GetRangeOutput();
+
+  // Previous implementation
+  LabelImageType::Pointer refLabelImage = LabelImageType::New();
+  ImageType::Pointer      refClusteredImage = ImageType::New();
+
+  itk::TimeProbe refChrono;
+  refChrono.Start();
+  ReferenceRegionMerging(labelImage, spectralImage, rangeBandwidth, refLabelImage, refClusteredImage);
+  refChrono.Stop();
+
+  // Current implementation
+  MergeFilterType::Pointer mergeFilter = MergeFilterType::New();
+  mergeFilter->SetInputLabelImage(labelImage);
+  mergeFilter->SetInputSpectralImage(spectralImage);
+  mergeFilter->SetRangeBandwidth(rangeBandwidth);
+
+  itk::TimeProbe chrono;
+  chrono.Start();
+  mergeFilter->Update();
+  chrono.Stop();
+
+  std::cout << "Set adjacency (s)\tCSR adjacency (s)" << std::endl;
+  std::cout << refChrono.GetTotal() << "\t" << chrono.GetTotal() << std::endl;
+
+  const LabelImageType::RegionType region = labelImage->GetLargestPossibleRegion();
+  itk::ImageRegionConstIteratorWithIndex<LabelImageType> refLabelIt(refLabelImage, region);
+  itk::ImageRegionConstIterator<LabelImageType>          labelIt(mergeFilter->GetLabelOutput(), region);
+  itk::ImageRegionConstIterator<ImageType>               refClusteredIt(refClusteredImage, region);
+  itk::ImageRegionConstIterator<ImageType>               clusteredIt(mergeFilter->GetClusteredOutput(), region);
+
+  for (refLabelIt.GoToBegin(), labelIt.GoToBegin(), refClusteredIt.GoToBegin(), clusteredIt.GoToBegin();
+       !refLabelIt.IsAtEnd(); ++refLabelIt, ++labelIt, ++refClusteredIt, ++clusteredIt)
+    {
+    if (refLabelIt.Get() != labelIt.Get() || refClusteredIt.Get() != clusteredIt.Get())
+      {
+      std::cerr << "Pixel " << refLabelIt.GetIndex() << " differs: label " << refLabelIt.Get() << " / " << labelIt.Get()
+                << ", mode " << refClusteredIt.Get() << " / " << clusteredIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbLabelImageSmallRegionMergingFilter.h"
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "itkChangeLabelImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <map>
+
+int otbLabelImageSmallRegionMergingFilter(int itkNotUsed(argc), char * argv[])
+{
+  const unsigned int size = atoi(argv[1]);
+  const unsigned int minSize = atoi(argv[2]);
+  const unsigned int nbDivisions = atoi(argv[3]);
+
+  typedef otb::Image<unsigned int, 2>                                     LabelImageType;
+  typedef otb::VectorImage<float, 2>                                      ImageType;
+  typedef otb::LabelImageSmallRegionMergingFilter<LabelImageType, ImageType> MergingFilterType;
+  typedef itk::ChangeLabelImageFilter<LabelImageType, LabelImageType>     ChangeLabelFilterType;
+
+  LabelImageType::RegionType region;
+  region.SetSize(0, size);
+  region.SetSize(1, size);
+
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions(region);
+  labelImage->Allocate();
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+
+  // Blocks of 8x8 pixels, sprinkled with regions of 1, 2 and 4 pixels
+  itk::ImageRegionIteratorWithIndex<LabelImageType> labelIt(labelImage, region);
+  itk::ImageRegionIterator<ImageType>               imageIt(image, region);
+  ImageType::PixelType pixel(3);
+  const unsigned int blocksPerLine = (size + 7) / 8;
+
+  for (labelIt.GoToBegin(), imageIt.GoToBegin(); !labelIt.IsAtEnd(); ++labelIt, ++imageIt)
+    {
+    const LabelImageType::IndexType index = labelIt.GetIndex();
+    unsigned int label = 1 + (index[1] / 8) * blocksPerLine + index[0] / 8;
+
+    const unsigned int hash = (index[0] / 2) * 7919 + (index[1] / 2) * 104729;
+    if (hash % 13 == 0)
+      {
+      // 2x2 region
+      label = 1000000 + (index[1] / 2) * size + index[0] / 2;
+      }
+    else if ((index[0] * 31 + index[1] * 17) % 29 == 0)
+      {
+      // 1 pixel region
+      label = 2000000 + index[1] * size + index[0];
+      }
+    labelIt.Set(label);
+
+    for (unsigned int comp = 0; comp < 3; ++comp)
+      {
+      pixel[comp] = static_cast<float>((label * (comp + 3)) % 251);
+      }
+    imageIt.Set(pixel);
+    }
+
+  // Reference computed in a single piece
+  MergingFilterType::Pointer reference = MergingFilterType::New();
+  reference->SetInputLabelImage(labelImage);
+  reference->SetInputSpectralImage(image);
+  reference->SetMinSize(minSize);
+  reference->GetStreamer()->SetNumberOfDivisionsStrippedStreaming(1);
+  reference->Update();
+
+  MergingFilterType::Pointer streamed = MergingFilterType::New();
+  streamed->SetInputLabelImage(labelImage);
+  streamed->SetInputSpectralImage(image);
+  streamed->SetMinSize(minSize);
+  streamed->GetStreamer()->SetNumberOfDivisionsTiledStreaming(nbDivisions);
+  streamed->Update();
+
+  std::cout << "Regions: " << reference->GetFilter()->GetNumberOfRegions() << ", after merging: "
+            << reference->GetFilter()->GetNumberOfMergedRegions() << std::endl;
+
+  if (reference->GetLUT() != streamed->GetLUT())
+    {
+    std::cerr << "The merging depends on the streaming: " << reference->GetLUT().size() << " merged labels in one piece, "
+              << streamed->GetLUT().size() << " with " << nbDivisions << " tiles" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // No small region must remain
+  ChangeLabelFilterType::Pointer changeLabel = ChangeLabelFilterType::New();
+  changeLabel->SetInput(labelImage);
+  changeLabel->SetChangeMap(reference->GetLUT());
+  changeLabel->Update();
+
+  std::map<unsigned int, unsigned long> counts;
+  itk::ImageRegionIterator<LabelImageType> outIt(changeLabel->GetOutput(), region);
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+    {
+    ++counts[outIt.Get()];
+    }
+
+  if (counts.size() != reference->GetFilter()->GetNumberOfMergedRegions())
+    {
+    std::cerr << "Relabelled image has " << counts.size() << " regions, expected "
+              << reference->GetFilter()->GetNumberOfMergedRegions() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (std::map<unsigned int, unsigned long>::const_iterator it = counts.begin(); it != counts.end(); ++it)
+    {
+    if (it->second < minSize)
+      {
+      std::cerr << "Region " << it->first << " has only " << it->second << " pixels" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
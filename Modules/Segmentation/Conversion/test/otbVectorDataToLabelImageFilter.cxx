@@ -43,7 +43,7 @@ int otbVectorDataToLabelImageFilterNew(int itkNotUsed(argc), char * itkNotUsed(a
   return EXIT_SUCCESS;
 }
 
-int otbVectorDataToLabelImageFilter(int itkNotUsed(argc), char * argv[])
+int otbVectorDataToLabelImageFilter(int argc, char * argv[])
 {
 
   ReaderType::Pointer reader = ReaderType::New();
@@ -69,6 +69,10 @@ int otbVectorDataToLabelImageFilter(int itkNotUsed(argc), char * argv[])
   WriterType::Pointer writer  = WriterType::New();
   writer->SetFileName(argv[3]);
   writer->SetInput(rasterization->GetOutput());
+  if (argc > 4)
+    {
+    writer->SetNumberOfDivisionsTiledStreaming(atoi(argv[4]));
+    }
   writer->Update();
 
 return EXIT_SUCCESS;
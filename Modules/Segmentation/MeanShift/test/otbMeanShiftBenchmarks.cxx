@@ -0,0 +1,52 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "otbBenchmarkHelper.h"
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbMeanShiftSegmentationFilter.h"
+
+int otbMeanShiftSegmentationFilterBenchmark(otb::BenchmarkHelper * helper, int argc, char * argv[])
+{
+  if (argc < 5)
+    {
+    std::cerr << "Usage: " << argv[0] << " spatialBandwidth rangeBandwidth maxIter threshold" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::VectorImage<float, 2>                                            ImageType;
+  typedef otb::Image<unsigned int, 2>                                           LabelImageType;
+  typedef otb::MeanShiftSegmentationFilter<ImageType, LabelImageType, ImageType> FilterType;
+
+  ImageType::Pointer image = helper->GenerateImage<ImageType>(0., 255.);
+
+  while (helper->KeepRunning())
+    {
+    // The filter runs a mini-pipeline, which is not updated again if only
+    // the filter is modified: use a new filter at each iteration
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetSpatialBandwidth(atof(argv[1]));
+    filter->SetRangeBandwidth(atof(argv[2]));
+    filter->SetMaxIterationNumber(atoi(argv[3]));
+    filter->SetThreshold(atof(argv[4]));
+    filter->Update();
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,34 @@
+#include <cstdlib>
+#include "muParser.h"
+
+int main(int argc, char *argv[])
+{
+  // Test the bulk mode evaluation
+  // This will not compile if muParser version is < 2.1.0
+
+  double x[3] = {1., 2., 3.};
+  double results[3] = {0., 0., 0.};
+
+  mu::Parser parser;
+  parser.DefineVar("x", x);
+  parser.SetExpr("2*x");
+
+  try
+    {
+    parser.Eval(results, 3);
+    }
+  catch( const mu::Parser::exception_type& e )
+    {
+    std::cerr << "Message:     "   << e.GetMsg()   << std::endl
+              << "Formula:     "   << e.GetExpr()  << std::endl
+              << "Token:       "   << e.GetToken() << std::endl
+              << "Position:    "   << e.GetPos()   << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (results[0] != 2. || results[1] != 4. || results[2] != 6.)
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -116,6 +116,13 @@ public:
    */
   int ExecuteAndWriteOutput();
 
+  /** Write the enabled outputs which have an associated filename. The
+   * application must have been executed. ExecuteAndWriteOutput() calls
+   * it after Execute(), ApplicationChain once the whole chain is
+   * connected.
+   */
+  void WriteOutput();
+
   /* Get the internal application parameters
    *
    * WARNING: this method may disappear from the API */
@@ -312,6 +319,14 @@ public:
    */
   void SetParameterStringList(std::string parameter, std::vector<std::string> value);
 
+  /* Set an in-memory input image value. The image must be one of the
+   * image types of otbWrapperTypes.h.
+   *
+   * Can be called for types :
+   * \li ParameterType_InputImage
+   */
+  void SetParameterInputImage(std::string parameter, InputImageParameter::ImageBaseType* inputImage);
+
   /* Set an output image value
    *
    * Can be called for types :
@@ -395,6 +410,14 @@ public:
    */
   FloatVectorImageType* GetParameterImage(std::string parameter);
 
+  /* Get the image of an output image parameter, as set by the
+   * application during Execute(). The image is not updated.
+   *
+   * Can be called for types :
+   * \li ParameterType_OutputImage
+   */
+  OutputImageParameter::ImageBaseType* GetParameterOutputImage(std::string parameter);
+
 #define otbGetParameterImageMacro( Image )                              \
   Image##Type * GetParameter##Image( std::string parameter )            \
     {                                                                   \
@@ -803,11 +826,13 @@ private:
     * Declare the class
     * - Wrapper::MapProjectionParametersHandler
     * - Wrapper::ElevationParametersHandler
+    * - Wrapper::ApplicationChain
     * as friend to be able to access to the protected method of
     * Wrapper::Application class.
     **/
   friend class MapProjectionParametersHandler;
   friend class ElevationParametersHandler;
+  friend class ApplicationChain;
 
 }; //end class
 
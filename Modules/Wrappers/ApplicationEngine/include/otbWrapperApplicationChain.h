@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbWrapperApplicationChain_h
+#define __otbWrapperApplicationChain_h
+
+#include <set>
+#include <string>
+#include <vector>
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include "otbWrapperApplication.h"
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \class ApplicationChain
+ *  \brief Execute several applications connected in memory
+ *
+ * The chain holds applications executed in order. The output image of
+ * an application can be connected to an input image of a following
+ * one: the pipeline of the downstream application is then plugged on
+ * the output of the upstream one instead of reading a file, and the
+ * whole chain is streamed once by the writers of the last outputs.
+ *
+ * Load() builds a chain from a process XML file holding several
+ * <application> nodes, in the format written by the outxml parameter.
+ * An input image whose value is the file name of an output image of a
+ * previous application is connected to it in memory. Such an
+ * intermediate output is not written, unless it is made persistent,
+ * with a <persistent>true</persistent> node in its <parameter> node or
+ * with SetOutputPersistent(). The outputs which are not connected are
+ * always written.
+ *
+ * A connected output is converted to its pixel type (pixtype) before
+ * being plugged on the downstream application, as it would be by its
+ * writer, so that the downstream application reads the same values as
+ * from the intermediate file.
+ *
+ * A persistent intermediate output is written by its own writer, which
+ * streams the upstream part of the chain once more.
+ *
+ * \ingroup OTBApplicationEngine
+ */
+class ITK_ABI_EXPORT ApplicationChain : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ApplicationChain              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Defining ::New() static method */
+  itkNewMacro(Self);
+
+  /** RTTI support */
+  itkTypeMacro(ApplicationChain, itk::Object);
+
+  /** Append the applications described in a process XML file, and
+   * connect them. The applications are created with the
+   * ApplicationRegistry, whose search path must be set. */
+  void Load(const std::string& filename);
+
+  /** Append an application to the chain. Returns its index */
+  unsigned int AddApplication(Application * application);
+
+  /** Number of applications of the chain */
+  unsigned int GetNumberOfApplications() const
+  {
+    return m_Applications.size();
+  }
+
+  /** Get the application at index */
+  Application * GetApplication(unsigned int index) const;
+
+  /** Connect the output image outputKey of the application upstream to
+   * the input image inputKey of the application downstream, which
+   * must come after it in the chain */
+  void Connect(unsigned int upstream, const std::string& outputKey,
+               unsigned int downstream, const std::string& inputKey);
+
+  /** Is the output of the application connected to a following one ? */
+  bool IsOutputConnected(unsigned int index, const std::string& outputKey) const;
+
+  /** Write (or not) a connected output in addition to the final ones */
+  void SetOutputPersistent(unsigned int index, const std::string& outputKey, bool persistent);
+
+  /** Same as above, for the output image written in filename. Throws
+   * an exception if no output of the chain has this file name. */
+  void SetOutputPersistent(const std::string& filename, bool persistent);
+
+  bool IsOutputPersistent(unsigned int index, const std::string& outputKey) const;
+
+  /** Connect and execute the applications, in order. No output is
+   * written. Returns 0 on success, or the status of the application
+   * which failed. */
+  int Execute();
+
+  /** Execute the chain, then write the outputs which are not
+   * connected, and the persistent ones */
+  int ExecuteAndWriteOutput();
+
+protected:
+  ApplicationChain();
+  virtual ~ApplicationChain();
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+private:
+  ApplicationChain(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** Connection of an output image to an input image */
+  struct Connection
+  {
+    unsigned int upstream;
+    std::string  outputKey;
+    unsigned int downstream;
+    std::string  inputKey;
+  };
+
+  typedef std::pair<unsigned int, std::string> OutputType;
+
+  /** Find the last output image written in filename, among the count
+   * first applications */
+  bool FindOutput(const std::string& filename, unsigned int count, OutputType& output) const;
+
+  /** File name without the extended filename options, as a full path */
+  static std::string NormalizeFileName(const std::string& filename);
+
+  std::vector<Application::Pointer> m_Applications;
+  std::vector<Connection>           m_Connections;
+  std::set<OutputType>              m_PersistentOutputs;
+};
+
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif
@@ -65,6 +65,10 @@ public:
 
   int Read(Application::Pointer application);
 
+  /** Set the parameters of application from an <application> node. Used
+   * by Read() and by ApplicationChain, whose files hold several nodes */
+  int ReadApplication(TiXmlElement *n_AppNode, Application::Pointer application);
+
   void otbAppLogInfo(Application::Pointer app, std::string info);
 
 /* copied from Utilities/tinyXMLlib/tinyxml.cpp. Must have a FIX inside tinyxml.cpp */
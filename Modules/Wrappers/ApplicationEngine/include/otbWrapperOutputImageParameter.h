@@ -87,6 +87,10 @@ public:
 
   void Write();
 
+  /** The image converted to the pixel type of the parameter, as it would
+   * be written. RGB and RGBA images are returned unchanged. */
+  ImageBaseType* GetCastImage();
+
   itk::ProcessObject* GetWriter();
 
   void InitializeWriters();
@@ -109,11 +113,20 @@ protected:
   template <class TInputVectorImageType>
     void SwitchRGBAImageWrite();
 
+  template <class TInputImageType>
+    ImageBaseType* SwitchImageCast();
+
+  template <class TInputVectorImageType>
+    ImageBaseType* SwitchVectorImageCast();
+
   //FloatVectorImageType::Pointer m_Image;
   ImageBaseType::Pointer m_Image;
   std::string            m_FileName;
   ImagePixelType         m_PixelType;
 
+  /** The filter converting the image returned by GetCastImage() */
+  itk::ProcessObject::Pointer m_Caster;
+
   typedef otb::ImageFileWriter<UInt8ImageType>  UInt8WriterType;
   typedef otb::ImageFileWriter<Int16ImageType>  Int16WriterType;
   typedef otb::ImageFileWriter<UInt16ImageType> UInt16WriterType;
@@ -37,6 +37,7 @@
 #include "otbWrapperAddProcessToWatchEvent.h"
 
 #include "otbMacro.h"
+#include "otbPipelineProfiler.h"
 #include "otbWrapperTypes.h"
 #include <exception>
 #include "itkMacro.h"
@@ -231,105 +232,118 @@ int Application::ExecuteAndWriteOutput()
 
   if (status == 0)
     {
-      std::vector<std::string> paramList = GetParametersKeys(true);
-      // First Get the value of the available memory to use with the
-      // writer if a RAMParameter is set
-      bool useRAM = false;
-      unsigned int ram = 0;
-      for (std::vector<std::string>::const_iterator it = paramList.begin();
-           it != paramList.end();
-           ++it)
-        {
-        std::string key = *it;
+    this->WriteOutput();
+    }
 
-        if (GetParameterType(key) == ParameterType_RAM
-            && IsParameterEnabled(key))
-          {
-          Parameter* param = GetParameterByKey(key);
-          RAMParameter* ramParam = dynamic_cast<RAMParameter*>(param);
-          if(ramParam!=NULL)
-            {
-            ram = ramParam->GetValue();
-            useRAM = true;
-            }
-          }
-        }
+  this->AfterExecuteAndWriteOutputs();
+
+  // Write the pipeline profiling report, if enabled
+  PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+  if (profiler->IsEnabled())
+    {
+    GetLogger()->Info(std::string("Writing the profiling report ") + profiler->GetFileName() + "\n");
+    profiler->WriteReport();
+    }
+
+  return status;
+}
+
+void Application::WriteOutput()
+{
+  std::vector<std::string> paramList = GetParametersKeys(true);
+  // First Get the value of the available memory to use with the
+  // writer if a RAMParameter is set
+  bool useRAM = false;
+  unsigned int ram = 0;
+  for (std::vector<std::string>::const_iterator it = paramList.begin();
+       it != paramList.end();
+       ++it)
+    {
+    std::string key = *it;
 
-      for (std::vector<std::string>::const_iterator it = paramList.begin();
-           it != paramList.end();
-           ++it)
+    if (GetParameterType(key) == ParameterType_RAM
+        && IsParameterEnabled(key))
+      {
+      Parameter* param = GetParameterByKey(key);
+      RAMParameter* ramParam = dynamic_cast<RAMParameter*>(param);
+      if(ramParam!=NULL)
         {
-        std::string key = *it;
-        if (GetParameterType(key) == ParameterType_OutputImage
-            && IsParameterEnabled(key) && HasValue(key) )
-          {
-          Parameter* param = GetParameterByKey(key);
-          OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(param);
+        ram = ramParam->GetValue();
+        useRAM = true;
+        }
+      }
+    }
 
-          if(outputParam!=NULL)
-            {
-            outputParam->InitializeWriters();
-            if (useRAM)
-              {
-              outputParam->SetRAMValue(ram);
-              }
-            std::ostringstream progressId;
-            progressId << "Writing " << outputParam->GetFileName() << "...";
-            AddProcess(outputParam->GetWriter(), progressId.str());
-            outputParam->Write();
-            }
-          }
-        else if (GetParameterType(key) == ParameterType_OutputVectorData
-                 && IsParameterEnabled(key) && HasValue(key) )
+  for (std::vector<std::string>::const_iterator it = paramList.begin();
+       it != paramList.end();
+       ++it)
+    {
+    std::string key = *it;
+    if (GetParameterType(key) == ParameterType_OutputImage
+        && IsParameterEnabled(key) && HasValue(key) )
+      {
+      Parameter* param = GetParameterByKey(key);
+      OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(param);
+
+      if(outputParam!=NULL)
+        {
+        outputParam->InitializeWriters();
+        if (useRAM)
           {
-          Parameter* param = GetParameterByKey(key);
-          OutputVectorDataParameter* outputParam = dynamic_cast<OutputVectorDataParameter*>(param);
-          if(outputParam!=NULL)
-            {
-            outputParam->InitializeWriters();
-            std::ostringstream progressId;
-            progressId << "Writing " << outputParam->GetFileName() << "...";
-            AddProcess(outputParam->GetWriter(), progressId.str());
-            outputParam->Write();
-            }
+          outputParam->SetRAMValue(ram);
           }
-        else if (GetParameterType(key) == ParameterType_ComplexOutputImage
-                 && IsParameterEnabled(key) && HasValue(key) )
+        std::ostringstream progressId;
+        progressId << "Writing " << outputParam->GetFileName() << "...";
+        AddProcess(outputParam->GetWriter(), progressId.str());
+        outputParam->Write();
+        }
+      }
+    else if (GetParameterType(key) == ParameterType_OutputVectorData
+             && IsParameterEnabled(key) && HasValue(key) )
+      {
+      Parameter* param = GetParameterByKey(key);
+      OutputVectorDataParameter* outputParam = dynamic_cast<OutputVectorDataParameter*>(param);
+      if(outputParam!=NULL)
+        {
+        outputParam->InitializeWriters();
+        std::ostringstream progressId;
+        progressId << "Writing " << outputParam->GetFileName() << "...";
+        AddProcess(outputParam->GetWriter(), progressId.str());
+        outputParam->Write();
+        }
+      }
+    else if (GetParameterType(key) == ParameterType_ComplexOutputImage
+             && IsParameterEnabled(key) && HasValue(key) )
+      {
+      Parameter* param = GetParameterByKey(key);
+      ComplexOutputImageParameter* outputParam = dynamic_cast<ComplexOutputImageParameter*>(param);
+      
+      if(outputParam!=NULL)
+        {
+        outputParam->InitializeWriters();
+        if (useRAM)
           {
-          Parameter* param = GetParameterByKey(key);
-          ComplexOutputImageParameter* outputParam = dynamic_cast<ComplexOutputImageParameter*>(param);
-          
-          if(outputParam!=NULL)
-            {
-            outputParam->InitializeWriters();
-            if (useRAM)
-              {
-              outputParam->SetRAMValue(ram);
-              }
-            std::ostringstream progressId;
-            progressId << "Writing " << outputParam->GetFileName() << "...";
-            AddProcess(outputParam->GetWriter(), progressId.str());
-            outputParam->Write();
-            }
+          outputParam->SetRAMValue(ram);
           }
+        std::ostringstream progressId;
+        progressId << "Writing " << outputParam->GetFileName() << "...";
+        AddProcess(outputParam->GetWriter(), progressId.str());
+        outputParam->Write();
+        }
+      }
 
-        //xml writer parameter
-        else if (m_HaveOutXML && GetParameterType(key) == ParameterType_OutputProcessXML
-                 && IsParameterEnabled(key) && HasValue(key) )
-          {
-          Parameter* param = GetParameterByKey(key);
-          OutputProcessXMLParameter* outXMLParam = dynamic_cast<OutputProcessXMLParameter*>(param);
-          if(outXMLParam!=NULL)
-            {
-            outXMLParam->Write(this);
-            }
-          }
+    //xml writer parameter
+    else if (m_HaveOutXML && GetParameterType(key) == ParameterType_OutputProcessXML
+             && IsParameterEnabled(key) && HasValue(key) )
+      {
+      Parameter* param = GetParameterByKey(key);
+      OutputProcessXMLParameter* outXMLParam = dynamic_cast<OutputProcessXMLParameter*>(param);
+      if(outXMLParam!=NULL)
+        {
+        outXMLParam->Write(this);
         }
+      }
     }
-
-  this->AfterExecuteAndWriteOutputs();
-
-  return status;
 }
 
 /* Enable the use of an optional parameter. Returns the previous state */
@@ -845,6 +859,21 @@ void Application::SetParameterStringList(std::string parameter, std::vector<std:
     }
 }
 
+void Application::SetParameterInputImage(std::string parameter, InputImageParameter::ImageBaseType* inputImage)
+{
+  Parameter* param = GetParameterByKey(parameter);
+
+  if (dynamic_cast<InputImageParameter*>(param))
+    {
+    InputImageParameter* paramDown = dynamic_cast<InputImageParameter*>(param);
+    paramDown->SetImage<InputImageParameter::ImageBaseType>(inputImage);
+    }
+  else
+    {
+    itkExceptionMacro(<<parameter << " parameter can't be casted to InputImageParameter");
+    }
+}
+
 void Application::SetParameterOutputImage(std::string parameter, FloatVectorImageType* value)
 {
   Parameter* param = GetParameterByKey(parameter);
@@ -1132,6 +1161,21 @@ FloatVectorImageType* Application::GetParameterImage(std::string parameter)
   return ret;
 }
 
+OutputImageParameter::ImageBaseType* Application::GetParameterOutputImage(std::string parameter)
+{
+  Parameter* param = GetParameterByKey(parameter);
+
+  if (dynamic_cast<OutputImageParameter*>(param))
+    {
+    OutputImageParameter* paramDown = dynamic_cast<OutputImageParameter*>(param);
+    return paramDown->GetValue();
+    }
+  else
+    {
+    itkExceptionMacro(<<parameter << " parameter can't be casted to OutputImageParameter");
+    }
+}
+
 FloatVectorImageListType* Application::GetParameterImageList(std::string parameter)
 {
   FloatVectorImageListType::Pointer ret=NULL;
@@ -0,0 +1,329 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbWrapperApplicationChain.h"
+#include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperInputProcessXMLParameter.h"
+#include "otbPipelineProfiler.h"
+#include "otb_tinyxml.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <sstream>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+ApplicationChain::ApplicationChain()
+{
+}
+
+ApplicationChain::~ApplicationChain()
+{
+}
+
+void ApplicationChain::Load(const std::string& filename)
+{
+  if (itksys::SystemTools::GetFilenameLastExtension(filename) != ".xml")
+    {
+    itkExceptionMacro(<< filename << " is a wrong Extension FileName : Expected .xml");
+    }
+
+  TiXmlDocument doc;
+  FILE*         fp = itksys::SystemTools::Fopen(filename.c_str(), "rb");
+  if (fp == NULL)
+    {
+    itkExceptionMacro(<< "Can't open file " << filename);
+    }
+  const bool loaded = doc.LoadFile(fp, TIXML_ENCODING_UTF8);
+  fclose(fp);
+  if (!loaded)
+    {
+    itkExceptionMacro(<< "Can't parse file " << filename);
+    }
+
+  TiXmlElement* n_OTB = TiXmlHandle(&doc).FirstChild("OTB").Element();
+  if (n_OTB == NULL)
+    {
+    itkExceptionMacro(<< "Input XML file " << filename << " is invalid.");
+    }
+
+  // The parser sets the parameters of each application from its node
+  InputProcessXMLParameter::Pointer parser = InputProcessXMLParameter::New();
+
+  for (TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application"); n_AppNode != NULL;
+       n_AppNode = n_AppNode->NextSiblingElement("application"))
+    {
+    const std::string name = parser->GetChildNodeTextOf(n_AppNode, "name");
+    Application::Pointer application = ApplicationRegistry::CreateApplication(name);
+    if (application.IsNull())
+      {
+      itkExceptionMacro(<< "Could not find application " << name << " of the chain " << filename);
+      }
+
+    const unsigned int index = this->AddApplication(application);
+    parser->ReadApplication(n_AppNode, application);
+
+    for (TiXmlElement* n_Parameter = n_AppNode->FirstChildElement("parameter"); n_Parameter != NULL;
+         n_Parameter = n_Parameter->NextSiblingElement("parameter"))
+      {
+      const std::string key = parser->GetChildNodeTextOf(n_Parameter, "key");
+      const std::string type = parser->GetChildNodeTextOf(n_Parameter, "type");
+      const std::string value = parser->GetChildNodeTextOf(n_Parameter, "value");
+
+      OutputType output;
+      if (type == "InputImage" && this->FindOutput(value, index, output))
+        {
+        this->Connect(output.first, output.second, index, key);
+        }
+      else if (type == "OutputImage" && parser->GetChildNodeTextOf(n_Parameter, "persistent") == "true")
+        {
+        this->SetOutputPersistent(index, key, true);
+        }
+      }
+    }
+}
+
+unsigned int ApplicationChain::AddApplication(Application * application)
+{
+  if (application == NULL)
+    {
+    itkExceptionMacro(<< "Can't add a null application to the chain");
+    }
+  m_Applications.push_back(application);
+  this->Modified();
+  return m_Applications.size() - 1;
+}
+
+Application * ApplicationChain::GetApplication(unsigned int index) const
+{
+  if (index >= m_Applications.size())
+    {
+    itkExceptionMacro(<< "Application index " << index << " is out of range (" << m_Applications.size()
+                      << " applications)");
+    }
+  return m_Applications[index];
+}
+
+void ApplicationChain::Connect(unsigned int upstream, const std::string& outputKey,
+                               unsigned int downstream, const std::string& inputKey)
+{
+  if (upstream >= downstream || downstream >= m_Applications.size())
+    {
+    itkExceptionMacro(<< "Can't connect application " << upstream << " to application " << downstream
+                      << ": the upstream application must come first in the chain");
+    }
+  if (m_Applications[upstream]->GetParameterType(outputKey) != ParameterType_OutputImage)
+    {
+    itkExceptionMacro(<< outputKey << " is not an output image of " << m_Applications[upstream]->GetName());
+    }
+  if (m_Applications[downstream]->GetParameterType(inputKey) != ParameterType_InputImage)
+    {
+    itkExceptionMacro(<< inputKey << " is not an input image of " << m_Applications[downstream]->GetName());
+    }
+
+  Connection connection;
+  connection.upstream = upstream;
+  connection.outputKey = outputKey;
+  connection.downstream = downstream;
+  connection.inputKey = inputKey;
+  m_Connections.push_back(connection);
+  this->Modified();
+}
+
+bool ApplicationChain::IsOutputConnected(unsigned int index, const std::string& outputKey) const
+{
+  for (std::vector<Connection>::const_iterator it = m_Connections.begin(); it != m_Connections.end(); ++it)
+    {
+    if (it->upstream == index && it->outputKey == outputKey)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+void ApplicationChain::SetOutputPersistent(unsigned int index, const std::string& outputKey, bool persistent)
+{
+  if (persistent)
+    {
+    m_PersistentOutputs.insert(OutputType(index, outputKey));
+    }
+  else
+    {
+    m_PersistentOutputs.erase(OutputType(index, outputKey));
+    }
+  this->Modified();
+}
+
+void ApplicationChain::SetOutputPersistent(const std::string& filename, bool persistent)
+{
+  OutputType output;
+  if (!this->FindOutput(filename, m_Applications.size(), output))
+    {
+    itkExceptionMacro(<< "No application of the chain writes an image in " << filename);
+    }
+  this->SetOutputPersistent(output.first, output.second, persistent);
+}
+
+bool ApplicationChain::IsOutputPersistent(unsigned int index, const std::string& outputKey) const
+{
+  return m_PersistentOutputs.count(OutputType(index, outputKey)) != 0;
+}
+
+int ApplicationChain::Execute()
+{
+  for (unsigned int i = 0; i < m_Applications.size(); ++i)
+    {
+    Application* application = m_Applications[i];
+
+    // Plug the inputs on the pipelines built by the previous applications
+    for (std::vector<Connection>::const_iterator it = m_Connections.begin(); it != m_Connections.end(); ++it)
+      {
+      if (it->downstream != i)
+        {
+        continue;
+        }
+      Application* upstream = m_Applications[it->upstream];
+      OutputImageParameter* output = dynamic_cast<OutputImageParameter*>(upstream->GetParameterByKey(it->outputKey));
+      // The downstream application reads the pixel type it would read from the file
+      OutputImageParameter::ImageBaseType* image = (output != NULL ? output->GetCastImage() : NULL);
+      if (image == NULL)
+        {
+        itkExceptionMacro(<< "The output " << it->outputKey << " of " << upstream->GetName()
+                          << " has not been produced, it can't be connected to " << application->GetName());
+        }
+      application->SetParameterInputImage(it->inputKey, image);
+      }
+
+    std::ostringstream oss;
+    oss << "Executing " << application->GetName() << " (" << i + 1 << "/" << m_Applications.size() << ")\n";
+    application->GetLogger()->Info(oss.str());
+
+    const int status = application->Execute();
+    if (status != 0)
+      {
+      return status;
+      }
+    }
+  return 0;
+}
+
+int ApplicationChain::ExecuteAndWriteOutput()
+{
+  const int status = this->Execute();
+
+  if (status == 0)
+    {
+    for (unsigned int i = 0; i < m_Applications.size(); ++i)
+      {
+      Application* application = m_Applications[i];
+
+      // The intermediate outputs are only streamed through the chain
+      std::vector<std::string> skippedOutputs;
+      for (std::vector<Connection>::const_iterator it = m_Connections.begin(); it != m_Connections.end(); ++it)
+        {
+        if (it->upstream == i && !this->IsOutputPersistent(i, it->outputKey)
+            && application->IsParameterEnabled(it->outputKey))
+          {
+          application->DisableParameter(it->outputKey);
+          skippedOutputs.push_back(it->outputKey);
+          }
+        }
+
+      application->WriteOutput();
+
+      for (std::vector<std::string>::const_iterator it = skippedOutputs.begin(); it != skippedOutputs.end(); ++it)
+        {
+        application->EnableParameter(*it);
+        }
+      }
+    }
+
+  for (unsigned int i = 0; i < m_Applications.size(); ++i)
+    {
+    m_Applications[i]->AfterExecuteAndWriteOutputs();
+    }
+
+  // Write the pipeline profiling report, if enabled
+  PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+  if (profiler->IsEnabled() && !m_Applications.empty())
+    {
+    m_Applications.back()->GetLogger()->Info(std::string("Writing the profiling report ")
+                                             + profiler->GetFileName() + "\n");
+    profiler->WriteReport();
+    }
+
+  return status;
+}
+
+bool ApplicationChain::FindOutput(const std::string& filename, unsigned int count, OutputType& output) const
+{
+  const std::string normalized = NormalizeFileName(filename);
+  if (normalized.empty())
+    {
+    return false;
+    }
+
+  for (unsigned int i = std::min<unsigned int>(count, m_Applications.size()); i > 0; --i)
+    {
+    Application* application = m_Applications[i - 1];
+    std::vector<std::string> keys = application->GetParametersKeys(true);
+    for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+      {
+      if (application->GetParameterType(*it) == ParameterType_OutputImage && application->HasValue(*it)
+          && NormalizeFileName(application->GetParameterString(*it)) == normalized)
+        {
+        output = OutputType(i - 1, *it);
+        return true;
+        }
+      }
+    }
+  return false;
+}
+
+std::string ApplicationChain::NormalizeFileName(const std::string& filename)
+{
+  const std::string simpleFileName = filename.substr(0, filename.find('?'));
+  if (simpleFileName.empty())
+    {
+    return simpleFileName;
+    }
+  return itksys::SystemTools::CollapseFullPath(simpleFileName.c_str());
+}
+
+void ApplicationChain::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Applications: " << m_Applications.size() << std::endl;
+  for (unsigned int i = 0; i < m_Applications.size(); ++i)
+    {
+    os << indent.GetNextIndent() << i << ": " << m_Applications[i]->GetName() << std::endl;
+    }
+  os << indent << "Connections: " << m_Connections.size() << std::endl;
+  for (std::vector<Connection>::const_iterator it = m_Connections.begin(); it != m_Connections.end(); ++it)
+    {
+    os << indent.GetNextIndent() << it->upstream << "." << it->outputKey << " -> "
+       << it->downstream << "." << it->inputKey
+       << (this->IsOutputPersistent(it->upstream, it->outputKey) ? " (persistent)" : "") << std::endl;
+    }
+}
+
+} // end namespace Wrapper
+} // end namespace otb
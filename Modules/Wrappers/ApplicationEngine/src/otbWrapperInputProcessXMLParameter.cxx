@@ -185,8 +185,6 @@ InputProcessXMLParameter::Read(Application::Pointer this_)
   otb_Platform = this_->GetChildNodeTextOf(n_OTB, "platform");
   */
 
-  int ret = 0;
-
   TiXmlElement *n_AppNode   = n_OTB->FirstChildElement("application");
 
   std::string app_Name;
@@ -232,6 +230,18 @@ InputProcessXMLParameter::Read(Application::Pointer this_)
     return -1;
     }
 
+  int ret = ReadApplication(n_AppNode, this_);
+
+  fclose(fp);
+
+  return ret;
+}
+
+int
+InputProcessXMLParameter::ReadApplication(TiXmlElement *n_AppNode, Application::Pointer this_)
+{
+  int ret = 0;
+
   ParameterGroup::Pointer paramGroup = this_->GetParameterList();
 
   // Iterate through the parameter list
@@ -403,8 +413,6 @@ InputProcessXMLParameter::Read(Application::Pointer this_)
     }
   ret = 0; //resetting return to zero, we dont use it anyway for now.
 
-  fclose(fp);
-
   return ret;
 }
 
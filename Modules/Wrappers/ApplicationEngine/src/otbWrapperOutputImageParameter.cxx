@@ -278,6 +278,171 @@ OutputImageParameter::Write()
   }
 
 
+#define otbClampImageMacro(InputImageType, OutputImageType)                         \
+  {                                                                                 \
+    typedef otb::ClampImageFilter<InputImageType, OutputImageType> ClampFilterType; \
+    typename ClampFilterType::Pointer clampFilter = ClampFilterType::New();         \
+    clampFilter->SetInput( dynamic_cast<InputImageType*>(m_Image.GetPointer()) );   \
+    m_Caster = clampFilter;                                                         \
+    return clampFilter->GetOutput();                                                \
+  }
+
+#define otbClampVectorImageMacro(InputImageType, OutputImageType)                         \
+  {                                                                                       \
+    typedef otb::ClampVectorImageFilter<InputImageType, OutputImageType> ClampFilterType; \
+    typename ClampFilterType::Pointer clampFilter = ClampFilterType::New();               \
+    clampFilter->SetInput( dynamic_cast<InputImageType*>(m_Image.GetPointer()) );         \
+    m_Caster = clampFilter;                                                               \
+    return clampFilter->GetOutput();                                                      \
+  }
+
+
+template <class TInputImageType>
+OutputImageParameter::ImageBaseType*
+OutputImageParameter::SwitchImageCast()
+{
+  switch(m_PixelType )
+    {
+    case ImagePixelType_uint8:
+    {
+    otbClampImageMacro(TInputImageType, UInt8ImageType);
+    }
+    case ImagePixelType_int16:
+    {
+    otbClampImageMacro(TInputImageType, Int16ImageType);
+    }
+    case ImagePixelType_uint16:
+    {
+    otbClampImageMacro(TInputImageType, UInt16ImageType);
+    }
+    case ImagePixelType_int32:
+    {
+    otbClampImageMacro(TInputImageType, Int32ImageType);
+    }
+    case ImagePixelType_uint32:
+    {
+    otbClampImageMacro(TInputImageType, UInt32ImageType);
+    }
+    case ImagePixelType_float:
+    {
+    otbClampImageMacro(TInputImageType, FloatImageType);
+    }
+    case ImagePixelType_double:
+    {
+    otbClampImageMacro(TInputImageType, DoubleImageType);
+    }
+    }
+  return m_Image;
+}
+
+
+template <class TInputVectorImageType>
+OutputImageParameter::ImageBaseType*
+OutputImageParameter::SwitchVectorImageCast()
+{
+  switch(m_PixelType )
+    {
+    case ImagePixelType_uint8:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, UInt8VectorImageType);
+    }
+    case ImagePixelType_int16:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, Int16VectorImageType);
+    }
+    case ImagePixelType_uint16:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, UInt16VectorImageType);
+    }
+    case ImagePixelType_int32:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, Int32VectorImageType);
+    }
+    case ImagePixelType_uint32:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, UInt32VectorImageType);
+    }
+    case ImagePixelType_float:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, FloatVectorImageType);
+    }
+    case ImagePixelType_double:
+    {
+    otbClampVectorImageMacro(TInputVectorImageType, DoubleVectorImageType);
+    }
+    }
+  return m_Image;
+}
+
+
+OutputImageParameter::ImageBaseType*
+OutputImageParameter::GetCastImage()
+{
+  if (m_Image.IsNull())
+    {
+    return NULL;
+    }
+  if (dynamic_cast<UInt8ImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<UInt8ImageType>();
+    }
+  else if (dynamic_cast<Int16ImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<Int16ImageType>();
+    }
+  else if (dynamic_cast<UInt16ImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<UInt16ImageType>();
+    }
+  else if (dynamic_cast<Int32ImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<Int32ImageType>();
+    }
+  else if (dynamic_cast<UInt32ImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<UInt32ImageType>();
+    }
+  else if (dynamic_cast<FloatImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<FloatImageType>();
+    }
+  else if (dynamic_cast<DoubleImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchImageCast<DoubleImageType>();
+    }
+  else if (dynamic_cast<UInt8VectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<UInt8VectorImageType>();
+    }
+  else if (dynamic_cast<Int16VectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<Int16VectorImageType>();
+    }
+  else if (dynamic_cast<UInt16VectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<UInt16VectorImageType>();
+    }
+  else if (dynamic_cast<Int32VectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<Int32VectorImageType>();
+    }
+  else if (dynamic_cast<UInt32VectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<UInt32VectorImageType>();
+    }
+  else if (dynamic_cast<FloatVectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<FloatVectorImageType>();
+    }
+  else if (dynamic_cast<DoubleVectorImageType*>(m_Image.GetPointer()))
+    {
+    return SwitchVectorImageCast<DoubleVectorImageType>();
+    }
+  // RGB and RGBA images are only written in uint8
+  return m_Image;
+}
+
+
 itk::ProcessObject*
 OutputImageParameter::GetWriter()
 {
@@ -31,4 +31,6 @@ void RegisterTests()
   REGISTER_TEST(otbWrapperInputVectorDataParameterNew);
   REGISTER_TEST(otbWrapperOutputImageParameterNew);
   REGISTER_TEST(otbWrapperOutputImageParameterTest1);
+  REGISTER_TEST(otbWrapperApplicationChainNew);
+  REGISTER_TEST(otbWrapperApplicationChainTest1);
 }
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4786 )
+#endif
+
+#include <fstream>
+#include "itksys/SystemTools.hxx"
+#include "otbWrapperApplicationChain.h"
+#include "otbWrapperApplicationRegistry.h"
+
+int otbWrapperApplicationChainNew(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  otb::Wrapper::ApplicationChain::Pointer chain = otb::Wrapper::ApplicationChain::New();
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperApplicationChainTest1(int argc, char * argv[])
+{
+  if (argc != 7)
+    {
+    std::cerr << "Usage : " << argv[0]
+              << " module_path input chain.xml intermediate output reference" << std::endl;
+    return EXIT_FAILURE;
+    }
+  using otb::Wrapper::Application;
+  using otb::Wrapper::ApplicationRegistry;
+
+  const std::string modulePath = argv[1];
+  const std::string input = argv[2];
+  const std::string chainFileName = argv[3];
+  const std::string intermediate = argv[4];
+  const std::string output = argv[5];
+  const std::string reference = argv[6];
+
+  ApplicationRegistry::AddApplicationPath(modulePath);
+
+  // Reference: the applications executed one after the other, through a file
+  Application::Pointer extract = ApplicationRegistry::CreateApplication("ExtractROI");
+  Application::Pointer rescale = ApplicationRegistry::CreateApplication("Rescale");
+  if (extract.IsNull() || rescale.IsNull())
+    {
+    std::cerr << "Could not find the ExtractROI and Rescale applications in " << modulePath << std::endl;
+    return EXIT_FAILURE;
+    }
+  extract->SetParameterString("in", input);
+  extract->SetParameterString("out", intermediate);
+  extract->SetParameterOutputImagePixelType("out", otb::Wrapper::ImagePixelType_uint8);
+  extract->SetParameterInt("startx", 10);
+  extract->SetParameterInt("starty", 20);
+  extract->SetParameterInt("sizex", 50);
+  extract->SetParameterInt("sizey", 40);
+  extract->ExecuteAndWriteOutput();
+
+  rescale->SetParameterString("in", intermediate);
+  rescale->SetParameterString("out", reference);
+  rescale->SetParameterFloat("outmin", 10.);
+  rescale->SetParameterFloat("outmax", 100.);
+  rescale->ExecuteAndWriteOutput();
+
+  itksys::SystemTools::RemoveFile(intermediate.c_str());
+
+  // The same applications, connected in memory
+  std::ofstream file(chainFileName.c_str());
+  file << "<?xml version=\"1.0\" ?>\n"
+       << "<OTB>\n"
+       << "  <application>\n"
+       << "    <name>ExtractROI</name>\n"
+       << "    <parameter><key>in</key><type>InputImage</type><value>" << input << "</value></parameter>\n"
+       << "    <parameter><key>out</key><type>OutputImage</type><pixtype>uint8</pixtype>"
+       << "<value>" << intermediate << "</value></parameter>\n"
+       << "    <parameter><key>startx</key><type>Int</type><value>10</value></parameter>\n"
+       << "    <parameter><key>starty</key><type>Int</type><value>20</value></parameter>\n"
+       << "    <parameter><key>sizex</key><type>Int</type><value>50</value></parameter>\n"
+       << "    <parameter><key>sizey</key><type>Int</type><value>40</value></parameter>\n"
+       << "  </application>\n"
+       << "  <application>\n"
+       << "    <name>Rescale</name>\n"
+       << "    <parameter><key>in</key><type>InputImage</type><value>" << intermediate << "</value></parameter>\n"
+       << "    <parameter><key>out</key><type>OutputImage</type><pixtype>float</pixtype>"
+       << "<value>" << output << "</value></parameter>\n"
+       << "    <parameter><key>outmin</key><type>Float</type><value>10</value></parameter>\n"
+       << "    <parameter><key>outmax</key><type>Float</type><value>100</value></parameter>\n"
+       << "  </application>\n"
+       << "</OTB>\n";
+  file.close();
+
+  otb::Wrapper::ApplicationChain::Pointer chain = otb::Wrapper::ApplicationChain::New();
+  chain->Load(chainFileName);
+  std::cout << chain << std::endl;
+
+  if (chain->GetNumberOfApplications() != 2 || !chain->IsOutputConnected(0, "out")
+      || chain->IsOutputPersistent(0, "out"))
+    {
+    std::cerr << "The output of ExtractROI should be connected to Rescale" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (chain->ExecuteAndWriteOutput() != 0)
+    {
+    std::cerr << "The execution of the chain failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (itksys::SystemTools::FileExists(intermediate.c_str()))
+    {
+    std::cerr << "The intermediate output " << intermediate << " should not be written" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbWrapperApplicationServer_h
+#define __otbWrapperApplicationServer_h
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \class ApplicationServer
+ *  \brief Long-lived process executing application jobs sent on a Unix socket
+ *
+ * Launching an application with otbcli loads the application modules,
+ * registers the GDAL and OGR drivers and opens the elevation databases
+ * each time, which dominates the run time of short jobs. The server
+ * does it once in Initialize(), then Run() accepts jobs sent by the
+ * client (see ApplicationServerProtocol and otbApplicationClient) until
+ * it receives SIGINT or SIGTERM.
+ *
+ * Each job is executed by a CommandLineLauncher, in a child process
+ * forked from the initialized server: it starts with the modules loaded
+ * and the drivers and elevation databases opened, it is isolated from
+ * the other jobs (a crash only fails its own job), and it writes on the
+ * standard output and error of the client. The caches filled by a job
+ * are not shared with the next ones.
+ *
+ * At most MaximumNumberOfJobs jobs run concurrently, the others wait
+ * for a slot. The RAM (MaximumRAM, in MB) and the threads
+ * (NumberOfThreads) are shared evenly between the slots: each job gets
+ * its part as its RAM hint (OTB_MAX_RAM_HINT, and a cap on the ram
+ * parameter) and as its default number of threads.
+ *
+ * \ingroup OTBCommandLine
+ */
+class ITK_ABI_EXPORT ApplicationServer : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ApplicationServer             Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Defining ::New() static method */
+  itkNewMacro(Self);
+
+  /** RTTI support */
+  itkTypeMacro(ApplicationServer, itk::Object);
+
+  /** Path of the Unix socket */
+  itkSetStringMacro(SocketPath);
+  itkGetStringMacro(SocketPath);
+
+  /** Elevation databases opened at initialization (default: the
+   * OTB_DEM_DIRECTORY and OTB_GEOID_FILE configuration) */
+  itkSetStringMacro(DEMDirectory);
+  itkGetStringMacro(DEMDirectory);
+  itkSetStringMacro(GeoidFile);
+  itkGetStringMacro(GeoidFile);
+
+  /** RAM budget of all the jobs, in MB (default: the RAM hint) */
+  itkSetMacro(MaximumRAM, unsigned int);
+  itkGetMacro(MaximumRAM, unsigned int);
+
+  /** Thread budget of all the jobs (default: ITK default number of
+   * threads) */
+  itkSetMacro(NumberOfThreads, unsigned int);
+  itkGetMacro(NumberOfThreads, unsigned int);
+
+  /** Maximum number of concurrent jobs (default: half the threads) */
+  itkSetMacro(MaximumNumberOfJobs, unsigned int);
+  itkGetMacro(MaximumNumberOfJobs, unsigned int);
+
+  /** Budget of one job */
+  unsigned int GetRAMPerJob() const;
+  unsigned int GetThreadsPerJob() const;
+
+  /** Load the application modules, register the drivers and open the
+   * elevation databases. Throws an exception if a database can't be
+   * opened. */
+  void Initialize();
+
+  /** Listen on the socket and execute the jobs, until SIGINT or SIGTERM
+   * is received. The running jobs are then waited for. Throws an
+   * exception if the socket can't be created. */
+  void Run();
+
+protected:
+  ApplicationServer();
+  virtual ~ApplicationServer();
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Execute the job sent on the connection (in the child process).
+   * Returns the exit status of the job. */
+  int ExecuteJob(int connection);
+
+  /** Send the status of the finished jobs to their clients. If wait is
+   * true, block until a job finishes. */
+  void ReapJobs(bool wait);
+
+private:
+  ApplicationServer(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  std::string  m_SocketPath;
+  std::string  m_DEMDirectory;
+  std::string  m_GeoidFile;
+  unsigned int m_MaximumRAM;
+  unsigned int m_NumberOfThreads;
+  unsigned int m_MaximumNumberOfJobs;
+
+  /** Connection of the running jobs, by process id */
+  std::map<pid_t, int> m_Jobs;
+};
+
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif
@@ -0,0 +1,237 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __otbWrapperApplicationServerProtocol_h
+#define __otbWrapperApplicationServerProtocol_h
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \namespace ApplicationServerProtocol
+ *  \brief Messages exchanged by otbApplicationServer and its client
+ *
+ * The client connects to the Unix socket of the server and sends one
+ * request: the number of bytes of the payload (a 32 bits integer),
+ * along with its standard output and error as ancillary data
+ * (SCM_RIGHTS), then the payload, the working directory and the
+ * arguments of the job, each terminated by a null character. The
+ * arguments follow the otbcli syntax (application name, optional module
+ * path, then the parameters).
+ *
+ * The job writes directly on the descriptors of the client. Once it is
+ * done, the server sends its exit status (a 32 bits integer) and closes
+ * the connection.
+ *
+ * These functions only depend on the system headers, so that the client
+ * does not load the OTB libraries.
+ *
+ * \ingroup OTBCommandLine
+ */
+namespace ApplicationServerProtocol
+{
+
+/** Socket used when OTB_APPLICATION_SERVER_SOCKET is not set */
+inline std::string GetDefaultSocketPath()
+{
+  const char* path = getenv("OTB_APPLICATION_SERVER_SOCKET");
+  if (path != NULL && path[0] != '\0')
+    {
+    return path;
+    }
+  const char* tmp = getenv("TMPDIR");
+  std::string socketPath = (tmp != NULL && tmp[0] != '\0') ? tmp : "/tmp";
+  char        uid[32];
+  snprintf(uid, sizeof(uid), "%lu", static_cast<unsigned long>(getuid()));
+  return socketPath + "/otbApplicationServer-" + uid + ".socket";
+}
+
+/** Fill the address of a Unix socket. Returns false if the path is
+ * too long. */
+inline bool MakeAddress(const std::string& path, sockaddr_un& address)
+{
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+    {
+    return false;
+    }
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  return true;
+}
+
+/** Write or read size bytes, retrying on partial transfers */
+inline bool WriteAll(int fd, const void* data, size_t size)
+{
+  const char* buffer = static_cast<const char*>(data);
+  while (size > 0)
+    {
+    const ssize_t written = write(fd, buffer, size);
+    if (written <= 0)
+      {
+      return false;
+      }
+    buffer += written;
+    size -= written;
+    }
+  return true;
+}
+
+inline bool ReadAll(int fd, void* data, size_t size)
+{
+  char* buffer = static_cast<char*>(data);
+  while (size > 0)
+    {
+    const ssize_t nread = read(fd, buffer, size);
+    if (nread <= 0)
+      {
+      return false;
+      }
+    buffer += nread;
+    size -= nread;
+    }
+  return true;
+}
+
+/** Send a request, with the output and error descriptors of the job */
+inline bool SendRequest(int socket, const std::string& workingDirectory,
+                        const std::vector<std::string>& arguments, int outputFd, int errorFd)
+{
+  std::string payload = workingDirectory;
+  payload.push_back('\0');
+  for (std::vector<std::string>::const_iterator it = arguments.begin(); it != arguments.end(); ++it)
+    {
+    payload.append(*it);
+    payload.push_back('\0');
+    }
+  unsigned int size = payload.size();
+
+  iovec iov;
+  iov.iov_base = &size;
+  iov.iov_len = sizeof(size);
+
+  int    fds[2] = {outputFd, errorFd};
+  char   control[CMSG_SPACE(sizeof(fds))];
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  memset(control, 0, sizeof(control));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+  if (sendmsg(socket, &message, 0) != static_cast<ssize_t>(sizeof(size)))
+    {
+    return false;
+    }
+  return WriteAll(socket, payload.data(), payload.size());
+}
+
+/** Receive a request. The caller owns the descriptors received (not
+ * -1), even if the request turns out to be invalid. */
+inline bool ReceiveRequest(int socket, std::string& workingDirectory,
+                           std::vector<std::string>& arguments, int& outputFd, int& errorFd)
+{
+  outputFd = -1;
+  errorFd = -1;
+
+  unsigned int size = 0;
+  iovec        iov;
+  iov.iov_base = &size;
+  iov.iov_len = sizeof(size);
+
+  int    fds[2] = {-1, -1};
+  char   control[CMSG_SPACE(sizeof(fds))];
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  if (recvmsg(socket, &message, 0) != static_cast<ssize_t>(sizeof(size)))
+    {
+    return false;
+    }
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS
+      || cmsg->cmsg_len != CMSG_LEN(sizeof(fds)))
+    {
+    return false;
+    }
+  memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+  outputFd = fds[0];
+  errorFd = fds[1];
+
+  // Sanity limit: a command line is not that long
+  if (size == 0 || size > (1 << 24))
+    {
+    return false;
+    }
+  std::vector<char> payload(size);
+  if (!ReadAll(socket, &payload[0], size) || payload.back() != '\0')
+    {
+    return false;
+    }
+
+  arguments.clear();
+  const char* current = &payload[0];
+  const char* end = current + size;
+  workingDirectory = current;
+  current += workingDirectory.size() + 1;
+  while (current < end)
+    {
+    arguments.push_back(current);
+    current += arguments.back().size() + 1;
+    }
+  return true;
+}
+
+/** Exit status of the job, sent by the server once the job is done */
+inline bool SendStatus(int socket, int status)
+{
+  return WriteAll(socket, &status, sizeof(status));
+}
+
+inline bool ReceiveStatus(int socket, int& status)
+{
+  return ReadAll(socket, &status, sizeof(status));
+}
+
+} // end namespace ApplicationServerProtocol
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif
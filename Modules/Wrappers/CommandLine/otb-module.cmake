@@ -6,6 +6,9 @@ otb_module(OTBCommandLine
     OTBITK
     OTBTinyXML
     OTBApplicationEngine
+    OTBIOGDAL
+    OTBGdalAdapters
+    OTBOSSIMAdapters
 
   TEST_DEPENDS
     OTBTestKernel
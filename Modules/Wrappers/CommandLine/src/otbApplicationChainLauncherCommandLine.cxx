@@ -0,0 +1,79 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbWrapperApplicationChain.h"
+#include "otbWrapperApplicationRegistry.h"
+
+#include <cstring>
+#include <iostream>
+
+/** Execute a chain of applications described in a process XML file,
+ * the images being passed in memory from an application to the next one
+ * (see otb::Wrapper::ApplicationChain).
+ */
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage : " << argv[0] << " chain.xml [MODULEPATH] [-persist filename1 filename2 ...]" << std::endl;
+    std::cerr << "  -persist: also write these intermediate outputs of the chain" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int i = 2;
+  if (i < argc && strcmp(argv[i], "-persist") != 0)
+    {
+    otb::Wrapper::ApplicationRegistry::AddApplicationPath(argv[i]);
+    ++i;
+    }
+
+  try
+    {
+    otb::Wrapper::ApplicationChain::Pointer chain = otb::Wrapper::ApplicationChain::New();
+    chain->Load(argv[1]);
+
+    if (i < argc)
+      {
+      if (strcmp(argv[i], "-persist") != 0)
+        {
+        std::cerr << "Unknown option " << argv[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      for (++i; i < argc; ++i)
+        {
+        chain->SetOutputPersistent(argv[i], true);
+        }
+      }
+
+    if (chain->ExecuteAndWriteOutput() != 0)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cerr << "ERROR: " << err.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (std::exception& err)
+    {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbWrapperApplicationServerProtocol.h"
+
+#include <cerrno>
+#include <csignal>
+#include <iostream>
+
+/** Thin client of otbApplicationServer, with the syntax of otbcli:
+ *
+ *   otbApplicationClient module_name [MODULEPATH] [arguments]
+ *
+ * The job runs in the server, in the current directory, and writes on
+ * the standard output and error of the client. The exit status is the
+ * one of the job. The socket is given by OTB_APPLICATION_SERVER_SOCKET.
+ *
+ * The client only depends on the system: it does not load the OTB
+ * libraries.
+ */
+int main(int argc, char* argv[])
+{
+  namespace Protocol = otb::Wrapper::ApplicationServerProtocol;
+
+  if (argc < 2)
+    {
+    std::cerr << "Usage : " << argv[0] << " module_name [MODULEPATH] [arguments]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  const std::string socketPath = Protocol::GetDefaultSocketPath();
+  sockaddr_un       address;
+  const int         connection = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (connection < 0 || !Protocol::MakeAddress(socketPath, address)
+      || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+    std::cerr << "Can't connect to the application server on " << socketPath
+              << ": is otbApplicationServer running?" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector<char> directory(4096);
+  while (getcwd(&directory[0], directory.size()) == NULL)
+    {
+    if (errno != ERANGE)
+      {
+      std::cerr << "Can't get the current directory" << std::endl;
+      return EXIT_FAILURE;
+      }
+    directory.resize(2 * directory.size());
+    }
+
+  const std::vector<std::string> arguments(argv + 1, argv + argc);
+  int                            status = EXIT_FAILURE;
+  if (!Protocol::SendRequest(connection, &directory[0], arguments, STDOUT_FILENO, STDERR_FILENO)
+      || !Protocol::ReceiveStatus(connection, status))
+    {
+    std::cerr << "The application server closed the connection" << std::endl;
+    close(connection);
+    return EXIT_FAILURE;
+    }
+
+  close(connection);
+  return status;
+}
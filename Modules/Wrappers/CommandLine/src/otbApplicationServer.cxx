@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbWrapperApplicationServer.h"
+#include "otbWrapperApplicationRegistry.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/** Long-lived server executing the jobs of otbApplicationClient (see
+ * otb::Wrapper::ApplicationServer) */
+int main(int argc, char* argv[])
+{
+  typedef otb::Wrapper::ApplicationServer ServerType;
+  ServerType::Pointer server = ServerType::New();
+
+  for (int i = 1; i < argc; i += 2)
+    {
+    if (i + 1 >= argc || argv[i][0] != '-')
+      {
+      std::cerr << "Usage : " << argv[0] << " [-socket path] [-modulepath path] [-jobs N] [-threads N]"
+                << " [-ram MB] [-dem directory] [-geoid file]" << std::endl;
+      std::cerr << "  -socket: Unix socket (default: $OTB_APPLICATION_SERVER_SOCKET, or "
+                << server->GetSocketPath() << ")" << std::endl;
+      std::cerr << "  -modulepath: application modules directory, added to ITK_AUTOLOAD_PATH" << std::endl;
+      std::cerr << "  -jobs: maximum number of concurrent jobs (default " << server->GetMaximumNumberOfJobs()
+                << ")" << std::endl;
+      std::cerr << "  -threads: threads shared by the jobs (default " << server->GetNumberOfThreads()
+                << ")" << std::endl;
+      std::cerr << "  -ram: RAM shared by the jobs, in MB (default " << server->GetMaximumRAM() << ")"
+                << std::endl;
+      std::cerr << "  -dem, -geoid: elevation databases kept opened (default: $OTB_DEM_DIRECTORY,"
+                << " $OTB_GEOID_FILE)" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    const std::string option = argv[i];
+    const char*       value = argv[i + 1];
+    if (option == "-socket")
+      {
+      server->SetSocketPath(value);
+      }
+    else if (option == "-modulepath")
+      {
+      otb::Wrapper::ApplicationRegistry::AddApplicationPath(value);
+      }
+    else if (option == "-jobs")
+      {
+      server->SetMaximumNumberOfJobs(atoi(value));
+      }
+    else if (option == "-threads")
+      {
+      server->SetNumberOfThreads(atoi(value));
+      }
+    else if (option == "-ram")
+      {
+      server->SetMaximumRAM(atoi(value));
+      }
+    else if (option == "-dem")
+      {
+      server->SetDEMDirectory(value);
+      }
+    else if (option == "-geoid")
+      {
+      server->SetGeoidFile(value);
+      }
+    else
+      {
+      std::cerr << "Unknown option " << option << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  try
+    {
+    server->Initialize();
+    server->Run();
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cerr << "ERROR: " << err.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (std::exception& err)
+    {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,323 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "otbWrapperApplicationServer.h"
+#include "otbWrapperApplicationServerProtocol.h"
+#include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperCommandLineLauncher.h"
+#include "otbConfigurationManager.h"
+#include "otbGDALDriverManagerWrapper.h"
+#include "otbOGRDriversInit.h"
+#include "otbDEMHandler.h"
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+namespace
+{
+// Set by SIGINT and SIGTERM: stop accepting jobs
+volatile sig_atomic_t stopRequested = 0;
+
+extern "C" void ApplicationServerStopHandler(int)
+{
+  stopRequested = 1;
+}
+}
+
+namespace otb
+{
+namespace Wrapper
+{
+
+ApplicationServer::ApplicationServer() :
+  m_SocketPath(ApplicationServerProtocol::GetDefaultSocketPath()),
+  m_DEMDirectory(ConfigurationManager::GetDEMDirectory()),
+  m_GeoidFile(ConfigurationManager::GetGeoidFile()),
+  m_MaximumRAM(static_cast<unsigned int>(ConfigurationManager::GetMaxRAMHint())),
+  m_NumberOfThreads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()),
+  m_MaximumNumberOfJobs(std::max(1u, m_NumberOfThreads / 2))
+{
+}
+
+ApplicationServer::~ApplicationServer()
+{
+}
+
+unsigned int ApplicationServer::GetRAMPerJob() const
+{
+  return std::max(1u, m_MaximumRAM / std::max(1u, m_MaximumNumberOfJobs));
+}
+
+unsigned int ApplicationServer::GetThreadsPerJob() const
+{
+  return std::max(1u, m_NumberOfThreads / std::max(1u, m_MaximumNumberOfJobs));
+}
+
+void ApplicationServer::Initialize()
+{
+  // The jobs inherit the RAM hint, which also sizes the GDAL block cache
+  std::ostringstream ram;
+  ram << this->GetRAMPerJob();
+  setenv("OTB_MAX_RAM_HINT", ram.str().c_str(), 1);
+
+  GDALDriverManagerWrapper::GetInstance();
+  otb::ogr::Drivers::Init();
+
+  // Load all the application modules
+  const std::vector<std::string> applications = ApplicationRegistry::GetAvailableApplications();
+  std::cout << "Application server: " << applications.size() << " applications available" << std::endl;
+
+  if (!m_GeoidFile.empty())
+    {
+    DEMHandler::Instance()->OpenGeoidFile(m_GeoidFile);
+    std::cout << "Application server: geoid file " << m_GeoidFile << std::endl;
+    }
+  if (!m_DEMDirectory.empty())
+    {
+    DEMHandler::Instance()->OpenDEMDirectory(m_DEMDirectory);
+    std::cout << "Application server: DEM directory " << m_DEMDirectory << std::endl;
+    }
+}
+
+void ApplicationServer::Run()
+{
+  sockaddr_un address;
+  if (!ApplicationServerProtocol::MakeAddress(m_SocketPath, address))
+    {
+    itkExceptionMacro(<< "Socket path too long: " << m_SocketPath);
+    }
+
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0)
+    {
+    itkExceptionMacro(<< "Can't create the socket: " << strerror(errno));
+    }
+
+  // Remove the socket of a server which is not running anymore
+  if (connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+    {
+    close(server);
+    itkExceptionMacro(<< "A server is already listening on " << m_SocketPath);
+    }
+  close(server);
+  unlink(m_SocketPath.c_str());
+
+  server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0
+      || bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+      || chmod(m_SocketPath.c_str(), S_IRUSR | S_IWUSR) != 0
+      || listen(server, 64) != 0)
+    {
+    const std::string error = strerror(errno);
+    if (server >= 0)
+      {
+      close(server);
+      }
+    itkExceptionMacro(<< "Can't listen on " << m_SocketPath << ": " << error);
+    }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = ApplicationServerStopHandler;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  signal(SIGPIPE, SIG_IGN);
+  stopRequested = 0;
+
+  std::cout << "Application server: listening on " << m_SocketPath << " (" << m_MaximumNumberOfJobs
+            << " jobs of " << this->GetThreadsPerJob() << " threads and " << this->GetRAMPerJob()
+            << " MB)" << std::endl;
+
+  while (!stopRequested)
+    {
+    this->ReapJobs(false);
+
+    if (m_Jobs.size() >= m_MaximumNumberOfJobs)
+      {
+      this->ReapJobs(true);
+      continue;
+      }
+
+    pollfd request;
+    request.fd = server;
+    request.events = POLLIN;
+    request.revents = 0;
+    if (poll(&request, 1, 200) <= 0)
+      {
+      continue;
+      }
+
+    const int connection = accept(server, NULL, NULL);
+    if (connection < 0)
+      {
+      continue;
+      }
+
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid == 0)
+      {
+      // The job: in its own process group, so that an interruption of
+      // the server from the terminal lets it finish
+      setpgid(0, 0);
+      signal(SIGINT, SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+      signal(SIGPIPE, SIG_DFL);
+      close(server);
+
+      const int status = this->ExecuteJob(connection);
+      std::cout.flush();
+      std::cerr.flush();
+      fflush(NULL);
+      _exit(status);
+      }
+    else if (pid < 0)
+      {
+      std::cerr << "Application server: can't start a job: " << strerror(errno) << std::endl;
+      ApplicationServerProtocol::SendStatus(connection, EXIT_FAILURE);
+      close(connection);
+      }
+    else
+      {
+      m_Jobs[pid] = connection;
+      }
+    }
+
+  std::cout << "Application server: stopping, waiting for " << m_Jobs.size() << " jobs" << std::endl;
+  close(server);
+  unlink(m_SocketPath.c_str());
+  while (!m_Jobs.empty())
+    {
+    this->ReapJobs(true);
+    }
+}
+
+int ApplicationServer::ExecuteJob(int connection)
+{
+  std::string              workingDirectory;
+  std::vector<std::string> arguments;
+  int                      outputFd = -1;
+  int                      errorFd = -1;
+
+  const bool received = ApplicationServerProtocol::ReceiveRequest(connection, workingDirectory, arguments,
+                                                                  outputFd, errorFd);
+  if (outputFd >= 0)
+    {
+    dup2(outputFd, STDOUT_FILENO);
+    close(outputFd);
+    }
+  if (errorFd >= 0)
+    {
+    dup2(errorFd, STDERR_FILENO);
+    close(errorFd);
+    }
+  if (!received)
+    {
+    std::cerr << "Application server: invalid request" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (chdir(workingDirectory.c_str()) != 0)
+    {
+    std::cerr << "Application server: can't change directory to " << workingDirectory << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(this->GetThreadsPerJob());
+
+  // Same cleaning as otbApplicationLauncherCommandLine, and the RAM
+  // requested by the job is kept in its budget
+  std::vector<std::string> vexp;
+  for (unsigned int i = 0; i < arguments.size(); ++i)
+    {
+    const std::string::size_type start = arguments[i].find_first_not_of(" \t");
+    const std::string::size_type end = arguments[i].find_last_not_of(" \t\f\v\n\r");
+    if (start == std::string::npos || end == std::string::npos)
+      {
+      continue;
+      }
+    vexp.push_back(arguments[i].substr(start, end - start + 1));
+
+    if (vexp.size() > 1 && vexp[vexp.size() - 2] == "-ram"
+        && static_cast<unsigned int>(atoi(vexp.back().c_str())) > this->GetRAMPerJob())
+      {
+      std::ostringstream ram;
+      ram << this->GetRAMPerJob();
+      std::cerr << "Application server: ram limited to " << ram.str() << " MB" << std::endl;
+      vexp.back() = ram.str();
+      }
+    }
+
+  try
+    {
+    CommandLineLauncher::Pointer launcher = CommandLineLauncher::New();
+    if (launcher->Load(vexp) && launcher->ExecuteAndWriteOutput())
+      {
+      return EXIT_SUCCESS;
+      }
+    }
+  catch (std::exception& err)
+    {
+    std::cerr << "Application server: " << err.what() << std::endl;
+    }
+  return EXIT_FAILURE;
+}
+
+void ApplicationServer::ReapJobs(bool wait)
+{
+  int options = wait ? 0 : WNOHANG;
+  int status = 0;
+  pid_t pid;
+  while ((pid = waitpid(-1, &status, options)) > 0)
+    {
+    std::map<pid_t, int>::iterator job = m_Jobs.find(pid);
+    if (job != m_Jobs.end())
+      {
+      // Same convention as the shells for the jobs killed by a signal
+      const int exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+      ApplicationServerProtocol::SendStatus(job->second, exitStatus);
+      close(job->second);
+      m_Jobs.erase(job);
+      }
+    options = WNOHANG;
+    }
+}
+
+void ApplicationServer::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "SocketPath: " << m_SocketPath << std::endl;
+  os << indent << "DEMDirectory: " << m_DEMDirectory << std::endl;
+  os << indent << "GeoidFile: " << m_GeoidFile << std::endl;
+  os << indent << "MaximumRAM: " << m_MaximumRAM << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "MaximumNumberOfJobs: " << m_MaximumNumberOfJobs << std::endl;
+  os << indent << "RunningJobs: " << m_Jobs.size() << std::endl;
+}
+
+} // end namespace Wrapper
+} // end namespace otb
@@ -42,6 +42,7 @@
 
 #include "otbWrapperApplicationRegistry.h"
 #include "otbWrapperTypes.h"
+#include "otbPipelineProfiler.h"
 #include <itksys/RegularExpression.hxx>
 #include <string>
 #include <iostream>
@@ -281,6 +282,19 @@ bool CommandLineLauncher::BeforeExecute()
         }
     }
 
+  // Check for the profiling report
+  if (m_Parser->IsAttributExists("-profile", m_VExpression) == true)
+    {
+    std::vector<std::string> val;
+    val = m_Parser->GetAttribut("-profile", m_VExpression);
+    if (val.size() != 1)
+      {
+      std::cerr << "ERROR: Invalid profile argument, must be a unique file name..." << std::endl;
+      return false;
+      }
+    PipelineProfiler::GetInstance()->SetFileName(val[0]);
+    }
+
   return true;
 }
 
@@ -687,6 +701,13 @@ void CommandLineLauncher::DisplayHelp()
 
   std::cerr << "        -"<<bigKey<<" <boolean>        Report progress " << std::endl;
 
+  //// profiling report parameter
+  bigKey = "profile";
+  for(unsigned int i=0; i<m_MaxKeySize-std::string("profile").size(); i++)
+    bigKey.append(" ");
+
+  std::cerr << "        -"<<bigKey<<" <string>         Write a profiling report of the pipelines (JSON trace) " << std::endl;
+
   for (unsigned int i = 0; i < nbOfParam; i++)
     {
       Parameter::Pointer param = m_Application->GetParameterByKey(appKeyList[i]);
@@ -918,6 +939,7 @@ bool CommandLineLauncher::CheckKeyValidity(std::string& refKey)
   std::vector<std::string> appKeyList = m_Application->GetParametersKeys(true);
   appKeyList.push_back("help");
   appKeyList.push_back("progress");
+  appKeyList.push_back("profile");
   appKeyList.push_back("testenv");
   appKeyList.push_back("version");
 
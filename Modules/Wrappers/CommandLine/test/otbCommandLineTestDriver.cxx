@@ -8,4 +8,10 @@ void RegisterTests()
   REGISTER_TEST(otbWrapperCommandLineParserTest2);
   REGISTER_TEST(otbWrapperCommandLineParserTest3);
   REGISTER_TEST(otbWrapperCommandLineParserTest4);
+#if !defined(_WIN32)
+  REGISTER_TEST(otbWrapperApplicationServerNew);
+  REGISTER_TEST(otbWrapperApplicationServerBudget);
+  REGISTER_TEST(otbWrapperApplicationServerProtocol);
+  REGISTER_TEST(otbWrapperApplicationServerJobs);
+#endif
 }
@@ -0,0 +1,265 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4786 )
+#endif
+
+#include "otbWrapperApplicationServer.h"
+#include "otbWrapperApplicationServerProtocol.h"
+
+#include <csignal>
+#include <sstream>
+#include <sys/wait.h>
+
+namespace
+{
+namespace Protocol = otb::Wrapper::ApplicationServerProtocol;
+
+/** Read what was written on the read end of a pipe */
+std::string ReadPipe(int fd)
+{
+  char          buffer[64];
+  const ssize_t nread = read(fd, buffer, sizeof(buffer));
+  return nread > 0 ? std::string(buffer, nread) : std::string();
+}
+
+/** Send a job to the server as otbApplicationClient does, and return
+ * its exit status, or -1 if the server can't be reached */
+int SendJob(const std::string& socketPath, const std::vector<std::string>& arguments)
+{
+  sockaddr_un address;
+  char        directory[4096];
+  if (!Protocol::MakeAddress(socketPath, address) || getcwd(directory, sizeof(directory)) == NULL)
+    {
+    return -1;
+    }
+
+  // The server may not be listening yet
+  for (unsigned int attempt = 0; attempt < 100; ++attempt)
+    {
+    const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+      {
+      return -1;
+      }
+    if (connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+      {
+      int status = -1;
+      if (!Protocol::SendRequest(connection, directory, arguments, STDOUT_FILENO, STDERR_FILENO)
+          || !Protocol::ReceiveStatus(connection, status))
+        {
+        status = -1;
+        }
+      close(connection);
+      return status;
+      }
+    close(connection);
+    usleep(100000);
+    }
+  return -1;
+}
+}
+
+int otbWrapperApplicationServerNew(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::Wrapper::ApplicationServer ServerType;
+  ServerType::Pointer server = ServerType::New();
+
+  std::cout << server << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperApplicationServerBudget(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::Wrapper::ApplicationServer ServerType;
+  ServerType::Pointer server = ServerType::New();
+
+  server->SetMaximumRAM(1000);
+  server->SetNumberOfThreads(8);
+  server->SetMaximumNumberOfJobs(3);
+  if (server->GetRAMPerJob() != 333 || server->GetThreadsPerJob() != 2)
+    {
+    std::cerr << "Wrong budget per job: " << server->GetRAMPerJob() << " MB, "
+              << server->GetThreadsPerJob() << " threads" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Each job gets at least one thread
+  server->SetMaximumNumberOfJobs(16);
+  if (server->GetThreadsPerJob() != 1)
+    {
+    std::cerr << "A job should get at least one thread" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperApplicationServerProtocol(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  int sockets[2];
+  int output[2];
+  int error[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0 || pipe(output) != 0 || pipe(error) != 0)
+    {
+    std::cerr << "Can't create the socket pair and the pipes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector<std::string> arguments;
+  arguments.push_back("Rescale");
+  arguments.push_back("-in");
+  arguments.push_back("image with spaces.tif");
+  arguments.push_back("-outmin");
+  arguments.push_back("15");
+
+  if (!Protocol::SendRequest(sockets[0], "/working/directory", arguments, output[1], error[1]))
+    {
+    std::cerr << "Can't send the request" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string              workingDirectory;
+  std::vector<std::string> received;
+  int                      outputFd = -1;
+  int                      errorFd = -1;
+  if (!Protocol::ReceiveRequest(sockets[1], workingDirectory, received, outputFd, errorFd))
+    {
+    std::cerr << "Can't receive the request" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (workingDirectory != "/working/directory" || received != arguments)
+    {
+    std::cerr << "Wrong request received: " << workingDirectory;
+    for (unsigned int i = 0; i < received.size(); ++i)
+      {
+      std::cerr << " [" << received[i] << "]";
+      }
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The descriptors received are new ones on the same pipes
+  if (outputFd < 0 || errorFd < 0
+      || write(outputFd, "out", 3) != 3 || write(errorFd, "err", 3) != 3
+      || ReadPipe(output[0]) != "out" || ReadPipe(error[0]) != "err")
+    {
+    std::cerr << "The descriptors received are not the output and error ones" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int status = -1;
+  if (!Protocol::SendStatus(sockets[1], 3) || !Protocol::ReceiveStatus(sockets[0], status) || status != 3)
+    {
+    std::cerr << "Wrong status received: " << status << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  close(outputFd);
+  close(errorFd);
+  close(sockets[0]);
+  close(sockets[1]);
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+    close(output[i]);
+    close(error[i]);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperApplicationServerJobs(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::Wrapper::ApplicationServer ServerType;
+
+  const std::string modulePath = argv[1];
+  const std::string input = argv[2];
+  const std::string output = argv[3];
+
+  // A socket of its own: the build tree path may be too long for a Unix
+  // socket, and a server of the user may be running
+  const char*        tmp = getenv("TMPDIR");
+  std::ostringstream socketPath;
+  socketPath << ((tmp != NULL && tmp[0] != '\0') ? tmp : "/tmp")
+             << "/otbWrapperApplicationServerJobs-" << getpid() << ".socket";
+
+  std::cout.flush();
+  std::cerr.flush();
+  const pid_t server = fork();
+  if (server < 0)
+    {
+    std::cerr << "Can't start the server" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (server == 0)
+    {
+    int status = EXIT_SUCCESS;
+    try
+      {
+      ServerType::Pointer applicationServer = ServerType::New();
+      applicationServer->SetSocketPath(socketPath.str());
+      applicationServer->SetMaximumNumberOfJobs(1);
+      applicationServer->Run();
+      }
+    catch (std::exception& err)
+      {
+      std::cerr << err.what() << std::endl;
+      status = EXIT_FAILURE;
+      }
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(status);
+    }
+
+  std::vector<std::string> success;
+  success.push_back("Rescale");
+  success.push_back(modulePath);
+  success.push_back("-in");
+  success.push_back(input);
+  success.push_back("-out");
+  success.push_back(output);
+
+  std::vector<std::string> failure;
+  failure.push_back("Rescale");
+  failure.push_back(modulePath);
+  failure.push_back("-inn");
+  failure.push_back(input);
+
+  const int successStatus = SendJob(socketPath.str(), success);
+  const int failureStatus = SendJob(socketPath.str(), failure);
+
+  int serverStatus = 0;
+  kill(server, SIGTERM);
+  waitpid(server, &serverStatus, 0);
+
+  std::cout << "Exit status of the jobs: " << successStatus << " and " << failureStatus << std::endl;
+  if (successStatus != EXIT_SUCCESS || failureStatus != EXIT_FAILURE)
+    {
+    std::cerr << "Wrong exit status of the jobs" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!WIFEXITED(serverStatus) || WEXITSTATUS(serverStatus) != EXIT_SUCCESS)
+    {
+    std::cerr << "The server did not stop cleanly" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
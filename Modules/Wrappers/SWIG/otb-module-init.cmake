@@ -25,6 +25,12 @@ if ( OTB_WRAP_PYTHON )
   check_PIC_flag ( Python )
   find_package ( PythonLibs REQUIRED )
   find_package ( PythonInterp REQUIRED )
+  # NumPy is optional, it enables the exchange of images with NumPy arrays
+  find_package ( Numpy )
+  option ( OTB_WRAP_PYTHON_NUMPY "Exchange images with NumPy arrays in the Python wrapping" ${NUMPY_FOUND} )
+  if ( OTB_WRAP_PYTHON_NUMPY AND NOT NUMPY_FOUND )
+    message ( FATAL_ERROR "OTB_WRAP_PYTHON_NUMPY requires the NumPy headers (set NUMPY_INCLUDE_DIR)" )
+  endif()
 endif()
 
 #
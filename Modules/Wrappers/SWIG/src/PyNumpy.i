@@ -0,0 +1,283 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if SWIGPYTHON && OTB_SWIGNUMPY
+
+ %{
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include "otbImportImageFilter.h"
+#include "otbImportVectorImageFilter.h"
+#include "otbMetaDataKey.h"
+#include "itkMetaDataObject.h"
+
+namespace otb
+{
+namespace Wrapper
+{
+namespace Numpy
+{
+
+/** NumPy type number of the pixel components */
+template <class T> struct TypeNumber;
+template <> struct TypeNumber<unsigned char>  { enum { Value = NPY_UINT8 }; };
+template <> struct TypeNumber<short>          { enum { Value = NPY_INT16 }; };
+template <> struct TypeNumber<unsigned short> { enum { Value = NPY_UINT16 }; };
+template <> struct TypeNumber<int>            { enum { Value = NPY_INT32 }; };
+template <> struct TypeNumber<unsigned int>   { enum { Value = NPY_UINT32 }; };
+template <> struct TypeNumber<float>          { enum { Value = NPY_FLOAT32 }; };
+template <> struct TypeNumber<double>         { enum { Value = NPY_FLOAT64 }; };
+
+/** Wrap the buffer of a C-contiguous array (rows, columns) or (rows,
+ * columns, bands) in the output image of an import filter, and set this
+ * image to an input image parameter. The array is not copied: the caller
+ * must keep it, as well as the returned import filter, as long as the
+ * image is used. */
+template <class TImage, class TImporter>
+itk::ProcessObject::Pointer ImportArray(Application * app, const std::string& paramKey,
+                                        PyArrayObject * array, const double origin[2],
+                                        const double spacing[2], const std::string& projection)
+{
+  typedef typename TImage::InternalPixelType ValueType;
+
+  typename TImage::RegionType region;
+  region.SetSize(0, PyArray_DIM(array, 1));
+  region.SetSize(1, PyArray_DIM(array, 0));
+
+  typename TImporter::Pointer importer = TImporter::New();
+  importer->SetRegion(region);
+  importer->SetOrigin(origin);
+  importer->SetSpacing(spacing);
+  importer->SetImportPointer(static_cast<ValueType *>(PyArray_DATA(array)), PyArray_SIZE(array), false);
+  importer->UpdateOutputInformation();
+  if (!projection.empty())
+    {
+    importer->GetOutput()->SetProjectionRef(projection);
+    }
+
+  app->SetParameterInputImage(paramKey, importer->GetOutput());
+  return importer.GetPointer();
+}
+
+/** Release the pixel container referenced by an exported array */
+void ReleasePixelContainer(PyObject * capsule)
+{
+  static_cast<itk::LightObject *>(PyCapsule_GetPointer(capsule, NULL))->UnRegister();
+}
+
+/** Array viewing the buffer of an image: one band (rows, columns) if band
+ * is positive, all the bands (rows, columns, bands) otherwise. The array
+ * holds a reference to the pixel container of the image, so that the
+ * buffer stays valid even if the image is updated again. */
+template <class TImage>
+PyObject * ExportImage(TImage * image, int band)
+{
+  typedef typename TImage::InternalPixelType ValueType;
+
+  const typename TImage::SizeType size = image->GetBufferedRegion().GetSize();
+  const int nbBands = image->GetNumberOfComponentsPerPixel();
+  if (band >= nbBands)
+    {
+    itkGenericExceptionMacro(<< "Band " << band << " requested from an image with " << nbBands << " bands");
+    }
+
+  npy_intp dims[3];
+  dims[0] = size[1];
+  dims[1] = size[0];
+  dims[2] = nbBands;
+
+  npy_intp strides[3];
+  strides[2] = sizeof(ValueType);
+  strides[1] = nbBands * strides[2];
+  strides[0] = dims[1] * strides[1];
+
+  ValueType * data = image->GetBufferPointer() + (band < 0 ? 0 : band);
+  PyObject * array = PyArray_New(&PyArray_Type, band < 0 ? 3 : 2, dims, TypeNumber<ValueType>::Value,
+                                 strides, data, 0, NPY_ARRAY_WRITEABLE, NULL);
+  if (array == NULL)
+    {
+    return NULL;
+    }
+
+  itk::LightObject * container = image->GetPixelContainer();
+  container->Register();
+  PyArray_SetBaseObject(reinterpret_cast<PyArrayObject *>(array),
+                        PyCapsule_New(container, NULL, ReleasePixelContainer));
+  return array;
+}
+
+} // end namespace Numpy
+} // end namespace Wrapper
+} // end namespace otb
+
+#define otbImportNumpyArrayMacro(ValueType, Image, VectorImage)               \
+  if (PyArray_EquivTypenums(typeNumber, otb::Wrapper::Numpy::TypeNumber<ValueType>::Value)) \
+    {                                                                      \
+    if (vectorImage)                                                       \
+      {                                                                    \
+      return otb::Wrapper::Numpy::ImportArray<VectorImage,                 \
+        otb::ImportVectorImageFilter<VectorImage> >(self, paramKey, array, origin, spacing, projection); \
+      }                                                                    \
+    return otb::Wrapper::Numpy::ImportArray<Image,                         \
+      otb::ImportImageFilter<Image> >(self, paramKey, array, origin, spacing, projection); \
+    }
+
+#define otbExportImageMacro(Image)                                         \
+  if (dynamic_cast<Image *>(image))                                        \
+    {                                                                      \
+    return otb::Wrapper::Numpy::ExportImage(dynamic_cast<Image *>(image), band); \
+    }
+ %}
+
+%init %{
+import_array();
+%}
+
+%extend Application
+{
+  /** Set an input image parameter from the buffer of a NumPy array. Use
+   *  SetImageFromNumpyArray() or SetVectorImageFromNumpyArray() instead. */
+  itkProcessObject_Pointer SetImageFromNumpyArray_(std::string paramKey, PyObject * object,
+                                                   double originX, double originY,
+                                                   double spacingX, double spacingY,
+                                                   std::string projection, bool vectorImage)
+  {
+    if (!PyArray_Check(object))
+      {
+      itkGenericExceptionMacro(<< "A NumPy array is expected for parameter " << paramKey);
+      }
+    PyArrayObject * array = reinterpret_cast<PyArrayObject *>(object);
+    if (PyArray_NDIM(array) != (vectorImage ? 3 : 2) || PyArray_SIZE(array) == 0
+        || !PyArray_ISCARRAY_RO(array) || !PyArray_ISNOTSWAPPED(array))
+      {
+      itkGenericExceptionMacro(<< "Parameter " << paramKey << " expects a non-empty C-contiguous array of "
+                               << (vectorImage ? "(rows, columns, bands)" : "(rows, columns)")
+                               << " in native byte order");
+      }
+
+    const double origin[2] = {originX, originY};
+    const double spacing[2] = {spacingX, spacingY};
+    const int    typeNumber = PyArray_TYPE(array);
+
+    otbImportNumpyArrayMacro(unsigned char, otb::Wrapper::UInt8ImageType, otb::Wrapper::UInt8VectorImageType);
+    otbImportNumpyArrayMacro(short, otb::Wrapper::Int16ImageType, otb::Wrapper::Int16VectorImageType);
+    otbImportNumpyArrayMacro(unsigned short, otb::Wrapper::UInt16ImageType, otb::Wrapper::UInt16VectorImageType);
+    otbImportNumpyArrayMacro(int, otb::Wrapper::Int32ImageType, otb::Wrapper::Int32VectorImageType);
+    otbImportNumpyArrayMacro(unsigned int, otb::Wrapper::UInt32ImageType, otb::Wrapper::UInt32VectorImageType);
+    otbImportNumpyArrayMacro(float, otb::Wrapper::FloatImageType, otb::Wrapper::FloatVectorImageType);
+    otbImportNumpyArrayMacro(double, otb::Wrapper::DoubleImageType, otb::Wrapper::DoubleVectorImageType);
+
+    itkGenericExceptionMacro(<< "Unsupported array type for parameter " << paramKey
+                             << " (supported: uint8, int16, uint16, int32, uint32, float32, float64)");
+  }
+
+  /** Update an output image parameter on its largest region, and return a
+   *  NumPy array viewing its buffer. Use GetImageAsNumpyArray() or
+   *  GetVectorImageAsNumpyArray() instead. */
+  PyObject * GetImageAsNumpyArray_(std::string paramKey, int band)
+  {
+    itk::ImageBase<2> * image = self->GetParameterOutputImage(paramKey);
+    if (image == NULL)
+      {
+      itkGenericExceptionMacro(<< "No image for parameter " << paramKey << ", has the application been executed ?");
+      }
+    image->UpdateOutputInformation();
+    image->SetRequestedRegionToLargestPossibleRegion();
+    image->PropagateRequestedRegion();
+    image->UpdateOutputData();
+
+    otbExportImageMacro(otb::Wrapper::UInt8ImageType);
+    otbExportImageMacro(otb::Wrapper::Int16ImageType);
+    otbExportImageMacro(otb::Wrapper::UInt16ImageType);
+    otbExportImageMacro(otb::Wrapper::Int32ImageType);
+    otbExportImageMacro(otb::Wrapper::UInt32ImageType);
+    otbExportImageMacro(otb::Wrapper::FloatImageType);
+    otbExportImageMacro(otb::Wrapper::DoubleImageType);
+    otbExportImageMacro(otb::Wrapper::UInt8VectorImageType);
+    otbExportImageMacro(otb::Wrapper::Int16VectorImageType);
+    otbExportImageMacro(otb::Wrapper::UInt16VectorImageType);
+    otbExportImageMacro(otb::Wrapper::Int32VectorImageType);
+    otbExportImageMacro(otb::Wrapper::UInt32VectorImageType);
+    otbExportImageMacro(otb::Wrapper::FloatVectorImageType);
+    otbExportImageMacro(otb::Wrapper::DoubleVectorImageType);
+
+    itkGenericExceptionMacro(<< "Image type of parameter " << paramKey << " can not be exported to NumPy");
+  }
+
+  /** Origin, spacing and projection of an output image parameter. Use
+   *  GetImageMetaData() instead. */
+  PyObject * GetImageMetaData_(std::string paramKey)
+  {
+    itk::ImageBase<2> * image = self->GetParameterOutputImage(paramKey);
+    if (image == NULL)
+      {
+      itkGenericExceptionMacro(<< "No image for parameter " << paramKey << ", has the application been executed ?");
+      }
+    image->UpdateOutputInformation();
+
+    std::string projection;
+    itk::ExposeMetaData<std::string>(image->GetMetaDataDictionary(), otb::MetaDataKey::ProjectionRefKey, projection);
+
+    return Py_BuildValue("{s:(dd),s:(dd),s:s}",
+                         "origin", image->GetOrigin()[0], image->GetOrigin()[1],
+                         "spacing", image->GetSpacing()[0], image->GetSpacing()[1],
+                         "projection", projection.c_str());
+  }
+
+  %pythoncode {
+    def _KeepNumpyImport(self, paramKey, npArray, importer):
+       # The images imported from NumPy arrays wrap the array buffers: keep
+       # the arrays and the import filters as long as the application
+       self.__dict__.setdefault('_numpyImports', {})[paramKey] = (npArray, importer)
+
+    def SetImageFromNumpyArray(self, paramKey, npArray, origin=(0.5, 0.5), spacing=(1., 1.), projection=""):
+       """Set an input image parameter from a 2D array (rows, columns), without copying it.
+       The array type selects the pixel type of the image."""
+       import numpy
+       npArray = numpy.ascontiguousarray(npArray)
+       importer = self.SetImageFromNumpyArray_(paramKey, npArray, origin[0], origin[1],
+                                               spacing[0], spacing[1], projection, False)
+       self._KeepNumpyImport(paramKey, npArray, importer)
+
+    def SetVectorImageFromNumpyArray(self, paramKey, npArray, origin=(0.5, 0.5), spacing=(1., 1.), projection=""):
+       """Set an input image parameter from a 3D array (rows, columns, bands), without copying it.
+       The array type selects the pixel type of the image."""
+       import numpy
+       npArray = numpy.ascontiguousarray(npArray)
+       importer = self.SetImageFromNumpyArray_(paramKey, npArray, origin[0], origin[1],
+                                               spacing[0], spacing[1], projection, True)
+       self._KeepNumpyImport(paramKey, npArray, importer)
+
+    def GetImageAsNumpyArray(self, paramKey, band=0):
+       """Compute an output image parameter (after Execute()) in memory, and return a
+       2D array (rows, columns) viewing one of its bands, without copying it."""
+       return self.GetImageAsNumpyArray_(paramKey, band)
+
+    def GetVectorImageAsNumpyArray(self, paramKey):
+       """Compute an output image parameter (after Execute()) in memory, and return a
+       3D array (rows, columns, bands) viewing it, without copying it."""
+       return self.GetImageAsNumpyArray_(paramKey, -1)
+
+    def GetImageMetaData(self, paramKey):
+       """Origin, spacing and projection of an output image parameter, as a dictionary
+       which can be passed to SetImageFromNumpyArray() with the ** operator."""
+       return self.GetImageMetaData_(paramKey)
+  }
+}
+
+#endif
@@ -276,3 +276,4 @@ public:
 };
 
 %include "PyCommand.i"
+%include "PyNumpy.i"
@@ -0,0 +1,50 @@
+# -*- coding: utf-8 -*-
+
+#
+#  Exchange images with NumPy arrays, without writing any file
+#
+import sys
+import numpy
+import otbApplication as otb
+
+rows, cols, bands = 50, 60, 3
+radius = 2
+image = numpy.random.RandomState(0).uniform(0, 255, (rows, cols, bands)).astype(numpy.float32)
+
+app = otb.Registry.CreateApplication("Smoothing")
+app.SetVectorImageFromNumpyArray("in", image, origin=(10.5, 20.5), spacing=(2., -2.))
+app.SetParameterString("type", "mean")
+app.SetParameterInt("type.mean.radius", radius)
+app.Execute()
+
+smoothed = app.GetVectorImageAsNumpyArray("out")
+if smoothed.shape != image.shape:
+  sys.exit("Wrong output shape " + str(smoothed.shape))
+
+# Mean filter, away from the borders
+size = 2 * radius + 1
+expected = numpy.zeros((rows - size + 1, cols - size + 1, bands))
+for dy in range(size):
+  for dx in range(size):
+    expected += image[dy:dy + rows - size + 1, dx:dx + cols - size + 1, :]
+expected /= size * size
+if not numpy.allclose(smoothed[radius:rows - radius, radius:cols - radius, :], expected, atol=1e-3):
+  sys.exit("Wrong smoothed values")
+
+# One band, as a view on the same buffer
+band = app.GetImageAsNumpyArray("out", 1)
+if not numpy.array_equal(band, smoothed[:, :, 1]):
+  sys.exit("Wrong band 1")
+
+metadata = app.GetImageMetaData("out")
+if metadata["origin"] != (10.5, 20.5) or metadata["spacing"] != (2., -2.):
+  sys.exit("Wrong metadata " + str(metadata))
+
+# Chain a second application on the output array
+app2 = otb.Registry.CreateApplication("Smoothing")
+app2.SetImageFromNumpyArray("in", band, **metadata)
+app2.SetParameterString("type", "mean")
+app2.SetParameterInt("type.mean.radius", 0)
+app2.Execute()
+if not numpy.allclose(app2.GetImageAsNumpyArray("out"), band):
+  sys.exit("Wrong identity smoothing")